@@ -72,6 +72,8 @@ typedef enum {
     UCX_PERF_WAIT_MODE_POLL,         /* Repeatedly call progress */
     UCX_PERF_WAIT_MODE_SLEEP,        /* Go to sleep */
     UCX_PERF_WAIT_MODE_SPIN,         /* Spin without calling progress */
+    UCX_PERF_WAIT_MODE_HYBRID,       /* Call progress for a while, then go to
+                                        sleep */
     UCX_PERF_WAIT_MODE_LAST
 } ucx_perf_wait_mode_t;
 
@@ -173,6 +175,8 @@ typedef enum {
 
 #define UCP_PERF_FC_WINDOW_DEFAULT 4
 
+#define UCP_PERF_WAIT_SPIN_DEFAULT 100e-6
+
 /**
  * Performance counter type.
  */
@@ -320,6 +324,9 @@ typedef struct ucx_perf_params {
         ucp_perf_datatype_t     recv_datatype;
         size_t                  am_hdr_size; /* UCP Active Message header size
                                                 (not included in message size) */
+        double                  wait_spin;   /* Maximal busy-poll time of
+                                                ucp_worker_wait() in hybrid
+                                                wait mode, in seconds */
         int                     is_daemon_mode;  /* Whether DPU offloading daemon
                                                     is configured */
         struct sockaddr_storage dmn_local_addr;  /* IP and port of local daemon,
@@ -927,7 +927,8 @@ static ucs_status_t ucp_perf_test_fill_params(ucx_perf_params_t *params,
     }
 
     if ((params->flags & UCX_PERF_TEST_FLAG_WAKEUP) ||
-        (params->wait_mode == UCX_PERF_WAIT_MODE_SLEEP)) {
+        (params->wait_mode == UCX_PERF_WAIT_MODE_SLEEP) ||
+        (params->wait_mode == UCX_PERF_WAIT_MODE_HYBRID)) {
         ucp_params->features |= UCP_FEATURE_WAKEUP;
     }
 
@@ -2090,6 +2091,10 @@ static ucs_status_t ucp_perf_setup(ucx_perf_context_t *perf)
 
     worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
     worker_params.thread_mode = perf->params.thread_mode;
+    if (perf->params.wait_mode == UCX_PERF_WAIT_MODE_HYBRID) {
+        worker_params.field_mask |= UCP_WORKER_PARAM_FIELD_WAIT_SPIN;
+        worker_params.wait_spin   = perf->params.ucp.wait_spin;
+    }
 
     for (i = 0; i < thread_count; i++) {
         perf->ucp.tctx[i].tid              = i;
@@ -238,7 +238,9 @@ public:
     }
 
     void UCS_F_ALWAYS_INLINE progress() {
-        if (ucs_unlikely(UCX_PERF_WAIT_MODE_SLEEP == m_perf.params.wait_mode)) {
+        if (ucs_unlikely((UCX_PERF_WAIT_MODE_SLEEP == m_perf.params.wait_mode) ||
+                         (UCX_PERF_WAIT_MODE_HYBRID ==
+                          m_perf.params.wait_mode))) {
             blocking_progress();
         } else {
             ucp_worker_progress(m_perf.ucp.worker);
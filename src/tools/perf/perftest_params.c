@@ -171,6 +171,11 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -E <mode>      wait mode for tests\n");
     printf("                        poll       : repeatedly call worker_progress\n");
     printf("                        sleep      : go to sleep after posting requests\n");
+    printf("                        hybrid[:<usec>]\n");
+    printf("                                   : call worker_progress for up to <usec> (%.0f)\n",
+                                ctx->params.super.ucp.wait_spin * 1e6);
+    printf("                                     before going to sleep, based on recent\n");
+    printf("                                     message arrival times\n");
     printf("     -H <size>      active message header size (%zu), not included in message size\n",
                                 ctx->params.super.ucp.am_hdr_size);
     printf("     -y             do additional memcopy to the user memory in active message receive handler\n");
@@ -656,6 +661,16 @@ ucs_status_t parse_test_params(perftest_params_t *params, char opt,
         } else if (!strcmp(opt_arg, "sleep")) {
             params->super.wait_mode = UCX_PERF_WAIT_MODE_SLEEP;
             return UCS_OK;
+        } else if (!strncmp(opt_arg, "hybrid", strlen("hybrid"))) {
+            params->super.wait_mode = UCX_PERF_WAIT_MODE_HYBRID;
+            optarg2                 = opt_arg + strlen("hybrid");
+            if (*optarg2 == ':') {
+                params->super.ucp.wait_spin = atof(optarg2 + 1) * 1e-6;
+            } else if (*optarg2 != '\0') {
+                ucs_error("Invalid option argument for -E");
+                return UCS_ERR_INVALID_PARAM;
+            }
+            return UCS_OK;
         } else {
             ucs_error("Invalid option argument for -E");
             return UCS_ERR_INVALID_PARAM;
@@ -0,0 +1,1160 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucp/api/ucp.h>
+#include <ucp/core/ucp_api_record.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/profile/profile.h>
+#include <ucs/time/time.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+
+
+#define AM_ID                  0
+#define REPLAY_THREAD_ALL      -1
+#define REPLAY_IOV_MAX         4
+#define REPLAY_WINDOW_DEFAULT  64
+
+#define print_error(_fmt, ...) \
+    fprintf(stderr, "Error: " _fmt "\n", ## __VA_ARGS__)
+
+
+typedef enum {
+    REPLAY_OP_TAG_SEND,
+    REPLAY_OP_TAG_SEND_SYNC,
+    REPLAY_OP_TAG_RECV,
+    REPLAY_OP_AM_SEND,
+    REPLAY_OP_STREAM_SEND,
+    REPLAY_OP_PUT,
+    REPLAY_OP_GET,
+    REPLAY_OP_EP_FLUSH,
+    REPLAY_OP_LAST,
+    REPLAY_OP_NONE = REPLAY_OP_LAST
+} replay_op_t;
+
+
+typedef struct options {
+    const char                   *filename;
+    int                          thread;
+    int                          pace;
+    int                          loopback;
+    unsigned                     window;
+} options_t;
+
+
+typedef struct {
+    const ucs_profile_thread_header_t   *header;
+    const ucs_profile_record_t          *records;
+} replay_thread_data_t;
+
+
+typedef struct {
+    void                         *mem;
+    size_t                       length;
+    const ucs_profile_header_t   *header;
+    const ucs_profile_location_t *locations;
+    replay_thread_data_t         *threads;
+    uint32_t                     num_locations;
+    unsigned                     num_threads;
+    replay_op_t                  *location_ops;
+} replay_data_t;
+
+
+/* Replays the calls of one recorded endpoint */
+typedef struct {
+    ucp_ep_h                     tx_ep;      /* sender -> receiver */
+    ucp_ep_h                     rx_ep;      /* receiver -> sender */
+    ucp_rkey_h                   rkey;       /* Receiver buffer */
+} replay_peer_t;
+
+
+typedef struct {
+    size_t                       count;
+    size_t                       bytes;
+    ucs_time_t                   time;
+} replay_op_stats_t;
+
+
+/* Map recorded endpoint to replay peer index */
+KHASH_MAP_INIT_INT64(replay_peer, unsigned);
+
+
+typedef struct {
+    ucp_context_h                context;
+    ucp_worker_h                 sender;
+    ucp_worker_h                 receiver;
+    replay_peer_t                *peers;
+    unsigned                     num_peers;
+    khash_t(replay_peer)         peer_hash;
+    ucp_mem_h                    memh;
+    ucp_datatype_t               generic_dt;
+    void                         *send_buffer;
+    void                         *recv_buffer;
+    size_t                       buffer_size;
+    unsigned                     outstanding; /* Operations in progress */
+    ucs_status_t                 status;      /* First operation failure */
+    ucp_tag_t                    tag;         /* Last used message tag */
+    replay_op_stats_t            stats[REPLAY_OP_LAST];
+} replay_ctx_t;
+
+
+/* Replayed operation, completed when both its sender and receiver parts are */
+typedef struct replay_req {
+    replay_ctx_t                 *ctx;
+    struct replay_req            *self;       /* Active message header */
+    replay_op_t                  op;
+    size_t                       length;
+    unsigned                     parts;       /* Parts not completed yet */
+    ucs_time_t                   start_time;
+    ucp_dt_iov_t                 send_iov[REPLAY_IOV_MAX];
+    ucp_dt_iov_t                 recv_iov[REPLAY_IOV_MAX];
+} replay_req_t;
+
+
+/* State of the generic datatype, which packs a contiguous buffer */
+typedef struct {
+    void                         *buffer;
+    size_t                       length;
+} replay_generic_state_t;
+
+
+static const char *replay_op_names[] = {
+    [REPLAY_OP_TAG_SEND]      = UCP_API_RECORD_OP_TAG_SEND,
+    [REPLAY_OP_TAG_SEND_SYNC] = UCP_API_RECORD_OP_TAG_SEND_SYNC,
+    [REPLAY_OP_TAG_RECV]      = UCP_API_RECORD_OP_TAG_RECV,
+    [REPLAY_OP_AM_SEND]       = UCP_API_RECORD_OP_AM_SEND,
+    [REPLAY_OP_STREAM_SEND]   = UCP_API_RECORD_OP_STREAM_SEND,
+    [REPLAY_OP_PUT]           = UCP_API_RECORD_OP_PUT,
+    [REPLAY_OP_GET]           = UCP_API_RECORD_OP_GET,
+    [REPLAY_OP_EP_FLUSH]      = UCP_API_RECORD_OP_EP_FLUSH,
+    [REPLAY_OP_LAST]          = NULL
+};
+
+
+static replay_op_t replay_location_op(const ucs_profile_location_t *loc)
+{
+    size_t prefix_len = strlen(UCP_API_RECORD_PREFIX);
+    replay_op_t op;
+
+    if ((loc->type != UCS_PROFILE_TYPE_SAMPLE) ||
+        strncmp(loc->name, UCP_API_RECORD_PREFIX, prefix_len)) {
+        return REPLAY_OP_NONE;
+    }
+
+    for (op = 0; op < REPLAY_OP_LAST; ++op) {
+        if (!strncmp(loc->name + prefix_len, replay_op_names[op],
+                     sizeof(loc->name) - prefix_len)) {
+            return op;
+        }
+    }
+
+    return REPLAY_OP_NONE;
+}
+
+static int read_replay_data(const char *file_name, replay_data_t *data)
+{
+    size_t total_num_records = 0;
+    const void *threads_start, *threads_end;
+    replay_thread_data_t *thread;
+    uint32_t thread_idx, i;
+    const void *ptr;
+    struct stat stt;
+    int ret, fd;
+
+    fd = open(file_name, O_RDONLY);
+    if (fd < 0) {
+        print_error("failed to open %s: %m", file_name);
+        return fd;
+    }
+
+    ret = fstat(fd, &stt);
+    if (ret < 0) {
+        print_error("fstat(%s) failed: %m", file_name);
+        goto out_close;
+    }
+
+    data->length = stt.st_size;
+    data->mem    = mmap(NULL, stt.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data->mem == MAP_FAILED) {
+        print_error("mmap(%s, length=%zd) failed: %m", file_name,
+                    data->length);
+        ret = -1;
+        goto out_close;
+    }
+
+    data->header = data->mem;
+    if (data->header->version < UCS_PROFILE_FILE_MIN_VERSION) {
+        print_error("invalid file version, expected: %u or greater, actual: %u",
+                    UCS_PROFILE_FILE_MIN_VERSION, data->header->version);
+        ret = -1;
+        goto err_munmap;
+    }
+
+    if (!(data->header->mode & UCS_BIT(UCS_PROFILE_MODE_LOG))) {
+        print_error("%s was not recorded with UCX_PROFILE_MODE=log", file_name);
+        ret = -1;
+        goto err_munmap;
+    }
+
+    data->num_locations = data->header->locations.size /
+                          sizeof(ucs_profile_location_t);
+    data->locations     = UCS_PTR_BYTE_OFFSET(data->mem,
+                                              data->header->locations.offset);
+    /* coverity[tainted_data] */
+    data->location_ops  = calloc(data->num_locations + 1,
+                                 sizeof(*data->location_ops));
+    /* coverity[tainted_data] */
+    data->threads       = calloc(data->header->threads.size, 1);
+    if ((data->location_ops == NULL) || (data->threads == NULL)) {
+        print_error("failed to allocate replay data");
+        ret = -1;
+        goto err_free;
+    }
+
+    for (i = 0; i < data->num_locations; ++i) {
+        data->location_ops[i] = replay_location_op(&data->locations[i]);
+    }
+
+    threads_start = UCS_PTR_BYTE_OFFSET(data->mem,
+                                        data->header->threads.offset);
+    threads_end   = UCS_PTR_BYTE_OFFSET(threads_start,
+                                        data->header->threads.size);
+
+    for (thread_idx = 0, ptr = threads_start; ptr < threads_end; ++thread_idx) {
+        thread             = &data->threads[thread_idx];
+        thread->header     = ptr;
+        ptr                = thread->header + 1;
+        ptr                = (const ucs_profile_thread_location_t*)ptr +
+                             data->num_locations;
+        thread->records    = ptr;
+        ptr                = thread->records + thread->header->num_records;
+        total_num_records += thread->header->num_records;
+    }
+
+    data->num_threads = ucs_profile_calc_num_threads(total_num_records,
+                                                     data->header);
+    ret               = 0;
+
+out_close:
+    close(fd);
+    return ret;
+
+err_free:
+    free(data->threads);
+    free(data->location_ops);
+err_munmap:
+    munmap(data->mem, data->length);
+    goto out_close;
+}
+
+static void release_replay_data(replay_data_t *data)
+{
+    free(data->threads);
+    free(data->location_ops);
+    munmap(data->mem, data->length);
+}
+
+static replay_op_t
+replay_record_op(const replay_data_t *data, const ucs_profile_record_t *rec)
+{
+    return (rec->location < data->num_locations) ?
+           data->location_ops[rec->location] : REPLAY_OP_NONE;
+}
+
+
+static int replay_thread_selected(const options_t *opts, unsigned thread_idx)
+{
+    return (opts->thread == REPLAY_THREAD_ALL) ||
+           (opts->thread == (int)thread_idx);
+}
+
+/* Return the next recorded call of all replayed threads, by time */
+static const ucs_profile_record_t *
+replay_next_record(const replay_data_t *data, const options_t *opts,
+                   const ucs_profile_record_t **cursors, replay_op_t *op_p)
+{
+    const ucs_profile_record_t *next = NULL;
+    const replay_thread_data_t *thread;
+    unsigned thread_idx, next_idx;
+
+    for (thread_idx = 0; thread_idx < data->num_threads; ++thread_idx) {
+        if (!replay_thread_selected(opts, thread_idx)) {
+            continue;
+        }
+
+        thread = &data->threads[thread_idx];
+        while ((cursors[thread_idx] <
+                thread->records + thread->header->num_records) &&
+               (replay_record_op(data, cursors[thread_idx]) ==
+                REPLAY_OP_NONE)) {
+            ++cursors[thread_idx];
+        }
+
+        if ((cursors[thread_idx] <
+             thread->records + thread->header->num_records) &&
+            ((next == NULL) ||
+             (cursors[thread_idx]->timestamp < next->timestamp))) {
+            next     = cursors[thread_idx];
+            next_idx = thread_idx;
+        }
+    }
+
+    if (next != NULL) {
+        ++cursors[next_idx];
+        *op_p = replay_record_op(data, next);
+    }
+
+    return next;
+}
+
+static void replay_cursors_init(const replay_data_t *data,
+                                const ucs_profile_record_t **cursors)
+{
+    unsigned thread_idx;
+
+    for (thread_idx = 0; thread_idx < data->num_threads; ++thread_idx) {
+        cursors[thread_idx] = data->threads[thread_idx].records;
+    }
+}
+
+/* Find the buffer size and assign a peer to every recorded endpoint */
+static int replay_scan(replay_ctx_t *ctx, const replay_data_t *data,
+                       const options_t *opts)
+{
+    const ucs_profile_record_t **cursors;
+    const ucs_profile_record_t *rec;
+    replay_op_t op;
+    khiter_t iter;
+    int ret;
+
+    cursors = calloc(data->num_threads + 1, sizeof(*cursors));
+    if (cursors == NULL) {
+        print_error("failed to allocate thread cursors");
+        return -1;
+    }
+
+    ctx->buffer_size = 1;
+    ctx->num_peers   = 0;
+
+    replay_cursors_init(data, cursors);
+    while ((rec = replay_next_record(data, opts, cursors, &op)) != NULL) {
+        ctx->buffer_size = ucs_max(ctx->buffer_size, rec->param32);
+        if (op == REPLAY_OP_TAG_RECV) {
+            /* A tag receive has no peer */
+            continue;
+        }
+
+        iter = kh_put(replay_peer, &ctx->peer_hash,
+                      UCP_API_RECORD_PEER(rec->param64), &ret);
+        if (ret == UCS_KH_PUT_FAILED) {
+            print_error("failed to add a recorded endpoint");
+            free(cursors);
+            return -1;
+        } else if (ret != UCS_KH_PUT_KEY_PRESENT) {
+            kh_val(&ctx->peer_hash, iter) = ctx->num_peers++;
+        }
+    }
+
+    /* Tag receives are replayed as messages from the first peer */
+    ctx->num_peers = ucs_max(ctx->num_peers, 1);
+    free(cursors);
+    return 0;
+}
+
+static replay_peer_t *replay_peer(replay_ctx_t *ctx, replay_op_t op,
+                                  const ucs_profile_record_t *rec)
+{
+    khiter_t iter;
+
+    if (op == REPLAY_OP_TAG_RECV) {
+        return &ctx->peers[0];
+    }
+
+    /* All recorded endpoints were added by replay_scan() */
+    iter = kh_get(replay_peer, &ctx->peer_hash,
+                  UCP_API_RECORD_PEER(rec->param64));
+    return &ctx->peers[kh_val(&ctx->peer_hash, iter)];
+}
+
+static void *replay_generic_start(void *context, const void *buffer,
+                                  size_t count)
+{
+    replay_generic_state_t *state = malloc(sizeof(*state));
+
+    if (state != NULL) {
+        state->buffer = (void*)buffer;
+        state->length = count;
+    }
+
+    return state;
+}
+
+static void *
+replay_generic_start_unpack(void *context, void *buffer, size_t count)
+{
+    return replay_generic_start(context, buffer, count);
+}
+
+static size_t replay_generic_packed_size(void *state)
+{
+    return ((replay_generic_state_t*)state)->length;
+}
+
+static size_t replay_generic_pack(void *state, size_t offset, void *dest,
+                                  size_t max_length)
+{
+    replay_generic_state_t *gstate = state;
+    size_t length                  = ucs_min(max_length,
+                                             gstate->length - offset);
+
+    memcpy(dest, UCS_PTR_BYTE_OFFSET(gstate->buffer, offset), length);
+    return length;
+}
+
+static ucs_status_t replay_generic_unpack(void *state, size_t offset,
+                                          const void *src, size_t length)
+{
+    replay_generic_state_t *gstate = state;
+
+    if ((offset + length) > gstate->length) {
+        return UCS_ERR_MESSAGE_TRUNCATED;
+    }
+
+    memcpy(UCS_PTR_BYTE_OFFSET(gstate->buffer, offset), src, length);
+    return UCS_OK;
+}
+
+static void replay_generic_finish(void *state)
+{
+    free(state);
+}
+
+static ucp_generic_dt_ops_t replay_generic_ops = {
+    .start_pack   = replay_generic_start,
+    .start_unpack = replay_generic_start_unpack,
+    .packed_size  = replay_generic_packed_size,
+    .pack         = replay_generic_pack,
+    .unpack       = replay_generic_unpack,
+    .finish       = replay_generic_finish
+};
+
+/*
+ * Describe a buffer with the recorded datatype class. IOV buffers are split to
+ * REPLAY_IOV_MAX entries, and generic datatypes pack one byte per element.
+ */
+static void *replay_buffer_dt(replay_ctx_t *ctx, uint64_t dt_class,
+                              void *buffer, size_t length, ucp_dt_iov_t *iov,
+                              ucp_request_param_t *param, size_t *count_p)
+{
+    size_t iovcnt, offset, i;
+
+    switch (dt_class) {
+    case UCP_DATATYPE_IOV:
+        iovcnt = ucs_max(ucs_min(length, REPLAY_IOV_MAX), 1);
+        for (i = 0, offset = 0; i < iovcnt; ++i) {
+            iov[i].buffer = UCS_PTR_BYTE_OFFSET(buffer, offset);
+            iov[i].length = (length - offset) / (iovcnt - i);
+            offset       += iov[i].length;
+        }
+
+        param->datatype = ucp_dt_make_iov();
+        *count_p        = iovcnt;
+        return iov;
+    case UCP_DATATYPE_GENERIC:
+        param->datatype = ctx->generic_dt;
+        break;
+    default:
+        param->datatype = ucp_dt_make_contig(1);
+        break;
+    }
+
+    *count_p = length;
+    return buffer;
+}
+
+static void replay_req_part_done(replay_req_t *rreq, ucs_status_t status)
+{
+    replay_ctx_t *ctx = rreq->ctx;
+    replay_op_stats_t *stats;
+
+    if ((status != UCS_OK) && (ctx->status == UCS_OK)) {
+        print_error("%s of %zu bytes failed: %s", replay_op_names[rreq->op],
+                    rreq->length, ucs_status_string(status));
+        ctx->status = status;
+    }
+
+    if (--rreq->parts > 0) {
+        return;
+    }
+
+    stats         = &ctx->stats[rreq->op];
+    stats->time  += ucs_get_time() - rreq->start_time;
+    stats->bytes += rreq->length;
+    ++stats->count;
+    --ctx->outstanding;
+    free(rreq);
+}
+
+/* Complete a part of the operation, unless the callback is going to do it */
+static void replay_req_track(replay_req_t *rreq, ucs_status_ptr_t request)
+{
+    if (!UCS_PTR_IS_PTR(request)) {
+        replay_req_part_done(rreq, UCS_PTR_STATUS(request));
+    }
+}
+
+static void replay_send_cb(void *request, ucs_status_t status, void *user_data)
+{
+    ucp_request_free(request);
+    replay_req_part_done(user_data, status);
+}
+
+static void replay_tag_recv_cb(void *request, ucs_status_t status,
+                               const ucp_tag_recv_info_t *tag_info,
+                               void *user_data)
+{
+    ucp_request_free(request);
+    replay_req_part_done(user_data, status);
+}
+
+static void replay_data_recv_cb(void *request, ucs_status_t status,
+                                size_t length, void *user_data)
+{
+    ucp_request_free(request);
+    replay_req_part_done(user_data, status);
+}
+
+static void replay_param_init(ucp_request_param_t *param, replay_req_t *rreq)
+{
+    param->op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK |
+                          UCP_OP_ATTR_FIELD_USER_DATA |
+                          UCP_OP_ATTR_FIELD_DATATYPE;
+    param->user_data    = rreq;
+    param->datatype     = ucp_dt_make_contig(1);
+}
+
+static ucs_status_t replay_am_cb(void *arg, const void *header,
+                                 size_t header_length, void *data,
+                                 size_t length,
+                                 const ucp_am_recv_param_t *param)
+{
+    replay_ctx_t *ctx    = arg;
+    replay_req_t *rreq   = *(replay_req_t* const*)header;
+    ucp_request_param_t recv_param;
+    ucs_status_ptr_t request;
+    size_t count;
+    void *buffer;
+
+    if (!(param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV)) {
+        /* The data is not needed, so release it and let the sender complete */
+        replay_req_part_done(rreq, UCS_OK);
+        return UCS_OK;
+    }
+
+    /* Fetch the rendezvous payload, as the application would */
+    replay_param_init(&recv_param, rreq);
+    recv_param.cb.recv_am = replay_data_recv_cb;
+    buffer  = replay_buffer_dt(ctx, UCP_DATATYPE_CONTIG, ctx->recv_buffer,
+                               length, rreq->recv_iov, &recv_param, &count);
+    request = ucp_am_recv_data_nbx(ctx->receiver, data, buffer, count,
+                                   &recv_param);
+    replay_req_track(rreq, request);
+    return UCS_OK;
+}
+
+static ucs_status_t
+replay_ep_create(ucp_worker_h worker, ucp_worker_h remote, ucp_ep_h *ep_p)
+{
+    ucp_ep_params_t ep_params;
+    ucp_address_t *address;
+    size_t address_length;
+    ucs_status_t status;
+
+    status = ucp_worker_get_address(remote, &address, &address_length);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address    = address;
+    status               = ucp_ep_create(worker, &ep_params, ep_p);
+    ucp_worker_release_address(remote, address);
+    return status;
+}
+
+static void replay_progress(replay_ctx_t *ctx)
+{
+    ucp_worker_progress(ctx->sender);
+    if (ctx->receiver != ctx->sender) {
+        ucp_worker_progress(ctx->receiver);
+    }
+}
+
+static ucs_status_t replay_wait(replay_ctx_t *ctx, ucs_status_ptr_t request)
+{
+    ucs_status_t status;
+
+    if (!UCS_PTR_IS_PTR(request)) {
+        return UCS_PTR_STATUS(request);
+    }
+
+    do {
+        replay_progress(ctx);
+        status = ucp_request_check_status(request);
+    } while (status == UCS_INPROGRESS);
+
+    ucp_request_free(request);
+    return status;
+}
+
+static void replay_ep_close(replay_ctx_t *ctx, ucp_ep_h ep)
+{
+    ucp_request_param_t param;
+
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags        = UCP_EP_CLOSE_FLAG_FORCE;
+    replay_wait(ctx, ucp_ep_close_nbx(ep, &param));
+}
+
+static void replay_peer_cleanup(replay_ctx_t *ctx, replay_peer_t *peer)
+{
+    if (peer->rkey != NULL) {
+        ucp_rkey_destroy(peer->rkey);
+    }
+
+    if ((peer->rx_ep != NULL) && (peer->rx_ep != peer->tx_ep)) {
+        replay_ep_close(ctx, peer->rx_ep);
+    }
+
+    if (peer->tx_ep != NULL) {
+        replay_ep_close(ctx, peer->tx_ep);
+    }
+}
+
+/*
+ * Endpoints of the peers are created in the same order on both workers, so
+ * every receiver endpoint is matched with the sender endpoint of its peer.
+ */
+static ucs_status_t replay_peer_init(replay_ctx_t *ctx, replay_peer_t *peer,
+                                     const void *rkey_buffer)
+{
+    ucs_status_t status;
+
+    status = replay_ep_create(ctx->sender, ctx->receiver, &peer->tx_ep);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (ctx->receiver == ctx->sender) {
+        peer->rx_ep = peer->tx_ep;
+    } else {
+        status = replay_ep_create(ctx->receiver, ctx->sender, &peer->rx_ep);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    return ucp_ep_rkey_unpack(peer->tx_ep, rkey_buffer, &peer->rkey);
+}
+
+static ucs_status_t replay_ctx_init(replay_ctx_t *ctx, const options_t *opts)
+{
+    ucp_worker_params_t worker_params = {0};
+    ucp_am_handler_param_t am_param;
+    ucp_mem_map_params_t map_params;
+    ucp_params_t params;
+    void *rkey_buffer;
+    size_t rkey_size;
+    ucs_status_t status;
+    unsigned i;
+
+    params.field_mask = UCP_PARAM_FIELD_FEATURES;
+    params.features   = UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_RMA |
+                        UCP_FEATURE_STREAM;
+    status            = ucp_init(&params, NULL, &ctx->context);
+    if (status != UCS_OK) {
+        print_error("failed to create UCP context: %s",
+                    ucs_status_string(status));
+        return status;
+    }
+
+    ctx->outstanding = 0;
+    ctx->status      = UCS_OK;
+    ctx->tag         = 0;
+    memset(ctx->stats, 0, sizeof(ctx->stats));
+
+    ctx->send_buffer = calloc(1, ctx->buffer_size);
+    ctx->recv_buffer = calloc(1, ctx->buffer_size);
+    ctx->peers       = calloc(ctx->num_peers, sizeof(*ctx->peers));
+    if ((ctx->send_buffer == NULL) || (ctx->recv_buffer == NULL) ||
+        (ctx->peers == NULL)) {
+        print_error("failed to allocate buffers of %zu bytes",
+                    ctx->buffer_size);
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free;
+    }
+
+    status = ucp_dt_create_generic(&replay_generic_ops, NULL,
+                                   &ctx->generic_dt);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    worker_params.field_mask  = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+    status = ucp_worker_create(ctx->context, &worker_params, &ctx->sender);
+    if (status != UCS_OK) {
+        goto err_destroy_dt;
+    }
+
+    if (opts->loopback) {
+        ctx->receiver = ctx->sender;
+    } else {
+        status = ucp_worker_create(ctx->context, &worker_params,
+                                   &ctx->receiver);
+        if (status != UCS_OK) {
+            goto err_destroy_sender;
+        }
+    }
+
+    am_param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                          UCP_AM_HANDLER_PARAM_FIELD_CB |
+                          UCP_AM_HANDLER_PARAM_FIELD_ARG;
+    am_param.id         = AM_ID;
+    am_param.cb         = replay_am_cb;
+    am_param.arg        = ctx;
+    status = ucp_worker_set_am_recv_handler(ctx->receiver, &am_param);
+    if (status != UCS_OK) {
+        goto err_destroy_receiver;
+    }
+
+    map_params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS |
+                            UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    map_params.address    = ctx->recv_buffer;
+    map_params.length     = ctx->buffer_size;
+    status = ucp_mem_map(ctx->context, &map_params, &ctx->memh);
+    if (status != UCS_OK) {
+        goto err_destroy_receiver;
+    }
+
+    status = ucp_rkey_pack(ctx->context, ctx->memh, &rkey_buffer, &rkey_size);
+    if (status != UCS_OK) {
+        goto err_unmap;
+    }
+
+    for (i = 0; i < ctx->num_peers; ++i) {
+        status = replay_peer_init(ctx, &ctx->peers[i], rkey_buffer);
+        if (status != UCS_OK) {
+            break;
+        }
+    }
+
+    ucp_rkey_buffer_release(rkey_buffer);
+    if (status != UCS_OK) {
+        goto err_cleanup_peers;
+    }
+
+    return UCS_OK;
+
+err_cleanup_peers:
+    for (i = 0; i < ctx->num_peers; ++i) {
+        replay_peer_cleanup(ctx, &ctx->peers[i]);
+    }
+err_unmap:
+    ucp_mem_unmap(ctx->context, ctx->memh);
+err_destroy_receiver:
+    if (ctx->receiver != ctx->sender) {
+        ucp_worker_destroy(ctx->receiver);
+    }
+err_destroy_sender:
+    ucp_worker_destroy(ctx->sender);
+err_destroy_dt:
+    ucp_dt_destroy(ctx->generic_dt);
+err_free:
+    free(ctx->peers);
+    free(ctx->recv_buffer);
+    free(ctx->send_buffer);
+    ucp_cleanup(ctx->context);
+    print_error("failed to initialize replay: %s", ucs_status_string(status));
+    return status;
+}
+
+static void replay_ctx_cleanup(replay_ctx_t *ctx)
+{
+    unsigned i;
+
+    for (i = 0; i < ctx->num_peers; ++i) {
+        replay_peer_cleanup(ctx, &ctx->peers[i]);
+    }
+
+    ucp_mem_unmap(ctx->context, ctx->memh);
+    if (ctx->receiver != ctx->sender) {
+        ucp_worker_destroy(ctx->receiver);
+    }
+    ucp_worker_destroy(ctx->sender);
+    ucp_dt_destroy(ctx->generic_dt);
+    free(ctx->peers);
+    free(ctx->recv_buffer);
+    free(ctx->send_buffer);
+    ucp_cleanup(ctx->context);
+}
+
+/* Send a tagged message with a unique tag, and receive it on the other side */
+static void replay_tag(replay_req_t *rreq, uint64_t dt_class, ucp_ep_h ep,
+                       ucp_worker_h receiver, int sync)
+{
+    replay_ctx_t *ctx = rreq->ctx;
+    ucp_tag_t tag     = ++ctx->tag;
+    ucp_request_param_t param;
+    ucs_status_ptr_t sreq;
+    size_t count;
+    void *buffer;
+
+    rreq->parts = 2;
+
+    replay_param_init(&param, rreq);
+    param.cb.recv = replay_tag_recv_cb;
+    buffer        = replay_buffer_dt(ctx, dt_class, ctx->recv_buffer,
+                                     rreq->length, rreq->recv_iov, &param,
+                                     &count);
+    replay_req_track(rreq, ucp_tag_recv_nbx(receiver, buffer, count, tag,
+                                            (ucp_tag_t)-1, &param));
+
+    replay_param_init(&param, rreq);
+    param.cb.send = replay_send_cb;
+    buffer        = replay_buffer_dt(ctx, dt_class, ctx->send_buffer,
+                                     rreq->length, rreq->send_iov, &param,
+                                     &count);
+    if (sync) {
+        sreq = ucp_tag_send_sync_nbx(ep, buffer, count, tag, &param);
+    } else {
+        sreq = ucp_tag_send_nbx(ep, buffer, count, tag, &param);
+    }
+
+    replay_req_track(rreq, sreq);
+}
+
+static void replay_am(replay_req_t *rreq, uint64_t dt_class,
+                      replay_peer_t *peer)
+{
+    replay_ctx_t *ctx = rreq->ctx;
+    ucp_request_param_t param;
+    size_t count;
+    void *buffer;
+
+    /* The receiver completes the other part from the AM callback, which finds
+     * the request by the header */
+    rreq->parts = 2;
+    rreq->self  = rreq;
+
+    replay_param_init(&param, rreq);
+    param.cb.send = replay_send_cb;
+    buffer        = replay_buffer_dt(ctx, dt_class, ctx->send_buffer,
+                                     rreq->length, rreq->send_iov, &param,
+                                     &count);
+    replay_req_track(rreq, ucp_am_send_nbx(peer->tx_ep, AM_ID, &rreq->self,
+                                           sizeof(rreq->self), buffer, count,
+                                           &param));
+}
+
+static void replay_stream(replay_req_t *rreq, uint64_t dt_class,
+                          replay_peer_t *peer)
+{
+    replay_ctx_t *ctx = rreq->ctx;
+    ucp_request_param_t param;
+    size_t count, recv_length;
+    void *buffer;
+
+    rreq->parts = 2;
+
+    replay_param_init(&param, rreq);
+    param.cb.send = replay_send_cb;
+    buffer        = replay_buffer_dt(ctx, dt_class, ctx->send_buffer,
+                                     rreq->length, rreq->send_iov, &param,
+                                     &count);
+    replay_req_track(rreq, ucp_stream_send_nbx(peer->tx_ep, buffer, count,
+                                               &param));
+
+    replay_param_init(&param, rreq);
+    param.op_attr_mask   |= UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags           = UCP_STREAM_RECV_FLAG_WAITALL;
+    param.cb.recv_stream  = replay_data_recv_cb;
+    buffer                = replay_buffer_dt(ctx, dt_class, ctx->recv_buffer,
+                                             rreq->length, rreq->recv_iov,
+                                             &param, &count);
+    replay_req_track(rreq, ucp_stream_recv_nbx(peer->rx_ep, buffer, count,
+                                               &recv_length, &param));
+}
+
+/* Start replaying a recorded call, without waiting for it to complete */
+static ucs_status_t replay_op(replay_ctx_t *ctx, replay_op_t op,
+                              const ucs_profile_record_t *rec)
+{
+    uint64_t dt_class    = UCP_API_RECORD_DT_CLASS(rec->param64);
+    replay_peer_t *peer  = replay_peer(ctx, op, rec);
+    ucp_request_param_t param;
+    replay_req_t *rreq;
+
+    rreq = malloc(sizeof(*rreq));
+    if (rreq == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    rreq->ctx        = ctx;
+    rreq->op         = op;
+    rreq->length     = rec->param32;
+    rreq->parts      = 1;
+    rreq->start_time = ucs_get_time();
+    ++ctx->outstanding;
+
+    replay_param_init(&param, rreq);
+    param.cb.send = replay_send_cb;
+
+    switch (op) {
+    case REPLAY_OP_TAG_SEND:
+        replay_tag(rreq, dt_class, peer->tx_ep, ctx->receiver, 0);
+        break;
+    case REPLAY_OP_TAG_SEND_SYNC:
+        replay_tag(rreq, dt_class, peer->tx_ep, ctx->receiver, 1);
+        break;
+    case REPLAY_OP_TAG_RECV:
+        /* A received message is replayed in the opposite direction */
+        replay_tag(rreq, dt_class, peer->rx_ep, ctx->sender, 0);
+        break;
+    case REPLAY_OP_AM_SEND:
+        replay_am(rreq, dt_class, peer);
+        break;
+    case REPLAY_OP_STREAM_SEND:
+        replay_stream(rreq, dt_class, peer);
+        break;
+    case REPLAY_OP_PUT:
+        /* Remote memory access is replayed with contiguous buffers */
+        replay_req_track(rreq, ucp_put_nbx(peer->tx_ep, ctx->send_buffer,
+                                           rreq->length,
+                                           (uintptr_t)ctx->recv_buffer,
+                                           peer->rkey, &param));
+        break;
+    case REPLAY_OP_GET:
+        replay_req_track(rreq, ucp_get_nbx(peer->tx_ep, ctx->send_buffer,
+                                           rreq->length,
+                                           (uintptr_t)ctx->recv_buffer,
+                                           peer->rkey, &param));
+        break;
+    case REPLAY_OP_EP_FLUSH:
+        replay_req_track(rreq, ucp_ep_flush_nbx(peer->tx_ep, &param));
+        break;
+    default:
+        replay_req_part_done(rreq, UCS_ERR_INVALID_PARAM);
+        break;
+    }
+
+    return UCS_OK;
+}
+
+/*
+ * Replay the calls of all selected threads in the recorded order. A call is
+ * started without waiting for the previous ones, so the calls overlap as they
+ * did in the application, up to the window size.
+ */
+static int replay_run(replay_ctx_t *ctx, const replay_data_t *data,
+                      const options_t *opts)
+{
+    double recorded_second             = data->header->one_second;
+    const ucs_profile_record_t *first  = NULL;
+    const ucs_profile_record_t **cursors;
+    const ucs_profile_record_t *rec;
+    ucs_time_t start_time, target;
+    ucs_status_t status;
+    replay_op_t op;
+
+    cursors = calloc(data->num_threads + 1, sizeof(*cursors));
+    if (cursors == NULL) {
+        print_error("failed to allocate thread cursors");
+        return -1;
+    }
+
+    replay_cursors_init(data, cursors);
+    start_time = ucs_get_time();
+    while ((ctx->status == UCS_OK) &&
+           ((rec = replay_next_record(data, opts, cursors, &op)) != NULL)) {
+        if (first == NULL) {
+            first = rec;
+        }
+
+        if (opts->pace) {
+            /* Keep the recorded time between the calls */
+            target = start_time +
+                     ucs_time_from_sec((rec->timestamp - first->timestamp) /
+                                       recorded_second);
+            while (ucs_get_time() < target) {
+                replay_progress(ctx);
+            }
+        }
+
+        while ((ctx->outstanding >= opts->window) &&
+               (ctx->status == UCS_OK)) {
+            replay_progress(ctx);
+        }
+
+        status = replay_op(ctx, op, rec);
+        if (status != UCS_OK) {
+            print_error("%s of %u bytes failed: %s", replay_op_names[op],
+                        rec->param32, ucs_status_string(status));
+            ctx->status = status;
+        }
+    }
+
+    /* After a failure, the remaining calls are completed by closing the
+     * endpoints */
+    while ((ctx->outstanding > 0) && (ctx->status == UCS_OK)) {
+        replay_progress(ctx);
+    }
+
+    free(cursors);
+    return (ctx->status == UCS_OK) ? 0 : -1;
+}
+
+static void replay_show_stats(const replay_op_stats_t *stats,
+                              ucs_time_t total_time)
+{
+    replay_op_t op;
+
+    printf("%-16s %12s %16s %14s %14s\n", "operation", "count", "bytes",
+           "total (msec)", "avg (usec)");
+    for (op = 0; op < REPLAY_OP_LAST; ++op) {
+        if (stats[op].count == 0) {
+            continue;
+        }
+
+        printf("%-16s %12zu %16zu %14.3f %14.3f\n", replay_op_names[op],
+               stats[op].count, stats[op].bytes,
+               ucs_time_to_msec(stats[op].time),
+               ucs_time_to_usec(stats[op].time) / stats[op].count);
+    }
+
+    printf("total replay time: %.3f msec\n", ucs_time_to_msec(total_time));
+}
+
+static void usage()
+{
+    printf("Usage: ucx_replay [options] <profile-file>\n");
+    printf("Replays the UCP communication calls recorded by running an\n");
+    printf("application with UCX_PROFILE_MODE=log, between two workers in\n");
+    printf("this process. Every recorded endpoint is replayed by its own\n");
+    printf("pair of endpoints, and calls are started without waiting for\n");
+    printf("the previous ones to complete. The time of a call is measured\n");
+    printf("until both its send and receive sides complete.\n");
+    printf("Use UCX_TLS to select the transport.\n");
+    printf("Options are:\n");
+    printf("  -T <thread>     Replay only the calls of this thread index "
+           "(default: all)\n");
+    printf("  -p              Keep the recorded time between calls\n");
+    printf("  -w <count>      Maximal number of calls in progress "
+           "(default: %d)\n", REPLAY_WINDOW_DEFAULT);
+    printf("  -l              Use a single worker, connected to itself\n");
+    printf("  -h              Show this help message\n");
+}
+
+static int parse_args(int argc, char **argv, options_t *opts)
+{
+    int c;
+
+    opts->thread   = REPLAY_THREAD_ALL;
+    opts->pace     = 0;
+    opts->loopback = 0;
+    opts->window   = REPLAY_WINDOW_DEFAULT;
+
+    while ((c = getopt(argc, argv, "T:pw:lh")) != -1) {
+        switch (c) {
+        case 'T':
+            opts->thread = atoi(optarg);
+            break;
+        case 'p':
+            opts->pace = 1;
+            break;
+        case 'w':
+            opts->window = atoi(optarg);
+            if (opts->window == 0) {
+                print_error("window size must be positive");
+                return -1;
+            }
+            break;
+        case 'l':
+            opts->loopback = 1;
+            break;
+        case 'h':
+            usage();
+            return -127;
+        default:
+            usage();
+            return -1;
+        }
+    }
+
+    if (optind >= argc) {
+        print_error("missing profile file argument\n");
+        usage();
+        return -1;
+    }
+
+    opts->filename = argv[optind];
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    replay_data_t data = {0};
+    ucs_time_t start_time;
+    replay_ctx_t ctx;
+    options_t opts;
+    int ret;
+
+    ret = parse_args(argc, argv, &opts);
+    if (ret < 0) {
+        return (ret == -127) ? 0 : ret;
+    }
+
+    /* coverity[tainted_argument] */
+    ret = read_replay_data(opts.filename, &data);
+    if (ret < 0) {
+        return ret;
+    }
+
+    kh_init_inplace(replay_peer, &ctx.peer_hash);
+
+    ret = replay_scan(&ctx, &data, &opts);
+    if (ret < 0) {
+        goto out;
+    }
+
+    if (replay_ctx_init(&ctx, &opts) != UCS_OK) {
+        ret = -1;
+        goto out;
+    }
+
+    start_time = ucs_get_time();
+    ret        = replay_run(&ctx, &data, &opts);
+    if (ret == 0) {
+        replay_show_stats(ctx.stats, ucs_get_time() - start_time);
+    }
+
+    replay_ctx_cleanup(&ctx);
+out:
+    kh_destroy_inplace(replay_peer, &ctx.peer_hash);
+    release_replay_data(&data);
+    return ret;
+}
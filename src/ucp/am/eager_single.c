@@ -12,6 +12,7 @@
 
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_am.h>
+#include <ucp/proto/proto_coalesce.h>
 #include <ucp/proto/proto_common.inl>
 #include <ucp/proto/proto_single.h>
 #include <ucp/proto/proto_single.inl>
@@ -72,6 +73,11 @@ ucp_am_eager_short_proto_progress_common(uct_pending_req_t *self, int is_reply)
     status = uct_ep_am_short_iov(ucp_ep_get_fast_lane(req->send.ep,
                                                       spriv->super.lane),
                                  am_id, iov, iov_cnt);
+    if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE)) {
+        status = ucp_proto_coalesce_add_iov(req, spriv->super.lane, am_id, iov,
+                                            iov_cnt);
+    }
+
     if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE)) {
         req->send.lane = spriv->super.lane; /* for pending add */
         return ucp_am_handle_user_header_send_status_or_abort(
@@ -206,6 +212,24 @@ static size_t ucp_am_eager_single_bcopy_pack(void *dest, void *arg)
     return ucp_am_eager_single_bcopy_pack_common(dest, arg, 0);
 }
 
+static ucs_status_t
+ucp_am_eager_single_bcopy_coalesce(ucp_request_t *req, ucp_am_id_t am_id,
+                                   uct_pack_callback_t pack_func, int is_reply)
+{
+    const ucp_proto_single_priv_t *spriv = req->send.proto_config->priv;
+    ucs_status_t status;
+
+    status = ucp_proto_coalesce_add(
+            req, spriv->super.lane, am_id, pack_func, req,
+            sizeof(ucp_am_hdr_t) + ucp_am_send_req_total_size(req) +
+            (is_reply ? sizeof(ucp_am_reply_ftr_t) : 0));
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    return ucp_proto_request_am_bcopy_complete_success(req);
+}
+
 static ucs_status_t
 ucp_am_eager_single_bcopy_proto_progress(uct_pending_req_t *self)
 {
@@ -217,6 +241,11 @@ ucp_am_eager_single_bcopy_proto_progress(uct_pending_req_t *self)
             req, UCP_AM_ID_AM_SINGLE, spriv->super.lane,
             ucp_am_eager_single_bcopy_pack, req, SIZE_MAX,
             ucp_proto_request_am_bcopy_complete_success, 1);
+    if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE)) {
+        status = ucp_am_eager_single_bcopy_coalesce(
+                req, UCP_AM_ID_AM_SINGLE, ucp_am_eager_single_bcopy_pack, 0);
+    }
+
     return ucp_am_handle_user_header_send_status_or_abort(req, status);
 }
 
@@ -297,6 +326,12 @@ ucp_am_eager_single_bcopy_reply_proto_progress(uct_pending_req_t *self)
             req, UCP_AM_ID_AM_SINGLE_REPLY, spriv->super.lane,
             ucp_am_eager_single_bcopy_reply_pack, req, SIZE_MAX,
             ucp_proto_request_am_bcopy_complete_success, 1);
+    if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE)) {
+        status = ucp_am_eager_single_bcopy_coalesce(
+                req, UCP_AM_ID_AM_SINGLE_REPLY,
+                ucp_am_eager_single_bcopy_reply_pack, 1);
+    }
+
     return ucp_am_handle_user_header_send_status_or_abort(req, status);
 }
 
@@ -190,7 +190,10 @@ enum ucp_worker_params_field {
     UCP_WORKER_PARAM_FIELD_NAME         = UCS_BIT(6), /**< Worker name */
     UCP_WORKER_PARAM_FIELD_AM_ALIGNMENT = UCS_BIT(7), /**< Alignment of active
                                                            messages on the receiver */
-    UCP_WORKER_PARAM_FIELD_CLIENT_ID    = UCS_BIT(8)  /**< Client id */
+    UCP_WORKER_PARAM_FIELD_CLIENT_ID    = UCS_BIT(8), /**< Client id */
+    UCP_WORKER_PARAM_FIELD_WAIT_SPIN    = UCS_BIT(9)  /**< Maximal busy-poll
+                                                           time in
+                                                           @ref ucp_worker_wait */
 };
 
 
@@ -297,7 +300,7 @@ enum ucp_ep_params_flags_field {
                                                            send to a particular
                                                            remote endpoint, for
                                                            example stream */
-    UCP_EP_PARAMS_FLAGS_SEND_CLIENT_ID = UCS_BIT(2)   /**< Send client id
+    UCP_EP_PARAMS_FLAGS_SEND_CLIENT_ID = UCS_BIT(2),  /**< Send client id
                                                            when connecting to remote
                                                            socket address as part of the
                                                            connection request payload.
@@ -305,6 +308,14 @@ enum ucp_ep_params_flags_field {
                                                            can be obtained from
                                                            @ref ucp_conn_request_h using
                                                            @ref ucp_conn_request_query */
+    UCP_EP_PARAMS_FLAGS_COMPRESS       = UCS_BIT(3)   /**< Allow compressing
+                                                           the data sent on the
+                                                           endpoint, when it is
+                                                           estimated to reduce
+                                                           the transfer time.
+                                                           The remote peer must
+                                                           support compressed
+                                                           messages */
 };
 
 
@@ -1525,6 +1536,19 @@ typedef struct ucp_worker_params {
     * using @ref ucp_conn_request_query.
     */
     uint64_t                client_id;
+
+    /**
+     * Maximal time, in seconds, that @ref ucp_worker_wait may busy-poll the
+     * worker before blocking on the event file descriptor. The actual
+     * busy-poll time of every call is derived from the recent time between
+     * events: if events arrive shortly, the worker progresses until the next
+     * one arrives and avoids the wakeup latency of the blocking wait;
+     * otherwise, it blocks right away to save CPU.
+     * This value is optional.
+     * If @ref UCP_WORKER_PARAM_FIELD_WAIT_SPIN is not set in the field_mask,
+     * or the value is 0, @ref ucp_worker_wait always blocks immediately.
+     */
+    double                  wait_spin;
 } ucp_worker_params_t;
 
 
@@ -2545,6 +2569,10 @@ ucs_status_t ucp_worker_get_efd(ucp_worker_h worker, int *fd);
  * notification and may not progress some of the requests as it would when
  * calling @ref ucp_worker_progress (which is not invoked in that duration).
  *
+ * @note If the worker was created with @ref UCP_WORKER_PARAM_FIELD_WAIT_SPIN,
+ * this routine may call @ref ucp_worker_progress for a short time before
+ * blocking, and return once it has progressed an event.
+ *
  * @note UCP @ref ucp_feature "features" have to be triggered
  *   with @ref UCP_FEATURE_WAKEUP to select proper transport
  *
@@ -13,6 +13,7 @@
 #include "ucp_am.h"
 #include <ucp/am/ucp_am.inl>
 
+#include <ucp/core/ucp_api_record.h>
 #include <ucp/core/ucp_ep.h>
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_worker.h>
@@ -79,12 +80,30 @@ void ucp_am_ep_init(ucp_ep_h ep)
     ucp_ep_ext_t *ep_ext = ep->ext;
 
     if (ep->worker->context->config.features & UCP_FEATURE_AM) {
-        ucs_list_head_init(&ep_ext->am.started_ams);
-        ucs_queue_head_init(&ep_ext->am.mid_rdesc_q);
         ep_ext->am.psn = 0;
     }
 }
 
+ucp_ep_am_frags_t *ucp_am_ep_frags_get(ucp_ep_ext_t *ep_ext)
+{
+    ucp_ep_am_frags_t *frags = ep_ext->am.frags;
+
+    if (ucs_likely(frags != NULL)) {
+        return frags;
+    }
+
+    frags = ucs_malloc(sizeof(*frags), "ucp_ep_am_frags");
+    if (frags == NULL) {
+        ucs_error("ep %p: failed to allocate AM reassembly state", ep_ext->ep);
+        return NULL;
+    }
+
+    ucs_list_head_init(&frags->started_ams);
+    ucs_queue_head_init(&frags->mid_rdesc_q);
+    ep_ext->am.frags = frags;
+    return frags;
+}
+
 static UCS_F_ALWAYS_INLINE void ucp_am_release_long_desc(ucp_recv_desc_t *desc)
 {
     /* Don't use UCS_PTR_BYTE_OFFSET here due to coverity false positive report. */
@@ -93,17 +112,19 @@ static UCS_F_ALWAYS_INLINE void ucp_am_release_long_desc(ucp_recv_desc_t *desc)
 
 void ucp_am_ep_cleanup(ucp_ep_h ep)
 {
-    ucp_ep_ext_t *ep_ext = ep->ext;
+    ucp_ep_am_frags_t *frags = ep->ext->am.frags;
     ucp_recv_desc_t *rdesc, *tmp_rdesc;
     ucs_queue_iter_t iter;
     size_t count;
 
-    if (!(ep->worker->context->config.features & UCP_FEATURE_AM)) {
+    /* The reassembly state itself is released with the endpoint, since more
+     * fragments may arrive until the endpoint is destroyed */
+    if (frags == NULL) {
         return;
     }
 
     count = 0;
-    ucs_list_for_each_safe(rdesc, tmp_rdesc, &ep_ext->am.started_ams,
+    ucs_list_for_each_safe(rdesc, tmp_rdesc, &frags->started_ams,
                            am_first.list) {
         ucs_list_del(&rdesc->am_first.list);
         ucs_interval_tree_cleanup(ucp_am_rdesc_frag_tree(rdesc));
@@ -114,9 +135,8 @@ void ucp_am_ep_cleanup(ucp_ep_h ep)
                    " dropped on ep %p", ep->worker, count, ep);
 
     count = 0;
-    ucs_queue_for_each_safe(rdesc, iter, &ep_ext->am.mid_rdesc_q,
-                            am_mid_queue) {
-        ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
+    ucs_queue_for_each_safe(rdesc, iter, &frags->mid_rdesc_q, am_mid_queue) {
+        ucs_queue_del_iter(&frags->mid_rdesc_q, iter);
         ucp_recv_desc_release(rdesc);
         ++count;
     }
@@ -991,6 +1011,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nbx,
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_AM,
                                     return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
     UCP_REQUEST_CHECK_PARAM(param);
+    UCP_API_RECORD(UCP_API_RECORD_OP_AM_SEND, ep, buffer, count, param);
 
     status = ucp_am_check_id(id);
     if (status != UCS_OK) {
@@ -1400,7 +1421,11 @@ ucp_am_find_first_rdesc(ucp_worker_h worker, ucp_ep_ext_t *ep_ext,
     ucp_recv_desc_t *rdesc;
     ucp_am_first_ftr_t *first_ftr;
 
-    ucs_list_for_each(rdesc, &ep_ext->am.started_ams, am_first.list) {
+    if (ep_ext->am.frags == NULL) {
+        return NULL;
+    }
+
+    ucs_list_for_each(rdesc, &ep_ext->am.frags->started_ams, am_first.list) {
         first_ftr = (ucp_am_first_ftr_t*)(rdesc + 1);
         if (first_ftr->super.msg_id == msg_id) {
             return rdesc;
@@ -1454,8 +1479,8 @@ ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *rdesc,
 
     ucp_am_copy_data_fragment(rdesc, data, length, offset);
 
-    ucs_list_for_each_safe(first_rdesc, tmp_rdesc, &ep_ext->am.started_ams,
-                           am_first.list) {
+    ucs_list_for_each_safe(first_rdesc, tmp_rdesc,
+                           &ep_ext->am.frags->started_ams, am_first.list) {
         if (first_rdesc == NULL) {
             return;
         }
@@ -1522,16 +1547,21 @@ ucp_am_handle_unfinished(ucp_worker_h worker, ucp_recv_desc_t *rdesc,
 static void ucp_am_release_mid_fragments_by_msg_id(ucp_ep_ext_t *ep_ext,
                                                     uint64_t msg_id)
 {
+    ucp_ep_am_frags_t *frags = ep_ext->am.frags;
     ucp_recv_desc_t *mid_rdesc;
     ucp_am_mid_ftr_t *mid_ftr;
     ucs_queue_iter_t iter;
 
-    ucs_queue_for_each_safe(mid_rdesc, iter, &ep_ext->am.mid_rdesc_q,
+    if (frags == NULL) {
+        return;
+    }
+
+    ucs_queue_for_each_safe(mid_rdesc, iter, &frags->mid_rdesc_q,
                             am_mid_queue) {
         mid_ftr = UCS_PTR_BYTE_OFFSET(mid_rdesc + 1,
                                       mid_rdesc->length - sizeof(*mid_ftr));
         if (mid_ftr->msg_id == msg_id) {
-            ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
+            ucs_queue_del_iter(&frags->mid_rdesc_q, iter);
             ucp_recv_desc_release(mid_rdesc);
         }
     }
@@ -1567,6 +1597,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
     ucp_am_mid_hdr_t *mid_hdr;
     ucp_am_mid_ftr_t *mid_ftr;
     ucp_am_first_ftr_t *first_ftr;
+    ucp_ep_am_frags_t *frags;
     ucs_queue_iter_t iter;
     ucp_ep_h ep;
     ucp_ep_ext_t *ep_ext;
@@ -1599,7 +1630,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
     }
 
     /* This is the first fragment, other fragments (if arrived) should be on
-     * ep_ext->am.mid_rdesc_q queue */
+     * ep_ext->am.frags->mid_rdesc_q queue */
     first_rdesc = ucp_am_find_first_rdesc(worker, ep_ext,
                                           first_ftr->super.msg_id);
 
@@ -1607,6 +1638,11 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         goto out;
     }
 
+    frags = ucp_am_ep_frags_get(ep_ext);
+    if (ucs_unlikely(frags == NULL)) {
+        return UCS_OK; /* release UCT desc */
+    }
+
     /* Alloc buffer for the data and its desc, as we know total_size.
      * Need to allocate a separate rdesc which would be in one contiguous chunk
      * with data buffer. The layout of assembled message is below:
@@ -1662,7 +1698,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
                            UCS_ARCH_MEMCPY_NT_SOURCE, user_hdr_length);
 
     /* Copy all already arrived middle fragments to the data buffer */
-    ucs_queue_for_each_safe(mid_rdesc, iter, &ep_ext->am.mid_rdesc_q,
+    ucs_queue_for_each_safe(mid_rdesc, iter, &frags->mid_rdesc_q,
                             am_mid_queue) {
         mid_ftr = UCS_PTR_BYTE_OFFSET(mid_rdesc + 1,
                                       mid_rdesc->length - sizeof(*mid_ftr));
@@ -1671,7 +1707,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         }
 
         mid_hdr = (ucp_am_mid_hdr_t*)(mid_rdesc + 1);
-        ucs_queue_del_iter(&ep_ext->am.mid_rdesc_q, iter);
+        ucs_queue_del_iter(&frags->mid_rdesc_q, iter);
         ucp_am_copy_data_fragment(first_rdesc, mid_hdr + 1,
                                   mid_rdesc->length - UCP_AM_MID_FRAG_META_LEN,
                                   mid_hdr->offset +
@@ -1679,7 +1715,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_first_handler,
         ucp_recv_desc_release(mid_rdesc);
     }
 
-    ucs_list_add_tail(&ep_ext->am.started_ams, &first_rdesc->am_first.list);
+    ucs_list_add_tail(&frags->started_ams, &first_rdesc->am_first.list);
 
 out:
     /* Note: copy first chunk of data together with AM header, which contains
@@ -1701,6 +1737,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
     ucp_am_mid_hdr_t *mid_hdr  = am_data;
     ucp_recv_desc_t *mid_rdesc = NULL, *first_rdesc = NULL;
     ucp_am_mid_ftr_t *mid_ftr;
+    ucp_ep_am_frags_t *frags;
     ucp_ep_ext_t *ep_ext;
     ucp_ep_h ep;
     ucs_status_t status;
@@ -1724,6 +1761,11 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
         return UCS_OK; /* data is copied, release UCT desc */
     }
 
+    frags = ucp_am_ep_frags_get(ep_ext);
+    if (ucs_unlikely(frags == NULL)) {
+        return UCS_OK; /* release UCT desc */
+    }
+
     /* Init desc and put it on the queue in ep AM extension, because data
      * buffer is not allocated yet. When first fragment arrives (carrying total
      * data size), all middle fragments will be copied to the data buffer. */
@@ -1737,7 +1779,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_am_long_middle_handler,
     }
 
     ucs_assert(mid_rdesc != NULL);
-    ucs_queue_push(&ep_ext->am.mid_rdesc_q, &mid_rdesc->am_mid_queue);
+    ucs_queue_push(&frags->mid_rdesc_q, &mid_rdesc->am_mid_queue);
 
     return status;
 }
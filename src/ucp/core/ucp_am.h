@@ -12,6 +12,7 @@
 #include <ucs/datastruct/array.h>
 #include <ucs/datastruct/interval_tree.h>
 #include <ucs/datastruct/mpool.h>
+#include <ucp/core/ucp_ep.h>
 #include <ucp/rndv/rndv.h>
 
 #define ucp_am_hdr_from_rts(_rts) \
@@ -151,6 +152,9 @@ void ucp_am_ep_init(ucp_ep_h ep);
 
 void ucp_am_ep_cleanup(ucp_ep_h ep);
 
+/* Get the AM reassembly state of an endpoint, allocate it on first use */
+ucp_ep_am_frags_t *ucp_am_ep_frags_get(ucp_ep_ext_t *ep_ext);
+
 ucs_status_t ucp_proto_progress_am_rndv_rts(uct_pending_req_t *self);
 
 ucs_status_t ucp_am_rndv_process_rts(void *arg, void *data, size_t length,
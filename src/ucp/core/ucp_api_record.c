@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ucp_api_record.h"
+#include "ucp_request.inl"
+
+#include <ucp/dt/dt_contig.h>
+#include <ucp/dt/dt_iov.h>
+#include <ucs/profile/profile.h>
+
+
+void ucp_api_record(const char *name, ucp_ep_h ep, const void *buffer,
+                    size_t count, const ucp_request_param_t *param,
+                    const char *file, int line, const char *function,
+                    volatile ucs_profile_loc_id_t *loc_id_p)
+{
+    ucp_datatype_t datatype = ucp_request_param_datatype(param);
+    size_t length;
+
+    switch (datatype & UCP_DATATYPE_CLASS_MASK) {
+    case UCP_DATATYPE_CONTIG:
+        length = ucp_contig_dt_length(datatype, count);
+        break;
+    case UCP_DATATYPE_IOV:
+        length = ucp_dt_iov_length(buffer, count);
+        break;
+    default:
+        /* Packing a generic datatype could have side effects */
+        length = count;
+        break;
+    }
+
+    ucp_api_record_length(name, ep, length, datatype, file, line, function,
+                          loc_id_p);
+}
+
+void ucp_api_record_length(const char *name, ucp_ep_h ep, size_t length,
+                           ucp_datatype_t dt_class, const char *file, int line,
+                           const char *function,
+                           volatile ucs_profile_loc_id_t *loc_id_p)
+{
+    ucs_profile_record(ucs_profile_default_ctx, UCS_PROFILE_TYPE_SAMPLE, name,
+                       ucs_min(length, UINT32_MAX),
+                       UCP_API_RECORD_PARAM64(ep, dt_class), file, line,
+                       function, loc_id_p);
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_API_RECORD_H_
+#define UCP_API_RECORD_H_
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucp/api/ucp.h>
+#include <ucs/config/global_opts.h>
+#include <ucs/profile/profile_defs.h>
+#include <ucs/sys/compiler_def.h>
+
+
+/*
+ * UCP communication calls are recorded as profiling samples, when UCX is built
+ * with --enable-profiling and profiling is enabled in log mode
+ * (UCX_PROFILE_MODE=log). Every sample is named
+ * UCP_API_RECORD_PREFIX followed by the operation name, and holds:
+ *  - param32: message length in bytes, or number of elements for a generic
+ *             datatype, saturated to UINT32_MAX. A tag receive is recorded
+ *             when it completes, with the received length.
+ *  - param64: the endpoint which identifies the peer, and the datatype class.
+ * The recorded file can be replayed by ucx_replay.
+ */
+#define UCP_API_RECORD_PREFIX         "ucp_api:"
+
+
+/* Operation names */
+#define UCP_API_RECORD_OP_TAG_SEND      "tag_send"
+#define UCP_API_RECORD_OP_TAG_SEND_SYNC "tag_send_sync"
+#define UCP_API_RECORD_OP_TAG_RECV      "tag_recv"
+#define UCP_API_RECORD_OP_AM_SEND       "am_send"
+#define UCP_API_RECORD_OP_STREAM_SEND   "stream_send"
+#define UCP_API_RECORD_OP_PUT           "put"
+#define UCP_API_RECORD_OP_GET           "get"
+#define UCP_API_RECORD_OP_EP_FLUSH      "ep_flush"
+
+
+/* Layout of param64 */
+#define UCP_API_RECORD_DT_SHIFT       56
+#define UCP_API_RECORD_PEER_MASK      UCS_MASK(UCP_API_RECORD_DT_SHIFT)
+
+#define UCP_API_RECORD_PARAM64(_ep, _datatype) \
+    ((((uint64_t)(_datatype) & UCP_DATATYPE_CLASS_MASK) << \
+      UCP_API_RECORD_DT_SHIFT) | \
+     ((uintptr_t)(_ep) & UCP_API_RECORD_PEER_MASK))
+
+/* Checked on every call, rather than caching a disabled location id, so
+ * recording starts when the profiling mode is changed at runtime */
+#define UCP_API_RECORD_IS_ENABLED() \
+    (ucs_global_opts.profile_mode & UCS_BIT(UCS_PROFILE_MODE_LOG))
+
+#define UCP_API_RECORD_PEER(_param64) \
+    ((_param64) & UCP_API_RECORD_PEER_MASK)
+
+#define UCP_API_RECORD_DT_CLASS(_param64) \
+    ((_param64) >> UCP_API_RECORD_DT_SHIFT)
+
+
+#ifdef HAVE_PROFILING
+
+/**
+ * Record a UCP communication call.
+ *
+ * @param _op      Operation name, one of UCP_API_RECORD_OP_xx.
+ * @param _ep      Endpoint, or NULL if the operation has no specific peer.
+ * @param _buffer  User buffer passed to the call.
+ * @param _count   Number of elements passed to the call.
+ * @param _param   Request parameters passed to the call.
+ */
+#define UCP_API_RECORD(_op, _ep, _buffer, _count, _param) \
+    { \
+        static ucs_profile_loc_id_t loc_id = UCS_PROFILE_LOC_ID_UNKNOWN; \
+        if (ucs_unlikely(UCP_API_RECORD_IS_ENABLED())) { \
+            ucp_api_record(UCP_API_RECORD_PREFIX _op, _ep, _buffer, _count, \
+                           _param, __FILE__, __LINE__, __func__, &loc_id); \
+        } \
+    }
+
+
+/**
+ * Record a UCP communication call with a known length.
+ *
+ * @param _op       Operation name, one of UCP_API_RECORD_OP_xx.
+ * @param _ep       Endpoint, or NULL if the operation has no specific peer.
+ * @param _length   Message length in bytes.
+ * @param _dt_class Datatype class, one of @ref ucp_dt_type.
+ */
+#define UCP_API_RECORD_LENGTH(_op, _ep, _length, _dt_class) \
+    { \
+        static ucs_profile_loc_id_t loc_id = UCS_PROFILE_LOC_ID_UNKNOWN; \
+        if (ucs_unlikely(UCP_API_RECORD_IS_ENABLED())) { \
+            ucp_api_record_length(UCP_API_RECORD_PREFIX _op, _ep, _length, \
+                                  _dt_class, __FILE__, __LINE__, __func__, \
+                                  &loc_id); \
+        } \
+    }
+
+
+#else
+
+#define UCP_API_RECORD(...)        UCS_EMPTY_STATEMENT
+#define UCP_API_RECORD_LENGTH(...) UCS_EMPTY_STATEMENT
+
+#endif
+
+
+void ucp_api_record(const char *name, ucp_ep_h ep, const void *buffer,
+                    size_t count, const ucp_request_param_t *param,
+                    const char *file, int line, const char *function,
+                    volatile ucs_profile_loc_id_t *loc_id_p);
+
+
+void ucp_api_record_length(const char *name, ucp_ep_h ep, size_t length,
+                           ucp_datatype_t dt_class, const char *file, int line,
+                           const char *function,
+                           volatile ucs_profile_loc_id_t *loc_id_p);
+
+#endif
@@ -62,7 +62,9 @@
     _macro(UCP_AM_ID_AM_MIDDLE) \
     _macro(UCP_AM_ID_AM_SINGLE_REPLY) \
     _macro(UCP_AM_ID_AM_FIRST_PSN) \
-    _macro(UCP_AM_ID_AM_MIDDLE_PSN)
+    _macro(UCP_AM_ID_AM_MIDDLE_PSN) \
+    _macro(UCP_AM_ID_COALESCED) \
+    _macro(UCP_AM_ID_COMPRESSED)
 
 #define UCP_AM_HANDLER_DECL(_id) extern ucp_am_handler_t ucp_am_handler_##_id;
 
@@ -86,6 +88,26 @@ typedef enum ucp_transports_list_search_result {
 } ucp_transports_list_search_result_t;
 
 
+/* Memory domain opened ahead of resource collection */
+typedef struct ucp_md_open_entry {
+    uct_md_resource_desc_t rsc;        /* Memory domain resource */
+    uct_md_config_t        *md_config; /* Memory domain configuration */
+    ucp_tl_md_t            tl_md;      /* Opened memory domain */
+    ucs_status_t           status;     /* UCS_OK if the entry owns tl_md */
+} ucp_md_open_entry_t;
+
+
+/* Memory domains of one component, opened by a dedicated thread */
+typedef struct ucp_cmpt_md_open {
+    ucp_context_h          context;
+    ucp_rsc_index_t        cmpt_index;
+    unsigned               num_mds;
+    ucp_md_open_entry_t    *mds;
+    pthread_t              thread_id;
+    int                    thread_started;
+} ucp_cmpt_md_open_t;
+
+
 /* Declare all am handlers */
 UCP_AM_HANDLER_FOREACH(UCP_AM_HANDLER_DECL)
 
@@ -148,6 +170,14 @@ static size_t ucp_rndv_frag_default_num_elems[] = {
 const char *ucp_object_versions[] = {
     [UCP_OBJECT_VERSION_V1]   = "v1",
     [UCP_OBJECT_VERSION_V2]   = "v2",
+    [UCP_OBJECT_VERSION_V3]   = NULL, /* Defined only for worker address */
+    [UCP_OBJECT_VERSION_LAST] = NULL
+};
+
+static const char *ucp_address_versions[] = {
+    [UCP_OBJECT_VERSION_V1]   = "v1",
+    [UCP_OBJECT_VERSION_V2]   = "v2",
+    [UCP_OBJECT_VERSION_V3]   = "v3",
     [UCP_OBJECT_VERSION_LAST] = NULL
 };
 
@@ -431,6 +461,39 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "Enable new protocol selection logic",
    ucs_offsetof(ucp_context_config_t, proto_enable), UCS_CONFIG_TYPE_BOOL},
 
+  {"COALESCE_THRESH", "0",
+   "Maximal size of a tag or active message, including protocol headers, which\n"
+   "can be coalesced with other small messages to the same endpoint when the\n"
+   "transport is out of send resources. Coalesced messages are copied and\n"
+   "completed immediately, and later sent together in a single frame.\n"
+   "0 disables coalescing. All peers must support coalesced messages.",
+   ucs_offsetof(ucp_context_config_t, coalesce_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"COALESCE_MAX_SIZE", "8k",
+   "Maximal total size of small messages coalesced on an endpoint. A single\n"
+   "frame is also limited by the maximal bcopy size of the transport.",
+   ucs_offsetof(ucp_context_config_t, coalesce_max_size), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"COMPRESS", "n",
+   "Enable compressing protocols for eager and rendezvous fragments sent over\n"
+   "active messages on all endpoints. Otherwise, they are enabled only on\n"
+   "endpoints created with UCP_EP_PARAMS_FLAGS_COMPRESS. A compressing protocol\n"
+   "is selected only if it is estimated to be faster, according to the\n"
+   "transport bandwidth and the compression bandwidth and ratio.",
+   ucs_offsetof(ucp_context_config_t, compress), UCS_CONFIG_TYPE_BOOL},
+
+  {"COMPRESS_RATIO", "4",
+   "Expected ratio between the original and the compressed data size, used to\n"
+   "estimate the performance of compressing protocols. It is not measured, and\n"
+   "the default is a static guess for mostly zero or sparse data; it should be\n"
+   "set according to the actual data of the application.",
+   ucs_offsetof(ucp_context_config_t, compress_ratio), UCS_CONFIG_TYPE_DOUBLE},
+
+  {"COMPRESS_BW", "auto",
+   "Estimation of data compression bandwidth. If set to 'auto', it is measured\n"
+   "when a compressing protocol is first considered.",
+   ucs_offsetof(ucp_context_config_t, compress_bw), UCS_CONFIG_TYPE_BW},
+
   {"PROTO_REQUEST_RESET", "n",
    "Experimental: forces reset of pending request when an endpoint has been\n"
    "connected, useful for testing purposes only",
@@ -507,9 +570,15 @@ static ucs_config_field_t ucp_context_config_table[] = {
 
   {"ADDRESS_VERSION", "v1",
    "Defines UCP worker address format obtained with ucp_worker_get_address() or\n"
-   "ucp_worker_query() routines.",
+   "ucp_worker_query() routines.\n"
+   " v1 - Compatible with all UCX versions.\n"
+   " v2 - Supports larger device and interface addresses.\n"
+   " v3 - Compact format: transport names and device addresses which are\n"
+   "      shared by several devices are packed once, and interface attributes\n"
+   "      are packed as a difference from the previous interface. Can be\n"
+   "      unpacked only by peers which support it.",
    ucs_offsetof(ucp_context_config_t, worker_addr_version),
-   UCS_CONFIG_TYPE_ENUM(ucp_object_versions)},
+   UCS_CONFIG_TYPE_ENUM(ucp_address_versions)},
 
   {"PROTO_INFO", "auto",
    "Enable printing protocols information. The value is interpreted as follows:\n"
@@ -603,6 +672,22 @@ static ucs_config_field_t ucp_context_config_table[] = {
    ucs_offsetof(ucp_context_config_t, wireup_via_am_lane),
    UCS_CONFIG_TYPE_BOOL},
 
+  {"WIREUP_LAZY", "n",
+   "Defer lane selection and transport connection of an endpoint created with\n"
+   "a remote worker address until the first operation is posted on it.\n"
+   "Endpoints with error handling and loopback endpoints are always connected\n"
+   "on creation, and the option has no effect when UCX_PROTO_ENABLE=n.",
+   ucs_offsetof(ucp_context_config_t, wireup_lazy),
+   UCS_CONFIG_TYPE_BOOL},
+
+  {"WIREUP_SELECT_CACHE", "y",
+   "Cache the lanes selected for a new endpoint by the transport capabilities\n"
+   "of the remote worker address and the transports which can reach it. An\n"
+   "endpoint to a peer with the same capabilities as a previous one reuses the\n"
+   "selection result instead of scoring the transports again.",
+   ucs_offsetof(ucp_context_config_t, wireup_select_cache),
+   UCS_CONFIG_TYPE_BOOL},
+
   {"CONNECT_ALL_TO_ALL", "n",
    "Establish connections between all pairs of local and remote devices that\n"
    "are reachable through the transport layer.",
@@ -741,6 +826,12 @@ static ucs_config_field_t ucp_config_table[] = {
    "Maximum number of memory domains per component to use.",
    ucs_offsetof(ucp_config_t, max_component_mds), UCS_CONFIG_TYPE_ULUNITS},
 
+  {"PARALLEL_MD_OPEN", "n",
+   "Open the memory domains of different components concurrently, each\n"
+   "component from its own thread. This can reduce the context initialization\n"
+   "time when several components have devices which are slow to open.",
+   ucs_offsetof(ucp_config_t, parallel_md_open), UCS_CONFIG_TYPE_BOOL},
+
   {NULL}
 };
 UCS_CONFIG_DECLARE_TABLE(ucp_config_table, "UCP context", NULL, ucp_config_t)
@@ -1583,12 +1674,28 @@ static ucs_status_t ucp_check_resource_config(const ucp_config_t *config)
     return UCS_OK;
 }
 
-static ucs_status_t ucp_fill_tl_md(ucp_context_h context,
+static ucs_status_t ucp_tl_md_config_read(ucp_context_h context,
+                                          ucp_rsc_index_t cmpt_index,
+                                          uct_md_config_t **md_config_p)
+{
+    ucs_status_t status;
+
+    status = uct_md_config_read(context->tl_cmpts[cmpt_index].cmpt, NULL, NULL,
+                                md_config_p);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_apply_uct_config_list(context, *md_config_p);
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_tl_md_open(ucp_context_h context,
                                    ucp_rsc_index_t cmpt_index,
                                    const uct_md_resource_desc_t *md_rsc,
+                                   const uct_md_config_t *md_config,
                                    ucp_tl_md_t *tl_md)
 {
-    uct_md_config_t *md_config;
     ucs_status_t status;
 
     /* Initialize tl_md structure */
@@ -1596,18 +1703,8 @@ static ucs_status_t ucp_fill_tl_md(ucp_context_h context,
     tl_md->rsc         = *md_rsc;
     tl_md->sys_dev_map = 0;
 
-    /* Read MD configuration */
-    status = uct_md_config_read(context->tl_cmpts[cmpt_index].cmpt, NULL, NULL,
-                                &md_config);
-    if (status != UCS_OK) {
-        return status;
-    }
-
-    ucp_apply_uct_config_list(context, md_config);
-
     status = uct_md_open(context->tl_cmpts[cmpt_index].cmpt, md_rsc->md_name,
                          md_config, &tl_md->md);
-    uct_config_release(md_config);
     if (status != UCS_OK) {
         return status;
     }
@@ -1626,6 +1723,197 @@ static ucs_status_t ucp_fill_tl_md(ucp_context_h context,
     return UCS_OK;
 }
 
+static ucs_status_t ucp_fill_tl_md(ucp_context_h context,
+                                   ucp_rsc_index_t cmpt_index,
+                                   const uct_md_resource_desc_t *md_rsc,
+                                   ucp_tl_md_t *tl_md)
+{
+    uct_md_config_t *md_config;
+    ucs_status_t status;
+
+    /* Read MD configuration */
+    status = ucp_tl_md_config_read(context, cmpt_index, &md_config);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucp_tl_md_open(context, cmpt_index, md_rsc, md_config, tl_md);
+    uct_config_release(md_config);
+    return status;
+}
+
+static void *ucp_cmpt_md_open_thread(void *arg)
+{
+    ucp_cmpt_md_open_t *cmpt_md_open = arg;
+    ucp_md_open_entry_t *entry;
+
+    for (entry = cmpt_md_open->mds;
+         entry < cmpt_md_open->mds + cmpt_md_open->num_mds; ++entry) {
+        if (entry->status != UCS_OK) {
+            continue;
+        }
+
+        entry->status = ucp_tl_md_open(cmpt_md_open->context,
+                                       cmpt_md_open->cmpt_index, &entry->rsc,
+                                       entry->md_config, &entry->tl_md);
+        uct_config_release(entry->md_config);
+    }
+
+    return NULL;
+}
+
+static void ucp_cmpt_md_open_prepare(ucp_context_h context,
+                                     const ucp_config_t *config,
+                                     ucp_rsc_index_t cmpt_index,
+                                     ucp_cmpt_md_open_t *cmpt_md_open)
+{
+    const ucp_tl_cmpt_t *tl_cmpt = &context->tl_cmpts[cmpt_index];
+    uct_component_attr_t uct_component_attr;
+    ucp_md_open_entry_t *entry;
+    ucs_status_t status;
+    unsigned i, num_mds;
+
+    cmpt_md_open->context        = context;
+    cmpt_md_open->cmpt_index     = cmpt_index;
+    cmpt_md_open->num_mds        = 0;
+    cmpt_md_open->thread_started = 0;
+    if (tl_cmpt->attr.md_resource_count == 0) {
+        return;
+    }
+
+    /* Open in advance no more domains than the component may keep; if some of
+     * them are not used, the following ones are opened serially */
+    num_mds = ucs_min(tl_cmpt->attr.md_resource_count,
+                      config->max_component_mds);
+    if (num_mds == 0) {
+        return;
+    }
+
+    uct_component_attr.field_mask   = UCT_COMPONENT_ATTR_FIELD_MD_RESOURCES;
+    uct_component_attr.md_resources =
+                    ucs_alloca(tl_cmpt->attr.md_resource_count *
+                               sizeof(*uct_component_attr.md_resources));
+    status = uct_component_query(tl_cmpt->cmpt, &uct_component_attr);
+    if (status != UCS_OK) {
+        return;
+    }
+
+    cmpt_md_open->mds = ucs_calloc(num_mds, sizeof(*cmpt_md_open->mds),
+                                   "ucp_cmpt_md_open");
+    if (cmpt_md_open->mds == NULL) {
+        return;
+    }
+
+    /* Configuration is read on the calling thread, since applying the cached
+     * UCT configuration updates the context */
+    for (i = 0; i < num_mds; ++i) {
+        entry         = &cmpt_md_open->mds[i];
+        entry->rsc    = uct_component_attr.md_resources[i];
+        entry->status = ucp_tl_md_config_read(context, cmpt_index,
+                                              &entry->md_config);
+    }
+
+    cmpt_md_open->num_mds = num_mds;
+}
+
+/*
+ * Open the memory domains of all components concurrently, one thread per
+ * component, so that slow device initialization of one component does not
+ * delay the others. Returns NULL if memory domains should be opened serially.
+ */
+static ucp_cmpt_md_open_t *
+ucp_cmpt_md_open_parallel(ucp_context_h context, const ucp_config_t *config)
+{
+    ucp_cmpt_md_open_t *cmpt_md_opens, *cmpt_md_open;
+    ucs_status_t status;
+    ucp_rsc_index_t i;
+
+    cmpt_md_opens = ucs_calloc(context->num_cmpts, sizeof(*cmpt_md_opens),
+                               "ucp_cmpt_md_opens");
+    if (cmpt_md_opens == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < context->num_cmpts; ++i) {
+        cmpt_md_open = &cmpt_md_opens[i];
+        ucp_cmpt_md_open_prepare(context, config, i, cmpt_md_open);
+        if (cmpt_md_open->num_mds == 0) {
+            continue;
+        }
+
+        status = ucs_pthread_create(&cmpt_md_open->thread_id,
+                                    ucp_cmpt_md_open_thread, cmpt_md_open,
+                                    "ucp_md_%s",
+                                    context->tl_cmpts[i].attr.name);
+        if (status == UCS_OK) {
+            cmpt_md_open->thread_started = 1;
+        } else {
+            ucp_cmpt_md_open_thread(cmpt_md_open);
+        }
+    }
+
+    for (i = 0; i < context->num_cmpts; ++i) {
+        if (cmpt_md_opens[i].thread_started) {
+            pthread_join(cmpt_md_opens[i].thread_id, NULL);
+        }
+    }
+
+    return cmpt_md_opens;
+}
+
+static void ucp_cmpt_md_open_cleanup(ucp_context_h context,
+                                     ucp_cmpt_md_open_t *cmpt_md_opens)
+{
+    ucp_md_open_entry_t *entry;
+    ucp_rsc_index_t i;
+
+    if (cmpt_md_opens == NULL) {
+        return;
+    }
+
+    /* Close memory domains which were opened but not taken by the context */
+    for (i = 0; i < context->num_cmpts; ++i) {
+        for (entry = cmpt_md_opens[i].mds;
+             entry < cmpt_md_opens[i].mds + cmpt_md_opens[i].num_mds;
+             ++entry) {
+            if (entry->status == UCS_OK) {
+                uct_md_close(entry->tl_md.md);
+            }
+        }
+
+        ucs_free(cmpt_md_opens[i].mds);
+    }
+
+    ucs_free(cmpt_md_opens);
+}
+
+static ucs_status_t ucp_get_tl_md(ucp_context_h context,
+                                  ucp_rsc_index_t cmpt_index,
+                                  ucp_cmpt_md_open_t *cmpt_md_open,
+                                  unsigned md_rsc_index,
+                                  const uct_md_resource_desc_t *md_rsc,
+                                  ucp_tl_md_t *tl_md)
+{
+    ucp_md_open_entry_t *entry;
+    ucs_status_t status;
+
+    if ((cmpt_md_open == NULL) || (md_rsc_index >= cmpt_md_open->num_mds) ||
+        strcmp(cmpt_md_open->mds[md_rsc_index].rsc.md_name,
+               md_rsc->md_name)) {
+        return ucp_fill_tl_md(context, cmpt_index, md_rsc, tl_md);
+    }
+
+    entry  = &cmpt_md_open->mds[md_rsc_index];
+    status = entry->status;
+    if (status == UCS_OK) {
+        *tl_md        = entry->tl_md;
+        /* Ownership moved to the context */
+        entry->status = UCS_ERR_NO_ELEM;
+    }
+
+    return status;
+}
+
 static void ucp_resource_config_array_str(const ucs_config_names_array_t *array,
                                           const char *title, char *buf, size_t max)
 {
@@ -1765,7 +2053,8 @@ ucp_add_component_resources(ucp_context_h context, ucp_rsc_index_t cmpt_index,
                             uint64_t dev_cfg_masks[], uint64_t *tl_cfg_mask,
                             const ucp_config_t *config,
                             const ucs_string_set_t *aux_tls,
-                            ucp_tl_info_array_t *all_rscs)
+                            ucp_tl_info_array_t *all_rscs,
+                            ucp_cmpt_md_open_t *cmpt_md_open)
 {
     const ucp_tl_cmpt_t *tl_cmpt = &context->tl_cmpts[cmpt_index];
     size_t avail_mds             = config->max_component_mds;
@@ -1804,9 +2093,9 @@ ucp_add_component_resources(ucp_context_h context, ucp_rsc_index_t cmpt_index,
         md_index = context->num_mds;
         md_attr  = &context->tl_mds[md_index].attr;
 
-        status = ucp_fill_tl_md(context, cmpt_index,
-                                &uct_component_attr.md_resources[i],
-                                &context->tl_mds[md_index]);
+        status = ucp_get_tl_md(context, cmpt_index, cmpt_md_open, i,
+                               &uct_component_attr.md_resources[i],
+                               &context->tl_mds[md_index]);
         if (status != UCS_OK) {
             continue;
         }
@@ -2156,6 +2445,7 @@ ucp_fill_resources(ucp_context_h context, const ucp_config_t *config)
     ucs_status_t status;
     unsigned max_mds;
     ucs_string_set_t aux_tls;
+    ucp_cmpt_md_open_t *cmpt_md_opens;
 
     context->tl_cmpts                 = NULL;
     context->num_cmpts                = 0;
@@ -2246,17 +2536,25 @@ ucp_fill_resources(ucp_context_h context, const ucp_config_t *config)
         goto err_free_resources;
     }
 
+    cmpt_md_opens = config->parallel_md_open ?
+                    ucp_cmpt_md_open_parallel(context, config) : NULL;
+
     /* Collect resources of each component */
     for (i = 0; i < context->num_cmpts; ++i) {
-        status = ucp_add_component_resources(context, i, avail_devices,
-                                             &avail_tls, dev_cfg_masks,
-                                             &tl_cfg_mask, config, &aux_tls,
-                                             &all_rscs);
+        status = ucp_add_component_resources(
+                context, i, avail_devices, &avail_tls, dev_cfg_masks,
+                &tl_cfg_mask, config, &aux_tls, &all_rscs,
+                (cmpt_md_opens == NULL) ? NULL : &cmpt_md_opens[i]);
         if (status != UCS_OK) {
-            goto err_free_resources;
+            break;
         }
     }
 
+    ucp_cmpt_md_open_cleanup(context, cmpt_md_opens);
+    if (status != UCS_OK) {
+        goto err_free_resources;
+    }
+
     ucp_fill_resources_reg_md_map_update(context);
 
     /* If unified mode is enabled, initialize tl_bitmap to 0.
@@ -2660,6 +2958,8 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
     context->config.trace_used_proto_selections =
             !strcasecmp(context->config.ext.proto_info, "used");
 
+    context->config.compress_bw = context->config.ext.compress_bw;
+
     return UCS_OK;
 
 err_free_key_list:
@@ -179,6 +179,16 @@ typedef struct ucp_context_config {
     size_t                                 listener_backlog;
     /** Enable new protocol selection logic */
     int                                    proto_enable;
+    /** Maximal size of a small message which can be coalesced */
+    size_t                                 coalesce_thresh;
+    /** Maximal total size of coalesced messages per endpoint */
+    size_t                                 coalesce_max_size;
+    /** Enable compressing protocols on all endpoints */
+    int                                    compress;
+    /** Expected compression ratio */
+    double                                 compress_ratio;
+    /** Estimated compression bandwidth */
+    double                                 compress_bw;
     /** Force request reset after wireup */
     int                                    proto_request_reset;
     /** Time period between keepalive rounds */
@@ -252,6 +262,10 @@ typedef struct ucp_context_config {
     unsigned                               max_priority_eps;
     /* Use AM lane to send wireup messages */
     int                                    wireup_via_am_lane;
+    /** Connect endpoints to a remote worker address on first use */
+    int                                    wireup_lazy;
+    /** Cache lane selection results by remote address capabilities */
+    int                                    wireup_select_cache;
     /** Extend endpoint lanes connections of each local device to all remote
      *  devices */
     int                                    connect_all_to_all;
@@ -303,6 +317,8 @@ struct ucp_config {
     char                                   *env_prefix;
     /** Maximum number of memory domains to use per component **/
     size_t                                 max_component_mds;
+    /** Open memory domains of different components concurrently **/
+    int                                    parallel_md_open;
 };
 
 
@@ -508,6 +524,9 @@ typedef struct ucp_context {
         /* Indicate whether tracing for used protocol selections is enabled */
         int                       trace_used_proto_selections;
 
+        /* Compression bandwidth, as configured or measured on first use */
+        double                    compress_bw;
+
         struct {
            unsigned               count;
            size_t                 *sizes;
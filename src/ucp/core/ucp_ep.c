@@ -260,8 +260,10 @@ static ucp_ep_h ucp_ep_allocate(ucp_worker_h worker, const char *peer_name)
     ep->ext->ka_last_round                = 0;
 #endif
     ep->ext->peer_mem                     = NULL;
+    ep->ext->am.frags                     = NULL;
     ep->ext->unflushed_lanes              = 0;
     ep->ext->fence_seq                    = 0;
+    ep->ext->coalesce_req                 = NULL;
     ep->ext->uct_eps                      = NULL;
     ep->ext->flush_sys_dev_map            = 0;
 
@@ -508,13 +510,21 @@ static int ucp_ep_wireup_eps_progress_filter(const ucs_callbackq_elem_t *elem,
     return (elem->cb == ucp_wireup_eps_progress) && (elem->arg == arg);
 }
 
+static int ucp_ep_wireup_lazy_connect_filter(const ucs_callbackq_elem_t *elem,
+                                             void *arg)
+{
+    return (elem->cb == ucp_wireup_lazy_connect_progress) &&
+           (elem->arg == arg);
+}
+
 static int ucp_ep_remove_filter(const ucs_callbackq_elem_t *elem, void *arg)
 {
     if (ucp_wireup_msg_ack_cb_pred(elem, arg) ||
         ucp_listener_accept_cb_remove_filter(elem, arg) ||
         ucp_ep_local_disconnect_progress_remove_filter(elem, arg) ||
         ucp_ep_set_failed_remove_filter(elem, arg) ||
-        ucp_ep_wireup_eps_progress_filter(elem, arg)) {
+        ucp_ep_wireup_eps_progress_filter(elem, arg) ||
+        ucp_ep_wireup_lazy_connect_filter(elem, arg)) {
         return 1;
     }
 
@@ -556,6 +566,7 @@ void ucp_ep_destroy_base(ucp_ep_h ep)
 
         kh_destroy(ucp_ep_peer_mem_hash, ep->ext->peer_mem);
     }
+    ucs_free(ep->ext->am.frags);
     ucp_ep_deallocate(ep);
 }
 
@@ -626,6 +637,10 @@ void ucp_ep_config_key_init_flags(ucp_ep_config_key_t *key,
                            UCP_EP_INIT_CREATE_AM_LANE | UCP_EP_INIT_CM_PHASE)) {
         key->flags |= UCP_EP_CONFIG_KEY_FLAG_INTERMEDIATE;
     }
+
+    if (ep_init_flags & UCP_EP_INIT_FLAG_COMPRESS) {
+        key->flags |= UCP_EP_CONFIG_KEY_FLAG_COMPRESS;
+    }
 }
 
 ucs_status_t
@@ -692,6 +707,10 @@ ucs_status_t ucp_ep_evaluate_perf(ucp_ep_h ep,
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        return UCS_ERR_NOT_CONNECTED;
+    }
+
     for (lane = 0; lane < ucp_ep_num_lanes(ep); ++lane) {
         if (lane == key->cm_lane) {
             /* Skip CM lanes for bandwidth calculation */
@@ -833,8 +852,8 @@ static ucs_status_t ucp_ep_init_create_wireup(ucp_ep_h ep,
     ucs_status_t status;
     ucp_worker_cfg_index_t cfg_index;
 
-    ucs_assert(ep_init_flags & UCP_EP_INIT_CM_WIREUP_CLIENT);
-    ucs_assert(ucp_worker_num_cm_cmpts(ep->worker) != 0);
+    ucs_assert(!ucp_ep_init_flags_has_cm(ep_init_flags) ||
+               (ucp_worker_num_cm_cmpts(ep->worker) != 0));
 
     ucp_ep_config_key_reset(&key);
     ucp_ep_config_key_set_err_mode(&key, ep_init_flags);
@@ -861,9 +880,6 @@ static ucs_status_t ucp_ep_init_create_wireup(ucp_ep_h ep,
     }
 
     ucp_ep_set_cfg_index(ep, cfg_index, 1);
-    if (!ucp_ep_has_cm_lane(ep)) {
-        ucp_ep_update_flags(ep, UCP_EP_FLAG_CONNECT_REQ_QUEUED, 0);
-    }
 
     status = ucp_wireup_ep_create(ep, &uct_ep);
     if (status != UCS_OK) {
@@ -914,6 +930,63 @@ err:
     return status;
 }
 
+static ucs_status_t
+ucp_ep_create_lazy_to_worker_addr(ucp_worker_h worker,
+                                  const ucp_unpacked_address_t *remote_address,
+                                  unsigned ep_init_flags, const char *message,
+                                  ucp_ep_h *ep_p)
+{
+    ucp_wireup_ep_t *wireup_ep;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    status = ucp_ep_create_base(worker, ep_init_flags, remote_address->name,
+                                message, &ep);
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    /* All operations are queued on a stub endpoint, until the first of them
+     * selects the lanes and connects them */
+    status = ucp_ep_init_create_wireup(ep, ep_init_flags, &wireup_ep);
+    if (status != UCS_OK) {
+        goto err_delete;
+    }
+
+    status = ucp_wireup_ep_set_lazy(wireup_ep, remote_address, ep_init_flags);
+    if (status != UCS_OK) {
+        goto err_cleanup_lanes;
+    }
+
+    ucp_ep_update_flags(ep, UCP_EP_FLAG_LAZY_CONNECT, 0);
+    *ep_p = ep;
+    return UCS_OK;
+
+err_cleanup_lanes:
+    ucp_ep_cleanup_lanes(ep);
+err_delete:
+    ucp_ep_delete(ep);
+err:
+    return status;
+}
+
+static int
+ucp_ep_create_is_lazy(ucp_worker_h worker,
+                      const ucp_unpacked_address_t *remote_address,
+                      unsigned ep_init_flags)
+{
+    ucp_context_h context = worker->context;
+
+    /* Endpoints with error handling need keepalive and remote id resolution,
+     * and loopback endpoints are connected to themselves on creation. Only
+     * protocols v2 select the protocol again once the lanes are known. */
+    return context->config.ext.wireup_lazy &&
+           context->config.ext.proto_enable &&
+           (remote_address->uuid != worker->uuid) &&
+           !(ep_init_flags & UCP_EP_INIT_ERR_MODE_FAILOVER_MASK) &&
+           (context->config.ext.resolve_remote_ep_id != UCS_CONFIG_ON);
+}
+
 static ucs_status_t ucp_ep_create_to_sock_addr(ucp_worker_h worker,
                                                const ucp_ep_params_t *params,
                                                ucp_ep_h *ep_p)
@@ -1156,9 +1229,16 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
         goto out_resolve_remote_id;
     }
 
-    status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
-                                          &remote_address, ep_init_flags,
-                                          "from api call", addr_indices, &ep);
+    if (ucp_ep_create_is_lazy(worker, &remote_address, ep_init_flags)) {
+        status = ucp_ep_create_lazy_to_worker_addr(worker, &remote_address,
+                                                   ep_init_flags,
+                                                   "from api call", &ep);
+    } else {
+        status = ucp_ep_create_to_worker_addr(worker, &ucp_tl_bitmap_max,
+                                              &remote_address, ep_init_flags,
+                                              "from api call", addr_indices,
+                                              &ep);
+    }
     if (status != UCS_OK) {
         goto out_free_address;
     }
@@ -1191,7 +1271,8 @@ ucp_ep_create_api_to_worker_addr(ucp_worker_h worker,
     }
 
     /* if needed, send initial wireup message */
-    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+    if (!(ep->flags &
+          (UCP_EP_FLAG_LOCAL_CONNECTED | UCP_EP_FLAG_LAZY_CONNECT))) {
         ucs_assert(!(ep->flags & UCP_EP_FLAG_CONNECT_REQ_QUEUED));
         status = ucp_wireup_send_request(ep);
         if (status != UCS_OK) {
@@ -3875,6 +3956,28 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
     }
 }
 
+static size_t ucp_ep_memory_usage(ucp_ep_h ep)
+{
+    ucp_lane_index_t num_lanes = ucp_ep_num_lanes(ep);
+    size_t size                = sizeof(ucp_ep_t) + sizeof(ucp_ep_ext_t);
+
+    if (num_lanes > UCP_MAX_FAST_PATH_LANES) {
+        size += (num_lanes - UCP_MAX_FAST_PATH_LANES) *
+                sizeof(*ep->ext->uct_eps);
+    }
+
+    if (ep->ext->am.frags != NULL) {
+        size += sizeof(*ep->ext->am.frags);
+    }
+
+    if (ep->ext->peer_mem != NULL) {
+        size += kh_n_buckets(ep->ext->peer_mem) *
+                (sizeof(uint64_t) + sizeof(ucp_ep_peer_mem_data_t));
+    }
+
+    return size;
+}
+
 static void ucp_ep_print_info_internal(ucp_ep_h ep, const char *name,
                                        FILE *stream)
 {
@@ -3891,6 +3994,8 @@ static void ucp_ep_print_info_internal(ucp_ep_h ep, const char *name,
     fprintf(stream, "# UCP endpoint %s\n", name);
     fprintf(stream, "#\n");
     fprintf(stream, "#               peer: %s\n", ucp_ep_peer_name(ep));
+    fprintf(stream, "#             memory: %zu bytes, without transport "
+            "endpoints\n", ucp_ep_memory_usage(ep));
 
     /* if there is a wireup lane, set aux_rsc_index to the stub ep resource */
     aux_rsc_index   = UCP_NULL_RESOURCE;
@@ -4269,6 +4374,12 @@ static ucs_status_t ucp_ep_query_transport(ucp_ep_h ep, ucp_ep_attr_t *attr)
     device_limit    = ucs_offsetof(ucp_transport_entry_t, device_name) +
                       sizeof(transport_entry->device_name);
 
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        /* Transports are not selected yet */
+        attr->transports.num_entries = 0;
+        return UCS_OK;
+    }
+
     for (lane_index = 0; lane_index < ucs_min(attr->transports.num_entries,
                                               config->key.num_lanes);
          lane_index++) {
@@ -104,7 +104,8 @@ enum {
                                                         while merging pending queues */
     UCP_EP_FLAG_CONNECT_PRE_REQ_QUEUED = UCS_BIT(9), /* Pre-Connection request was queued */
     UCP_EP_FLAG_CLOSED                 = UCS_BIT(10),/* EP was closed */
-    /* 11 bit is vacant for a flag */
+    UCP_EP_FLAG_LAZY_CONNECT           = UCS_BIT(11),/* EP lanes are not selected yet,
+                                                        see UCX_WIREUP_LAZY */
     UCP_EP_FLAG_ERR_HANDLER_INVOKED    = UCS_BIT(12),/* error handler was called */
     UCP_EP_FLAG_INTERNAL               = UCS_BIT(13),/* the internal EP which holds
                                                         temporary wireup configuration or
@@ -169,6 +170,8 @@ enum {
                                                            transports for AM lane */
     UCP_EP_INIT_ERR_MODE_FAILOVER      = UCS_BIT(11), /**< Endpoint requires an
                                                            @ref UCP_ERR_HANDLING_MODE_FAILOVER */
+    UCP_EP_INIT_FLAG_COMPRESS          = UCS_BIT(12), /**< Endpoint allows
+                                                           compressing protocols */
 
     /**
      * For consistency with @ref UCP_SA_DATA_MASK_ERR_MODE_FAILOVER
@@ -196,7 +199,12 @@ enum {
      * Endpoint is in an intermediate connection establishment phase,
      * some capabilities may be limited or disabled.
      */
-    UCP_EP_CONFIG_KEY_FLAG_INTERMEDIATE = UCS_BIT(2)
+    UCP_EP_CONFIG_KEY_FLAG_INTERMEDIATE = UCS_BIT(2),
+
+    /**
+     * Endpoint allows compressing protocols.
+     */
+    UCP_EP_CONFIG_KEY_FLAG_COMPRESS     = UCS_BIT(3)
 };
 
 
@@ -499,6 +507,17 @@ typedef struct ucp_ep_recovery_arg {
 } ucp_ep_recovery_arg_t;
 
 
+/**
+ * Reassembly state of fragmented active messages received on an endpoint.
+ */
+typedef struct {
+    ucs_list_link_t               started_ams;   /* Messages whose first fragment
+                                                    arrived */
+    ucs_queue_head_t              mid_rdesc_q;   /* Queue of middle fragments, which
+                                                    arrived before the first one */
+} ucp_ep_am_frags_t;
+
+
 /**
  * Endpoint extension
  */
@@ -541,9 +560,9 @@ typedef struct ucp_ep_ext {
     } stream;
 
     struct {
-        ucs_list_link_t           started_ams;
-        ucs_queue_head_t          mid_rdesc_q;    /* Queue of middle fragments, which
-                                                     arrived before the first one */
+        ucp_ep_am_frags_t         *frags;         /* Reassembly state of fragmented
+                                                     messages, allocated when the
+                                                     first one arrives */
         uint64_t                  psn;
     } am;
 
@@ -551,6 +570,9 @@ typedef struct ucp_ep_ext {
                                                       unflushed operations */
     uint64_t                      fence_seq;       /* Sequence number for fence
                                                       detection */
+    ucp_request_t                 *coalesce_req;   /* Pending request which
+                                                      small messages can be
+                                                      coalesced into */
 
     /**
      * UCT endpoints for every slow-path lane that has no room in the base endpoint
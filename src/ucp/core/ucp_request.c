@@ -14,6 +14,7 @@
 #include "ucp_mm.inl"
 
 #include <ucp/proto/proto_am.h>
+#include <ucp/proto/proto_coalesce.h>
 #include <ucp/proto/proto_debug.h>
 #include <ucp/tag/tag_rndv.h>
 #include <uct/api/v2/uct_v2.h>
@@ -338,6 +339,7 @@ int ucp_request_pending_add(ucp_request_t *req)
         ucs_trace_data("ep %p: added pending uct request %p to lane[%d]=%p",
                        req->send.ep, req, req->send.lane, uct_ep);
         req->send.pending_lane = req->send.lane;
+        ucp_proto_coalesce_close(req->send.ep, req);
         return 1;
     } else if (status == UCS_ERR_BUSY) {
         /* Could not add, try to send again */
@@ -684,6 +686,8 @@ void ucp_request_send_state_ff(ucp_request_t *req, ucs_status_t status)
     } else if (req->send.uct.func == ucp_wireup_msg_progress) {
         ucs_free(req->send.buffer);
         ucp_request_mem_free(req);
+    } else if (req->send.uct.func == ucp_proto_coalesce_progress) {
+        ucp_proto_coalesce_release(req);
     } else if (req->send.state.uct_comp.func == ucp_ep_flush_completion) {
         ucp_ep_flush_request_ff(req, status);
     } else if (req->send.uct.func == ucp_worker_discard_uct_ep_pending_cb) {
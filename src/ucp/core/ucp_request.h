@@ -206,6 +206,11 @@ struct ucp_request {
                     ucp_wireup_msg_lanes_info_t lanes_info;
                 } UCS_S_PACKED wireup;
 
+                struct {
+                    size_t   offset;     /* Length of already sent data */
+                    size_t   max_length; /* Size of the coalescing buffer */
+                } coalesce;
+
                 struct {
                     /* Used to identify matching parts of a large message */
                     uint64_t message_id;
@@ -11,6 +11,7 @@
 #include "ucp_worker.h"
 #include "ucp_ep.inl"
 #include "ucp_mm.inl"
+#include "ucp_api_record.h"
 
 #include <ucp/dt/dt.h>
 #include <ucs/profile/profile.h>
@@ -301,6 +302,11 @@ ucp_request_complete_tag_recv(ucp_request_t *req, ucs_status_t status)
                   req->recv.tag.info.sender_tag, req->recv.tag.info.length,
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_tag_recv", status);
+    if (status == UCS_OK) {
+        UCP_API_RECORD_LENGTH(UCP_API_RECORD_OP_TAG_RECV, NULL,
+                              req->recv.tag.info.length,
+                              req->recv.dt_iter.dt_class);
+    }
     /* coverity[address_free] */
     /* coverity[offset_free] */
     ucp_request_complete(req, recv.tag.cb, status, &req->recv.tag.info,
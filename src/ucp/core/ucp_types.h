@@ -204,6 +204,9 @@ typedef enum {
                                           carrying remote ep and PSN for
                                           tracking */
     UCP_AM_ID_AM_MIDDLE_PSN     =  28,
+    UCP_AM_ID_COALESCED         =  29, /* Several small messages packed into
+                                          a single frame */
+    UCP_AM_ID_COMPRESSED        =  30, /* Message with compressed payload */
     UCP_AM_ID_LAST
 } ucp_am_id_t;
 
@@ -253,6 +256,7 @@ typedef enum {
 typedef enum {
     UCP_OBJECT_VERSION_V1,
     UCP_OBJECT_VERSION_V2,
+    UCP_OBJECT_VERSION_V3,
     UCP_OBJECT_VERSION_LAST
 } ucp_object_version_t;
 
@@ -49,6 +49,10 @@
 #define UCP_WORKER_USAGE_TRACKER_EXP_DECAY_MULTIPLIER 0.8
 #define UCP_WORKER_USAGE_TRACKER_EXP_DECAY_ADDER      0.2
 
+/* Weight of the last wait time in the moving average used to set the busy-poll
+ * time of ucp_worker_wait(), as a power of 2 */
+#define UCP_WORKER_WAIT_SPIN_AVG_SHIFT                3
+
 
 #define UCP_WIFACE_FMT "iface %p (" UCT_TL_RESOURCE_DESC_FMT ")"
 #define UCP_WIFACE_ARG(_wiface) \
@@ -99,7 +103,9 @@ static ucs_stats_class_t ucp_worker_stats_class = {
         [UCP_WORKER_STAT_RNDV_GET_ZCOPY]           = "rndv_get_zcopy",
         [UCP_WORKER_STAT_RNDV_RTR]                 = "rndv_rtr",
         [UCP_WORKER_STAT_RNDV_RTR_MTYPE]           = "rndv_rtr_mtype",
-        [UCP_WORKER_STAT_RNDV_RKEY_PTR]            = "rndv_rkey_ptr"
+        [UCP_WORKER_STAT_RNDV_RKEY_PTR]            = "rndv_rkey_ptr",
+        [UCP_WORKER_STAT_COALESCE_TX_MSG]          = "coalesce_tx_msg",
+        [UCP_WORKER_STAT_COALESCE_TX_FRAME]        = "coalesce_tx_frame"
     }
 };
 #endif
@@ -2450,6 +2456,15 @@ ucp_worker_vfs_show_primitive(void *obj, ucs_string_buffer_t *strb,
     UCS_ASYNC_UNBLOCK(&worker->async);
 }
 
+static void
+ucp_worker_vfs_show_progress_profile(void *obj, ucs_string_buffer_t *strb,
+                                     void *arg_ptr, uint64_t arg_u64)
+{
+    ucp_worker_h worker = obj;
+
+    ucs_callbackq_prof_dump(&worker->uct->progress_q, strb);
+}
+
 void ucp_worker_create_vfs(ucp_context_h context, ucp_worker_h worker)
 {
     ucs_thread_mode_t thread_mode;
@@ -2488,6 +2503,11 @@ void ucp_worker_create_vfs(ucp_context_h context, ucp_worker_h worker)
     ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
                             &worker->counters.ep_failures, UCS_VFS_TYPE_ULONG,
                             "counters/ep_failures");
+
+    if (ucs_callbackq_prof_is_enabled(&worker->uct->progress_q)) {
+        ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_progress_profile,
+                                NULL, 0, "progress_profile");
+    }
 }
 
 static void ucp_worker_set_max_am_header(ucp_worker_h worker)
@@ -2632,10 +2652,15 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     kh_init_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
     kh_init_inplace(ucp_worker_discard_uct_ep_hash, &worker->discard_uct_ep_hash);
     kh_init_inplace(ucp_worker_remote_flush, &worker->remote_flush_hash);
+    kh_init_inplace(ucp_worker_select_cache, &worker->select_cache);
     worker->counters.ep_creations         = 0;
     worker->counters.ep_creation_failures = 0;
     worker->counters.ep_closures          = 0;
     worker->counters.ep_failures          = 0;
+    worker->compress.tx_buffer            = NULL;
+    worker->compress.tx_size              = 0;
+    worker->compress.rx_buffer            = NULL;
+    worker->compress.rx_size              = 0;
 
     /* Copy user flags, and mask-out unsupported flags for compatibility */
     worker->flags = UCP_PARAM_VALUE(WORKER, params, flags, FLAGS, 0) &
@@ -2678,6 +2703,9 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->am.alignment = UCP_PARAM_VALUE(WORKER, params, am_alignment,
                                            AM_ALIGNMENT, 1);
     worker->client_id    = UCP_PARAM_VALUE(WORKER, params, client_id, CLIENT_ID, 0);
+    worker->wait_spin.max     = ucs_time_from_sec(
+            UCP_PARAM_VALUE(WORKER, params, wait_spin, WAIT_SPIN, 0));
+    worker->wait_spin.avg_gap = 0;
     if ((params->field_mask & UCP_WORKER_PARAM_FIELD_NAME) &&
         (params->name != NULL)) {
         ucs_snprintf_zero(worker->name, UCP_ENTITY_NAME_MAX, "%s",
@@ -2851,6 +2879,7 @@ err_free:
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
     kh_destroy_inplace(ucp_worker_remote_flush, &worker->remote_flush_hash);
+    ucp_wireup_select_cache_cleanup(worker);
     ucp_worker_destroy_configs(worker);
     ucs_free(worker);
     return status;
@@ -3105,7 +3134,10 @@ void ucp_worker_destroy(ucp_worker_h worker)
                        &worker->discard_uct_ep_hash);
     kh_destroy_inplace(ucp_worker_remote_flush, &worker->remote_flush_hash);
     kh_destroy_inplace(ucp_worker_rkey_config, &worker->rkey_config_hash);
+    ucp_wireup_select_cache_cleanup(worker);
     ucp_worker_destroy_configs(worker);
+    ucs_free(worker->compress.tx_buffer);
+    ucs_free(worker->compress.rx_buffer);
     ucs_free(worker);
 }
 
@@ -3345,8 +3377,43 @@ void ucp_worker_wait_mem(ucp_worker_h worker, void *address)
     ucs_arch_wait_mem(address);
 }
 
+/* Account the time ucp_worker_wait() waited for an event */
+static void ucp_worker_wait_spin_update(ucp_worker_h worker,
+                                        ucs_time_t start_time)
+{
+    /* Limit the effect of a single long wait, so busy-polling resumes quickly
+     * when events become frequent again */
+    ucs_time_t gap = ucs_min(ucs_get_time() - start_time,
+                             2 * worker->wait_spin.max);
+
+    worker->wait_spin.avg_gap += (gap >> UCP_WORKER_WAIT_SPIN_AVG_SHIFT) -
+                                 (worker->wait_spin.avg_gap >>
+                                  UCP_WORKER_WAIT_SPIN_AVG_SHIFT);
+}
+
+/* Busy-poll the worker if the next event is expected to arrive earlier than
+ * the maximal busy-poll time. Returns nonzero if an event was progressed. */
+static int ucp_worker_wait_spin(ucp_worker_h worker, ucs_time_t start_time)
+{
+    ucs_time_t budget;
+
+    if (worker->wait_spin.avg_gap > worker->wait_spin.max) {
+        return 0;
+    }
+
+    budget = ucs_min(2 * worker->wait_spin.avg_gap, worker->wait_spin.max);
+    do {
+        if (ucp_worker_progress(worker) != 0) {
+            return 1;
+        }
+    } while ((ucs_get_time() - start_time) < budget);
+
+    return 0;
+}
+
 ucs_status_t ucp_worker_wait(ucp_worker_h worker)
 {
+    ucs_time_t start_time = 0;
     ucp_worker_iface_t *wiface;
     struct pollfd *pfd;
     ucs_status_t status;
@@ -3358,10 +3425,21 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_WAKEUP,
                                     return UCS_ERR_INVALID_PARAM);
 
+    if (worker->wait_spin.max > 0) {
+        start_time = ucs_get_time();
+        if (ucp_worker_wait_spin(worker, start_time)) {
+            ucp_worker_wait_spin_update(worker, start_time);
+            return UCS_OK;
+        }
+    }
+
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     status = ucp_worker_arm(worker);
     if (status == UCS_ERR_BUSY) { /* if UCS_ERR_BUSY returned - no poll() must called */
+        if (worker->wait_spin.max > 0) {
+            ucp_worker_wait_spin_update(worker, start_time);
+        }
         status = UCS_OK;
         goto out_unlock;
     } else if (status != UCS_OK) {
@@ -3399,6 +3477,9 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
         ret = poll(pfd, nfds, -1);
         if (ret >= 0) {
             ucs_assertv(ret == 1, "ret=%d", ret);
+            if (worker->wait_spin.max > 0) {
+                ucp_worker_wait_spin_update(worker, start_time);
+            }
             status = UCS_OK;
             goto out;
         } else {
@@ -3502,6 +3583,14 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
 
     ucp_worker_mem_type_eps_print_info(worker, stream);
 
+    if (ucs_callbackq_prof_is_enabled(&worker->uct->progress_q)) {
+        ucs_string_buffer_init(&strb);
+        ucs_callbackq_prof_dump(&worker->uct->progress_q, &strb);
+        fprintf(stream, "#\n# progress callbacks:\n");
+        ucs_string_buffer_dump(&strb, "#   ", stream);
+        ucs_string_buffer_cleanup(&strb);
+    }
+
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
 }
 
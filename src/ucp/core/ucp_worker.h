@@ -155,6 +155,11 @@ enum {
     UCP_WORKER_STAT_RNDV_RTR_MTYPE,
     UCP_WORKER_STAT_RNDV_RKEY_PTR,
 
+    /* Number of messages packed to coalescing requests, and number of frames
+     * which carried them */
+    UCP_WORKER_STAT_COALESCE_TX_MSG,
+    UCP_WORKER_STAT_COALESCE_TX_FRAME,
+
     UCP_WORKER_STAT_LAST
 };
 
@@ -213,6 +218,12 @@ KHASH_TYPE(ucp_worker_rkey_config, ucp_rkey_config_key_t, ucp_worker_cfg_index_t
 typedef khash_t(ucp_worker_rkey_config) ucp_worker_rkey_config_hash_t;
 
 
+/* Hash map of cached lane selection results, by remote address fingerprint */
+typedef struct ucp_wireup_select_cache_entry ucp_wireup_select_cache_entry_t;
+KHASH_DECLARE(ucp_worker_select_cache, uint32_t,
+              ucp_wireup_select_cache_entry_t*);
+
+
 /* Hash map of UCT EPs that are being discarded on UCP Worker */
 KHASH_TYPE(ucp_worker_discard_uct_ep_hash, uct_ep_h, ucp_request_t*);
 typedef khash_t(ucp_worker_discard_uct_ep_hash) ucp_worker_discard_uct_ep_hash_t;
@@ -326,6 +337,13 @@ typedef struct ucp_worker {
     unsigned                         uct_events;          /* UCT arm events */
     ucs_list_link_t                  arm_ifaces;          /* List of interfaces to arm */
 
+    struct {
+        ucs_time_t                   max;                 /* Maximal busy-poll time in
+                                                             ucp_worker_wait() */
+        ucs_time_t                   avg_gap;             /* Moving average of the time
+                                                             ucp_worker_wait() waits */
+    } wait_spin;
+
     void                             *user_data;          /* User-defined data */
     ucs_strided_alloc_t              ep_alloc;            /* Endpoint allocator */
     ucs_list_link_t                  stream_ready_eps;    /* List of EPs with received stream data */
@@ -368,6 +386,8 @@ typedef struct ucp_worker {
     UCS_PTR_MAP_T(request)           request_map;         /* UCP requests key to
                                                              ptr mapping */
     kh_ucp_worker_remote_flush_t     remote_flush_hash;
+    khash_t(ucp_worker_select_cache) select_cache;        /* Lane selection
+                                                             results */
 
     ucp_ep_config_arr_t              ep_config; /* EP configurations storage */
 
@@ -408,6 +428,15 @@ typedef struct ucp_worker {
         ucs_time_t                   last_round;
     } usage_tracker;
 
+    struct {
+        /* Staging buffer for the data of a compressed message being sent */
+        void                         *tx_buffer;
+        size_t                       tx_size;
+        /* Staging buffer for the data of a compressed message being received */
+        void                         *rx_buffer;
+        size_t                       rx_size;
+    } compress;
+
     /* Configuration epoch (generation counter).
      * Incremented after major connectivity changes (e.g. lane failure, port
      * speed change). A matching epoch is stored in @ref ucp_proto_select_t.
@@ -34,6 +34,7 @@
     _macro(ucp_put_sgl_offload_proto) \
     _macro(ucp_put_sgl_offload_sw_proto) \
     _macro(ucp_eager_bcopy_multi_proto) \
+    _macro(ucp_eager_bcopy_multi_compress_proto) \
     _macro(ucp_eager_sync_bcopy_multi_proto) \
     _macro(ucp_eager_zcopy_multi_proto) \
     _macro(ucp_eager_short_proto) \
@@ -45,6 +46,7 @@
     _macro(ucp_tag_offload_eager_zcopy_single_proto) \
     _macro(ucp_eager_sync_zcopy_single_proto) \
     _macro(ucp_rndv_am_bcopy_proto) \
+    _macro(ucp_rndv_am_compress_proto) \
     _macro(ucp_rndv_am_zcopy_proto) \
     _macro(ucp_rndv_get_zcopy_proto) \
     _macro(ucp_rndv_get_mtype_proto) \
@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_coalesce.h"
+
+#include <ucp/core/ucp_worker.h>
+#include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_request.inl>
+#include <ucs/debug/log.h>
+#include <ucs/sys/string.h>
+
+
+typedef struct {
+    ucp_request_t *req;
+    size_t        length;
+} ucp_proto_coalesce_pack_ctx_t;
+
+
+typedef struct {
+    const uct_iov_t *iov;
+    size_t          iovcnt;
+} ucp_proto_coalesce_iov_ctx_t;
+
+
+static size_t ucp_proto_coalesce_frame_length(ucp_request_t *req,
+                                              size_t max_length)
+{
+    size_t offset = req->send.coalesce.offset;
+    const ucp_proto_coalesce_hdr_t *hdr;
+    size_t msg_length;
+
+    while (offset < req->send.length) {
+        hdr        = UCS_PTR_BYTE_OFFSET(req->send.buffer, offset);
+        msg_length = UCP_PROTO_COALESCE_ENTRY_SIZE(hdr->length);
+        if ((offset + msg_length - req->send.coalesce.offset) > max_length) {
+            break;
+        }
+
+        offset += msg_length;
+    }
+
+    return offset - req->send.coalesce.offset;
+}
+
+static size_t ucp_proto_coalesce_pack(void *dest, void *arg)
+{
+    ucp_proto_coalesce_pack_ctx_t *pack_ctx = arg;
+    ucp_request_t *req                      = pack_ctx->req;
+
+    memcpy(dest,
+           UCS_PTR_BYTE_OFFSET(req->send.buffer, req->send.coalesce.offset),
+           pack_ctx->length);
+    return pack_ctx->length;
+}
+
+void ucp_proto_coalesce_release(ucp_request_t *req)
+{
+    ucp_ep_h ep = req->send.ep;
+
+    ucp_trace_req(req, "ep %p: release coalescing request, sent %zu/%zu", ep,
+                  req->send.coalesce.offset, req->send.length);
+
+    if (ep->ext->coalesce_req == req) {
+        ep->ext->coalesce_req = NULL;
+    }
+
+    ucs_free(req->send.buffer);
+    ucp_request_put(req);
+}
+
+ucs_status_t ucp_proto_coalesce_progress(uct_pending_req_t *self)
+{
+    ucp_request_t *req = ucs_container_of(self, ucp_request_t, send.uct);
+    ucp_ep_h ep        = req->send.ep;
+    ucp_proto_coalesce_pack_ctx_t pack_ctx;
+    ucp_lane_index_t lane;
+    ssize_t packed_size;
+
+    /* The lane may have changed if the endpoint was reconfigured, so send all
+     * the messages which fit into the maximal frame of the current lane */
+    lane            = ucp_ep_get_am_lane(ep);
+    pack_ctx.req    = req;
+    pack_ctx.length = ucp_proto_coalesce_frame_length(
+            req, ucp_ep_get_max_bcopy(ep, lane));
+    if (ucs_unlikely(pack_ctx.length == 0)) {
+        /* The new lane can't send the next message even in a separate frame */
+        ucs_error("ep %p: coalesced message does not fit max_bcopy %zu of "
+                  "lane %d", ep, ucp_ep_get_max_bcopy(ep, lane), lane);
+        ucp_proto_coalesce_release(req);
+        return UCS_OK;
+    }
+
+    packed_size = uct_ep_am_bcopy(ucp_ep_get_fast_lane(ep, lane),
+                                  UCP_AM_ID_COALESCED, ucp_proto_coalesce_pack,
+                                  &pack_ctx, 0);
+    if (packed_size == UCS_ERR_NO_RESOURCE) {
+        req->send.lane = lane; /* for pending add */
+        return UCS_ERR_NO_RESOURCE;
+    } else if (ucs_unlikely(packed_size < 0)) {
+        /* The messages were already completed, so nothing to report */
+        ucp_trace_req(req, "failed to send coalesced messages: %s",
+                      ucs_status_string((ucs_status_t)packed_size));
+        ucp_proto_coalesce_release(req);
+        return UCS_OK;
+    }
+
+    ucs_assert(packed_size == pack_ctx.length);
+    UCS_STATS_UPDATE_COUNTER(ep->worker->stats,
+                             UCP_WORKER_STAT_COALESCE_TX_FRAME, 1);
+    req->send.coalesce.offset += packed_size;
+    if (req->send.coalesce.offset < req->send.length) {
+        return UCS_INPROGRESS;
+    }
+
+    ucp_proto_coalesce_release(req);
+    return UCS_OK;
+}
+
+static ucp_request_t *
+ucp_proto_coalesce_req_create(ucp_ep_h ep, ucp_lane_index_t lane)
+{
+    size_t max_length = ep->worker->context->config.ext.coalesce_max_size;
+    ucp_request_t *req;
+
+    req = ucp_request_get(ep->worker);
+    if (req == NULL) {
+        return NULL;
+    }
+
+    req->send.buffer = ucs_malloc(max_length, "coalesce_buffer");
+    if (req->send.buffer == NULL) {
+        ucp_request_put(req);
+        return NULL;
+    }
+
+    req->flags                     = 0;
+    req->send.ep                   = ep;
+    req->send.uct.func             = ucp_proto_coalesce_progress;
+    req->send.lane                 = lane;
+    req->send.length               = 0;
+    req->send.coalesce.offset      = 0;
+    req->send.coalesce.max_length  = max_length;
+
+    if (!ucp_request_pending_add(req)) {
+        /* The lane has resources again, so the message may be sent directly */
+        ucs_free(req->send.buffer);
+        ucp_request_put(req);
+        return NULL;
+    }
+
+    ucp_trace_req(req, "ep %p: created coalescing request on lane %d", ep,
+                  lane);
+    return req;
+}
+
+ucs_status_t ucp_proto_coalesce_add(ucp_request_t *req, ucp_lane_index_t lane,
+                                    uint8_t am_id, uct_pack_callback_t pack_cb,
+                                    void *pack_arg, size_t max_length)
+{
+    ucp_ep_h ep             = req->send.ep;
+    ucp_context_h context   = ep->worker->context;
+    ucp_request_t *coal_req = ep->ext->coalesce_req;
+    size_t entry_size       = UCP_PROTO_COALESCE_ENTRY_SIZE(max_length);
+    ucp_proto_coalesce_hdr_t *hdr;
+    size_t length;
+
+    /* A request which was already queued must not be sent after the requests
+     * that were queued after it. The message is packed now, so a reply
+     * message, whose footer holds the remote endpoint id, is coalesced only
+     * when the id is known. Every message must fit a single frame of the lane
+     * by itself. */
+    if ((max_length > context->config.ext.coalesce_thresh) ||
+        (max_length > UINT16_MAX) ||
+        (entry_size > context->config.ext.coalesce_max_size) ||
+        (req->send.pending_lane != UCP_NULL_LANE) ||
+        ((am_id == UCP_AM_ID_AM_SINGLE_REPLY) &&
+         !(ep->flags & UCP_EP_FLAG_REMOTE_ID)) ||
+        (lane != ucp_ep_get_am_lane(ep)) ||
+        (entry_size > ucp_ep_get_max_bcopy(ep, lane))) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if ((coal_req != NULL) &&
+        ((coal_req->send.length + entry_size) >
+         coal_req->send.coalesce.max_length)) {
+        /* The coalescing buffer is full, so start a new one after it */
+        ep->ext->coalesce_req = NULL;
+        coal_req              = NULL;
+    }
+
+    if (coal_req == NULL) {
+        coal_req = ucp_proto_coalesce_req_create(ep, lane);
+        if (coal_req == NULL) {
+            return UCS_ERR_NO_RESOURCE;
+        }
+
+        ep->ext->coalesce_req = coal_req;
+    }
+
+    hdr    = UCS_PTR_BYTE_OFFSET(coal_req->send.buffer, coal_req->send.length);
+    length = pack_cb(hdr + 1, pack_arg);
+    ucs_assertv(length <= max_length, "length=%zu max_length=%zu", length,
+                max_length);
+
+    hdr->length            = length;
+    hdr->am_id             = am_id;
+    coal_req->send.length += UCP_PROTO_COALESCE_ENTRY_SIZE(length);
+    UCS_STATS_UPDATE_COUNTER(ep->worker->stats,
+                             UCP_WORKER_STAT_COALESCE_TX_MSG, 1);
+    ucp_trace_req(req, "coalesced am_id %d length %zu into request %p",
+                  am_id, length, coal_req);
+    return UCS_OK;
+}
+
+static size_t ucp_proto_coalesce_iov_pack(void *dest, void *arg)
+{
+    ucp_proto_coalesce_iov_ctx_t *iov_ctx = arg;
+    size_t length                         = 0;
+    size_t iov_index;
+
+    for (iov_index = 0; iov_index < iov_ctx->iovcnt; ++iov_index) {
+        memcpy(UCS_PTR_BYTE_OFFSET(dest, length), iov_ctx->iov[iov_index].buffer,
+               iov_ctx->iov[iov_index].length);
+        length += iov_ctx->iov[iov_index].length;
+    }
+
+    return length;
+}
+
+ucs_status_t
+ucp_proto_coalesce_add_iov(ucp_request_t *req, ucp_lane_index_t lane,
+                           uint8_t am_id, const uct_iov_t *iov, size_t iovcnt)
+{
+    ucp_proto_coalesce_iov_ctx_t iov_ctx = {iov, iovcnt};
+    size_t length                        = 0;
+    size_t iov_index;
+
+    for (iov_index = 0; iov_index < iovcnt; ++iov_index) {
+        ucs_assert(iov[iov_index].count == 1);
+        length += iov[iov_index].length;
+    }
+
+    return ucp_proto_coalesce_add(req, lane, am_id, ucp_proto_coalesce_iov_pack,
+                                  &iov_ctx, length);
+}
+
+static ucs_status_t
+ucp_proto_coalesce_handler(void *arg, void *data, size_t length,
+                           unsigned flags)
+{
+    ucp_worker_h worker = arg;
+    void *end           = UCS_PTR_BYTE_OFFSET(data, length);
+    const ucp_proto_coalesce_hdr_t *hdr;
+    UCS_V_UNUSED ucs_status_t status;
+
+    /* Messages are dispatched without UCT_CB_PARAM_FLAG_DESC, so the handlers
+     * copy the data they need to keep */
+    while (data < end) {
+        hdr  = data;
+        data = UCS_PTR_BYTE_OFFSET(hdr,
+                                   UCP_PROTO_COALESCE_ENTRY_SIZE(hdr->length));
+        ucs_assertv((hdr->am_id < UCP_AM_ID_LAST) &&
+                    (ucp_am_handlers[hdr->am_id] != NULL) &&
+                    (hdr->am_id != UCP_AM_ID_COALESCED),
+                    "invalid coalesced am_id %d", hdr->am_id);
+        ucs_assert(data <= end);
+
+        status = ucp_am_handlers[hdr->am_id]->cb(worker, (void*)(hdr + 1),
+                                                 hdr->length, 0);
+        ucs_assert(status == UCS_OK);
+    }
+
+    return UCS_OK;
+}
+
+static void ucp_proto_coalesce_dump(ucp_worker_h worker,
+                                    uct_am_trace_type_t type, uint8_t id,
+                                    const void *data, size_t length,
+                                    char *buffer, size_t max)
+{
+    const void *end = UCS_PTR_BYTE_OFFSET(data, length);
+    const ucp_proto_coalesce_hdr_t *hdr;
+    char *p, *endp;
+
+    snprintf(buffer, max, "COALESCED");
+    p    = buffer + strlen(buffer);
+    endp = buffer + max;
+
+    while ((data < end) && (p < endp)) {
+        hdr  = data;
+        data = UCS_PTR_BYTE_OFFSET(hdr,
+                                   UCP_PROTO_COALESCE_ENTRY_SIZE(hdr->length));
+        snprintf(p, endp - p, " am_id %d len %u", hdr->am_id, hdr->length);
+        p += strlen(p);
+    }
+}
+
+UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG | UCP_FEATURE_AM,
+                         UCP_AM_ID_COALESCED, ucp_proto_coalesce_handler,
+                         ucp_proto_coalesce_dump, 0);
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_COALESCE_H_
+#define UCP_PROTO_COALESCE_H_
+
+#include <ucp/core/ucp_ep.h>
+#include <uct/api/uct.h>
+#include <ucs/sys/compiler.h>
+#include <ucs/sys/ptr_arith.h>
+
+
+/**
+ * Alignment of the messages in a coalesced frame, so the protocol headers of
+ * each message are accessed at the same alignment as in a separate frame.
+ */
+#define UCP_PROTO_COALESCE_ALIGN 8
+
+
+/**
+ * Header of a single message in a coalesced frame. The message itself, as it
+ * would be sent by a separate active message, follows the header, and is
+ * padded to @ref UCP_PROTO_COALESCE_ALIGN.
+ */
+typedef struct {
+    uint16_t length;      /* Length of the message, without padding */
+    uint8_t  am_id;       /* Active message id of the message */
+    uint8_t  reserved[5];
+} UCS_S_PACKED ucp_proto_coalesce_hdr_t;
+
+
+/* Size of a message in a coalesced frame, including its header and padding */
+#define UCP_PROTO_COALESCE_ENTRY_SIZE(_length) \
+    ucs_align_up_pow2(sizeof(ucp_proto_coalesce_hdr_t) + (_length), \
+                      UCP_PROTO_COALESCE_ALIGN)
+
+
+/**
+ * Try to coalesce a small message which could not be sent because the lane is
+ * out of resources. The message is packed to the coalescing request of the
+ * endpoint, which is added to the pending queue of the lane and later sends
+ * all messages it holds in a single frame.
+ *
+ * @param [in] req         Send request of the message, which was not added to
+ *                         a pending queue yet.
+ * @param [in] lane        Lane the message was sent on.
+ * @param [in] am_id       Active message id of the message.
+ * @param [in] pack_cb     Callback to pack the message, including the protocol
+ *                         headers, as it would be sent by am_bcopy.
+ * @param [in] pack_arg    Argument for @a pack_cb.
+ * @param [in] max_length  Maximal length of the packed message.
+ *
+ * @return UCS_OK if the message was packed and the request may be completed,
+ *         or UCS_ERR_NO_RESOURCE if the request should be added to the pending
+ *         queue as usual.
+ */
+ucs_status_t ucp_proto_coalesce_add(ucp_request_t *req, ucp_lane_index_t lane,
+                                    uint8_t am_id, uct_pack_callback_t pack_cb,
+                                    void *pack_arg, size_t max_length);
+
+
+/**
+ * Same as @ref ucp_proto_coalesce_add, for a message which would be sent by
+ * am_short_iov.
+ */
+ucs_status_t
+ucp_proto_coalesce_add_iov(ucp_request_t *req, ucp_lane_index_t lane,
+                           uint8_t am_id, const uct_iov_t *iov, size_t iovcnt);
+
+
+ucs_status_t ucp_proto_coalesce_progress(uct_pending_req_t *self);
+
+
+/**
+ * Release a coalescing request without sending the rest of its messages.
+ */
+void ucp_proto_coalesce_release(ucp_request_t *req);
+
+
+/**
+ * Stop coalescing messages into the pending coalescing request of the
+ * endpoint, since another request is queued after it.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_coalesce_close(ucp_ep_h ep, ucp_request_t *req)
+{
+    if (ucs_unlikely(ep->ext->coalesce_req != NULL) &&
+        (ep->ext->coalesce_req != req)) {
+        ep->ext->coalesce_req = NULL;
+    }
+}
+
+#endif
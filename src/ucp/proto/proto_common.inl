@@ -245,8 +245,9 @@ static UCS_F_ALWAYS_INLINE ucs_status_t ucp_proto_request_lookup_proto(
 static UCS_F_ALWAYS_INLINE void
 ucp_proto_request_send_init(ucp_request_t *req, ucp_ep_h ep, uint32_t flags)
 {
-    req->flags   = UCP_REQUEST_FLAG_PROTO_SEND | flags;
-    req->send.ep = ep;
+    req->flags             = UCP_REQUEST_FLAG_PROTO_SEND | flags;
+    req->send.ep           = ep;
+    req->send.pending_lane = UCP_NULL_LANE;
 }
 
 
@@ -324,6 +325,22 @@ ucp_proto_request_send_op(ucp_ep_h ep, ucp_proto_select_t *proto_select,
 }
 
 
+/* Switch the remote key to the current configuration of the endpoint, if the
+ * endpoint was reconfigured after the key was unpacked */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_proto_rkey_config_update(ucp_ep_h ep, ucp_rkey_h rkey)
+{
+    ucp_worker_h worker            = ep->worker;
+    ucp_rkey_config_t *rkey_config = ucp_rkey_config(worker, rkey);
+
+    if (ucs_likely((rkey_config->proto_select.worker_epoch == worker->epoch) &&
+                   (rkey_config->key.ep_cfg_index == ep->cfg_index))) {
+        return UCS_OK;
+    }
+
+    return ucp_ep_update_rkey_config(ep, rkey);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
 ucp_proto_request_send_op_rma(ucp_ep_h ep, ucp_rkey_h rkey, ucp_request_t *req,
                               uint32_t req_flags, ucp_operation_id_t op_id,
@@ -333,24 +350,16 @@ ucp_proto_request_send_op_rma(ucp_ep_h ep, ucp_rkey_h rkey, ucp_request_t *req,
                               size_t header_length, uint8_t op_flags)
 {
     ucp_worker_h worker = ep->worker;
-    ucp_rkey_config_t *rkey_config;
     ucp_proto_select_t *proto_select;
     ucs_status_t status;
 
-    rkey_config  = ucp_rkey_config(worker, rkey);
-    proto_select = &rkey_config->proto_select;
-    
-    if (ucs_unlikely((proto_select->worker_epoch != worker->epoch) ||
-                     (rkey_config->key.ep_cfg_index != ep->cfg_index))) {
-        status = ucp_ep_update_rkey_config(ep, rkey);
-        if (status != UCS_OK) {
-            ucp_request_put_param(param, req);
-            return UCS_STATUS_PTR(status);
-        }
-
-        proto_select = &ucp_rkey_config(worker, rkey)->proto_select;
+    status = ucp_proto_rkey_config_update(ep, rkey);
+    if (status != UCS_OK) {
+        ucp_request_put_param(param, req);
+        return UCS_STATUS_PTR(status);
     }
 
+    proto_select = &ucp_rkey_config(worker, rkey)->proto_select;
     return ucp_proto_request_send_op(ep, proto_select, rkey->cfg_index, req,
                                      req_flags, op_id, buffer, count, datatype,
                                      contig_length, param, header_length,
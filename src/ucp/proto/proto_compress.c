@@ -0,0 +1,259 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_compress.h"
+#include "proto_multi.inl"
+
+#include <ucp/core/ucp_worker.inl>
+#include <ucs/algorithm/zrle.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/time/time.h>
+
+
+/* Size of the sample buffer used to measure compression bandwidth */
+#define UCP_PROTO_COMPRESS_BW_SAMPLE_SIZE  (64 * UCS_KBYTE)
+
+/* Number of iterations to measure compression bandwidth */
+#define UCP_PROTO_COMPRESS_BW_ITERS        8
+
+
+typedef struct {
+    ucp_proto_multi_pack_ctx_t super;
+    ucp_am_id_t                am_id;
+    const void                 *hdr;
+    size_t                     hdr_length;
+} ucp_proto_compress_pack_ctx_t;
+
+
+int ucp_proto_compress_check(const ucp_proto_init_params_t *init_params)
+{
+    ucp_context_h context = init_params->worker->context;
+
+    return ((init_params->ep_config_key->flags &
+             UCP_EP_CONFIG_KEY_FLAG_COMPRESS) ||
+            context->config.ext.compress) &&
+           (context->config.ext.compress_ratio > 1.0) &&
+           UCP_MEM_IS_HOST(init_params->select_param->mem_type);
+}
+
+static double ucp_proto_compress_measure_bw(ucp_context_h context)
+{
+    const size_t size = UCP_PROTO_COMPRESS_BW_SAMPLE_SIZE;
+    size_t i, compressed_length;
+    ucs_time_t start_time;
+    uint8_t *src, *dst;
+    double elapsed;
+
+    src = ucs_malloc(size, "compress_bw_src");
+    dst = ucs_malloc(size, "compress_bw_dst");
+    if ((src == NULL) || (dst == NULL)) {
+        ucs_free(src);
+        ucs_free(dst);
+        return context->config.ext.bcopy_bw;
+    }
+
+    /* Sparse buffer, with blocks of zero and non-zero bytes */
+    for (i = 0; i < size; ++i) {
+        src[i] = ((i / UCS_SYS_CACHE_LINE_SIZE) % 2) ? (i | 1) : 0;
+    }
+
+    start_time = ucs_get_time();
+    for (i = 0; i < UCP_PROTO_COMPRESS_BW_ITERS; ++i) {
+        ucs_zrle_compress(src, size, dst, size, &compressed_length);
+    }
+    elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+
+    ucs_free(src);
+    ucs_free(dst);
+
+    if (elapsed <= 0) {
+        return context->config.ext.bcopy_bw;
+    }
+
+    return (size * UCP_PROTO_COMPRESS_BW_ITERS) / elapsed;
+}
+
+double ucp_proto_compress_bw(ucp_context_h context)
+{
+    if (UCS_CONFIG_DBL_IS_AUTO(context->config.compress_bw)) {
+        context->config.compress_bw = ucp_proto_compress_measure_bw(context);
+        ucs_debug("estimated compression bandwidth is %f",
+                  context->config.compress_bw);
+    }
+
+    return context->config.compress_bw;
+}
+
+static void *
+ucp_proto_compress_buffer(void **buffer_p, size_t *size_p, size_t size)
+{
+    void *buffer;
+
+    if (ucs_likely(*size_p >= size)) {
+        return *buffer_p;
+    }
+
+    buffer = ucs_realloc(*buffer_p, size, "compress_buffer");
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    *buffer_p = buffer;
+    *size_p   = size;
+    return buffer;
+}
+
+static size_t ucp_proto_compress_pack(void *dest, void *arg)
+{
+    ucp_proto_compress_pack_ctx_t *pack_ctx = arg;
+    ucp_worker_h worker                     = pack_ctx->super.req->send.ep->worker;
+    ucp_proto_compress_hdr_t *hdr           = dest;
+    void *payload = UCS_PTR_BYTE_OFFSET(hdr + 1, pack_ctx->hdr_length);
+    size_t length, compressed_length;
+    ucs_status_t status;
+    void *buffer;
+
+    hdr->ep_id      = ucp_send_request_get_ep_remote_id(pack_ctx->super.req);
+    hdr->am_id      = pack_ctx->am_id;
+    hdr->hdr_length = pack_ctx->hdr_length;
+    memcpy(hdr + 1, pack_ctx->hdr, pack_ctx->hdr_length);
+
+    buffer = ucp_proto_compress_buffer(&worker->compress.tx_buffer,
+                                       &worker->compress.tx_size,
+                                       pack_ctx->super.max_payload);
+    if (buffer == NULL) {
+        /* Send the payload as is */
+        length      = ucp_proto_multi_data_pack(&pack_ctx->super, payload);
+        hdr->length = length;
+        return sizeof(*hdr) + pack_ctx->hdr_length + length;
+    }
+
+    /* Use the compressed payload only if it's smaller than the original one,
+     * so the receiver can tell them apart by length */
+    length = ucp_proto_multi_data_pack(&pack_ctx->super, buffer);
+    status = ucs_zrle_compress(buffer, length, payload,
+                               (length > 0) ? (length - 1) : 0,
+                               &compressed_length);
+    if (status != UCS_OK) {
+        memcpy(payload, buffer, length);
+        compressed_length = length;
+    }
+
+    hdr->length = length;
+    return sizeof(*hdr) + pack_ctx->hdr_length + compressed_length;
+}
+
+ucs_status_t
+ucp_proto_compress_am_bcopy_send(ucp_request_t *req,
+                                 const ucp_proto_multi_lane_priv_t *lpriv,
+                                 ucp_datatype_iter_t *next_iter,
+                                 ucp_am_id_t am_id, const void *hdr,
+                                 size_t hdr_length)
+{
+    ucp_proto_compress_pack_ctx_t pack_ctx = {
+        .super.req       = req,
+        .super.next_iter = next_iter,
+        .am_id           = am_id,
+        .hdr             = hdr,
+        .hdr_length      = hdr_length
+    };
+    ssize_t packed_size;
+
+    pack_ctx.super.max_payload = ucp_proto_multi_max_payload(
+            req, lpriv, sizeof(ucp_proto_compress_hdr_t) + hdr_length);
+
+    packed_size = uct_ep_am_bcopy(ucp_ep_get_lane(req->send.ep,
+                                                  lpriv->super.lane),
+                                  UCP_AM_ID_COMPRESSED, ucp_proto_compress_pack,
+                                  &pack_ctx, 0);
+
+    return ucp_proto_bcopy_send_func_status(packed_size);
+}
+
+static void
+ucp_proto_compress_set_ep_failed(ucp_worker_h worker,
+                                 const ucp_proto_compress_hdr_t *hdr)
+{
+    ucp_ep_h ep;
+
+    /* The fragment is lost, so the message it belongs to can't be completed
+     * successfully. Fail the endpoint to complete it with an error. */
+    UCP_WORKER_GET_VALID_EP_BY_ID(&ep, worker, hdr->ep_id, return,
+                                  "compressed am_id %d", hdr->am_id);
+    ucp_ep_set_lanes_failed_schedule(ep, 0, UCS_ERR_IO_ERROR);
+}
+
+static ucs_status_t
+ucp_proto_compress_handler(void *arg, void *data, size_t length,
+                           unsigned flags)
+{
+    ucp_worker_h worker                 = arg;
+    const ucp_proto_compress_hdr_t *hdr = data;
+    const void *payload = UCS_PTR_BYTE_OFFSET(hdr + 1, hdr->hdr_length);
+    size_t payload_length, msg_length, decompressed_length;
+    UCS_V_UNUSED ucs_status_t status;
+    void *msg;
+
+    ucs_assertv((hdr->am_id < UCP_AM_ID_LAST) &&
+                (ucp_am_handlers[hdr->am_id] != NULL) &&
+                (hdr->am_id != UCP_AM_ID_COMPRESSED),
+                "invalid compressed am_id %d", hdr->am_id);
+
+    payload_length = length - sizeof(*hdr) - hdr->hdr_length;
+    msg_length     = hdr->hdr_length + hdr->length;
+    if (payload_length == hdr->length) {
+        /* The payload was sent as is */
+        msg = (void*)(hdr + 1);
+    } else {
+        msg = ucp_proto_compress_buffer(&worker->compress.rx_buffer,
+                                        &worker->compress.rx_size, msg_length);
+        if (msg == NULL) {
+            ucs_error("worker %p: failed to allocate %zu bytes to decompress "
+                      "am_id %d", worker, msg_length, hdr->am_id);
+            ucp_proto_compress_set_ep_failed(worker, hdr);
+            return UCS_OK;
+        }
+
+        memcpy(msg, hdr + 1, hdr->hdr_length);
+        status = ucs_zrle_decompress(payload, payload_length,
+                                     UCS_PTR_BYTE_OFFSET(msg, hdr->hdr_length),
+                                     hdr->length, &decompressed_length);
+        if ((status != UCS_OK) || (decompressed_length != hdr->length)) {
+            ucs_error("worker %p: failed to decompress am_id %d payload of "
+                      "%zu bytes", worker, hdr->am_id, payload_length);
+            ucp_proto_compress_set_ep_failed(worker, hdr);
+            return UCS_OK;
+        }
+    }
+
+    /* The message is dispatched without UCT_CB_PARAM_FLAG_DESC, so the
+     * handler copies the data it needs to keep */
+    status = ucp_am_handlers[hdr->am_id]->cb(worker, msg, msg_length, 0);
+    ucs_assert(status == UCS_OK);
+    return UCS_OK;
+}
+
+static void ucp_proto_compress_dump(ucp_worker_h worker,
+                                    uct_am_trace_type_t type, uint8_t id,
+                                    const void *data, size_t length,
+                                    char *buffer, size_t max)
+{
+    const ucp_proto_compress_hdr_t *hdr = data;
+
+    snprintf(buffer, max,
+             "COMPRESSED ep_id 0x%" PRIx64 " am_id %d hdr_len %u len %u "
+             "payload %zu", hdr->ep_id, hdr->am_id, hdr->hdr_length, hdr->length,
+             length - sizeof(*hdr) - hdr->hdr_length);
+}
+
+UCP_DEFINE_AM_WITH_PROXY(UCP_FEATURE_TAG | UCP_FEATURE_AM,
+                         UCP_AM_ID_COMPRESSED, ucp_proto_compress_handler,
+                         ucp_proto_compress_dump, 0);
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_COMPRESS_H_
+#define UCP_PROTO_COMPRESS_H_
+
+#include "proto_multi.h"
+
+#include <ucs/sys/compiler.h>
+
+
+/**
+ * Header of a message with compressed payload. It is followed by the header of
+ * the original message, which is not compressed, and then by the payload. If
+ * the payload could not be compressed to a smaller size, it is sent as is.
+ */
+typedef struct {
+    uint64_t ep_id;      /* Endpoint id on the receiver, to fail the endpoint if
+                            the payload can't be decompressed */
+    uint32_t length;     /* Length of the payload before compression */
+    uint8_t  am_id;      /* Active message id of the original message */
+    uint8_t  hdr_length; /* Length of the original message header */
+} UCS_S_PACKED ucp_proto_compress_hdr_t;
+
+
+/**
+ * Check if a compressing protocol may be used with the given parameters.
+ *
+ * @param [in] init_params  Protocol initialization parameters.
+ *
+ * @return Nonzero if compressing protocols are enabled on the endpoint, and
+ *         the data resides in host memory.
+ */
+int ucp_proto_compress_check(const ucp_proto_init_params_t *init_params);
+
+
+/**
+ * Get the estimated compression bandwidth, and measure it on the first call
+ * if it was not configured.
+ *
+ * @param [in] context  UCP context.
+ *
+ * @return Compression bandwidth, in bytes per second.
+ */
+double ucp_proto_compress_bw(ucp_context_h context);
+
+
+/**
+ * Send the next fragment of a multi-fragment request by active message, with
+ * compressed payload.
+ *
+ * @param [in]  req         Request to send.
+ * @param [in]  lpriv       Lane to send the fragment on.
+ * @param [out] next_iter   Datatype iterator at the end of the fragment.
+ * @param [in]  am_id       Active message id of the original message.
+ * @param [in]  hdr         Header of the original message.
+ * @param [in]  hdr_length  Length of @a hdr.
+ *
+ * @return Send status, as returned by the send function of a multi-fragment
+ *         protocol.
+ */
+ucs_status_t
+ucp_proto_compress_am_bcopy_send(ucp_request_t *req,
+                                 const ucp_proto_multi_lane_priv_t *lpriv,
+                                 ucp_datatype_iter_t *next_iter,
+                                 ucp_am_id_t am_id, const void *hdr,
+                                 size_t hdr_length);
+
+#endif
@@ -9,6 +9,7 @@
 #endif
 
 #include "proto_init.h"
+#include "proto_compress.h"
 #include "proto_debug.h"
 #include "proto_select.inl"
 #include "proto_common.inl"
@@ -484,6 +485,35 @@ ucp_proto_init_add_buffer_perf(const ucp_proto_common_init_params_t *params,
     return status;
 }
 
+static ucs_status_t
+ucp_proto_init_add_compress_time(const ucp_proto_common_init_params_t *params,
+                                 size_t range_start, size_t range_end,
+                                 ucp_proto_perf_t *perf)
+{
+    ucp_proto_perf_factors_t perf_factors = UCP_PROTO_PERF_FACTORS_INITIALIZER;
+    ucp_context_h context                 = params->super.worker->context;
+    uint32_t op_attr_mask;
+
+    /* Sender packs the data to a staging buffer and compresses it */
+    perf_factors[UCP_PROTO_PERF_FACTOR_LOCAL_CPU] = ucs_linear_func_make(
+            0, (1.0 / context->config.ext.bcopy_bw) +
+               (1.0 / ucp_proto_compress_bw(context)));
+
+    /* Receiver decompresses the data to a staging buffer */
+    op_attr_mask = ucp_proto_select_op_attr_unpack(
+            params->super.select_param->op_attr);
+    if (!ucp_proto_init_skip_recv_overhead(params, op_attr_mask)) {
+        perf_factors[UCP_PROTO_PERF_FACTOR_REMOTE_CPU] =
+                ucs_linear_func_make(0, 1.0 / context->config.ext.bcopy_bw);
+    }
+
+    return ucp_proto_perf_add_funcs(
+            perf, range_start, range_end, perf_factors,
+            ucp_proto_perf_node_new_data("compress", "ratio %.1f",
+                                         context->config.ext.compress_ratio),
+            NULL);
+}
+
 static int
 ucp_proto_common_check_mem_access(const ucp_proto_common_init_params_t *params)
 {
@@ -507,6 +537,7 @@ ucs_status_t ucp_proto_init_perf(const ucp_proto_common_init_params_t *params,
                                  ucp_proto_perf_t **perf_p)
 {
     const ucp_proto_perf_segment_t *frag_seg;
+    ucp_proto_common_tl_perf_t compress_tl_perf;
     size_t range_start, range_end;
     ucp_proto_perf_t *perf;
     ucs_status_t status;
@@ -531,6 +562,14 @@ ucs_status_t ucp_proto_init_perf(const ucp_proto_common_init_params_t *params,
         return status;
     }
 
+    if (params->flags & UCP_PROTO_COMMON_INIT_FLAG_COMPRESS) {
+        /* The transport sends only the compressed data */
+        compress_tl_perf            = *tl_perf;
+        compress_tl_perf.bandwidth *=
+                params->super.worker->context->config.ext.compress_ratio;
+        tl_perf                     = &compress_tl_perf;
+    }
+
     status = ucp_proto_init_add_tl_perf(params, tl_perf, range_start, range_end,
                                         perf);
     if (status != UCS_OK) {
@@ -545,6 +584,15 @@ ucs_status_t ucp_proto_init_perf(const ucp_proto_common_init_params_t *params,
             goto err_cleanup_perf;
         }
 
+        if (params->flags & UCP_PROTO_COMMON_INIT_FLAG_COMPRESS) {
+            status = ucp_proto_init_add_compress_time(params,
+                                                      ucs_max(1, range_start),
+                                                      range_end, perf);
+            if (status != UCS_OK) {
+                goto err_cleanup_perf;
+            }
+        }
+
         /* Add range that represents sending many fragments */
         if ((range_end < params->max_length) &&
             !(params->flags & UCP_PROTO_COMMON_INIT_FLAG_SINGLE_FRAG)) {
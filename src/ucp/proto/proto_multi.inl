@@ -8,6 +8,7 @@
 #define UCP_PROTO_MULTI_INL_
 
 #include "proto_multi.h"
+#include "proto_coalesce.h"
 
 #include <ucp/proto/proto_common.inl>
 #include <ucp/rma/rma.inl>
@@ -123,6 +124,7 @@ ucp_proto_multi_no_resource(ucp_request_t *req, ucp_lane_index_t lane)
 
     ucs_assert(status == UCS_OK);
     req->send.lane = lane;
+    ucp_proto_coalesce_close(req->send.ep, req);
 
     /* Remove the request from current pending queue because it was added to
      * other lane's pending queue.
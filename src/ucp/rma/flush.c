@@ -11,6 +11,9 @@
 #include <ucp/core/ucp_ep.h>
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_request.inl>
+#include <ucp/core/ucp_api_record.h>
+#include <ucp/proto/proto_coalesce.h>
+#include <ucp/wireup/wireup_ep.h>
 
 #include "rma.inl"
 
@@ -144,6 +147,7 @@ static void ucp_ep_flush_progress(ucp_request_t *req)
                           ep, lane, ucs_status_string(status));
             if (status == UCS_OK) {
                 req->send.lane = lane;
+                ucp_proto_coalesce_close(ep, req);
             } else if (status != UCS_ERR_BUSY) {
                 ucp_ep_flush_error(req, lane, status);
                 break;
@@ -498,6 +502,11 @@ ucs_status_ptr_t ucp_ep_flush_internal(ucp_ep_h ep, unsigned req_flags,
 
     ucs_debug("%s ep %p", debug_name, ep);
 
+    if (ucp_wireup_ep_is_lazy_idle(ep)) {
+        /* Nothing was sent on the endpoint, so avoid connecting it */
+        return UCS_STATUS_PTR(UCS_OK);
+    }
+
     req = ucp_request_get_param(ep->worker, param,
                                 {return UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);});
 
@@ -559,6 +568,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_ep_flush_nbx, (ep, param),
 {
     void *request;
 
+    UCP_API_RECORD(UCP_API_RECORD_OP_EP_FLUSH, ep, NULL, 0, param);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
     request = ucp_ep_flush_internal(ep, 0, param, NULL, ucp_ep_flushed_callback,
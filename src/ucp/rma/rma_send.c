@@ -16,6 +16,7 @@
 #include <ucs/profile/profile.h>
 #include <ucs/sys/stubs.h>
 
+#include <ucp/core/ucp_api_record.h>
 #include <ucp/core/ucp_rkey.inl>
 #include <ucp/proto/proto_common.inl>
 #include <ucp/proto/proto_multi.inl>
@@ -217,6 +218,7 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
 
     UCP_REQUEST_CHECK_PARAM_COMMON(param);
     UCP_RMA_CHECK_PTR(worker->context, buffer, count);
+    UCP_API_RECORD(UCP_API_RECORD_OP_PUT, ep, buffer, count, param);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     ucs_trace_req("put_nbx buffer %p count %zu remote_addr %" PRIx64
@@ -305,6 +307,7 @@ ucs_status_ptr_t ucp_get_nbx(ucp_ep_h ep, void *buffer, size_t count,
 
     UCP_REQUEST_CHECK_PARAM(param);
     UCP_RMA_CHECK_PTR(worker->context, buffer, count);
+    UCP_API_RECORD(UCP_API_RECORD_OP_GET, ep, buffer, count, param);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     ucs_trace_req("get_nbx buffer %p count %zu remote_addr %" PRIx64
@@ -10,8 +10,11 @@
 
 #include "proto_rndv.inl"
 
+#include <ucp/proto/proto_compress.h>
 
-static void ucp_rndv_am_probe_common(ucp_proto_multi_init_params_t *params)
+
+static void ucp_rndv_am_probe_common(ucp_proto_multi_init_params_t *params,
+                                     size_t hdr_size)
 {
     ucp_context_h context = params->super.super.worker->context;
 
@@ -30,7 +33,7 @@ static void ucp_rndv_am_probe_common(ucp_proto_multi_init_params_t *params)
     params->super.latency      = 0;
     params->first.lane_type    = UCP_LANE_TYPE_AM;
     params->middle.lane_type   = UCP_LANE_TYPE_AM_BW;
-    params->super.hdr_size     = sizeof(ucp_request_data_hdr_t);
+    params->super.hdr_size     = hdr_size;
     params->max_lanes          = context->config.ext.max_rndv_lanes;
     params->opt_align_offs     = UCP_PROTO_COMMON_OFFSET_INVALID;
 
@@ -121,7 +124,7 @@ static void ucp_rndv_am_bcopy_probe(const ucp_proto_init_params_t *init_params)
         .middle.tl_cap_flags = UCT_IFACE_FLAG_AM_BCOPY
     };
 
-    ucp_rndv_am_probe_common(&params);
+    ucp_rndv_am_probe_common(&params, sizeof(ucp_request_data_hdr_t));
 }
 
 static void
@@ -145,6 +148,72 @@ ucp_proto_t ucp_rndv_am_bcopy_proto = {
     .reset    = ucp_proto_request_bcopy_reset
 };
 
+static void
+ucp_rndv_am_compress_probe(const ucp_proto_init_params_t *init_params)
+{
+    ucp_proto_multi_init_params_t params = {
+        .super.super         = *init_params,
+        .super.min_iov       = 0,
+        .super.min_frag_offs = UCP_PROTO_COMMON_OFFSET_INVALID,
+        .super.max_frag_offs = ucs_offsetof(uct_iface_attr_t, cap.am.max_bcopy),
+        .super.max_iov_offs  = UCP_PROTO_COMMON_OFFSET_INVALID,
+        .super.send_op       = UCT_EP_OP_AM_BCOPY,
+        .super.memtype_op    = UCT_EP_OP_GET_SHORT,
+        .super.flags         = UCP_PROTO_COMMON_INIT_FLAG_CAP_SEG_SIZE |
+                               UCP_PROTO_COMMON_INIT_FLAG_ERR_HANDLING |
+                               UCP_PROTO_COMMON_INIT_FLAG_RESUME |
+                               UCP_PROTO_COMMON_INIT_FLAG_COMPRESS,
+        .super.exclude_map   = 0,
+        .super.reg_mem_info  = ucp_mem_info_unknown,
+        .first.tl_cap_flags  = UCT_IFACE_FLAG_AM_BCOPY,
+        .middle.tl_cap_flags = UCT_IFACE_FLAG_AM_BCOPY
+    };
+
+    if (!ucp_proto_compress_check(init_params)) {
+        return;
+    }
+
+    ucp_rndv_am_probe_common(&params, sizeof(ucp_proto_compress_hdr_t) +
+                                      sizeof(ucp_request_data_hdr_t));
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t ucp_proto_rndv_am_compress_send_func(
+        ucp_request_t *req, const ucp_proto_multi_lane_priv_t *lpriv,
+        ucp_datatype_iter_t *next_iter, ucp_lane_index_t *lane_shift)
+{
+    ucp_request_data_hdr_t hdr;
+
+    ucp_rndv_am_fill_header(&hdr, req);
+    return ucp_proto_compress_am_bcopy_send(req, lpriv, next_iter,
+                                            UCP_AM_ID_RNDV_DATA, &hdr,
+                                            sizeof(hdr));
+}
+
+static ucs_status_t
+ucp_proto_rndv_am_compress_progress(uct_pending_req_t *uct_req)
+{
+    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+
+    /* coverity[tainted_data_downcast] */
+    return ucp_proto_multi_bcopy_progress(req, req->send.proto_config->priv,
+                                          NULL,
+                                          ucp_proto_rndv_am_compress_send_func,
+                                          ucp_proto_rndv_am_bcopy_complete);
+}
+
+ucp_proto_t ucp_rndv_am_compress_proto = {
+    .name     = "rndv/am/compress",
+    .desc     = "fragmented compressed " UCP_PROTO_COPY_IN_DESC " "
+                UCP_PROTO_COPY_OUT_DESC,
+    .flags    = 0,
+    .dt_mask  = UCP_PROTO_DT_MASK_DEFAULT,
+    .probe    = ucp_rndv_am_compress_probe,
+    .query    = ucp_proto_multi_query,
+    .progress = {ucp_proto_rndv_am_compress_progress},
+    .abort    = ucp_proto_rndv_am_bcopy_abort,
+    .reset    = ucp_proto_request_bcopy_reset
+};
+
 static UCS_F_ALWAYS_INLINE ucs_status_t ucp_rndv_am_zcopy_send_func(
         ucp_request_t *req, const ucp_proto_multi_lane_priv_t *lpriv,
         ucp_datatype_iter_t *next_iter, ucp_lane_index_t *lane_shift)
@@ -199,7 +268,7 @@ static void ucp_rndv_am_zcopy_probe(const ucp_proto_init_params_t *init_params)
         .middle.tl_cap_flags = UCT_IFACE_FLAG_AM_ZCOPY
     };
 
-    ucp_rndv_am_probe_common(&params);
+    ucp_rndv_am_probe_common(&params, sizeof(ucp_request_data_hdr_t));
 }
 
 static void
@@ -12,6 +12,7 @@
 #include <ucp/core/ucp_ep.inl>
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_api_record.h>
 #include <ucp/proto/proto_am.inl>
 #include <ucp/stream/stream.h>
 #include <ucp/dt/dt.h>
@@ -136,6 +137,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nbx,
                                     return UCS_STATUS_PTR(
                                             UCS_ERR_INVALID_PARAM));
     UCP_REQUEST_CHECK_PARAM(param);
+    UCP_API_RECORD(UCP_API_RECORD_OP_STREAM_SEND, ep, buffer, count, param);
     if (ENABLE_PARAMS_CHECK && (ucp_request_param_flags(param) != 0)) {
         return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM);
     }
@@ -11,6 +11,7 @@
 #include "proto_eager.inl"
 
 #include <ucp/core/ucp_request.inl>
+#include <ucp/proto/proto_compress.h>
 #include <ucp/proto/proto_multi.inl>
 
 
@@ -50,7 +51,7 @@ ucp_proto_eager_multi_probe_common(ucp_proto_multi_init_params_t *params,
 
 static void ucp_proto_eager_bcopy_multi_common_probe(
         const ucp_proto_init_params_t *init_params, ucp_proto_id_t op_id,
-        size_t hdr_size)
+        size_t hdr_size, unsigned flags)
 {
     ucp_context_t *context               = init_params->worker->context;
     ucp_proto_multi_init_params_t params = {
@@ -68,7 +69,7 @@ static void ucp_proto_eager_bcopy_multi_common_probe(
         .super.memtype_op    = UCT_EP_OP_GET_SHORT,
         .super.flags         = UCP_PROTO_COMMON_INIT_FLAG_CAP_SEG_SIZE |
                                UCP_PROTO_COMMON_INIT_FLAG_ERR_HANDLING |
-                               UCP_PROTO_COMMON_INIT_FLAG_RESUME,
+                               UCP_PROTO_COMMON_INIT_FLAG_RESUME | flags,
         .super.exclude_map   = 0,
         .super.reg_mem_info  = ucp_mem_info_unknown,
         .min_chunk           = 0,
@@ -102,7 +103,7 @@ static void
 ucp_proto_eager_bcopy_multi_probe(const ucp_proto_init_params_t *init_params)
 {
     ucp_proto_eager_bcopy_multi_common_probe(init_params, UCP_OP_ID_TAG_SEND,
-                                             sizeof(ucp_eager_first_hdr_t));
+                                             sizeof(ucp_eager_first_hdr_t), 0);
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -142,12 +143,72 @@ ucp_proto_t ucp_eager_bcopy_multi_proto = {
     .reset    = ucp_proto_request_bcopy_reset
 };
 
+static void ucp_proto_eager_bcopy_multi_compress_probe(
+        const ucp_proto_init_params_t *init_params)
+{
+    if (!ucp_proto_compress_check(init_params)) {
+        return;
+    }
+
+    ucp_proto_eager_bcopy_multi_common_probe(
+            init_params, UCP_OP_ID_TAG_SEND,
+            sizeof(ucp_proto_compress_hdr_t) + sizeof(ucp_eager_first_hdr_t),
+            UCP_PROTO_COMMON_INIT_FLAG_COMPRESS);
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_proto_eager_bcopy_multi_compress_send_func(
+        ucp_request_t *req, const ucp_proto_multi_lane_priv_t *lpriv,
+        ucp_datatype_iter_t *next_iter, ucp_lane_index_t *lane_shift)
+{
+    ucp_eager_middle_hdr_t hdr_middle;
+    ucp_eager_first_hdr_t hdr_first;
+
+    if (req->send.state.dt_iter.offset == 0) {
+        ucp_proto_eager_set_first_hdr(req, &hdr_first);
+        return ucp_proto_compress_am_bcopy_send(req, lpriv, next_iter,
+                                                UCP_AM_ID_EAGER_FIRST,
+                                                &hdr_first, sizeof(hdr_first));
+    }
+
+    ucp_proto_eager_set_middle_hdr(req, &hdr_middle);
+    return ucp_proto_compress_am_bcopy_send(req, lpriv, next_iter,
+                                            UCP_AM_ID_EAGER_MIDDLE, &hdr_middle,
+                                            sizeof(hdr_middle));
+}
+
+static ucs_status_t
+ucp_proto_eager_bcopy_multi_compress_progress(uct_pending_req_t *uct_req)
+{
+    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+
+    /* coverity[tainted_data_downcast] */
+    return ucp_proto_multi_bcopy_progress(
+            req, req->send.proto_config->priv, ucp_proto_msg_multi_request_init,
+            ucp_proto_eager_bcopy_multi_compress_send_func,
+            ucp_proto_request_bcopy_complete_success);
+}
+
+ucp_proto_t ucp_eager_bcopy_multi_compress_proto = {
+    .name     = "egr/multi/compress",
+    .desc     = UCP_PROTO_MULTI_FRAG_DESC " compressed "
+                UCP_PROTO_EAGER_BCOPY_DESC,
+    .flags    = 0,
+    .dt_mask  = UCP_PROTO_DT_MASK_DEFAULT,
+    .probe    = ucp_proto_eager_bcopy_multi_compress_probe,
+    .query    = ucp_proto_multi_query,
+    .progress = {ucp_proto_eager_bcopy_multi_compress_progress},
+    .abort    = ucp_proto_request_bcopy_abort,
+    .reset    = ucp_proto_request_bcopy_reset
+};
+
 static void ucp_proto_eager_sync_bcopy_multi_probe(
         const ucp_proto_init_params_t *init_params)
 {
     ucp_proto_eager_bcopy_multi_common_probe(init_params,
                                              UCP_OP_ID_TAG_SEND_SYNC,
-                                             sizeof(ucp_eager_sync_first_hdr_t));
+                                             sizeof(ucp_eager_sync_first_hdr_t),
+                                             0);
 }
 
 static size_t ucp_eager_sync_bcopy_pack_first(void *dest, void *arg)
@@ -17,6 +17,8 @@
 #include <ucp/core/ucp_request.inl>
 #include <ucp/proto/proto_single.inl>
 #include <ucp/proto/proto_common.inl>
+#include <ucp/proto/proto_am.inl>
+#include <ucp/proto/proto_coalesce.h>
 
 
 static ucs_status_t ucp_eager_short_progress(uct_pending_req_t *self)
@@ -24,7 +26,9 @@ static ucs_status_t ucp_eager_short_progress(uct_pending_req_t *self)
     ucp_request_t                   *req = ucs_container_of(self, ucp_request_t,
                                                             send.uct);
     const ucp_proto_single_priv_t *spriv = req->send.proto_config->priv;
+    size_t iov_cnt                       = 0;
     ucs_status_t status;
+    uct_iov_t iov[2];
 
     status = uct_ep_am_short(ucp_ep_get_fast_lane(req->send.ep,
                                                   spriv->super.lane),
@@ -32,8 +36,18 @@ static ucs_status_t ucp_eager_short_progress(uct_pending_req_t *self)
                              req->send.state.dt_iter.type.contig.buffer,
                              req->send.state.dt_iter.length);
     if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE)) {
-        req->send.lane = spriv->super.lane; /* for pending add */
-        return status;
+        ucp_add_uct_iov_elem(iov, &req->send.msg_proto.tag,
+                             sizeof(ucp_tag_hdr_t), UCT_MEM_HANDLE_NULL,
+                             &iov_cnt);
+        ucp_add_uct_iov_elem(iov, req->send.state.dt_iter.type.contig.buffer,
+                             req->send.state.dt_iter.length,
+                             UCT_MEM_HANDLE_NULL, &iov_cnt);
+        status = ucp_proto_coalesce_add_iov(req, spriv->super.lane,
+                                            UCP_AM_ID_EAGER_ONLY, iov, iov_cnt);
+        if (status != UCS_OK) {
+            req->send.lane = spriv->super.lane; /* for pending add */
+            return status;
+        }
     }
 
     ucp_datatype_iter_cleanup(&req->send.state.dt_iter, 0,
@@ -113,10 +127,20 @@ static ucs_status_t ucp_eager_bcopy_single_progress(uct_pending_req_t *self)
     ucp_request_t                   *req = ucs_container_of(self, ucp_request_t,
                                                             send.uct);
     const ucp_proto_single_priv_t *spriv = req->send.proto_config->priv;
+    ucs_status_t status;
 
-    return ucp_proto_am_bcopy_single_progress(
+    status = ucp_proto_am_bcopy_single_progress(
             req, UCP_AM_ID_EAGER_ONLY, spriv->super.lane, ucp_eager_single_pack,
             req, SIZE_MAX, ucp_proto_request_bcopy_complete_success, 1);
+    if (ucs_unlikely(status == UCS_ERR_NO_RESOURCE) &&
+        (ucp_proto_coalesce_add(req, spriv->super.lane, UCP_AM_ID_EAGER_ONLY,
+                                ucp_eager_single_pack, req,
+                                sizeof(ucp_eager_hdr_t) +
+                                req->send.state.dt_iter.length) == UCS_OK)) {
+        return ucp_proto_request_bcopy_complete_success(req);
+    }
+
+    return status;
 }
 
 static void
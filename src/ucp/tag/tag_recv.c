@@ -13,6 +13,7 @@
 #include "tag_match.inl"
 #include "offload.h"
 
+#include <ucp/core/ucp_api_record.h>
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_request.inl>
 #include <ucs/datastruct/mpool.inl>
@@ -101,6 +102,8 @@ static UCS_F_ALWAYS_INLINE ucs_status_ptr_t ucp_tag_recv_common(
 
         req->status = status;
         UCS_PROFILE_REQUEST_EVENT(req, "complete_imm_tag_recv", 0);
+        UCP_API_RECORD_LENGTH(UCP_API_RECORD_OP_TAG_RECV, NULL, recv_len,
+                              ucp_request_param_datatype(param));
         goto out_completed;
     }
 
@@ -13,6 +13,7 @@
 #include "tag_rndv.h"
 
 #include <ucp/core/ucp_ep.h>
+#include <ucp/core/ucp_api_record.h>
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_context.h>
 #include <ucp/proto/proto_am.inl>
@@ -244,6 +245,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nbx,
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(ep->worker->context, UCP_FEATURE_TAG,
                                     return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
     UCP_REQUEST_CHECK_PARAM(param);
+    UCP_API_RECORD(UCP_API_RECORD_OP_TAG_SEND, ep, buffer, count, param);
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
@@ -322,6 +324,8 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nbx,
                                     return UCS_STATUS_PTR(
                                             UCS_ERR_INVALID_PARAM));
     UCP_REQUEST_CHECK_PARAM(param);
+    UCP_API_RECORD(UCP_API_RECORD_OP_TAG_SEND_SYNC, ep, buffer, count,
+                   param);
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
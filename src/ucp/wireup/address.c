@@ -110,9 +110,31 @@
  *           if if_addr_len == 63
  */
 
+/* Address version 3 format is the same as version 2, except:
+ *
+ *  - The device list is preceded by a dictionary of transport names, and each
+ *    iface refers to its transport name by a single byte index:
+ *
+ *      +-----------+-----------------+-----+     for each iface
+ *      | num_tls 8 | tl_name_csum 16 | ... |     +-------------+
+ *      +-----------+-----------------+-----+     | tl_index 8  | ...
+ *                                                +-------------+
+ *
+ *  - The 5 bits of device address length are replaced by dev_addr_ref: 0 for
+ *    an empty device address, 31 for a device address which is packed inline
+ *    right after its 8-bit length, or the 1-based index of a previous inline
+ *    device address with the same value.
+ *
+ *  - In non-unified mode, iface attributes are packed as a difference from the
+ *    previous iface: a mask of the fields which were changed (see
+ *    UCP_ADDRESS_V3_ATTR_*), followed by their values. Priority and fp8 values
+ *    take a byte, segment size and flags are packed as LEB128 varints.
+ */
+
 
 typedef struct {
     size_t           dev_addr_len;
+    uint8_t          dev_addr_ref; /* Address version 3 device address ref */
     ucp_tl_bitmap_t  tl_bitmap;
     ucp_rsc_index_t  rsc_index;
     ucp_rsc_index_t  tl_count;
@@ -221,6 +243,42 @@ UCS_ARRAY_DECLARE_TYPE(ucp_address_remote_device_array_t, unsigned,
 #define UCP_ADDRESS_DEFAULT_WORKER_UUID     0
 #define UCP_ADDRESS_DEFAULT_CLIENT_ID       0
 
+/* Empty device address, in address version 3 */
+#define UCP_ADDRESS_V3_DEV_ADDR_NONE     0
+
+/* Device address is packed inline, in address version 3 */
+#define UCP_ADDRESS_V3_DEV_ADDR_INLINE   UCP_ADDRESS_DEVICE_LEN_MASK
+
+/* Maximal number of inline device addresses which can be referenced */
+#define UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS (UCP_ADDRESS_V3_DEV_ADDR_INLINE - 1)
+
+/* Maximal size of iface attributes packed with address version 3 */
+#define UCP_ADDRESS_V3_IFACE_ATTR_MAX    16
+
+
+/* Fields of iface attributes which differ from the previous iface, in address
+ * version 3 */
+enum {
+    UCP_ADDRESS_V3_ATTR_OVERHEAD  = UCS_BIT(0),
+    UCP_ADDRESS_V3_ATTR_BANDWIDTH = UCS_BIT(1),
+    UCP_ADDRESS_V3_ATTR_LATENCY   = UCS_BIT(2),
+    UCP_ADDRESS_V3_ATTR_PRIO      = UCS_BIT(3),
+    UCP_ADDRESS_V3_ATTR_SEG_SIZE  = UCS_BIT(4),
+    UCP_ADDRESS_V3_ATTR_FLAGS     = UCS_BIT(5)
+};
+
+
+/* Items which were already packed, referred by address version 3 */
+typedef struct {
+    uint16_t                           tl_name_csums[UCP_MAX_RESOURCES];
+    unsigned                           num_tl_names;
+    const void                         *dev_addrs[UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS];
+    uint8_t                            dev_addr_lens[UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS];
+    unsigned                           num_dev_addrs;
+    ucp_address_v2_packed_iface_attr_t iface_attr; /* Previous iface */
+} ucp_address_v3_ctx_t;
+
+
 enum {
     UCP_ADDRESS_HEADER_FLAG_DEBUG_INFO  = UCS_BIT(0),  /* Address has debug info */
     UCP_ADDRESS_HEADER_FLAG_WORKER_UUID = UCS_BIT(1),  /* Worker unique id */
@@ -238,11 +296,65 @@ static size_t ucp_address_iface_attr_size(ucp_worker_t *worker, uint64_t flags,
         return sizeof(ucp_address_unified_iface_attr_t);
     } else if (addr_version == UCP_OBJECT_VERSION_V1) {
         return sizeof(ucp_address_packed_iface_attr_t) + rsc_id_size;
-    } else {
+    } else if (addr_version == UCP_OBJECT_VERSION_V2) {
         return sizeof(ucp_address_v2_packed_iface_attr_t) + rsc_id_size;
+    } else {
+        /* Size of the attributes depends on the previous iface, and is added
+         * by ucp_address_v3_iface_attrs_size() */
+        return rsc_id_size;
     }
 }
 
+static size_t ucp_address_tl_name_size(ucp_object_version_t addr_version)
+{
+    return (addr_version == UCP_OBJECT_VERSION_V3) ? sizeof(uint8_t) :
+                                                     sizeof(uint16_t);
+}
+
+static void *ucp_address_pack_varint(void *ptr, uint64_t value)
+{
+    /* LEB128: 7 bits per byte, MSB set on all bytes but the last one */
+    while (value >= 0x80) {
+        *ucs_serialize_next(&ptr, uint8_t) = value | 0x80;
+        value                            >>= 7;
+    }
+
+    *ucs_serialize_next(&ptr, uint8_t) = value;
+    return ptr;
+}
+
+static const void *ucp_address_unpack_varint(const void *ptr, uint64_t *value_p)
+{
+    uint64_t value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+
+    do {
+        byte   = *ucs_serialize_next(&ptr, const uint8_t);
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && (shift < 64));
+
+    *value_p = value;
+    return ptr;
+}
+
+static uint8_t ucp_address_v3_tl_name_index(ucp_address_v3_ctx_t *ctx,
+                                            uint16_t tl_name_csum)
+{
+    unsigned i;
+
+    for (i = 0; i < ctx->num_tl_names; ++i) {
+        if (ctx->tl_name_csums[i] == tl_name_csum) {
+            return i;
+        }
+    }
+
+    ucs_assert(ctx->num_tl_names < UCP_MAX_RESOURCES);
+    ctx->tl_name_csums[ctx->num_tl_names] = tl_name_csum;
+    return ctx->num_tl_names++;
+}
+
 static uint64_t ucp_worker_iface_can_connect(uct_iface_attr_t *attrs)
 {
     return attrs->cap.flags &
@@ -364,6 +476,80 @@ static int ucp_address_pack_v1_extra_info(ucp_object_version_t addr_version,
            (pack_flags & UCP_ADDRESS_PACK_FLAG_RELEASE_VER_V1);
 }
 
+/* Find devices which have the same device address as a previous one, so it
+ * could be packed once with address version 3 */
+static ucs_status_t
+ucp_address_v3_share_dev_addrs(ucp_worker_h worker,
+                               ucp_address_packed_device_t *devices,
+                               ucp_rsc_index_t num_devices)
+{
+    ucp_address_packed_device_t *inline_devs[UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS];
+    const void *inline_addrs[UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS];
+    unsigned i, num_inline_devs = 0;
+    ucp_address_packed_device_t *dev;
+    size_t dev_addrs_size = 0;
+    ucp_worker_iface_t *wiface;
+    ucs_status_t status;
+    uint8_t *dev_addr;
+    void *dev_addrs;
+
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        if (dev->dev_addr_len > UINT8_MAX) {
+            ucs_debug("device %s: address length %zu is not supported by "
+                      "address version 3",
+                      worker->context->tl_rscs[dev->rsc_index].tl_rsc.dev_name,
+                      dev->dev_addr_len);
+            return UCS_ERR_UNSUPPORTED;
+        }
+
+        dev_addrs_size += dev->dev_addr_len;
+    }
+
+    dev_addrs = ucs_malloc(ucs_max(dev_addrs_size, 1), "ucp_address_dev_addrs");
+    if (dev_addrs == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    dev_addr = dev_addrs;
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        if (dev->dev_addr_len == 0) {
+            dev->dev_addr_ref = UCP_ADDRESS_V3_DEV_ADDR_NONE;
+            continue;
+        }
+
+        wiface = ucp_worker_iface(worker, dev->rsc_index);
+        status = uct_iface_get_device_address(wiface->iface,
+                                              (uct_device_addr_t*)dev_addr);
+        if (status != UCS_OK) {
+            goto out;
+        }
+
+        dev->dev_addr_ref = UCP_ADDRESS_V3_DEV_ADDR_INLINE;
+        for (i = 0; i < num_inline_devs; ++i) {
+            if ((inline_devs[i]->dev_addr_len == dev->dev_addr_len) &&
+                !memcmp(inline_addrs[i], dev_addr, dev->dev_addr_len)) {
+                dev->dev_addr_ref = i + 1;
+                break;
+            }
+        }
+
+        if ((dev->dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_INLINE) &&
+            (num_inline_devs < UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS)) {
+            inline_devs[num_inline_devs]  = dev;
+            inline_addrs[num_inline_devs] = dev_addr;
+            ++num_inline_devs;
+        }
+
+        dev_addr += dev->dev_addr_len;
+    }
+
+    status = UCS_OK;
+
+out:
+    ucs_free(dev_addrs);
+    return status;
+}
+
 static ucs_status_t
 ucp_address_gather_devices(ucp_worker_h worker, const ucp_ep_config_key_t *key,
                            const ucp_tl_bitmap_t *tl_bitmap, uint64_t flags,
@@ -380,6 +566,7 @@ ucp_address_gather_devices(ucp_worker_h worker, const ucp_ep_config_key_t *key,
     ucp_rsc_index_t rsc_index;
     ucp_lane_index_t lane;
     ssize_t length_size;
+    ucs_status_t status;
 
     devices = ucs_calloc(context->num_tls, sizeof(*devices), "packed_devices");
     if (devices == NULL) {
@@ -411,7 +598,8 @@ ucp_address_gather_devices(ucp_worker_h worker, const ucp_ep_config_key_t *key,
             }
         }
 
-        dev->tl_addrs_size += sizeof(uint16_t); /* tl name checksum */
+        /* tl name checksum or its index */
+        dev->tl_addrs_size += ucp_address_tl_name_size(addr_version);
 
         if (flags & UCP_ADDRESS_PACK_FLAG_IFACE_ADDR) {
             /* iface address (its length will be packed in non-unified mode only) */
@@ -461,17 +649,75 @@ ucp_address_gather_devices(ucp_worker_h worker, const ucp_ep_config_key_t *key,
         }
     }
 
+    if (addr_version == UCP_OBJECT_VERSION_V3) {
+        status = ucp_address_v3_share_dev_addrs(worker, devices, num_devices);
+        if (status != UCS_OK) {
+            ucs_free(devices);
+            return status;
+        }
+    }
+
     *devices_p     = devices;
     *num_devices_p = num_devices;
     return UCS_OK;
 }
 
+static void
+ucp_address_v3_gather_tl_names(ucp_context_h context,
+                               const ucp_address_packed_device_t *devices,
+                               ucp_rsc_index_t num_devices,
+                               ucp_address_v3_ctx_t *ctx)
+{
+    const ucp_address_packed_device_t *dev;
+    ucp_rsc_index_t rsc_index;
+
+    ctx->num_tl_names = 0;
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        UCS_STATIC_BITMAP_FOR_EACH_BIT(rsc_index, &dev->tl_bitmap) {
+            ucp_address_v3_tl_name_index(ctx,
+                                         context->tl_rscs[rsc_index].tl_name_csum);
+        }
+    }
+}
+
+static int ucp_address_pack_iface_attr(const ucp_worker_iface_t *wiface,
+                                       void *ptr, ucp_rsc_index_t rsc_index,
+                                       unsigned pack_flags,
+                                       ucp_object_version_t addr_version,
+                                       int enable_atomics,
+                                       ucp_address_v2_packed_iface_attr_t *prev_attr);
+
+static size_t
+ucp_address_v3_iface_attrs_size(ucp_worker_h worker,
+                                const ucp_address_packed_device_t *devices,
+                                ucp_rsc_index_t num_devices)
+{
+    ucp_address_v2_packed_iface_attr_t prev_attr = {0};
+    const ucp_address_packed_device_t *dev;
+    ucp_rsc_index_t rsc_index;
+    size_t size;
+
+    size = 0;
+    for (dev = devices; dev < (devices + num_devices); ++dev) {
+        UCS_STATIC_BITMAP_FOR_EACH_BIT(rsc_index, &dev->tl_bitmap) {
+            size += ucp_address_pack_iface_attr(
+                    ucp_worker_iface(worker, rsc_index), NULL, rsc_index, 0,
+                    UCP_OBJECT_VERSION_V3,
+                    UCS_STATIC_BITMAP_GET(worker->atomic_tls, rsc_index),
+                    &prev_attr);
+        }
+    }
+
+    return size;
+}
+
 static ssize_t
 ucp_address_packed_size(ucp_worker_h worker,
                         const ucp_address_packed_device_t *devices,
                         ucp_rsc_index_t num_devices, uint64_t pack_flags,
                         ucp_object_version_t addr_version)
 {
+    ucp_address_v3_ctx_t v3_ctx;
     size_t size = 0;
     ssize_t value_size;
     const ucp_address_packed_device_t *dev;
@@ -501,6 +747,19 @@ ucp_address_packed_size(ucp_worker_h worker,
     if (num_devices == 0) {
         size += 1; /* NULL md_index */
     } else {
+        if (addr_version == UCP_OBJECT_VERSION_V3) {
+            /* Transport names dictionary */
+            ucp_address_v3_gather_tl_names(worker->context, devices,
+                                           num_devices, &v3_ctx);
+            size += sizeof(uint8_t) + (sizeof(uint16_t) * v3_ctx.num_tl_names);
+
+            if (!ucp_worker_is_unified_mode(worker) &&
+                (pack_flags & UCP_ADDRESS_PACK_FLAG_IFACE_ADDR)) {
+                size += ucp_address_v3_iface_attrs_size(worker, devices,
+                                                        num_devices);
+            }
+        }
+
         for (dev = devices; dev < (devices + num_devices); ++dev) {
             rsc        = &worker->context->tl_rscs[dev->rsc_index];
             /* device md_index */
@@ -515,7 +774,14 @@ ucp_address_packed_size(ucp_worker_h worker,
             }
 
             size += value_size;
-            if (pack_flags & UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR) {
+            if (addr_version == UCP_OBJECT_VERSION_V3) {
+                /* device address reference */
+                size += 1;
+                if (dev->dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_INLINE) {
+                    /* device address length and device address */
+                    size += 1 + dev->dev_addr_len;
+                }
+            } else if (pack_flags & UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR) {
                 /* device address length */
                 value_size = ucp_address_packed_value_size(
                         dev->dev_addr_len, UCP_ADDRESS_DEVICE_LEN_MASK,
@@ -797,15 +1063,71 @@ ucp_address_pack_iface_attr_v2(const ucp_worker_iface_t *wiface, void *ptr,
     return sizeof(*packed);
 }
 
+/* Pack the fields of iface attributes which differ from the previous iface,
+ * or only return the packed size if ptr is NULL */
+static unsigned
+ucp_address_pack_iface_attr_v3(const ucp_address_v2_packed_iface_attr_t *attr,
+                               ucp_address_v2_packed_iface_attr_t *prev_attr,
+                               void *ptr)
+{
+    uint8_t buffer[UCP_ADDRESS_V3_IFACE_ATTR_MAX];
+    void *p           = buffer + 1;
+    uint8_t attr_mask = 0;
+    unsigned packed_len;
+
+    if (attr->overhead != prev_attr->overhead) {
+        attr_mask                       |= UCP_ADDRESS_V3_ATTR_OVERHEAD;
+        *ucs_serialize_next(&p, uint8_t) = attr->overhead;
+    }
+
+    if (attr->bandwidth != prev_attr->bandwidth) {
+        attr_mask                       |= UCP_ADDRESS_V3_ATTR_BANDWIDTH;
+        *ucs_serialize_next(&p, uint8_t) = attr->bandwidth;
+    }
+
+    if (attr->latency != prev_attr->latency) {
+        attr_mask                       |= UCP_ADDRESS_V3_ATTR_LATENCY;
+        *ucs_serialize_next(&p, uint8_t) = attr->latency;
+    }
+
+    if (attr->prio != prev_attr->prio) {
+        attr_mask                       |= UCP_ADDRESS_V3_ATTR_PRIO;
+        *ucs_serialize_next(&p, uint8_t) = attr->prio;
+    }
+
+    if (attr->seg_size != prev_attr->seg_size) {
+        attr_mask |= UCP_ADDRESS_V3_ATTR_SEG_SIZE;
+        p          = ucp_address_pack_varint(p, attr->seg_size);
+    }
+
+    if (attr->flags != prev_attr->flags) {
+        attr_mask |= UCP_ADDRESS_V3_ATTR_FLAGS;
+        p          = ucp_address_pack_varint(p, attr->flags);
+    }
+
+    buffer[0]  = attr_mask;
+    packed_len = UCS_PTR_BYTE_DIFF(buffer, p);
+    ucs_assert(packed_len <= sizeof(buffer));
+
+    if (ptr != NULL) {
+        memcpy(ptr, buffer, packed_len);
+    }
+
+    *prev_attr = *attr;
+    return packed_len;
+}
+
 static int ucp_address_pack_iface_attr(const ucp_worker_iface_t *wiface,
                                        void *ptr, ucp_rsc_index_t rsc_index,
                                        unsigned pack_flags,
                                        ucp_object_version_t addr_version,
-                                       int enable_atomics)
+                                       int enable_atomics,
+                                       ucp_address_v2_packed_iface_attr_t *prev_attr)
 {
     const uct_iface_attr_t *iface_attr = &wiface->attr;
     ucp_worker_h worker                = wiface->worker;
     unsigned atomic_flags              = 0;
+    ucp_address_v2_packed_iface_attr_t attr_v2;
     unsigned packed_len;
     double lat_ovh;
     ucp_address_unified_iface_attr_t *unified;
@@ -843,8 +1165,11 @@ static int ucp_address_pack_iface_attr(const ucp_worker_iface_t *wiface,
 
     if (addr_version == UCP_OBJECT_VERSION_V1) {
         packed_len = ucp_address_pack_iface_attr_v1(wiface, ptr, atomic_flags);
-    } else {
+    } else if (addr_version == UCP_OBJECT_VERSION_V2) {
         packed_len = ucp_address_pack_iface_attr_v2(wiface, ptr, atomic_flags);
+    } else {
+        ucp_address_pack_iface_attr_v2(wiface, &attr_v2, atomic_flags);
+        packed_len = ucp_address_pack_iface_attr_v3(&attr_v2, prev_attr, ptr);
     }
 
     if (pack_flags & UCP_ADDRESS_PACK_FLAG_TL_RSC_IDX) {
@@ -928,11 +1253,53 @@ ucp_address_unpack_iface_attr_v2(ucp_worker_t *worker,
     return sizeof(*packed);
 }
 
+static unsigned
+ucp_address_unpack_iface_attr_v3(ucp_worker_t *worker,
+                                 ucp_address_iface_attr_t *iface_attr,
+                                 const void *ptr,
+                                 ucp_address_v2_packed_iface_attr_t *prev_attr)
+{
+    const void *start = ptr;
+    uint8_t attr_mask = *ucs_serialize_next(&ptr, const uint8_t);
+    uint64_t value;
+
+    if (attr_mask & UCP_ADDRESS_V3_ATTR_OVERHEAD) {
+        prev_attr->overhead = *ucs_serialize_next(&ptr, const uint8_t);
+    }
+
+    if (attr_mask & UCP_ADDRESS_V3_ATTR_BANDWIDTH) {
+        prev_attr->bandwidth = *ucs_serialize_next(&ptr, const uint8_t);
+    }
+
+    if (attr_mask & UCP_ADDRESS_V3_ATTR_LATENCY) {
+        prev_attr->latency = *ucs_serialize_next(&ptr, const uint8_t);
+    }
+
+    if (attr_mask & UCP_ADDRESS_V3_ATTR_PRIO) {
+        prev_attr->prio = *ucs_serialize_next(&ptr, const uint8_t);
+    }
+
+    if (attr_mask & UCP_ADDRESS_V3_ATTR_SEG_SIZE) {
+        ptr                 = ucp_address_unpack_varint(ptr, &value);
+        prev_attr->seg_size = value;
+    }
+
+    if (attr_mask & UCP_ADDRESS_V3_ATTR_FLAGS) {
+        ptr              = ucp_address_unpack_varint(ptr, &value);
+        prev_attr->flags = value;
+    }
+
+    ucp_address_unpack_iface_attr_v2(worker, iface_attr, prev_attr);
+    return UCS_PTR_BYTE_DIFF(start, ptr);
+}
+
 static ucs_status_t
 ucp_address_unpack_iface_attr(ucp_worker_t *worker,
                               ucp_address_iface_attr_t *iface_attr,
                               const void *ptr, unsigned unpack_flags,
-                              ucp_object_version_t addr_version, size_t *size_p)
+                              ucp_object_version_t addr_version,
+                              ucp_address_v2_packed_iface_attr_t *prev_attr,
+                              size_t *size_p)
 {
     const ucp_address_unified_iface_attr_t *unified;
     ucp_worker_iface_t *wiface;
@@ -979,9 +1346,12 @@ ucp_address_unpack_iface_attr(ucp_worker_t *worker,
     if (addr_version == UCP_OBJECT_VERSION_V1) {
         iface_attr_len = ucp_address_unpack_iface_attr_v1(worker, iface_attr,
                                                           ptr);
-    } else {
+    } else if (addr_version == UCP_OBJECT_VERSION_V2) {
         iface_attr_len = ucp_address_unpack_iface_attr_v2(worker, iface_attr,
                                                           ptr);
+    } else {
+        iface_attr_len = ucp_address_unpack_iface_attr_v3(worker, iface_attr,
+                                                          ptr, prev_attr);
     }
 
     if (iface_attr->bandwidth <= 0) {
@@ -1138,7 +1508,8 @@ static void *ucp_address_unpack_header(const void *ptr,
         return UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
     }
 
-    ucs_assertv_always(*addr_version == UCP_OBJECT_VERSION_V2,
+    ucs_assertv_always((*addr_version == UCP_OBJECT_VERSION_V2) ||
+                       (*addr_version == UCP_OBJECT_VERSION_V3),
                        "addr version %u", *addr_version);
 
     *addr_flags  = *(addr_header + 1);
@@ -1202,6 +1573,7 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
 {
     ucp_context_h context = worker->context;
     const ucp_address_packed_device_t *dev;
+    ucp_address_v3_ctx_t v3_ctx;
     uint8_t *address_header_p;
     uct_iface_attr_t *iface_attr;
     ucp_md_index_t md_index;
@@ -1263,6 +1635,16 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
         goto out;
     }
 
+    if (addr_version == UCP_OBJECT_VERSION_V3) {
+        /* Transport names dictionary */
+        ucp_address_v3_gather_tl_names(context, devices, num_devices, &v3_ctx);
+        *ucs_serialize_next(&ptr, uint8_t) = v3_ctx.num_tl_names;
+        memcpy(ptr, v3_ctx.tl_name_csums,
+               sizeof(uint16_t) * v3_ctx.num_tl_names);
+        ptr = UCS_PTR_BYTE_OFFSET(ptr, sizeof(uint16_t) * v3_ctx.num_tl_names);
+        memset(&v3_ctx.iface_attr, 0, sizeof(v3_ctx.iface_attr));
+    }
+
     for (dev = devices; dev < (devices + num_devices); ++dev) {
         dev_tl_bitmap = context->tl_bitmap;
         UCS_STATIC_BITMAP_AND_INPLACE(&dev_tl_bitmap, dev->tl_bitmap);
@@ -1275,9 +1657,16 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
         dev_flags_ptr = ptr;
         ucs_assert_always((pack_flags & UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR) ||
                           (dev->dev_addr_len == 0));
-        ptr = ucp_address_pack_byte_extended(ptr, dev->dev_addr_len,
-                                             UCP_ADDRESS_DEVICE_LEN_MASK,
-                                             addr_version);
+        if (addr_version == UCP_OBJECT_VERSION_V3) {
+            *ucs_serialize_next(&ptr, uint8_t) = dev->dev_addr_ref;
+            if (dev->dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_INLINE) {
+                *ucs_serialize_next(&ptr, uint8_t) = dev->dev_addr_len;
+            }
+        } else {
+            ptr = ucp_address_pack_byte_extended(ptr, dev->dev_addr_len,
+                                                 UCP_ADDRESS_DEVICE_LEN_MASK,
+                                                 addr_version);
+        }
 
         /* Device number of paths flag and value */
         ucs_assert(dev->num_paths >= 1);
@@ -1295,8 +1684,10 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
             ptr                       = UCS_PTR_TYPE_OFFSET(ptr, uint8_t);
         }
 
-        /* Device address */
-        if (pack_flags & UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR) {
+        /* Device address, unless it is a reference to a previous one */
+        if ((pack_flags & UCP_ADDRESS_PACK_FLAG_DEVICE_ADDR) &&
+            ((addr_version != UCP_OBJECT_VERSION_V3) ||
+             (dev->dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_INLINE))) {
             wiface = ucp_worker_iface(worker, dev->rsc_index);
             status = uct_iface_get_device_address(wiface->iface,
                                                   (uct_device_addr_t*)ptr);
@@ -1327,16 +1718,24 @@ ucp_address_do_pack(ucp_worker_h worker, ucp_ep_h ep, void *buffer, size_t size,
                 return UCS_ERR_INVALID_ADDR;
             }
 
-            /* Transport name checksum */
-            *(uint16_t*)ptr = context->tl_rscs[rsc_index].tl_name_csum;
-            ptr = UCS_PTR_TYPE_OFFSET(ptr,
-                                      context->tl_rscs[rsc_index].tl_name_csum);
+            /* Transport name checksum, or its index in the dictionary */
+            if (addr_version == UCP_OBJECT_VERSION_V3) {
+                *ucs_serialize_next(&ptr, uint8_t) =
+                        ucp_address_v3_tl_name_index(
+                                &v3_ctx,
+                                context->tl_rscs[rsc_index].tl_name_csum);
+            } else {
+                *(uint16_t*)ptr = context->tl_rscs[rsc_index].tl_name_csum;
+                ptr = UCS_PTR_TYPE_OFFSET(ptr,
+                                          context->tl_rscs[rsc_index].tl_name_csum);
+            }
 
             /* Transport information */
             enable_amo = UCS_STATIC_BITMAP_GET(worker->atomic_tls, rsc_index);
             attr_len   = ucp_address_pack_iface_attr(wiface, ptr, rsc_index,
                                                      pack_flags, addr_version,
-                                                     enable_amo);
+                                                     enable_amo,
+                                                     &v3_ctx.iface_attr);
             if (attr_len < 0) {
                 return UCS_ERR_INVALID_ADDR;
             }
@@ -1656,6 +2055,8 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     UCS_ARRAY_DEFINE_ONSTACK(ucp_address_remote_device_array_t,
                              remote_device_array, UCP_MAX_RESOURCES);
     ucp_address_entry_t *address_list, *address;
+    ucp_address_v3_ctx_t v3_ctx;
+    uint8_t dev_addr_ref;
     uint8_t addr_flags;
     ucp_object_version_t addr_version;
     unsigned dst_version;
@@ -1669,6 +2070,7 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     ucs_status_t status;
     int empty_dev;
     uint8_t dev_addr_len, iface_addr_len, ep_addr_len;
+    uint8_t tl_name_index;
     size_t attr_len;
     uint8_t flags;
     const void *ptr;
@@ -1730,6 +2132,24 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
         return UCS_ERR_NO_MEMORY;
     }
 
+    if (addr_version == UCP_OBJECT_VERSION_V3) {
+        /* Transport names dictionary */
+        v3_ctx.num_tl_names  = *ucs_serialize_next(&ptr, const uint8_t);
+        v3_ctx.num_dev_addrs = 0;
+        if (v3_ctx.num_tl_names > UCP_MAX_RESOURCES) {
+            ucp_address_error(unpack_flags,
+                              "failed to parse address: number of transport"
+                              " names %u exceeds %d",
+                              v3_ctx.num_tl_names, UCP_MAX_RESOURCES);
+            goto err_free;
+        }
+
+        memcpy(v3_ctx.tl_name_csums, ptr,
+               sizeof(uint16_t) * v3_ctx.num_tl_names);
+        ptr = UCS_PTR_BYTE_OFFSET(ptr, sizeof(uint16_t) * v3_ctx.num_tl_names);
+        memset(&v3_ctx.iface_attr, 0, sizeof(v3_ctx.iface_attr));
+    }
+
     /* Unpack addresses */
     address   = address_list;
     dev_index = 0;
@@ -1742,8 +2162,20 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
         /* device address length */
         flags    = (*(uint8_t*)ptr) & ~UCP_ADDRESS_DEVICE_LEN_MASK;
         last_dev = flags & UCP_ADDRESS_FLAG_LAST;
-        ptr = ucp_address_unpack_byte_extended(ptr, UCP_ADDRESS_DEVICE_LEN_MASK,
-                                               addr_version, &dev_addr_len);
+        if (addr_version == UCP_OBJECT_VERSION_V3) {
+            dev_addr_ref = *ucs_serialize_next(&ptr, const uint8_t) &
+                           UCP_ADDRESS_DEVICE_LEN_MASK;
+            if (dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_INLINE) {
+                dev_addr_len = *ucs_serialize_next(&ptr, const uint8_t);
+            } else {
+                dev_addr_len = 0;
+            }
+        } else {
+            dev_addr_ref = UCP_ADDRESS_V3_DEV_ADDR_INLINE;
+            ptr = ucp_address_unpack_byte_extended(ptr,
+                                                   UCP_ADDRESS_DEVICE_LEN_MASK,
+                                                   addr_version, &dev_addr_len);
+        }
 
         if (flags & UCP_ADDRESS_FLAG_NUM_PATHS) {
             dev_num_paths = *(uint8_t*)ptr;
@@ -1769,8 +2201,27 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                               "unpacked dst release version %u", dst_version);
         }
 
-        dev_addr = ptr;
-        ptr      = UCS_PTR_BYTE_OFFSET(ptr, dev_addr_len);
+        if (dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_INLINE) {
+            dev_addr = ptr;
+            ptr      = UCS_PTR_BYTE_OFFSET(ptr, dev_addr_len);
+            if ((addr_version == UCP_OBJECT_VERSION_V3) &&
+                (v3_ctx.num_dev_addrs < UCP_ADDRESS_V3_MAX_DEV_ADDR_REFS)) {
+                v3_ctx.dev_addrs[v3_ctx.num_dev_addrs]     = dev_addr;
+                v3_ctx.dev_addr_lens[v3_ctx.num_dev_addrs] = dev_addr_len;
+                ++v3_ctx.num_dev_addrs;
+            }
+        } else if (dev_addr_ref == UCP_ADDRESS_V3_DEV_ADDR_NONE) {
+            dev_addr = NULL;
+        } else if (dev_addr_ref <= v3_ctx.num_dev_addrs) {
+            /* Reference to a device address packed by a previous device */
+            dev_addr     = v3_ctx.dev_addrs[dev_addr_ref - 1];
+            dev_addr_len = v3_ctx.dev_addr_lens[dev_addr_ref - 1];
+        } else {
+            ucp_address_error(unpack_flags,
+                              "failed to parse address: invalid device address"
+                              " reference %u", dev_addr_ref);
+            goto err_free;
+        }
 
         last_tl = empty_dev;
         while (!last_tl) {
@@ -1782,9 +2233,22 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
                 goto err_free;
             }
 
-            /* tl_name_csum */
-            address->tl_name_csum = *(uint16_t*)ptr;
-            ptr = UCS_PTR_TYPE_OFFSET(ptr, address->tl_name_csum);
+            /* tl_name_csum, or its index in the dictionary */
+            if (addr_version == UCP_OBJECT_VERSION_V3) {
+                tl_name_index = *ucs_serialize_next(&ptr, const uint8_t);
+                if (tl_name_index >= v3_ctx.num_tl_names) {
+                    ucp_address_error(unpack_flags,
+                                      "failed to parse address: invalid"
+                                      " transport name index %u",
+                                      tl_name_index);
+                    goto err_free;
+                }
+
+                address->tl_name_csum = v3_ctx.tl_name_csums[tl_name_index];
+            } else {
+                address->tl_name_csum = *(uint16_t*)ptr;
+                ptr = UCS_PTR_TYPE_OFFSET(ptr, address->tl_name_csum);
+            }
 
             address->dev_addr      = (dev_addr_len > 0) ? dev_addr : NULL;
             address->dev_addr_len  = dev_addr_len;
@@ -1797,7 +2261,9 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
             status = ucp_address_unpack_iface_attr(worker, &address->iface_attr,
                                                    ptr, unpack_flags,
-                                                   addr_version, &attr_len);
+                                                   addr_version,
+                                                   &v3_ctx.iface_attr,
+                                                   &attr_len);
             if (status != UCS_OK) {
                 goto err_free;
             }
@@ -1882,3 +2348,55 @@ err_free:
     ucs_free(address_list);
     return UCS_ERR_INVALID_PARAM;
 }
+
+ucs_status_t ucp_address_dup(const ucp_unpacked_address_t *src,
+                             ucp_unpacked_address_t *dst)
+{
+    size_t size = src->address_count * sizeof(*src->address_list);
+    const ucp_address_entry_t *src_ae;
+    ucp_address_entry_t *dst_ae;
+    unsigned i;
+    void *ptr;
+
+    ucp_unpacked_address_for_each(src_ae, src) {
+        size += src_ae->dev_addr_len + src_ae->iface_addr_len;
+        for (i = 0; i < src_ae->num_ep_addrs; ++i) {
+            size += src_ae->ep_addrs[i].len;
+        }
+    }
+
+    *dst              = *src;
+    dst->address_list = ucs_malloc(ucs_max(size, 1), "ucp_address_dup");
+    if (dst->address_list == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* Copy the entries, followed by the transport addresses they point to */
+    memcpy(dst->address_list, src->address_list,
+           src->address_count * sizeof(*src->address_list));
+    ptr = dst->address_list + src->address_count;
+
+    for (dst_ae = dst->address_list;
+         dst_ae < dst->address_list + dst->address_count; ++dst_ae) {
+        if (dst_ae->dev_addr != NULL) {
+            dst_ae->dev_addr = memcpy(ptr, dst_ae->dev_addr,
+                                      dst_ae->dev_addr_len);
+            ptr              = UCS_PTR_BYTE_OFFSET(ptr, dst_ae->dev_addr_len);
+        }
+
+        if (dst_ae->iface_addr != NULL) {
+            dst_ae->iface_addr = memcpy(ptr, dst_ae->iface_addr,
+                                        dst_ae->iface_addr_len);
+            ptr                = UCS_PTR_BYTE_OFFSET(ptr,
+                                                     dst_ae->iface_addr_len);
+        }
+
+        for (i = 0; i < dst_ae->num_ep_addrs; ++i) {
+            dst_ae->ep_addrs[i].addr = memcpy(ptr, dst_ae->ep_addrs[i].addr,
+                                              dst_ae->ep_addrs[i].len);
+            ptr = UCS_PTR_BYTE_OFFSET(ptr, dst_ae->ep_addrs[i].len);
+        }
+    }
+
+    return UCS_OK;
+}
@@ -258,6 +258,18 @@ ucs_status_t ucp_address_unpack(ucp_worker_h worker, const void *buffer,
                                 ucp_unpacked_address_t *unpacked_address);
 
 
+/**
+ * Copy an unpacked address, together with the transport addresses it points
+ * to, so it does not depend on the packed address buffer.
+ *
+ * @param [in]  src  Unpacked address to copy.
+ * @param [out] dst  Filled with the copy. Its address list should be released
+ *                   by ucs_free().
+ */
+ucs_status_t ucp_address_dup(const ucp_unpacked_address_t *src,
+                             ucp_unpacked_address_t *dst);
+
+
 /**
  * Unpack worker unique id from the given address.
  *
@@ -1107,7 +1107,7 @@ ucp_wireup_iface_score_bandwidth(const ucp_worker_iface_t *wiface,
         local_bw = ucp_wireup_iface_bw_distance(wiface);
     }
 
-    if (unpacked_addr->addr_version == UCP_OBJECT_VERSION_V2) {
+    if (unpacked_addr->addr_version != UCP_OBJECT_VERSION_V1) {
         /* FP8 is a lossy compression method, so in order to create a symmetric
          * calculation we pack/unpack the local bandwidth as well */
         local_bw = UCS_FP8_PACK_UNPACK(BANDWIDTH, local_bw);
@@ -1425,7 +1425,7 @@ ucp_wireup_iface_avail_bandwidth(const ucp_worker_iface_t *wiface,
 
     local_bw = ucp_wireup_iface_bw_distance(wiface);
 
-    if (unpacked_addr->addr_version == UCP_OBJECT_VERSION_V2) {
+    if (unpacked_addr->addr_version != UCP_OBJECT_VERSION_V1) {
         /* FP8 is a lossy compression method, so in order to create a symmetric
          * calculation we pack/unpack the local bandwidth as well */
         local_bw = UCS_FP8_PACK_UNPACK(BANDWIDTH, local_bw);
@@ -1675,7 +1675,7 @@ static double ucp_wireup_get_lane_bw(ucp_worker_h worker,
 
     bw_remote  = address->address_list[sinfo->addr_index].iface_attr.bandwidth;
 
-    if (address->addr_version == UCP_OBJECT_VERSION_V2) {
+    if (address->addr_version != UCP_OBJECT_VERSION_V1) {
         /* FP8 is a lossy compression method, so in order to create a symmetric
          * calculation we pack/unpack the local bandwidth as well */
         bw_local = UCS_FP8_PACK_UNPACK(BANDWIDTH, bw_local);
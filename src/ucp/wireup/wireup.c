@@ -13,6 +13,7 @@
 #include "wireup_cm.h"
 #include "wireup_ep.h"
 
+#include <ucs/algorithm/crc.h>
 #include <ucs/async/async.h>
 #include <ucs/datastruct/queue.h>
 #include <ucp/core/ucp_ep.h>
@@ -1622,7 +1623,7 @@ ucp_wireup_check_is_reconfigurable(ucp_ep_h ep,
     const ucp_ep_config_key_t *old_key;
 
     if ((ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) ||
-        ucp_ep_has_cm_lane(ep)) {
+        ucp_ep_has_cm_lane(ep) || (ep->flags & UCP_EP_FLAG_LAZY_CONNECT)) {
         return 1;
     }
 
@@ -1832,6 +1833,15 @@ ucp_wireup_check_config_intersect(ucp_ep_h ep, ucp_ep_config_key_t *new_key,
     *connect_lane_bitmap = UCS_MASK(new_key->num_lanes);
     *am_need_flush_p     = 0;
 
+    if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+        /* Replace the stub endpoint, its pending requests were already
+         * gathered for replay */
+        uct_ep_destroy(ucp_ep_get_lane(ep, 0));
+        ucp_ep_set_lane(ep, 0, NULL);
+        ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_LAZY_CONNECT);
+        return ucp_ep_realloc_lanes(ep, new_key->num_lanes);
+    }
+
     if ((ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) ||
         !ucp_wireup_check_is_reconfigurable(ep, new_key, remote_address,
                                             addr_indices)) {
@@ -1931,6 +1941,289 @@ ucp_wireup_check_config_intersect(ucp_ep_h ep, ucp_ep_config_key_t *new_key,
     return UCS_OK;
 }
 
+/* Lane selection result, cached by the fingerprint of its input */
+struct ucp_wireup_select_cache_entry {
+    ucp_wireup_select_cache_entry_t *next;     /* Entry with the same hash */
+    ucp_ep_config_key_t             key;       /* Selected configuration */
+    ucp_rsc_index_t                 dst_mds[UCP_MAX_MDS];
+    unsigned                        addr_indices[UCP_MAX_LANES];
+    size_t                          fp_length; /* Length of the fingerprint */
+    uint8_t                         fp[0];     /* Fingerprint */
+};
+
+
+typedef struct {
+    uint8_t *buffer; /* NULL if only the length is calculated */
+    size_t  length;
+} ucp_wireup_select_fp_t;
+
+
+__KHASH_IMPL(ucp_worker_select_cache, kh_inline, uint32_t,
+             ucp_wireup_select_cache_entry_t*, 1, kh_int_hash_func,
+             kh_int_hash_equal);
+
+
+static void ucp_wireup_select_fp_add(ucp_wireup_select_fp_t *fp,
+                                     const void *data, size_t length)
+{
+    if (fp->buffer != NULL) {
+        memcpy(fp->buffer + fp->length, data, length);
+    }
+
+    fp->length += length;
+}
+
+#define ucp_wireup_select_fp_add_field(_fp, _field) \
+    ucp_wireup_select_fp_add(_fp, &(_field), sizeof(_field))
+
+static int ucp_wireup_select_fp_is_local(ucp_ep_h ep,
+                                          ucp_rsc_index_t rsc_index,
+                                          const ucp_address_entry_t *ae)
+{
+    ucp_worker_iface_t *wiface = ucp_worker_iface(ep->worker, rsc_index);
+    uct_iface_is_reachable_params_t params;
+
+    /* Same check as the intra-node locality of the selected lanes */
+    if (wiface->attr.device_addr_len == 0) {
+        return 0;
+    }
+
+    params.field_mask         = UCT_IFACE_IS_REACHABLE_FIELD_DEVICE_ADDR |
+                                UCT_IFACE_IS_REACHABLE_FIELD_IFACE_ADDR |
+                                UCT_IFACE_IS_REACHABLE_FIELD_SCOPE |
+                                UCT_IFACE_IS_REACHABLE_FIELD_DEVICE_ADDR_LENGTH |
+                                UCT_IFACE_IS_REACHABLE_FIELD_IFACE_ADDR_LENGTH;
+    params.device_addr        = ae->dev_addr;
+    params.iface_addr         = ae->iface_addr;
+    params.device_addr_length = ae->dev_addr_len;
+    params.iface_addr_length  = ae->iface_addr_len;
+    params.scope              = UCT_IFACE_REACHABILITY_SCOPE_DEVICE;
+
+    return uct_iface_is_reachable_v2(wiface->iface, &params);
+}
+
+static void
+ucp_wireup_select_fp_add_reachable(ucp_wireup_select_fp_t *fp, ucp_ep_h ep,
+                                   unsigned ep_init_flags,
+                                   const ucp_address_entry_t *ae)
+{
+    ucp_context_h context = ep->worker->context;
+    ucp_tl_bitmap_t reachable, local;
+    ucp_rsc_index_t rsc_index;
+
+    if (fp->buffer == NULL) {
+        fp->length += sizeof(reachable) + sizeof(local);
+        return;
+    }
+
+    UCS_STATIC_BITMAP_RESET_ALL(&reachable);
+    UCS_STATIC_BITMAP_RESET_ALL(&local);
+    UCS_STATIC_BITMAP_FOR_EACH_BIT(rsc_index, &context->tl_bitmap) {
+        if (!ucp_wireup_is_reachable(ep, ep_init_flags, rsc_index, ae, NULL,
+                                     0)) {
+            continue;
+        }
+
+        UCS_STATIC_BITMAP_SET(&reachable, rsc_index);
+        if (ucp_wireup_select_fp_is_local(ep, rsc_index, ae)) {
+            UCS_STATIC_BITMAP_SET(&local, rsc_index);
+        }
+    }
+
+    ucp_wireup_select_fp_add_field(fp, reachable);
+    ucp_wireup_select_fp_add_field(fp, local);
+}
+
+/*
+ * Serialize all the inputs of lane selection. The device and interface
+ * addresses of the remote entries are represented only by the set of local
+ * resources which can reach them, and the subset of those which are on the
+ * same device (which determines the intra-node locality of the selected
+ * configuration). So peers with the same capabilities and locality have the
+ * same fingerprint.
+ */
+static void
+ucp_wireup_select_fp_pack(ucp_ep_h ep, unsigned ep_init_flags,
+                          const ucp_tl_bitmap_t *tl_bitmap,
+                          const ucp_unpacked_address_t *remote_address,
+                          ucp_wireup_select_fp_t *fp)
+{
+    uint8_t loopback = (remote_address->uuid == ep->worker->uuid);
+    uint8_t is_lower = (ep->worker->uuid < remote_address->uuid);
+    const ucp_address_entry_t *ae;
+    unsigned i;
+
+    fp->length = 0;
+    ucp_wireup_select_fp_add_field(fp, ep_init_flags);
+    ucp_wireup_select_fp_add_field(fp, *tl_bitmap);
+    ucp_wireup_select_fp_add_field(fp, loopback);
+    ucp_wireup_select_fp_add_field(fp, is_lower);
+    ucp_wireup_select_fp_add_field(fp, remote_address->addr_version);
+    ucp_wireup_select_fp_add_field(fp, remote_address->dst_version);
+    ucp_wireup_select_fp_add_field(fp, remote_address->address_count);
+
+    ucp_unpacked_address_for_each(ae, remote_address) {
+        ucp_wireup_select_fp_add_field(fp, ae->tl_name_csum);
+        ucp_wireup_select_fp_add_field(fp, ae->md_index);
+        ucp_wireup_select_fp_add_field(fp, ae->sys_dev);
+        ucp_wireup_select_fp_add_field(fp, ae->dev_index);
+        ucp_wireup_select_fp_add_field(fp, ae->dev_num_paths);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.flags);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.overhead);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.bandwidth);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.priority);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.lat_ovh);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.atomic);
+        ucp_wireup_select_fp_add_field(fp, ae->iface_attr.seg_size);
+        ucp_wireup_select_fp_add_reachable(fp, ep, ep_init_flags, ae);
+        ucp_wireup_select_fp_add_field(fp, ae->num_ep_addrs);
+        for (i = 0; i < ae->num_ep_addrs; ++i) {
+            ucp_wireup_select_fp_add_field(fp, ae->ep_addrs[i].lane);
+            ucp_wireup_select_fp_add_field(fp, ae->ep_addrs[i].len);
+        }
+    }
+}
+
+static int ucp_wireup_select_cache_is_enabled(ucp_ep_h ep,
+                                              unsigned ep_init_flags)
+{
+    /* Selection of an endpoint which has a configuration depends also on the
+     * configuration, and selection with CM depends on the local device */
+    return ep->worker->context->config.ext.wireup_select_cache &&
+           !ucp_ep_init_flags_has_cm(ep_init_flags) &&
+           ((ep->cfg_index == UCP_WORKER_CFG_INDEX_NULL) ||
+            (ep->flags & UCP_EP_FLAG_LAZY_CONNECT));
+}
+
+static ucp_wireup_select_cache_entry_t *
+ucp_wireup_select_cache_entry_alloc(ucp_ep_h ep, unsigned ep_init_flags,
+                                    const ucp_tl_bitmap_t *tl_bitmap,
+                                    const ucp_unpacked_address_t *remote_address)
+{
+    ucp_wireup_select_fp_t fp = {.buffer = NULL};
+    ucp_wireup_select_cache_entry_t *entry;
+
+    ucp_wireup_select_fp_pack(ep, ep_init_flags, tl_bitmap, remote_address,
+                              &fp);
+
+    entry = ucs_malloc(sizeof(*entry) + fp.length,
+                       "ucp_wireup_select_cache_entry");
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    fp.buffer = entry->fp;
+    ucp_wireup_select_fp_pack(ep, ep_init_flags, tl_bitmap, remote_address,
+                              &fp);
+    entry->fp_length = fp.length;
+    entry->next      = NULL;
+    return entry;
+}
+
+static ucp_wireup_select_cache_entry_t *
+ucp_wireup_select_cache_find(ucp_worker_h worker,
+                             const ucp_wireup_select_cache_entry_t *lookup,
+                             uint32_t hash)
+{
+    ucp_wireup_select_cache_entry_t *entry;
+    khiter_t iter;
+
+    iter = kh_get(ucp_worker_select_cache, &worker->select_cache, hash);
+    if (iter == kh_end(&worker->select_cache)) {
+        return NULL;
+    }
+
+    for (entry = kh_val(&worker->select_cache, iter); entry != NULL;
+         entry = entry->next) {
+        if ((entry->fp_length == lookup->fp_length) &&
+            !memcmp(entry->fp, lookup->fp, entry->fp_length)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void ucp_wireup_select_cache_add(ucp_worker_h worker,
+                                        ucp_wireup_select_cache_entry_t *entry,
+                                        uint32_t hash)
+{
+    khiter_t iter;
+    int ret;
+
+    iter = kh_put(ucp_worker_select_cache, &worker->select_cache, hash, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        ucs_free(entry);
+        return;
+    }
+
+    entry->next = (ret == UCS_KH_PUT_KEY_PRESENT) ?
+                  kh_val(&worker->select_cache, iter) : NULL;
+    kh_val(&worker->select_cache, iter) = entry;
+}
+
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker)
+{
+    ucp_wireup_select_cache_entry_t *entry, *next;
+
+    kh_foreach_value(&worker->select_cache, entry, {
+        for (; entry != NULL; entry = next) {
+            next = entry->next;
+            ucs_free(entry);
+        }
+    });
+
+    kh_destroy_inplace(ucp_worker_select_cache, &worker->select_cache);
+}
+
+static ucs_status_t
+ucp_wireup_select_lanes_cached(ucp_ep_h ep, unsigned ep_init_flags,
+                               const ucp_tl_bitmap_t *tl_bitmap,
+                               const ucp_unpacked_address_t *remote_address,
+                               unsigned *addr_indices, ucp_ep_config_key_t *key)
+{
+    ucp_rsc_index_t *dst_md_storage = key->dst_md_cmpts;
+    ucp_wireup_select_cache_entry_t *lookup, *entry;
+    ucs_status_t status;
+    uint32_t hash;
+
+    lookup = ucp_wireup_select_cache_entry_alloc(ep, ep_init_flags, tl_bitmap,
+                                                 remote_address);
+    if (lookup == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    hash  = ucs_crc32(0, lookup->fp, lookup->fp_length);
+    entry = ucp_wireup_select_cache_find(ep->worker, lookup, hash);
+    if (entry != NULL) {
+        ucs_trace("ep %p: using cached lane selection for %s", ep,
+                  remote_address->name);
+        ucs_free(lookup);
+        *key = entry->key;
+        memcpy(dst_md_storage, entry->dst_mds, sizeof(entry->dst_mds));
+        memcpy(addr_indices, entry->addr_indices,
+               sizeof(entry->addr_indices));
+        key->dst_md_cmpts = dst_md_storage;
+        return UCS_OK;
+    }
+
+    status = ucp_wireup_select_lanes(ep, ep_init_flags, *tl_bitmap,
+                                     remote_address, addr_indices, key, 1);
+    if (status != UCS_OK) {
+        ucs_free(lookup);
+        return status;
+    }
+
+    ucp_wireup_get_reachable_mds(ep, ep_init_flags, remote_address, key);
+
+    lookup->key              = *key;
+    lookup->key.dst_md_cmpts = NULL;
+    memcpy(lookup->dst_mds, dst_md_storage, sizeof(lookup->dst_mds));
+    memcpy(lookup->addr_indices, addr_indices, sizeof(lookup->addr_indices));
+    ucp_wireup_select_cache_add(ep->worker, lookup, hash);
+    return UCS_OK;
+}
+
 static ucs_status_t
 ucp_wireup_try_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
                             const ucp_tl_bitmap_t *tl_bitmap,
@@ -1946,6 +2239,12 @@ ucp_wireup_try_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
     key->dst_version  = remote_address->dst_version;
     key->dst_md_cmpts = dst_md_storage;
 
+    if (ucp_wireup_select_cache_is_enabled(ep, ep_init_flags)) {
+        return ucp_wireup_select_lanes_cached(ep, ep_init_flags, tl_bitmap,
+                                              remote_address, addr_indices,
+                                              key);
+    }
+
     status = ucp_wireup_select_lanes(ep, ep_init_flags, *tl_bitmap,
                                      remote_address, addr_indices, key, 1);
     if (status != UCS_OK) {
@@ -2020,6 +2319,13 @@ ucs_status_t ucp_wireup_init_lanes(ucp_ep_h ep, unsigned ep_init_flags,
     ucs_trace("ep %p: initialize lanes", ep);
     ucs_log_indent(1);
 
+    if ((ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
+        (ucp_ep_config(ep)->key.flags & UCP_EP_CONFIG_KEY_FLAG_COMPRESS)) {
+        /* Keep the endpoint preference when it is reconfigured by a wireup
+         * message from the peer */
+        ep_init_flags |= UCP_EP_INIT_FLAG_COMPRESS;
+    }
+
     if (!ucp_ep_has_cm_lane(ep)) {
         ucp_ep_update_flags(ep, 0,
                             UCP_EP_FLAG_LOCAL_CONNECTED |
@@ -2180,6 +2486,70 @@ ucs_status_t ucp_wireup_send_request(ucp_ep_h ep)
     return status;
 }
 
+unsigned ucp_wireup_lazy_connect_progress(void *arg)
+{
+    ucp_ep_h ep = arg;
+    unsigned addr_indices[UCP_MAX_LANES];
+    ucp_unpacked_address_t *remote_address;
+    ucs_queue_head_t tmp_pending_queue;
+    ucp_wireup_ep_t *wireup_ep;
+    unsigned ep_init_flags;
+    ucs_status_t status;
+    int am_need_flush, resolve_id;
+
+    UCS_ASYNC_BLOCK(&ep->worker->async);
+
+    /* The endpoint could be connected by a wireup request from the peer */
+    if (!(ep->flags & UCP_EP_FLAG_LAZY_CONNECT) ||
+        (ep->flags & UCP_EP_FLAG_FAILED)) {
+        goto out_unblock;
+    }
+
+    wireup_ep      = ucp_wireup_ep(ucp_ep_get_lane(ep, 0));
+    ep_init_flags  = wireup_ep->ep_init_flags;
+    resolve_id     = wireup_ep->flags & UCP_WIREUP_EP_FLAG_RESOLVE_ID;
+    remote_address = ucp_wireup_ep_detach_lazy(wireup_ep);
+
+    ucs_debug("ep %p: connect to %s on first use", ep, remote_address->name);
+
+    /* Hold the queued requests until the remote id is resolved, since they
+     * could be initialized without it */
+    ucp_wireup_eps_pending_extract(ep, &tmp_pending_queue);
+
+    /* The stub endpoint is destroyed when the lanes are initialized */
+    status = ucp_wireup_init_lanes(ep, ep_init_flags, &ucp_tl_bitmap_max,
+                                   remote_address, addr_indices,
+                                   &am_need_flush);
+    if (status != UCS_OK) {
+        goto err_set_failed;
+    }
+
+    if (!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED)) {
+        status = ucp_wireup_send_request(ep);
+    } else if (resolve_id) {
+        status = ucp_ep_resolve_remote_id(ep, ep->am_lane);
+    } else {
+        status = UCS_OK;
+    }
+
+    if (status != UCS_OK) {
+        goto err_set_failed;
+    }
+
+    goto out_replay;
+
+err_set_failed:
+    ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_LAZY_CONNECT);
+    ucp_ep_set_lanes_failed(ep, 0, status);
+out_replay:
+    ucp_wireup_replay_pending_requests(ep, &tmp_pending_queue);
+    ucs_free(remote_address->address_list);
+    ucs_free(remote_address);
+out_unblock:
+    UCS_ASYNC_UNBLOCK(&ep->worker->async);
+    return 1;
+}
+
 ucs_status_t ucp_wireup_send_pre_request(ucp_ep_h ep)
 {
     ucs_status_t status;
@@ -2213,6 +2583,10 @@ ucs_status_t ucp_wireup_connect_remote(ucp_ep_h ep, ucp_lane_index_t lane)
      */
     if ((ep->flags & (UCP_EP_FLAG_REMOTE_ID | UCP_EP_FLAG_FAILED)) ||
         ucp_wireup_ep_test(uct_ep)) {
+        if (ep->flags & UCP_EP_FLAG_LAZY_CONNECT) {
+            ucp_wireup_ep(uct_ep)->flags |= UCP_WIREUP_EP_FLAG_RESOLVE_ID;
+        }
+
         status = UCS_OK;
         goto out_unlock;
     }
@@ -2432,6 +2806,11 @@ unsigned ucp_ep_init_flags(const ucp_worker_h worker,
         flags |= UCP_EP_INIT_CREATE_AM_LANE;
     }
 
+    if (UCP_PARAM_VALUE(EP, params, flags, FLAGS, 0) &
+        UCP_EP_PARAMS_FLAGS_COMPRESS) {
+        flags |= UCP_EP_INIT_FLAG_COMPRESS;
+    }
+
     return flags |
            ucp_ep_err_mode_init_flags(ucp_ep_params_err_handling_mode(params));
 }
@@ -257,6 +257,19 @@ uct_ep_h ucp_wireup_extract_lane(ucp_ep_h ep, ucp_lane_index_t lane);
 unsigned ucp_wireup_eps_progress(void *arg);
 
 
+/**
+ * Select and connect the lanes of an endpoint which was created with
+ * @ref UCP_EP_FLAG_LAZY_CONNECT, once the first operation is queued on it.
+ */
+unsigned ucp_wireup_lazy_connect_progress(void *arg);
+
+
+/**
+ * Release the lane selection results which were cached on the worker.
+ */
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker);
+
+
 /**
  * Send a LANES_ADDR_REQUEST/REPLY wireup message over the AM lane, packing
  * addresses for the lanes in @a provided_lane_map.
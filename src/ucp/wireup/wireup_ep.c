@@ -180,6 +180,15 @@ static ucs_status_t ucp_wireup_ep_pending_add(uct_ep_h uct_ep,
             ucp_request_mem_free(proxy_req);
         }
     } else {
+        if ((wireup_ep->remote_address != NULL) &&
+            ucs_queue_is_empty(&wireup_ep->pending_q)) {
+            /* First operation on a lazily connected endpoint */
+            ucs_callbackq_add_oneshot(&worker->uct->progress_q, ucp_ep,
+                                      ucp_wireup_lazy_connect_progress,
+                                      ucp_ep);
+            ucp_worker_signal_internal(worker);
+        }
+
         ucs_queue_push(&wireup_ep->pending_q, ucp_wireup_ep_req_priv(req));
         ucp_worker_flush_ops_count_add(worker, +1);
         status = UCS_OK;
@@ -435,7 +444,8 @@ UCS_CLASS_INIT_FUNC(ucp_wireup_ep_t, ucp_ep_h ucp_ep)
     self->aux_ep        = NULL;
     self->aux_rsc_index = UCP_NULL_RESOURCE;
     self->pending_count = 0;
-    self->flags         = 0;
+    self->flags          = 0;
+    self->remote_address = NULL;
     ucs_queue_head_init(&self->pending_q);
     UCS_STATIC_BITMAP_RESET_ALL(&self->cm_resolve_tl_bitmap);
 
@@ -475,6 +485,13 @@ static UCS_CLASS_CLEANUP_FUNC(ucp_wireup_ep_t)
         ucp_proxy_ep_set_uct_ep(&self->super, NULL, 0, UCP_NULL_RESOURCE);
     }
 
+    if (self->remote_address != NULL) {
+        /* Flush operations counter was released by ucp_wireup_ep_set_lazy() */
+        ucs_free(self->remote_address->address_list);
+        ucs_free(self->remote_address);
+        return;
+    }
+
     UCS_ASYNC_BLOCK(&worker->async);
     ucp_worker_flush_ops_count_add(worker, -1);
     UCS_ASYNC_UNBLOCK(&worker->async);
@@ -482,6 +499,67 @@ static UCS_CLASS_CLEANUP_FUNC(ucp_wireup_ep_t)
 
 UCS_CLASS_DEFINE(ucp_wireup_ep_t, ucp_proxy_ep_t);
 
+ucs_status_t
+ucp_wireup_ep_set_lazy(ucp_wireup_ep_t *wireup_ep,
+                       const ucp_unpacked_address_t *remote_address,
+                       unsigned ep_init_flags)
+{
+    ucp_worker_h worker = wireup_ep->super.ucp_ep->worker;
+    ucp_unpacked_address_t *address;
+    ucs_status_t status;
+
+    ucs_assert(wireup_ep->remote_address == NULL);
+
+    address = ucs_malloc(sizeof(*address), "ucp_wireup_lazy_address");
+    if (address == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    status = ucp_address_dup(remote_address, address);
+    if (status != UCS_OK) {
+        ucs_free(address);
+        return status;
+    }
+
+    wireup_ep->remote_address = address;
+    wireup_ep->ep_init_flags  = ep_init_flags;
+
+    /* An idle endpoint which was not connected yet does not block the worker
+     * flush */
+    UCS_ASYNC_BLOCK(&worker->async);
+    ucp_worker_flush_ops_count_add(worker, -1);
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return UCS_OK;
+}
+
+ucp_unpacked_address_t *ucp_wireup_ep_detach_lazy(ucp_wireup_ep_t *wireup_ep)
+{
+    ucp_worker_h worker             = wireup_ep->super.ucp_ep->worker;
+    ucp_unpacked_address_t *address = wireup_ep->remote_address;
+
+    ucs_assert(address != NULL);
+
+    wireup_ep->remote_address = NULL;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    ucp_worker_flush_ops_count_add(worker, +1);
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return address;
+}
+
+int ucp_wireup_ep_is_lazy_idle(ucp_ep_h ucp_ep)
+{
+    ucp_wireup_ep_t *wireup_ep;
+
+    if (!(ucp_ep->flags & UCP_EP_FLAG_LAZY_CONNECT)) {
+        return 0;
+    }
+
+    wireup_ep = ucp_wireup_ep(ucp_ep_get_lane(ucp_ep, 0));
+    return (wireup_ep->remote_address != NULL) &&
+           ucs_queue_is_empty(&wireup_ep->pending_q);
+}
+
 ucp_rsc_index_t ucp_wireup_ep_get_aux_rsc_index(uct_ep_h uct_ep)
 {
     ucp_wireup_ep_t *wireup_ep = ucp_wireup_ep(uct_ep);
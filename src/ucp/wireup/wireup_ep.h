@@ -32,7 +32,10 @@ enum {
     UCP_WIREUP_EP_FLAG_SEND_CLIENT_ID   = UCS_BIT(3),
 
     /* Indicates that aux_ep is CONNECT_TO_EP */
-    UCP_WIREUP_EP_FLAG_AUX_P2P          = UCS_BIT(4)
+    UCP_WIREUP_EP_FLAG_AUX_P2P          = UCS_BIT(4),
+
+    /* Remote endpoint id should be resolved once lazily connected */
+    UCP_WIREUP_EP_FLAG_RESOLVE_ID       = UCS_BIT(5)
 };
 
 
@@ -55,6 +58,8 @@ struct ucp_wireup_ep {
     volatile uint32_t         pending_count; /**< Number of pending wireup operations */
     volatile uint32_t         flags;         /**< Connection state flags */
     unsigned                  ep_init_flags; /**< UCP wireup EP init flags */
+    /**< Remote address of a lazily connected endpoint */
+    ucp_unpacked_address_t    *remote_address;
     /**< TLs which are available on client side resolved device */
     ucp_tl_bitmap_t           cm_resolve_tl_bitmap;
 };
@@ -67,6 +72,32 @@ ucs_status_t ucp_wireup_ep_create(ucp_ep_h ep,
                                   uct_ep_h *ep_p);
 
 
+/**
+ * Keep the remote address of an endpoint which is connected on first use.
+ *
+ * @param [in]  wireup_ep       Stub endpoint on the single lane of the UCP EP.
+ * @param [in]  remote_address  Remote address to connect to, it is copied.
+ * @param [in]  ep_init_flags   Initial flags of UCP EP.
+ */
+ucs_status_t
+ucp_wireup_ep_set_lazy(ucp_wireup_ep_t *wireup_ep,
+                       const ucp_unpacked_address_t *remote_address,
+                       unsigned ep_init_flags);
+
+
+/**
+ * Take the remote address which was kept by @ref ucp_wireup_ep_set_lazy. The
+ * caller is responsible to release it.
+ */
+ucp_unpacked_address_t *ucp_wireup_ep_detach_lazy(ucp_wireup_ep_t *wireup_ep);
+
+
+/**
+ * Check if a lazily connected UCP EP has no operations to connect for.
+ */
+int ucp_wireup_ep_is_lazy_idle(ucp_ep_h ucp_ep);
+
+
 /**
  * @return Auxiliary resource index used by the wireup endpoint.
  *   If the endpoint is not a wireup endpoint, return UCP_NULL_RESOURCE.
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <ucs/algorithm/zrle.h>
+#include <ucs/sys/compiler_def.h>
+
+#include <string.h>
+
+
+/* Record header: number of zero bytes and number of literal bytes after them */
+typedef struct {
+    uint16_t zeros;
+    uint16_t literals;
+} UCS_S_PACKED ucs_zrle_record_t;
+
+
+static UCS_F_ALWAYS_INLINE uint64_t ucs_zrle_load_word(const uint8_t *p)
+{
+    uint64_t word;
+
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+ucs_status_t ucs_zrle_compress(const void *src, size_t length, void *dst,
+                               size_t max_length, size_t *length_p)
+{
+    const uint8_t *p   = src;
+    const uint8_t *end = p + length;
+    uint8_t *out       = dst;
+    uint8_t *out_end   = out + max_length;
+    const uint8_t *literal;
+    ucs_zrle_record_t record;
+    size_t zeros;
+
+    while (p < end) {
+        /* Zero bytes, mostly compared by words */
+        zeros = 0;
+        while (((size_t)(end - p) >= sizeof(uint64_t)) &&
+               (zeros <= (UINT16_MAX - sizeof(uint64_t))) &&
+               (ucs_zrle_load_word(p) == 0)) {
+            p     += sizeof(uint64_t);
+            zeros += sizeof(uint64_t);
+        }
+        while ((p < end) && (*p == 0) && (zeros < UINT16_MAX)) {
+            ++p;
+            ++zeros;
+        }
+
+        /* Literal bytes, up to the next zero word. Short zero runs which are
+         * not aligned to a word are left in the literal */
+        literal = p;
+        while ((p < end) && ((p - literal) < UINT16_MAX)) {
+            if ((size_t)(end - p) < sizeof(uint64_t)) {
+                p = end;
+            } else if (ucs_zrle_load_word(p) == 0) {
+                while ((p > literal) && (p[-1] == 0)) {
+                    --p;
+                }
+                break;
+            } else {
+                p += sizeof(uint64_t);
+            }
+        }
+
+        if ((p - literal) > UINT16_MAX) {
+            p = literal + UINT16_MAX;
+        }
+
+        record.zeros    = zeros;
+        record.literals = p - literal;
+        if ((size_t)(out_end - out) < (sizeof(record) + record.literals)) {
+            return UCS_ERR_EXCEEDS_LIMIT;
+        }
+
+        memcpy(out, &record, sizeof(record));
+        memcpy(out + sizeof(record), literal, record.literals);
+        out += sizeof(record) + record.literals;
+    }
+
+    *length_p = out - (uint8_t*)dst;
+    return UCS_OK;
+}
+
+ucs_status_t ucs_zrle_decompress(const void *src, size_t length, void *dst,
+                                 size_t max_length, size_t *length_p)
+{
+    const uint8_t *p   = src;
+    const uint8_t *end = p + length;
+    uint8_t *out       = dst;
+    uint8_t *out_end   = out + max_length;
+    ucs_zrle_record_t record;
+
+    while (p < end) {
+        if ((size_t)(end - p) < sizeof(record)) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        memcpy(&record, p, sizeof(record));
+        p += sizeof(record);
+        if ((size_t)(end - p) < record.literals) {
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        if ((size_t)(out_end - out) < ((size_t)record.zeros + record.literals)) {
+            return UCS_ERR_EXCEEDS_LIMIT;
+        }
+
+        memset(out, 0, record.zeros);
+        memcpy(out + record.zeros, p, record.literals);
+        out += record.zeros + record.literals;
+        p   += record.literals;
+    }
+
+    *length_p = out - (uint8_t*)dst;
+    return UCS_OK;
+}
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCS_ALGORITHM_ZRLE_H_
+#define UCS_ALGORITHM_ZRLE_H_
+
+#include <ucs/sys/compiler_def.h>
+#include <ucs/type/status.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+BEGIN_C_DECLS
+
+/** @file zrle.h */
+
+/**
+ * Compress a buffer with zero run-length encoding. The encoding is a sequence
+ * of records, each one holding a run of zero bytes followed by a run of
+ * literal bytes. It is cheap to compute, and efficient for zeroed or sparse
+ * buffers.
+ *
+ * @param [in]  src         Buffer to compress.
+ * @param [in]  length      Length of the buffer to compress.
+ * @param [out] dst         Filled with the compressed data.
+ * @param [in]  max_length  Size of @a dst.
+ * @param [out] length_p    Filled with the length of the compressed data.
+ *
+ * @return UCS_OK, or UCS_ERR_EXCEEDS_LIMIT if the compressed data does not fit
+ *         in @a max_length bytes.
+ */
+ucs_status_t ucs_zrle_compress(const void *src, size_t length, void *dst,
+                               size_t max_length, size_t *length_p);
+
+
+/**
+ * Decompress a buffer compressed by @ref ucs_zrle_compress.
+ *
+ * @param [in]  src         Compressed data.
+ * @param [in]  length      Length of the compressed data.
+ * @param [out] dst         Filled with the decompressed data.
+ * @param [in]  max_length  Size of @a dst.
+ * @param [out] length_p    Filled with the length of the decompressed data.
+ *
+ * @return UCS_OK, UCS_ERR_EXCEEDS_LIMIT if the decompressed data does not fit
+ *         in @a max_length bytes, or UCS_ERR_INVALID_PARAM if the compressed
+ *         data is malformed.
+ */
+ucs_status_t ucs_zrle_decompress(const void *src, size_t length, void *dst,
+                                 size_t max_length, size_t *length_p);
+
+END_C_DECLS
+
+#endif
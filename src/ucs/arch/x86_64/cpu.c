@@ -35,6 +35,10 @@
 #define X86_CPU_CACHE_TAG_L1_ONLY 0x40
 #define X86_CPU_CACHE_TAG_LEAF4   0xff
 
+#define X86_MEMCPY_CALIBRATE_ITERS 3
+#define X86_MEMCPY_CALIBRATE_MAX   (32 * UCS_MBYTE) /* Per buffer */
+#define X86_MEMCPY_CALIBRATE_GAIN  1.1 /* Required speedup of NT transfer */
+
 #if defined (__SSE4_1__)
 #define _mm_load(a)    _mm_stream_load_si128((__m128i *) (a))
 #define _mm_store(a,v) _mm_storeu_si128((__m128i *) (a), (v))
@@ -643,8 +647,216 @@ static size_t ucs_cpu_nt_dest_thresh()
     }
 }
 
+#ifdef __AVX__
+/* Memory copy method to calibrate */
+typedef enum {
+    UCS_CPU_MEMCPY_LIBC,      /* memcpy() */
+    UCS_CPU_MEMCPY_NT_LOAD,   /* Non-temporal loads, cached stores */
+    UCS_CPU_MEMCPY_NT_STREAM  /* Non-temporal loads and stores */
+} ucs_cpu_memcpy_method_t;
+
+
+static void ucs_x86_nt_buffer_transfer_thresh(void *dst, const void *src,
+                                              size_t len,
+                                              ucs_arch_memcpy_hint_t hint,
+                                              size_t total_len,
+                                              size_t dest_threshold);
+
+static ucs_time_t ucs_cpu_memcpy_measure(void *dst, const void *src, size_t len,
+                                         ucs_cpu_memcpy_method_t method)
+{
+    /* Select the store type of the non-temporal transfer */
+    size_t dest_threshold = (method == UCS_CPU_MEMCPY_NT_STREAM) ?
+                            0 : UCS_MEMUNITS_INF;
+    ucs_time_t best_time  = UINT64_MAX;
+    ucs_time_t start_time;
+    int i;
+
+    for (i = 0; i < X86_MEMCPY_CALIBRATE_ITERS; ++i) {
+        start_time = ucs_get_time();
+        if (method == UCS_CPU_MEMCPY_LIBC) {
+            memcpy(dst, src, len);
+        } else {
+            ucs_x86_nt_buffer_transfer_thresh(dst, src, len,
+                                              UCS_ARCH_MEMCPY_NT_NONE, len,
+                                              dest_threshold);
+        }
+        best_time = ucs_min(best_time, ucs_get_time() - start_time);
+    }
+
+    return best_time;
+}
+
+/*
+ * Measure, for growing buffer lengths around the last level cache size, from
+ * which length the non-temporal transfer is faster than memcpy(), and from
+ * which length non-temporal stores are faster than cached stores. A threshold
+ * which is not found within the measured range is left as "auto".
+ */
+static void ucs_cpu_memcpy_calibrate_nt(size_t llc_size, size_t *bt_min_p,
+                                        size_t *dest_thresh_p)
+{
+    /* With a larger cache, thresholds above the bound are not found */
+    size_t max_len = ucs_min(2 * llc_size, X86_MEMCPY_CALIBRATE_MAX);
+    ucs_time_t memcpy_time, load_time, stream_time;
+    void *src, *dst;
+    size_t len;
+
+    *bt_min_p      = UCS_MEMUNITS_AUTO;
+    *dest_thresh_p = UCS_MEMUNITS_AUTO;
+
+    if ((posix_memalign(&src, UCS_SYS_CACHE_LINE_SIZE, max_len) != 0)) {
+        return;
+    }
+
+    if ((posix_memalign(&dst, UCS_SYS_CACHE_LINE_SIZE, max_len) != 0)) {
+        goto out_free_src;
+    }
+
+    memset(src, 0, max_len);
+    memset(dst, 0, max_len);
+
+    for (len = ucs_max(max_len / 8, 1); len <= max_len; len *= 2) {
+        memcpy_time = ucs_cpu_memcpy_measure(dst, src, len,
+                                             UCS_CPU_MEMCPY_LIBC);
+        load_time   = ucs_cpu_memcpy_measure(dst, src, len,
+                                             UCS_CPU_MEMCPY_NT_LOAD);
+        stream_time = ucs_cpu_memcpy_measure(dst, src, len,
+                                             UCS_CPU_MEMCPY_NT_STREAM);
+        ucs_debug("memcpy calibration: length %zu memcpy %.2f us nt-load "
+                  "%.2f us nt-stream %.2f us", len,
+                  ucs_time_to_usec(memcpy_time), ucs_time_to_usec(load_time),
+                  ucs_time_to_usec(stream_time));
+
+        if ((*bt_min_p == UCS_MEMUNITS_AUTO) &&
+            ((ucs_min(load_time, stream_time) * X86_MEMCPY_CALIBRATE_GAIN) <
+             memcpy_time)) {
+            *bt_min_p = len;
+        }
+
+        if ((*dest_thresh_p == UCS_MEMUNITS_AUTO) &&
+            ((stream_time * X86_MEMCPY_CALIBRATE_GAIN) < load_time)) {
+            *dest_thresh_p = len;
+        }
+
+        if ((*bt_min_p != UCS_MEMUNITS_AUTO) &&
+            (*dest_thresh_p != UCS_MEMUNITS_AUTO)) {
+            break;
+        }
+    }
+
+    free(dst);
+out_free_src:
+    free(src);
+}
+
+/* Processor signature, which holds the family, model and stepping. Unlike
+ * ucs_arch_get_cpu_model(), it tells apart CPU models which are not known to
+ * UCX. */
+static uint32_t ucs_cpu_signature()
+{
+    uint32_t _eax, _ebx, _ecx, _edx;
+
+    ucs_x86_cpuid(X86_CPUID_GET_MODEL, &_eax, &_ebx, &_ecx, &_edx);
+    return _eax;
+}
+
+static void ucs_cpu_memcpy_cache_path(char *path, size_t max, size_t llc_size)
+{
+    ucs_snprintf_safe(path, max, "%s/ucx_memcpy_%d_%08x_%zu",
+                      ucs_global_opts.arch.memcpy_calibrate_cache,
+                      ucs_arch_get_cpu_vendor(), ucs_cpu_signature(),
+                      llc_size);
+}
+
+/* Replace the file atomically, so concurrent readers never see a partial
+ * result. Not inlined, to keep the stack frame of the caller small. */
+static UCS_F_NOINLINE void ucs_cpu_memcpy_cache_save(const char *path,
+                                                     size_t bt_min,
+                                                     size_t dest_thresh)
+{
+    char tmp_path[PATH_MAX];
+    FILE *file;
+    int ret;
+
+    ucs_snprintf_safe(tmp_path, sizeof(tmp_path), "%s.%d", path, getpid());
+    file = fopen(tmp_path, "w");
+    if (file == NULL) {
+        ucs_debug("failed to save memcpy calibration to %s: %m", tmp_path);
+        return;
+    }
+
+    ret = fprintf(file, "%zu %zu\n", bt_min, dest_thresh);
+    if ((fclose(file) != 0) || (ret < 0)) {
+        ucs_debug("failed to write memcpy calibration to %s", tmp_path);
+        goto err_unlink;
+    }
+
+    if (rename(tmp_path, path) != 0) {
+        ucs_debug("failed to rename '%s' to '%s': %m", tmp_path, path);
+        goto err_unlink;
+    }
+
+    return;
+
+err_unlink:
+    unlink(tmp_path);
+}
+#endif
+
+static void ucs_cpu_memcpy_calibrate(size_t *bt_min_p, size_t *dest_thresh_p)
+{
+#ifdef __AVX__
+    size_t llc_size = ucs_cpu_get_cache_size(UCS_CPU_CACHE_L3);
+    int use_cache   = strlen(ucs_global_opts.arch.memcpy_calibrate_cache) > 0;
+    char path[PATH_MAX];
+    FILE *file;
+    int ret;
+
+    *bt_min_p      = UCS_MEMUNITS_AUTO;
+    *dest_thresh_p = UCS_MEMUNITS_AUTO;
+
+    if (llc_size == 0) {
+        ucs_debug("last level cache size is unknown, skip memcpy calibration");
+        return;
+    }
+
+    if (use_cache) {
+        ucs_cpu_memcpy_cache_path(path, sizeof(path), llc_size);
+        file = fopen(path, "r");
+        if (file != NULL) {
+            ret = fscanf(file, "%zu %zu", bt_min_p, dest_thresh_p);
+            fclose(file);
+            if (ret == 2) {
+                ucs_debug("using memcpy calibration from %s", path);
+                return;
+            }
+        }
+    }
+
+    ucs_cpu_memcpy_calibrate_nt(llc_size, bt_min_p, dest_thresh_p);
+
+    if (use_cache) {
+        ucs_cpu_memcpy_cache_save(path, *bt_min_p, *dest_thresh_p);
+    }
+#else
+    ucs_debug("non-temporal buffer transfer is not supported, skip memcpy "
+              "calibration");
+    *bt_min_p      = UCS_MEMUNITS_AUTO;
+    *dest_thresh_p = UCS_MEMUNITS_AUTO;
+#endif
+}
+
 void ucs_cpu_init()
 {
+    size_t calibrated_bt_min      = UCS_MEMUNITS_AUTO;
+    size_t calibrated_dest_thresh = UCS_MEMUNITS_AUTO;
+
+    if (ucs_global_opts.arch.memcpy_calibrate &&
+        (ucs_global_opts.arch.nt_buffer_transfer_min == UCS_MEMUNITS_AUTO)) {
+        ucs_cpu_memcpy_calibrate(&calibrated_bt_min, &calibrated_dest_thresh);
+    }
+
 #if ENABLE_BUILTIN_MEMCPY
     ucs_global_opts.arch.builtin_memcpy_min =
         ucs_cpu_memcpy_thresh(ucs_global_opts.arch.builtin_memcpy_min,
@@ -656,6 +868,14 @@ void ucs_cpu_init()
     ucs_global_opts.arch.nt_buffer_transfer_min =
         ucs_cpu_nt_bt_thresh_min(ucs_global_opts.arch.nt_buffer_transfer_min);
     ucs_global_opts.arch.nt_dest_threshold = ucs_cpu_nt_dest_thresh();
+
+    if (calibrated_bt_min != UCS_MEMUNITS_AUTO) {
+        ucs_global_opts.arch.nt_buffer_transfer_min = calibrated_bt_min;
+    }
+
+    if (calibrated_dest_thresh != UCS_MEMUNITS_AUTO) {
+        ucs_global_opts.arch.nt_dest_threshold = calibrated_dest_thresh;
+    }
 }
 
 ucs_status_t ucs_arch_get_cache_size(size_t *cache_sizes)
@@ -1151,8 +1371,10 @@ ucs_x86_copy_bytes_le_128(void *dst, const void *src, uint32_t len)
  * TODO: Provide an option to copy from backwards, in this way
  * application can choose the cache hotness of the final buffer
  */
-void ucs_x86_nt_buffer_transfer(void *dst, const void *src, size_t len,
-                                ucs_arch_memcpy_hint_t hint, size_t total_len)
+static UCS_F_ALWAYS_INLINE void
+ucs_x86_nt_buffer_transfer_thresh(void *dst, const void *src, size_t len,
+                                  ucs_arch_memcpy_hint_t hint, size_t total_len,
+                                  size_t dest_threshold)
 {
     size_t tail_bytes;
 
@@ -1160,7 +1382,7 @@ void ucs_x86_nt_buffer_transfer(void *dst, const void *src, size_t len,
         goto copy_bytes_le_128;
     }
 
-    if (ucs_unlikely(total_len > ucs_global_opts.arch.nt_dest_threshold)) {
+    if (ucs_unlikely(total_len > dest_threshold)) {
         if (hint & UCS_ARCH_MEMCPY_NT_SOURCE) {
             /*
              * If the lines prefetched with 'NTA' are in 'MODIFIED' state
@@ -1190,6 +1412,13 @@ void ucs_x86_nt_buffer_transfer(void *dst, const void *src, size_t len,
 copy_bytes_le_128:
     ucs_x86_copy_bytes_le_128(dst, src, len);
 }
+
+void ucs_x86_nt_buffer_transfer(void *dst, const void *src, size_t len,
+                                ucs_arch_memcpy_hint_t hint, size_t total_len)
+{
+    ucs_x86_nt_buffer_transfer_thresh(dst, src, len, hint, total_len,
+                                      ucs_global_opts.arch.nt_dest_threshold);
+}
 #endif
 
 void ucs_x86_memcpy_sse_movntdqa(void *dst, const void *src, size_t len)
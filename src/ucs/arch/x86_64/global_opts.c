@@ -30,6 +30,25 @@ ucs_config_field_t ucs_arch_global_opts_table[] = {
    "Minimal threshold of buffer length for using non-temporal buffer transfer.",
    ucs_offsetof(ucs_arch_global_opts_t, nt_buffer_transfer_min),
    UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"MEMCPY_CALIBRATE", "n",
+   "Measure on startup from which buffer length the non-temporal buffer\n"
+   "transfer is faster than memcpy(), and from which length non-temporal\n"
+   "stores are faster than cached stores on this host, and use them as the\n"
+   "non-temporal thresholds, if NT_BUFFER_TRANSFER_MIN is set to \"auto\".\n"
+   "The measurement takes up to a fraction of a second and temporarily\n"
+   "allocates up to 64MB. Thresholds above 32MB are not measured, and\n"
+   "remain \"auto\".",
+   ucs_offsetof(ucs_arch_global_opts_t, memcpy_calibrate),
+   UCS_CONFIG_TYPE_BOOL},
+
+  {"MEMCPY_CALIBRATE_CACHE", "",
+   "Directory to save memcpy calibration results in, per CPU model, stepping\n"
+   "and last level cache size, so only the first process on every type of\n"
+   "host runs the measurement.\n"
+   "If empty, the results are not saved.",
+   ucs_offsetof(ucs_arch_global_opts_t, memcpy_calibrate_cache),
+   UCS_CONFIG_TYPE_STRING},
   {NULL}
 };
 
@@ -18,7 +18,9 @@ BEGIN_C_DECLS
     .builtin_memcpy_min     = UCS_MEMUNITS_AUTO, \
     .builtin_memcpy_max     = UCS_MEMUNITS_AUTO, \
     .nt_buffer_transfer_min = UCS_MEMUNITS_AUTO, \
-    .nt_dest_threshold      = UCS_MEMUNITS_AUTO  \
+    .nt_dest_threshold      = UCS_MEMUNITS_AUTO, \
+    .memcpy_calibrate       = 0, \
+    .memcpy_calibrate_cache = ""  \
 }
 
 /* built-in memcpy & nt-buffer-transfer config */
@@ -27,6 +29,8 @@ typedef struct ucs_arch_global_opts {
     size_t builtin_memcpy_max;
     size_t nt_buffer_transfer_min;
     size_t nt_dest_threshold;
+    int    memcpy_calibrate;
+    char   *memcpy_calibrate_cache;
 } ucs_arch_global_opts_t;
 
 END_C_DECLS
@@ -47,9 +47,11 @@ ucs_global_opts_t ucs_global_opts = {
     .stats_trigger         = "exit",
     .profile_mode          = 0,
     .profile_file          = "",
+    .profile_progress      = 0,
     .stats_filter          = { NULL, 0 },
     .stats_format          = UCS_STATS_FULL,
     .topo_prio             = { NULL, 0 },
+    .topo_cache_dir        = "",
     .vfs_enable            = 1,
     .vfs_thread_affinity   = 0,
     .rcache_check_pfn      = 0,
@@ -201,7 +203,10 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "Comma-separated list of glob patterns specifying which module to load.\n"
   "The order is not meaningful. For example:\n"
   " *     - load all modules\n"
-  " ^cu*  - do not load modules that begin with 'cu'",
+  " ^cu*  - do not load modules that begin with 'cu'\n"
+  "When all the listed modules are linked into the libraries, for example\n"
+  "transports built in with --with-builtin-modules, the module directories\n"
+  "are not searched.",
   ucs_offsetof(ucs_global_opts_t, modules), UCS_CONFIG_TYPE_ALLOW_LIST},
 
  {"PLUGIN_PATH", "",
@@ -214,6 +219,13 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "The list order decides the priority of the providers.",
   ucs_offsetof(ucs_global_opts_t, topo_prio), UCS_CONFIG_TYPE_STRING_ARRAY},
 
+ {"TOPO_CACHE_DIR", "",
+  "Directory of a node-local cache of device topology information read from\n"
+  "sysfs, such as device paths, NUMA nodes and PCIe bandwidth. The cache is\n"
+  "shared by all processes on the node and is discarded after a reboot.\n"
+  "If empty, the cache is disabled.",
+  ucs_offsetof(ucs_global_opts_t, topo_cache_dir), UCS_CONFIG_TYPE_STRING},
+
  {"DISTANCE_LAT", "phb:300ns,node:300ns,sys:500ns",
   "Estimated latency between system devices", 0,
   UCS_CONFIG_TYPE_KEY_VALUE(UCS_CONFIG_TYPE_TIME,
@@ -276,7 +288,10 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
   "  udp:<host>[:<port>]   - send over UDP to the given host:port.\n"
   "  stdout                - print to standard output.\n"
   "  stderr                - print to standard error.\n"
-  "  file:<filename>[:bin] - save to a file (%h: host, %p: pid, %c: cpu, %t: time, %u: user, %e: exe)",
+  "  file:<filename>[:bin|:delta] - save to a file (%h: host, %p: pid, %c: cpu, %t: time, %u: user, %e: exe).\n"
+  "                          \"bin\" writes a binary snapshot on every dump, \"delta\" writes\n"
+  "                          a binary snapshot only when the set of nodes changes, and\n"
+  "                          otherwise just the varint-encoded counter changes.",
   ucs_offsetof(ucs_global_opts_t, stats_dest), UCS_CONFIG_TYPE_STRING},
 
  {"STATS_TRIGGER", "exit",
@@ -330,6 +345,13 @@ static ucs_config_field_t ucs_global_opts_read_only_table[] = {
   "Maximal size of profiling log. New records will replace old records.",
   ucs_offsetof(ucs_global_opts_t, profile_log_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+ {"PROFILE_PROGRESS", "n",
+  "Measure the number of calls and the time spent in each progress callback,\n"
+  "to find which transport interface or one-shot callback slows down progress.\n"
+  "Results are reported by ucp_worker_print_info() and by the worker VFS\n"
+  "directory. When disabled, progress dispatch has no additional overhead.",
+  ucs_offsetof(ucs_global_opts_t, profile_progress), UCS_CONFIG_TYPE_BOOL},
+
  {"RCACHE_STAT_MIN", "4k",
   "Registration cache minimum region size, for power-of-2 size distribution "
   "statistics.\nStatistics about smaller regions will be attributed to this "
@@ -113,6 +113,9 @@ typedef struct {
     /* Limit for profiling log size */
     size_t                     profile_log_size;
 
+    /* Measure time spent in each progress callback */
+    int                        profile_progress;
+
     /* Counters to be included in statistics summary */
     ucs_config_names_array_t   stats_filter;
 
@@ -122,6 +125,9 @@ typedef struct {
     /* Topology detection modules to use */
     ucs_config_names_array_t   topo_prio;
 
+    /* Directory of the node-local topology cache, empty to disable */
+    char                       *topo_cache_dir;
+
     /* Enable VFS monitoring */
     int                        vfs_enable;
 
@@ -1885,8 +1885,86 @@ out:
     return;
 }
 
+static int ucs_config_env_has_prefix(const char *envstr, const char *prefix)
+{
+    return (prefix != NULL) && !strncmp(envstr, prefix, strlen(prefix));
+}
+
+static void ucs_config_env_index_cleanup(khash_t(ucs_config_map) *env_index)
+{
+    const char *name;
+
+    kh_foreach_key(env_index, name, {
+        ucs_free((char*)name);
+    });
+    kh_destroy_inplace(ucs_config_map, env_index);
+}
+
+/*
+ * Index the environment variables which start with one of the given prefixes
+ * by their full name, so every field is looked up in O(1) instead of scanning
+ * the whole environment by getenv(). The values point to the environment
+ * strings, so the index is valid only until the environment is modified.
+ */
+static ucs_status_t
+ucs_config_env_index_init(khash_t(ucs_config_map) *env_index,
+                          const char *env_prefix, const char *sub_prefix)
+{
+    char **envp, *name;
+    const char *value;
+    khiter_t iter;
+    int ret;
+
+    kh_init_inplace(ucs_config_map, env_index);
+
+    for (envp = environ; *envp != NULL; ++envp) {
+        if (!ucs_config_env_has_prefix(*envp, env_prefix) &&
+            !ucs_config_env_has_prefix(*envp, sub_prefix)) {
+            continue;
+        }
+
+        value = strchr(*envp, '=');
+        if (value == NULL) {
+            continue;
+        }
+
+        name = ucs_strndup(*envp, value - *envp, "config_env_name");
+        if (name == NULL) {
+            goto err;
+        }
+
+        iter = kh_put(ucs_config_map, env_index, name, &ret);
+        if (ret == UCS_KH_PUT_FAILED) {
+            ucs_free(name);
+            goto err;
+        } else if (ret == UCS_KH_PUT_KEY_PRESENT) {
+            /* Same as getenv(), the first definition takes precedence */
+            ucs_free(name);
+            continue;
+        }
+
+        kh_val(env_index, iter) = (char*)value + 1;
+    }
+
+    return UCS_OK;
+
+err:
+    ucs_config_env_index_cleanup(env_index);
+    return UCS_ERR_NO_MEMORY;
+}
+
+static const char *
+ucs_config_env_index_get(const khash_t(ucs_config_map) *env_index,
+                         const char *name)
+{
+    khiter_t iter = kh_get(ucs_config_map, env_index, name);
+
+    return (iter == kh_end(env_index)) ? NULL : kh_val(env_index, iter);
+}
+
 static ucs_status_t
 ucs_config_apply_config_vars(void *opts, ucs_config_field_t *fields,
+                             const khash_t(ucs_config_map) *env_index,
                              const char *prefix, const char *table_prefix,
                              int recurse, int ignore_errors)
 {
@@ -1912,7 +1990,8 @@ ucs_config_apply_config_vars(void *opts, ucs_config_field_t *fields,
 
             /* Parse with sub-table prefix */
             if (recurse) {
-                status = ucs_config_apply_config_vars(var, sub_fields, prefix,
+                status = ucs_config_apply_config_vars(var, sub_fields,
+                                                      env_index, prefix,
                                                       field->name, 1,
                                                       ignore_errors);
                 if (status != UCS_OK) {
@@ -1922,7 +2001,8 @@ ucs_config_apply_config_vars(void *opts, ucs_config_field_t *fields,
 
             /* Possible override with my prefix */
             if (table_prefix) {
-                status = ucs_config_apply_config_vars(var, sub_fields, prefix,
+                status = ucs_config_apply_config_vars(var, sub_fields,
+                                                      env_index, prefix,
                                                       table_prefix, 0,
                                                       ignore_errors);
                 if (status != UCS_OK) {
@@ -1934,7 +2014,7 @@ ucs_config_apply_config_vars(void *opts, ucs_config_field_t *fields,
             strncpy(buf + prefix_len, field->name, sizeof(buf) - prefix_len - 1);
 
             /* Env variable has precedence over file config */
-            env_value = getenv(buf);
+            env_value = ucs_config_env_index_get(env_index, buf);
             if (env_value == NULL) {
                 env_value = ucs_config_get_value_from_config_file(buf);
             }
@@ -2044,6 +2124,7 @@ ucs_config_parser_fill_opts(void *opts, ucs_config_global_list_entry_t *entry,
 {
     const char   *sub_prefix = NULL;
     static ucs_init_once_t config_file_parse = UCS_INIT_ONCE_INITIALIZER;
+    khash_t(ucs_config_map) env_index;
     ucs_status_t status;
 
     /* Set default values */
@@ -2062,25 +2143,35 @@ ucs_config_parser_fill_opts(void *opts, ucs_config_global_list_entry_t *entry,
         ucs_config_parse_config_files();
     }
 
+    status = ucs_config_env_index_init(&env_index, env_prefix, sub_prefix);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
     /* Apply environment variables */
     if (sub_prefix != NULL) {
-        status = ucs_config_apply_config_vars(opts, entry->table, sub_prefix,
-                                              entry->prefix, 1, ignore_errors);
+        status = ucs_config_apply_config_vars(opts, entry->table, &env_index,
+                                              sub_prefix, entry->prefix, 1,
+                                              ignore_errors);
         if (status != UCS_OK) {
-            goto err_free;
+            goto err_cleanup_env_index;
         }
     }
 
     /* Apply environment variables with custom prefix */
-    status = ucs_config_apply_config_vars(opts, entry->table, env_prefix,
-                                          entry->prefix, 1, ignore_errors);
+    status = ucs_config_apply_config_vars(opts, entry->table, &env_index,
+                                          env_prefix, entry->prefix, 1,
+                                          ignore_errors);
     if (status != UCS_OK) {
-        goto err_free;
+        goto err_cleanup_env_index;
     }
 
+    ucs_config_env_index_cleanup(&env_index);
     entry->flags |= UCS_CONFIG_TABLE_FLAG_LOADED;
     return UCS_OK;
 
+err_cleanup_env_index:
+    ucs_config_env_index_cleanup(&env_index);
 err_free:
     ucs_config_parser_release_opts(opts,
                                    entry->table); /* Release default values */
@@ -13,12 +13,14 @@
 #include <ucs/arch/atomic.h>
 #include <ucs/arch/bitops.h>
 #include <ucs/async/async.h>
+#include <ucs/config/global_opts.h>
 #include <ucs/datastruct/array.h>
 #include <ucs/datastruct/hlist.h>
 #include <ucs/datastruct/khash.h>
 #include <ucs/debug/assert.h>
 #include <ucs/debug/debug_int.h>
 #include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
 
 #include "callbackq.h"
 
@@ -42,6 +44,21 @@ typedef struct ucs_callbackq_oneshot_elem {
     ucs_hlist_link_t     hlist;
 } ucs_callbackq_oneshot_elem_t;
 
+/*
+ * Profiling record of a callback. When profiling is enabled, a callback is
+ * added to the queue as ucs_callbackq_prof_callback() with a pointer to this
+ * record as its argument.
+ */
+typedef struct ucs_callbackq_prof_elem {
+    ucs_callbackq_elem_t super;     /* Original callback and argument */
+    ucs_list_link_t      list;      /* Entry in the list of records */
+    int                  oneshot;   /* Accounts all one-shot calls of 'cb' */
+    int                  installed; /* Currently added to the queue */
+    unsigned long        count;     /* Number of calls */
+    unsigned long        work;      /* Sum of values returned by the calls */
+    ucs_time_t           time;      /* Total time spent in the calls */
+} ucs_callbackq_prof_elem_t;
+
 #define ucs_callbackq_oneshot_key_hash(_key) \
     kh_int64_hash_func((int64_t)(_key))
 
@@ -76,6 +93,12 @@ struct ucs_callbackq_priv {
 
     /* ID of oneshot-path proxy in fast-path array */
     int                                               proxy_cb_id;
+
+    /* Whether callbacks are wrapped by a profiling record */
+    int                                               prof_enabled;
+
+    /* List of profiling records, including those of removed callbacks */
+    ucs_list_link_t                                   prof_elems;
 };
 
 
@@ -94,6 +117,112 @@ static void ucs_callbackq_leave(ucs_callbackq_t *cbq)
     ucs_recursive_spin_unlock(&cbq->priv->lock);
 }
 
+static unsigned ucs_callbackq_prof_callback(void *arg)
+{
+    ucs_callbackq_prof_elem_t *prof_elem = arg;
+    ucs_time_t start_time                = ucs_get_time();
+    unsigned count;
+
+    count            = prof_elem->super.cb(prof_elem->super.arg);
+    prof_elem->time += ucs_get_time() - start_time;
+    prof_elem->work += count;
+    ++prof_elem->count;
+    return count;
+}
+
+/* Lock must be held */
+static ucs_callbackq_prof_elem_t *
+ucs_callbackq_prof_elem_get(ucs_callbackq_t *cbq, ucs_callback_t cb, void *arg,
+                            int oneshot)
+{
+    ucs_callbackq_priv_t *priv = cbq->priv;
+    ucs_callbackq_prof_elem_t *prof_elem;
+
+    /* Reuse the record of a callback which was removed and added again, to
+       keep the number of records bounded */
+    ucs_list_for_each(prof_elem, &priv->prof_elems, list) {
+        if ((prof_elem->super.cb == cb) && (prof_elem->super.arg == arg) &&
+            (prof_elem->oneshot == oneshot) && !prof_elem->installed) {
+            return prof_elem;
+        }
+    }
+
+    prof_elem = ucs_malloc(sizeof(*prof_elem), "ucs_callbackq_prof_elem");
+    if (prof_elem == NULL) {
+        ucs_fatal("callbackq %p: failed to allocate profiling element", cbq);
+    }
+
+    prof_elem->super.cb  = cb;
+    prof_elem->super.arg = arg;
+    prof_elem->oneshot   = oneshot;
+    prof_elem->installed = 0;
+    prof_elem->count     = 0;
+    prof_elem->work      = 0;
+    prof_elem->time      = 0;
+    ucs_list_add_tail(&priv->prof_elems, &prof_elem->list);
+    return prof_elem;
+}
+
+/* Lock must be held */
+static void
+ucs_callbackq_prof_wrap(ucs_callbackq_t *cbq, ucs_callback_t *cb_p, void **arg_p)
+{
+    ucs_callbackq_prof_elem_t *prof_elem;
+
+    if (!cbq->priv->prof_enabled) {
+        return;
+    }
+
+    prof_elem            = ucs_callbackq_prof_elem_get(cbq, *cb_p, *arg_p, 0);
+    prof_elem->installed = 1;
+    *cb_p                = ucs_callbackq_prof_callback;
+    *arg_p               = prof_elem;
+}
+
+/* Returns the user-defined argument of a queue element, and detaches the
+   element from its profiling record, if any */
+static void *ucs_callbackq_elem_unwrap(const ucs_callbackq_elem_t *elem)
+{
+    ucs_callbackq_prof_elem_t *prof_elem;
+
+    if (elem->cb != ucs_callbackq_prof_callback) {
+        return elem->arg;
+    }
+
+    prof_elem            = elem->arg;
+    prof_elem->installed = 0;
+    return prof_elem->super.arg;
+}
+
+/* Lock must be held */
+static unsigned ucs_callbackq_oneshot_elem_call(ucs_callbackq_t *cbq,
+                                                const ucs_callbackq_elem_t *elem)
+{
+    ucs_callbackq_prof_elem_t *prof_elem;
+    ucs_time_t start_time;
+    unsigned count;
+
+    if (!cbq->priv->prof_enabled) {
+        ucs_callbackq_leave(cbq);
+        count = elem->cb(elem->arg);
+        ucs_callbackq_enter(cbq);
+        return count;
+    }
+
+    prof_elem = ucs_callbackq_prof_elem_get(cbq, elem->cb, NULL, 1);
+
+    ucs_callbackq_leave(cbq);
+    start_time = ucs_get_time();
+    count      = elem->cb(elem->arg);
+    ucs_callbackq_enter(cbq);
+
+    /* Records are released only by cleanup, so prof_elem is still valid */
+    prof_elem->time += ucs_get_time() - start_time;
+    prof_elem->work += count;
+    ++prof_elem->count;
+    return count;
+}
+
 static void ucs_callbackq_fast_elem_set(ucs_callbackq_t *cbq, unsigned idx,
                                         ucs_callback_t cb, void *arg, int id)
 {
@@ -276,7 +405,7 @@ static void *ucs_callbackq_spill_elem_remove(ucs_callbackq_t *cbq, unsigned idx)
     elem     = &ucs_array_elem(&priv->spill_elems, idx);
     elem->id = UCS_CALLBACKQ_ID_NULL;
 
-    return elem->super.arg;
+    return ucs_callbackq_elem_unwrap(&elem->super);
 }
 
 /* Should be called from dispatch thread only */
@@ -347,7 +476,7 @@ static void ucs_callbackq_spill_elem_promote(ucs_callbackq_t *cbq, unsigned idx)
     ucs_callbackq_fast_elem_set(cbq, fast_idx, elem->super.cb, elem->super.arg,
                                 elem->id);
     ucs_array_elem(&priv->idxs, elem->id) = fast_idx;
-    ucs_callbackq_spill_elem_remove(cbq, idx);
+    elem->id                              = UCS_CALLBACKQ_ID_NULL;
 }
 
 /* Lock must be held */
@@ -452,12 +581,8 @@ static unsigned ucs_callbackq_oneshot_elems_dispatch(ucs_callbackq_t *cbq)
         oneshot_elem = ucs_hlist_extract_head_elem(hlist,
                                                    ucs_callbackq_oneshot_elem_t,
                                                    hlist);
-        ucs_callbackq_leave(cbq);
-
-        count += oneshot_elem->super.cb(oneshot_elem->super.arg);
+        count += ucs_callbackq_oneshot_elem_call(cbq, &oneshot_elem->super);
         ucs_free(oneshot_elem);
-
-        ucs_callbackq_enter(cbq);
     }
 
     ucs_free(keys);
@@ -534,8 +659,15 @@ static void ucs_callbackq_proxy_disable(ucs_callbackq_t *cbq)
 static void
 ucs_callbackq_elem_show(const char *title, const ucs_callbackq_elem_t *elem)
 {
+    const ucs_callbackq_elem_t *user_elem = elem;
+
+    if (elem->cb == ucs_callbackq_prof_callback) {
+        user_elem = &((ucs_callbackq_prof_elem_t*)elem->arg)->super;
+    }
+
     ucs_diag("%s: cb %s (%p) arg %p", title,
-             ucs_debug_get_symbol_name(elem->cb), elem->cb, elem->arg);
+             ucs_debug_get_symbol_name(user_elem->cb), user_elem->cb,
+             user_elem->arg);
 }
 
 static void ucs_callbackq_show_remaining_elems(ucs_callbackq_t *cbq)
@@ -601,6 +733,8 @@ ucs_status_t ucs_callbackq_init(ucs_callbackq_t *cbq)
     priv->fast_remove_mask = 0;
     priv->free_idx_id      = UCS_CALLBACKQ_ID_NULL;
     priv->proxy_cb_id      = UCS_CALLBACKQ_ID_NULL;
+    priv->prof_enabled     = ucs_global_opts.profile_progress;
+    ucs_list_head_init(&priv->prof_elems);
     cbq->priv              = priv;
 
     for (idx = 0; idx < UCS_CALLBACKQ_FAST_COUNT; ++idx) {
@@ -614,6 +748,7 @@ ucs_status_t ucs_callbackq_init(ucs_callbackq_t *cbq)
 void ucs_callbackq_cleanup(ucs_callbackq_t *cbq)
 {
     ucs_callbackq_priv_t *priv = cbq->priv;
+    ucs_callbackq_prof_elem_t *prof_elem, *tmp_prof_elem;
 
     ucs_callbackq_fast_elems_purge(cbq);
     ucs_callbackq_spill_elems_purge(cbq);
@@ -625,6 +760,10 @@ void ucs_callbackq_cleanup(ucs_callbackq_t *cbq)
     ucs_array_cleanup_dynamic(&priv->spill_elems);
     ucs_array_cleanup_dynamic(&priv->idxs);
 
+    ucs_list_for_each_safe(prof_elem, tmp_prof_elem, &priv->prof_elems, list) {
+        ucs_free(prof_elem);
+    }
+
     ucs_free(priv);
 }
 
@@ -637,6 +776,7 @@ int ucs_callbackq_add(ucs_callbackq_t *cbq, ucs_callback_t cb, void *arg)
                    arg);
 
     ucs_callbackq_enter(cbq);
+    ucs_callbackq_prof_wrap(cbq, &cb, &arg);
 
     if (ucs_likely(priv->num_fast_elems < UCS_CALLBACKQ_FAST_MAX)) {
         id = ucs_callbackq_fast_elem_add(cbq, cb, arg);
@@ -662,7 +802,7 @@ void *ucs_callbackq_remove(ucs_callbackq_t *cbq, int id)
     if (idx < UCS_CALLBACKQ_FAST_COUNT) {
         ucs_assertv(idx < priv->num_fast_elems, "idx=%u num_fast_elems=%u", idx,
                     priv->num_fast_elems);
-        cb_arg                  = cbq->fast_elems[idx].arg;
+        cb_arg                  = ucs_callbackq_elem_unwrap(&cbq->fast_elems[idx]);
         priv->fast_remove_mask |= UCS_BIT(idx);
         ucs_callbackq_fast_elems_purge(cbq);
     } else {
@@ -683,6 +823,7 @@ int ucs_callbackq_add_safe(ucs_callbackq_t *cbq, ucs_callback_t cb, void *arg)
                    arg);
 
     ucs_callbackq_enter(cbq);
+    ucs_callbackq_prof_wrap(cbq, &cb, &arg);
 
     /* Add callback to spill elems, and it may be upgraded to fast-path later by
      * the proxy callback. It's not safe to add to fast_elems directly.
@@ -711,7 +852,7 @@ void *ucs_callbackq_remove_safe(ucs_callbackq_t *cbq, int id)
         /* Make sure user callback will not be called in case we try to dispatch
            the removed fast-path element before the proxy callback had a chance
            to clean it up. */
-        cb_arg                  = cbq->fast_elems[idx].arg;
+        cb_arg                  = ucs_callbackq_elem_unwrap(&cbq->fast_elems[idx]);
         cbq->fast_elems[idx].cb = (ucs_callback_t)ucs_empty_function_return_zero;
         priv->fast_remove_mask |= UCS_BIT(idx);
         ucs_callbackq_proxy_enable(cbq);
@@ -799,3 +940,79 @@ void ucs_callbackq_remove_oneshot(ucs_callbackq_t *cbq, ucs_callbackq_key_t key,
 out:
     ucs_callbackq_leave(cbq);
 }
+
+int ucs_callbackq_prof_is_enabled(ucs_callbackq_t *cbq)
+{
+    return cbq->priv->prof_enabled;
+}
+
+static int ucs_callbackq_prof_elem_compare(const void *elem1, const void *elem2)
+{
+    ucs_time_t time1 = (*(ucs_callbackq_prof_elem_t* const*)elem1)->time;
+    ucs_time_t time2 = (*(ucs_callbackq_prof_elem_t* const*)elem2)->time;
+
+    return (time1 < time2) - (time1 > time2);
+}
+
+void ucs_callbackq_prof_dump(ucs_callbackq_t *cbq, ucs_string_buffer_t *strb)
+{
+    ucs_callbackq_priv_t *priv = cbq->priv;
+    ucs_callbackq_prof_elem_t **sorted_elems, *prof_elem;
+    unsigned i, num_elems;
+
+    if (!priv->prof_enabled) {
+        return;
+    }
+
+    ucs_callbackq_enter(cbq);
+
+    num_elems = ucs_list_length(&priv->prof_elems);
+    if (num_elems == 0) {
+        goto out;
+    }
+
+    sorted_elems = ucs_malloc(sizeof(*sorted_elems) * num_elems,
+                              "ucs_callbackq_prof_sorted");
+    if (sorted_elems == NULL) {
+        ucs_error("callbackq %p: failed to allocate profiling dump array",
+                  cbq);
+        goto out;
+    }
+
+    i = 0;
+    ucs_list_for_each(prof_elem, &priv->prof_elems, list) {
+        sorted_elems[i++] = prof_elem;
+    }
+
+    qsort(sorted_elems, num_elems, sizeof(*sorted_elems),
+          ucs_callbackq_prof_elem_compare);
+
+    for (i = 0; i < num_elems; ++i) {
+        prof_elem = sorted_elems[i];
+        ucs_string_buffer_appendf(strb, "%s", ucs_debug_get_symbol_name(
+                                                      prof_elem->super.cb));
+        if (prof_elem->oneshot) {
+            ucs_string_buffer_appendf(strb, " (one-shot)");
+        } else {
+            ucs_string_buffer_appendf(strb, "(%p)%s", prof_elem->super.arg,
+                                      prof_elem->installed ? "" :
+                                                             " (removed)");
+        }
+
+        ucs_string_buffer_appendf(strb,
+                                  ": calls %lu work %lu time %.3f ms",
+                                  prof_elem->count, prof_elem->work,
+                                  ucs_time_to_msec(prof_elem->time));
+        if (prof_elem->count > 0) {
+            ucs_string_buffer_appendf(strb, " avg %.3f us",
+                                      ucs_time_to_usec(prof_elem->time) /
+                                              prof_elem->count);
+        }
+        ucs_string_buffer_appendf(strb, "\n");
+    }
+
+    ucs_free(sorted_elems);
+
+out:
+    ucs_callbackq_leave(cbq);
+}
@@ -9,6 +9,7 @@
 #define UCS_CALLBACKQ_H
 
 #include <ucs/datastruct/list.h>
+#include <ucs/datastruct/string_buffer.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/type/status.h>
 #include <stddef.h>
@@ -196,6 +197,32 @@ void ucs_callbackq_remove_oneshot(ucs_callbackq_t *cbq, ucs_callbackq_key_t key,
                                   ucs_callbackq_predicate_t pred, void *arg);
 
 
+/**
+ * Check whether the callback queue measures the time spent in its callbacks.
+ * Profiling is enabled by UCX_PROFILE_PROGRESS when the queue is initialized,
+ * by installing a measuring wrapper in place of every added callback, so
+ * @ref ucs_callbackq_dispatch is not affected when it is disabled.
+ *
+ * @param  [in] cbq      Callback queue to check.
+ *
+ * @return Nonzero if profiling is enabled, zero otherwise.
+ */
+int ucs_callbackq_prof_is_enabled(ucs_callbackq_t *cbq);
+
+
+/**
+ * Dump the number of calls, the amount of work and the time spent in each
+ * callback of the queue, sorted by descending total time. Callbacks which were
+ * already removed are reported as well. One-shot callbacks are accounted per
+ * callback function.
+ * This can be used from any thread.
+ *
+ * @param  [in]  cbq     Callback queue to dump.
+ * @param  [out] strb    String buffer to append the report to.
+ */
+void ucs_callbackq_prof_dump(ucs_callbackq_t *cbq, ucs_string_buffer_t *strb);
+
+
 /**
  * Dispatch callbacks from the callback queue.
  * Must be called from single thread only.
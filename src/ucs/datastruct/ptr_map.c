@@ -10,82 +10,126 @@
 
 #include "ptr_map.inl"
 
+#include <ucs/debug/memtrack_int.h>
+#include <string.h>
 
-static void ucs_ptr_hash_destroy(ucs_ptr_hash_t *ptr_hash)
+
+#define UCS_PTR_MAP_DIR_MIN_CHUNKS 8
+
+
+static ucs_status_t ucs_ptr_map_dir_grow(ucs_ptr_map_t *map)
 {
-    size_t size = kh_size(ptr_hash);
-    if (size != 0) {
-        ucs_warn("ptr hash %p contains %zd elements on destroy", ptr_hash,
-                 size);
+    ucs_ptr_map_dir_t *dir = map->dir;
+    size_t max_chunks      = (dir == NULL) ? UCS_PTR_MAP_DIR_MIN_CHUNKS :
+                                             (dir->max_chunks * 2);
+    ucs_ptr_map_dir_t *new_dir;
+
+    new_dir = ucs_malloc(sizeof(*new_dir) +
+                         (max_chunks * sizeof(*new_dir->chunks)),
+                         "ptr_map_dir");
+    if (new_dir == NULL) {
+        return UCS_ERR_NO_MEMORY;
     }
-    kh_destroy_inplace(ucs_ptr_map_impl, ptr_hash);
-}
 
-static ucs_status_t ucs_ptr_safe_hash_init(ucs_ptr_safe_hash_t *safe_hash)
-{
-    kh_init_inplace(ucs_ptr_map_impl, &safe_hash->hash);
-    return ucs_spinlock_init(&safe_hash->lock, 0);
-}
+    new_dir->prev       = dir;
+    new_dir->num_chunks = 0;
+    new_dir->max_chunks = max_chunks;
+    if (dir != NULL) {
+        memcpy(new_dir->chunks, dir->chunks,
+               dir->num_chunks * sizeof(*dir->chunks));
+        new_dir->num_chunks = dir->num_chunks;
+    }
 
-static void ucs_ptr_safe_hash_destroy(ucs_ptr_safe_hash_t *safe_hash)
-{
-    ucs_ptr_hash_destroy(&safe_hash->hash);
-    ucs_spinlock_destroy(&safe_hash->lock);
+    /* The old directory may still be used by a concurrent lookup */
+    ucs_memory_cpu_store_fence();
+    map->dir = new_dir;
+    return UCS_OK;
 }
 
-ucs_status_t ucs_ptr_safe_hash_get(ucs_ptr_map_t *map, ucs_ptr_map_key_t key,
-                                   int extract, void **ptr_p,
-                                   ucs_ptr_safe_hash_t *safe_hash)
+ucs_status_t ucs_ptr_map_grow(ucs_ptr_map_t *map)
 {
+    ucs_ptr_map_slot_t *chunk;
     ucs_status_t status;
+    size_t base, i;
 
-    ucs_spin_lock(&safe_hash->lock);
-    status = ucs_ptr_hash_get(&safe_hash->hash, key, 1, ptr_p);
-    ucs_spin_unlock(&safe_hash->lock);
+    ucs_assert(map->free_head == UCS_PTR_MAP_INDEX_NONE);
 
-    if ((status == UCS_OK) && !extract) {
-        ucs_ptr_hash_put(&map->hash, key, *ptr_p);
+    base = (map->dir == NULL) ? 0 :
+           (map->dir->num_chunks << UCS_PTR_MAP_CHUNK_SHIFT);
+    if ((base + UCS_PTR_MAP_CHUNK_SIZE) >
+        UCS_BIT(64 - UCS_PTR_MAP_KEY_INDEX_SHIFT)) {
+        return UCS_ERR_EXCEEDS_LIMIT;
     }
 
-    return status;
-}
-
-ucs_status_t ucs_ptr_safe_hash_put(ucs_ptr_map_t *map, void *ptr,
-                                   ucs_ptr_map_key_t *key,
-                                   ucs_ptr_safe_hash_t *safe_hash)
-{
-    ucs_status_t status;
+    if ((map->dir == NULL) ||
+        (map->dir->num_chunks == map->dir->max_chunks)) {
+        status = ucs_ptr_map_dir_grow(map);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
 
-    ucs_spin_lock(&safe_hash->lock);
-    *key   = ucs_ptr_map_create_key(map);
-    status = ucs_ptr_hash_put(&safe_hash->hash, *key, ptr);
-    ucs_spin_unlock(&safe_hash->lock);
+    chunk = ucs_malloc(UCS_PTR_MAP_CHUNK_SIZE * sizeof(*chunk),
+                       "ptr_map_chunk");
+    if (chunk == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
 
-    return status;
+    for (i = 0; i < UCS_PTR_MAP_CHUNK_SIZE; ++i) {
+        chunk[i].key       = (base + i) << UCS_PTR_MAP_KEY_INDEX_SHIFT;
+        chunk[i].next_free = base + i + 1;
+    }
+    chunk[UCS_PTR_MAP_CHUNK_SIZE - 1].next_free = UCS_PTR_MAP_INDEX_NONE;
+
+    map->dir->chunks[map->dir->num_chunks] = chunk;
+    ucs_memory_cpu_store_fence();
+    ++map->dir->num_chunks;
+    map->free_head = base;
+    map->free_tail = base + UCS_PTR_MAP_CHUNK_SIZE - 1;
+    return UCS_OK;
 }
 
 ucs_status_t ucs_ptr_map_init(ucs_ptr_map_t *map, int is_put_thread_safe,
-                              ucs_ptr_safe_hash_t *safe_hash)
+                              ucs_ptr_map_lock_t *safe)
 {
-    ucs_status_t status = UCS_OK;
-
     UCS_STATIC_ASSERT(!ucs_ptr_map_key_indirect(UCS_PTR_MAP_KEY_INVALID));
-    map->next_id = 0;
-    kh_init_inplace(ucs_ptr_map_impl, &map->hash);
+    map->dir       = NULL;
+    map->free_head = UCS_PTR_MAP_INDEX_NONE;
+    map->free_tail = UCS_PTR_MAP_INDEX_NONE;
+    map->count     = 0;
 
     if (is_put_thread_safe) {
-        status = ucs_ptr_safe_hash_init(safe_hash);
+        return ucs_spinlock_init(&safe->lock, 0);
     }
 
-    return status;
+    return UCS_OK;
 }
 
 void ucs_ptr_map_destroy(ucs_ptr_map_t *map, int is_put_thread_safe,
-                         ucs_ptr_safe_hash_t *safe_hash)
+                         ucs_ptr_map_lock_t *safe)
 {
-    ucs_ptr_hash_destroy(&map->hash);
+    ucs_ptr_map_dir_t *dir = map->dir;
+    ucs_ptr_map_dir_t *prev;
+    size_t i;
+
+    if (map->count != 0) {
+        ucs_warn("ptr map %p contains %zu elements on destroy", map,
+                 map->count);
+    }
+
+    if (dir != NULL) {
+        for (i = 0; i < dir->num_chunks; ++i) {
+            ucs_free(dir->chunks[i]);
+        }
+    }
+
+    while (dir != NULL) {
+        prev = dir->prev;
+        ucs_free(dir);
+        dir = prev;
+    }
 
     if (is_put_thread_safe) {
-        ucs_ptr_safe_hash_destroy(safe_hash);
+        ucs_spinlock_destroy(&safe->lock);
     }
 }
@@ -7,12 +7,11 @@
 #ifndef UCS_PTR_MAP_H_
 #define UCS_PTR_MAP_H_
 
-#include "khash.h"
-
 #include <ucs/sys/compiler.h>
 #include <ucs/type/spinlock.h>
 #include <ucs/type/status.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 BEGIN_C_DECLS
@@ -36,22 +35,47 @@ BEGIN_C_DECLS
 typedef uintptr_t ucs_ptr_map_key_t;
 
 
-KHASH_TYPE(ucs_ptr_map_impl, ucs_ptr_map_key_t, void*);
-typedef khash_t(ucs_ptr_map_impl) ucs_ptr_hash_t;
+/**
+ * Slot of the indirect keys table.
+ */
+typedef struct ucs_ptr_map_slot {
+    ucs_ptr_map_key_t key; /**< Key of the stored pointer. When the slot is
+                                free, holds the key to use next time, without
+                                the indirect flag. */
+    union {
+        void          *ptr; /**< Stored pointer. */
+        size_t        next_free; /**< Next free slot index. */
+    };
+} ucs_ptr_map_slot_t;
+
+
+/**
+ * Directory of slot table chunks. Chunks are never moved, and replaced
+ * directories are kept until the map is destroyed, so lookups may run
+ * concurrently with a thread-safe put which grows the table.
+ */
+typedef struct ucs_ptr_map_dir ucs_ptr_map_dir_t;
+struct ucs_ptr_map_dir {
+    ucs_ptr_map_dir_t  *prev; /**< Replaced directory. */
+    size_t             num_chunks; /**< Number of allocated chunks. */
+    size_t             max_chunks; /**< Capacity of the directory. */
+    ucs_ptr_map_slot_t *chunks[0]; /**< Chunks of slots. */
+};
 
 
 typedef struct ucs_ptr_map {
-    uint64_t       next_id; /**< Generator of unique keys per map. */
-    ucs_ptr_hash_t hash; /**< Hash table to store indirect key to pointer
-                              associations. */
+    ucs_ptr_map_dir_t *dir; /**< Table of slots for indirect keys, indexed by
+                                 the key. */
+    size_t            free_head; /**< First free slot index. */
+    size_t            free_tail; /**< Last free slot index. */
+    size_t            count; /**< Number of stored indirect keys. */
 } ucs_ptr_map_t;
 
 
-typedef struct ucs_ptr_safe_hash {
-    ucs_ptr_hash_t hash; /**< Hash table to store indirect key to pointer
-                              associations. */
-    ucs_spinlock_t lock; /**< Spin lock to synchronize access to hash table. */
-} ucs_ptr_safe_hash_t;
+typedef struct ucs_ptr_map_lock {
+    ucs_spinlock_t lock; /**< Spin lock to synchronize modifications of the
+                              slot table. */
+} ucs_ptr_map_lock_t;
 
 
 /**
@@ -70,7 +94,7 @@ typedef struct ucs_ptr_safe_hash {
 #define UCS_PTR_MAP_TYPE(_name, _is_put_thread_safe) \
     typedef struct { \
         ucs_ptr_map_t       ptr_map; \
-        ucs_ptr_safe_hash_t safe[_is_put_thread_safe]; \
+        ucs_ptr_map_lock_t  safe[_is_put_thread_safe]; \
     } UCS_PTR_MAP_T(_name);
 
 
@@ -79,21 +103,14 @@ typedef struct ucs_ptr_safe_hash {
 
 /* Internal helper function */
 ucs_status_t ucs_ptr_map_init(ucs_ptr_map_t *map, int is_put_thread_safe,
-                              ucs_ptr_safe_hash_t *safe_hash);
+                              ucs_ptr_map_lock_t *safe);
 
 
 void ucs_ptr_map_destroy(ucs_ptr_map_t *map, int is_put_thread_safe,
-                         ucs_ptr_safe_hash_t *safe_hash);
-
-
-ucs_status_t
-ucs_ptr_safe_hash_put(ucs_ptr_map_t *map, void *ptr, ucs_ptr_map_key_t *key,
-                      ucs_ptr_safe_hash_t *safe_hash);
+                         ucs_ptr_map_lock_t *safe);
 
 
-ucs_status_t
-ucs_ptr_safe_hash_get(ucs_ptr_map_t *map, ucs_ptr_map_key_t key, int extract,
-                      void **ptr_p, ucs_ptr_safe_hash_t *safe_hash);
+ucs_status_t ucs_ptr_map_grow(ucs_ptr_map_t *map);
 
 END_C_DECLS
 
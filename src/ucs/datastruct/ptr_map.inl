@@ -9,6 +9,7 @@
 
 #include "ptr_map.h"
 
+#include <ucs/arch/cpu.h>
 #include <ucs/debug/log.h>
 
 BEGIN_C_DECLS
@@ -20,6 +21,36 @@ BEGIN_C_DECLS
 #define UCS_PTR_MAP_KEY_INDIRECT_FLAG   UCS_BIT(0)
 
 
+/**
+ * Indirect key layout: the slot index, a generation counter of the slot which
+ * is advanced every time the slot is released, and the indirect flag.
+ *
+ *   63                      33 32            1   0
+ *  +--------------------------+---------------+---+
+ *  |        slot index        |   generation  | 1 |
+ *  +--------------------------+---------------+---+
+ */
+#define UCS_PTR_MAP_KEY_GEN_SHIFT       1
+#define UCS_PTR_MAP_KEY_GEN_BITS        32
+#define UCS_PTR_MAP_KEY_GEN_MASK \
+    (UCS_MASK(UCS_PTR_MAP_KEY_GEN_BITS) << UCS_PTR_MAP_KEY_GEN_SHIFT)
+#define UCS_PTR_MAP_KEY_INDEX_SHIFT \
+    (UCS_PTR_MAP_KEY_GEN_SHIFT + UCS_PTR_MAP_KEY_GEN_BITS)
+
+
+/**
+ * Number of slots in a chunk of the slot table.
+ */
+#define UCS_PTR_MAP_CHUNK_SHIFT         8
+#define UCS_PTR_MAP_CHUNK_SIZE          UCS_BIT(UCS_PTR_MAP_CHUNK_SHIFT)
+
+
+/**
+ * End of the free slots list.
+ */
+#define UCS_PTR_MAP_INDEX_NONE          SIZE_MAX
+
+
 /**
  * Returns whether the key is indirect or not.
  *
@@ -30,57 +61,100 @@ BEGIN_C_DECLS
 #define ucs_ptr_map_key_indirect(_key) ((_key) & UCS_PTR_MAP_KEY_INDIRECT_FLAG)
 
 
-KHASH_IMPL(ucs_ptr_map_impl, ucs_ptr_map_key_t, void*, 1,
-           kh_int64_hash_func, kh_int64_hash_equal);
-
-static UCS_F_ALWAYS_INLINE ucs_ptr_map_key_t
-ucs_ptr_map_create_key(ucs_ptr_map_t *map)
+static UCS_F_ALWAYS_INLINE ucs_ptr_map_slot_t *
+ucs_ptr_map_slot(const ucs_ptr_map_dir_t *dir, size_t index)
 {
-    return (map->next_id += UCS_PTR_MAP_KEY_MIN_ALIGN) |
-            UCS_PTR_MAP_KEY_INDIRECT_FLAG;
+    return &dir->chunks[index >> UCS_PTR_MAP_CHUNK_SHIFT]
+                       [index & (UCS_PTR_MAP_CHUNK_SIZE - 1)];
 }
 
-static UCS_F_ALWAYS_INLINE ucs_status_t
-ucs_ptr_hash_put(ucs_ptr_hash_t *hash, ucs_ptr_map_key_t key, void *ptr)
+static UCS_F_ALWAYS_INLINE ucs_ptr_map_slot_t *
+ucs_ptr_map_slot_find(const ucs_ptr_map_t *map, ucs_ptr_map_key_t key)
 {
-    khiter_t iter;
-    int ret;
-
-    iter = kh_put(ucs_ptr_map_impl, hash, key, &ret);
-    if (ucs_unlikely(ret == UCS_KH_PUT_FAILED)) {
-        return UCS_ERR_NO_MEMORY;
-    } else if (ucs_unlikely(ret == UCS_KH_PUT_KEY_PRESENT)) {
-        return UCS_ERR_ALREADY_EXISTS;
+    const ucs_ptr_map_dir_t *dir = map->dir;
+    size_t index                 = key >> UCS_PTR_MAP_KEY_INDEX_SHIFT;
+    ucs_ptr_map_slot_t *slot;
+
+    if (ucs_unlikely((dir == NULL) ||
+                     ((index >> UCS_PTR_MAP_CHUNK_SHIFT) >= dir->num_chunks))) {
+        return NULL;
     }
 
-    kh_value(hash, iter) = ptr;
-    return UCS_OK;
+    /* Read the chunk only after it was published by ucs_ptr_map_grow() */
+    ucs_memory_cpu_load_fence();
+
+    /* A stale key does not match since the generation of the slot was
+     * advanced when the key was released */
+    slot = ucs_ptr_map_slot(dir, index);
+    if (ucs_unlikely(slot->key != key)) {
+        return NULL;
+    }
+
+    /* Read the pointer only after the key which was set after it */
+    ucs_memory_cpu_load_fence();
+    return slot;
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
-ucs_ptr_hash_get(ucs_ptr_hash_t *hash, ucs_ptr_map_key_t key, int extract,
-                 void **ptr_p)
+ucs_ptr_map_slot_put(ucs_ptr_map_t *map, void *ptr, ucs_ptr_map_key_t *key)
 {
-    khiter_t iter;
+    ucs_ptr_map_slot_t *slot;
+    ucs_status_t status;
 
-    iter = kh_get(ucs_ptr_map_impl, hash, key);
-    if (ucs_unlikely(iter == kh_end(hash))) {
-        *ptr_p = NULL; /* To suppress compiler warning */
-        return UCS_ERR_NO_ELEM;
+    if (ucs_unlikely(map->free_head == UCS_PTR_MAP_INDEX_NONE)) {
+        status = ucs_ptr_map_grow(map);
+        if (status != UCS_OK) {
+            return status;
+        }
     }
 
-    *ptr_p = kh_value(hash, iter);
-    if (extract) {
-        kh_del(ucs_ptr_map_impl, hash, iter);
+    slot           = ucs_ptr_map_slot(map->dir, map->free_head);
+    map->free_head = slot->next_free;
+    if (map->free_head == UCS_PTR_MAP_INDEX_NONE) {
+        map->free_tail = UCS_PTR_MAP_INDEX_NONE;
     }
+
+    slot->ptr = ptr;
+    ++map->count;
+
+    /* Make the pointer visible before the key, for lookups by other threads */
+    ucs_memory_cpu_store_fence();
+    *key = slot->key = slot->key | UCS_PTR_MAP_KEY_INDIRECT_FLAG;
     return UCS_OK;
 }
 
+static UCS_F_ALWAYS_INLINE void
+ucs_ptr_map_slot_release(ucs_ptr_map_t *map, ucs_ptr_map_slot_t *slot)
+{
+    ucs_ptr_map_key_t key = slot->key;
+    size_t index          = key >> UCS_PTR_MAP_KEY_INDEX_SHIFT;
+
+    ucs_assert(map->count > 0);
+    slot->key       = (key & ~(UCS_PTR_MAP_KEY_GEN_MASK |
+                               UCS_PTR_MAP_KEY_INDIRECT_FLAG)) |
+                      ((key + UCS_BIT(UCS_PTR_MAP_KEY_GEN_SHIFT)) &
+                       UCS_PTR_MAP_KEY_GEN_MASK);
+    slot->next_free = UCS_PTR_MAP_INDEX_NONE;
+
+    /* Released slots are reused in FIFO order, so the generation of a slot
+     * advances only once in a full cycle over all free slots */
+    if (map->free_tail == UCS_PTR_MAP_INDEX_NONE) {
+        map->free_head = index;
+    } else {
+        ucs_ptr_map_slot(map->dir, map->free_tail)->next_free = index;
+    }
+
+    map->free_tail = index;
+    --map->count;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucs_ptr_map_put(ucs_ptr_map_t *map, void *ptr, int indirect,
                 ucs_ptr_map_key_t *key, int is_put_thread_safe,
-                ucs_ptr_safe_hash_t *safe_hash)
+                ucs_ptr_map_lock_t *safe)
 {
+    ucs_status_t status;
+
     if (ucs_likely(!indirect)) {
         *key = (uintptr_t)ptr;
         ucs_assert(!(*key & UCS_PTR_MAP_KEY_MIN_ALIGN));
@@ -88,19 +162,21 @@ ucs_ptr_map_put(ucs_ptr_map_t *map, void *ptr, int indirect,
         return UCS_ERR_NO_PROGRESS;
     }
 
-    if (is_put_thread_safe) {
-        return ucs_ptr_safe_hash_put(map, ptr, key, safe_hash);
+    if (!is_put_thread_safe) {
+        return ucs_ptr_map_slot_put(map, ptr, key);
     }
 
-    *key = ucs_ptr_map_create_key(map);
-    return ucs_ptr_hash_put(&map->hash, *key, ptr);
+    ucs_spin_lock(&safe->lock);
+    status = ucs_ptr_map_slot_put(map, ptr, key);
+    ucs_spin_unlock(&safe->lock);
+    return status;
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucs_ptr_map_get(ucs_ptr_map_t *map, ucs_ptr_map_key_t key, int extract,
-                void **ptr_p, int is_put_thread_safe,
-                ucs_ptr_safe_hash_t *safe_hash)
+                void **ptr_p, int is_put_thread_safe, ucs_ptr_map_lock_t *safe)
 {
+    ucs_ptr_map_slot_t *slot;
     ucs_status_t status;
 
     if (ucs_likely(!ucs_ptr_map_key_indirect(key))) {
@@ -108,13 +184,35 @@ ucs_ptr_map_get(ucs_ptr_map_t *map, ucs_ptr_map_key_t key, int extract,
         return UCS_ERR_NO_PROGRESS;
     }
 
-    status = ucs_ptr_hash_get(&map->hash, key, extract, ptr_p);
-    if (ucs_likely(status != UCS_ERR_NO_ELEM)) {
-        return status;
+    if (ucs_likely(!extract)) {
+        /* Lookup does not modify the table, so it does not have to be
+         * synchronized with a concurrent thread-safe put */
+        slot = ucs_ptr_map_slot_find(map, key);
+        if (ucs_unlikely(slot == NULL)) {
+            *ptr_p = NULL; /* To suppress compiler warning */
+            return UCS_ERR_NO_ELEM;
+        }
+
+        *ptr_p = slot->ptr;
+        return UCS_OK;
+    }
+
+    if (is_put_thread_safe) {
+        ucs_spin_lock(&safe->lock);
+    }
+
+    slot = ucs_ptr_map_slot_find(map, key);
+    if (ucs_unlikely(slot == NULL)) {
+        *ptr_p = NULL; /* To suppress compiler warning */
+        status = UCS_ERR_NO_ELEM;
+    } else {
+        *ptr_p = slot->ptr;
+        ucs_ptr_map_slot_release(map, slot);
+        status = UCS_OK;
     }
 
     if (is_put_thread_safe) {
-        status = ucs_ptr_safe_hash_get(map, key, extract, ptr_p, safe_hash);
+        ucs_spin_unlock(&safe->lock);
     }
 
     return status;
@@ -122,10 +220,10 @@ ucs_ptr_map_get(ucs_ptr_map_t *map, ucs_ptr_map_key_t key, int extract,
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucs_ptr_map_del(ucs_ptr_map_t *map, ucs_ptr_map_key_t key,
-                int is_put_thread_safe, ucs_ptr_safe_hash_t *safe_hash)
+                int is_put_thread_safe, ucs_ptr_map_lock_t *safe)
 {
     void UCS_V_UNUSED *dummy;
-    return ucs_ptr_map_get(map, key, 1, &dummy, is_put_thread_safe, safe_hash);
+    return ucs_ptr_map_get(map, key, 1, &dummy, is_put_thread_safe, safe);
 }
 
 #define UCS_PTR_MAP_IMPL(_name, _is_put_thread_safe) \
@@ -193,7 +291,7 @@ ucs_ptr_map_del_##_name(UCS_PTR_MAP_T(_name) *map, ucs_ptr_map_key_t key) \
  * @param [in]  map       Container.
  * @param [in]  ptr       Object pointer.
  * @param [in]  indirect  If nonzero, the pointer @a ptr is stored in the
- *                        internal hash table, associated with a unique indirect
+ *                        internal slot table, associated with a unique indirect
  *                        key which is returned from this function. Otherwise,
  *                        the returned value is the integer representation of
  *                        the pointer @a ptr.
@@ -230,8 +328,8 @@ ucs_ptr_map_del_##_name(UCS_PTR_MAP_T(_name) *map, ucs_ptr_map_key_t key) \
  * @return - UCS_OK on success
  *         - UCS_ERR_NO_PROGRESS if this key is direct and therefore no action
  *           was performed
- *         - UCS_ERR_NO_ELEM if the key is not found in the internal hash
- *           table.
+ *         - UCS_ERR_NO_ELEM if the key is not found in the internal slot
+ *           table, or was already removed.
  */
 #define UCS_PTR_MAP_DEL(_name, _map, _key) ucs_ptr_map_del_##_name(_map, _key)
 
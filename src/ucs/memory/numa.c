@@ -16,10 +16,13 @@
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 #include <ucs/type/spinlock.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/ptr_arith.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <sched.h>
 #include <dirent.h>
+#include <sys/syscall.h>
 
 #define UCS_NUMA_MIN_DISTANCE       10
 #define UCS_NUMA_NODE_MAX           INT16_MAX
@@ -27,6 +30,12 @@
 #define UCS_NUMA_NODES_DIR_PATH     UCS_SYS_FS_SYSTEM_PATH "/node"
 #define UCS_NUMA_NODE_DISTANCE_PATH UCS_NUMA_NODES_DIR_PATH "/node%d/distance"
 
+/* Memory policy definitions from linux/mempolicy.h */
+#define UCS_NUMA_MPOL_PREFERRED     1
+#define UCS_NUMA_MPOL_MF_MOVE       UCS_BIT(1)
+#define UCS_NUMA_MBIND_MAX_NODES    1024
+#define UCS_NUMA_MASK_WORD_BITS     (sizeof(unsigned long) * 8)
+
 
 KHASH_MAP_INIT_INT(numa_distance, ucs_numa_distance_t);
 
@@ -302,6 +311,71 @@ ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2)
     return distance;
 }
 
+ucs_numa_node_t ucs_numa_node_of_process()
+{
+    ucs_numa_node_t node = UCS_NUMA_NODE_UNDEFINED;
+    ucs_sys_cpuset_t cpuset;
+    unsigned cpu;
+
+    if (ucs_sys_getaffinity(&cpuset) < 0) {
+        return UCS_NUMA_NODE_UNDEFINED;
+    }
+
+    for (cpu = 0; cpu < ucs_numa_num_configured_cpus(); ++cpu) {
+        if (!CPU_ISSET(cpu, &cpuset)) {
+            continue;
+        }
+
+        if (node == UCS_NUMA_NODE_UNDEFINED) {
+            node = ucs_numa_node_of_cpu(cpu);
+        } else if (node != ucs_numa_node_of_cpu(cpu)) {
+            return UCS_NUMA_NODE_UNDEFINED;
+        }
+    }
+
+    return node;
+}
+
+ucs_status_t
+ucs_numa_mem_bind_preferred(void *address, size_t length, ucs_numa_node_t node)
+{
+#ifdef SYS_mbind
+    size_t page_size = ucs_get_page_size();
+    unsigned long nodemask[UCS_NUMA_MBIND_MAX_NODES /
+                           UCS_NUMA_MASK_WORD_BITS] = {0};
+    uintptr_t start, end;
+
+    if ((node < 0) || (node >= ucs_numa_num_configured_nodes()) ||
+        (node >= UCS_NUMA_MBIND_MAX_NODES)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    /* Pages which are partially outside of the range may hold other data, so
+     * leave their policy unchanged */
+    start = ucs_align_up((uintptr_t)address, page_size);
+    end   = ucs_align_down((uintptr_t)address + length, page_size);
+    if (end <= start) {
+        return UCS_OK;
+    }
+
+    nodemask[node / UCS_NUMA_MASK_WORD_BITS] |=
+            UCS_BIT(node % UCS_NUMA_MASK_WORD_BITS);
+
+    if (syscall(SYS_mbind, start, end - start, UCS_NUMA_MPOL_PREFERRED,
+                nodemask, UCS_NUMA_MBIND_MAX_NODES,
+                UCS_NUMA_MPOL_MF_MOVE) != 0) {
+        ucs_debug("mbind(%p, %zu, node %d) failed: %m", address, length, node);
+        /* Not implemented, or forbidden by a seccomp filter */
+        return ((errno == ENOSYS) || (errno == EPERM)) ?
+               UCS_ERR_UNSUPPORTED : UCS_ERR_IO_ERROR;
+    }
+
+    return UCS_OK;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 void ucs_numa_init()
 {
     ucs_spinlock_init(&ucs_numa_global_ctx.lock, 0);
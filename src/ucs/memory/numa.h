@@ -8,6 +8,8 @@
 #define UCS_NUMA_H_
 
 #include <ucs/sys/compiler_def.h>
+#include <ucs/type/status.h>
+#include <stddef.h>
 #include <stdint.h>
 
 BEGIN_C_DECLS
@@ -69,6 +71,31 @@ ucs_numa_node_t ucs_numa_node_of_device(const char *dev_path);
 ucs_numa_distance_t
 ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2);
 
+
+/**
+ * @return The NUMA node of the CPUs the current process is bound to, or
+ *         UCS_NUMA_NODE_UNDEFINED if the process may run on CPUs of more than
+ *         one NUMA node.
+ */
+ucs_numa_node_t ucs_numa_node_of_process(void);
+
+
+/**
+ * Set a preferred NUMA node for a memory range, and move its pages which are
+ * already allocated to that node. Pages are still allocated from other nodes
+ * if the preferred node does not have free memory. Only pages which are
+ * entirely inside the range are affected.
+ *
+ * @param [in]  address  Start of the memory range.
+ * @param [in]  length   Length of the memory range.
+ * @param [in]  node     Preferred NUMA node.
+ *
+ * @return UCS_OK if the memory policy was set, UCS_ERR_UNSUPPORTED if it is
+ *         not supported on the system, or another error if it failed.
+ */
+ucs_status_t
+ucs_numa_mem_bind_preferred(void *address, size_t length, ucs_numa_node_t node);
+
 END_C_DECLS
 
 #endif
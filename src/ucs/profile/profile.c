@@ -10,6 +10,7 @@
 
 #include "profile.h"
 
+#include <ucs/datastruct/array.h>
 #include <ucs/datastruct/list.h>
 #include <ucs/debug/debug_int.h>
 #include <ucs/debug/log.h>
@@ -26,6 +27,11 @@ typedef struct ucs_profile_global_location {
 } ucs_profile_global_location_t;
 
 
+/* Back-pointers to location indexes which share an existing location */
+UCS_ARRAY_DECLARE_TYPE(ucs_profile_loc_id_array_t, unsigned,
+                       volatile ucs_profile_loc_id_t*);
+
+
 /* Profiling per-thread context */
 typedef struct ucs_profile_thread_context {
     pthread_t                         pthread_id;    /**< POSIX thread id */
@@ -61,6 +67,7 @@ struct ucs_profile_context  {
     ucs_profile_global_location_t *locations;       /**< Array of all locations */
     unsigned                      num_locations;    /**< Number of valid locations */
     unsigned                      max_locations;    /**< Size of locations array */
+    ucs_profile_loc_id_array_t    loc_id_aliases;   /**< Other indexes of existing locations */
     pthread_mutex_t               mutex;            /**< Protects updating the locations array */
     pthread_key_t                 tls_key;          /**< TLS key for per-thread context */
     ucs_list_link_t               thread_list;      /**< List of all thread contexts */
@@ -476,6 +483,7 @@ ucs_profile_get_location(ucs_profile_context_t *ctx, ucs_profile_type_t type,
                          volatile ucs_profile_loc_id_t *loc_id_p)
 {
     ucs_profile_global_location_t *loc, *new_locations;
+    volatile ucs_profile_loc_id_t **alias;
     int loc_id;
 
     pthread_mutex_lock(&ctx->mutex);
@@ -529,8 +537,20 @@ ucs_profile_get_location(ucs_profile_context_t *ctx, ucs_profile_type_t type,
     loc->super.line = line;
     loc->super.type = type;
     loc->loc_id_p   = loc_id_p;
+    goto out_set_id;
 
 out_found:
+    if (loc->loc_id_p != loc_id_p) {
+        /* Same location in another copy of an inline function; track its
+         * index so it would be reset as well */
+        alias = ucs_array_append(&ctx->loc_id_aliases,
+                                 ucs_warn("failed to add location alias");
+                                 *loc_id_p = loc_id = UCS_PROFILE_LOC_ID_DISABLED;
+                                 goto out_unlock);
+        *alias = loc_id_p;
+    }
+
+out_set_id:
     *loc_id_p = loc_id = ucs_profile_location_id(ctx, loc);
     ucs_memory_cpu_store_fence();
 out_unlock:
@@ -649,6 +669,7 @@ static void ucs_profile_check_active_threads(ucs_profile_context_t *ctx)
 void ucs_profile_reset_locations_id(ucs_profile_context_t *ctx)
 {
     ucs_profile_global_location_t *loc;
+    volatile ucs_profile_loc_id_t **alias;
 
     pthread_mutex_lock(&ctx->mutex);
 
@@ -656,6 +677,11 @@ void ucs_profile_reset_locations_id(ucs_profile_context_t *ctx)
         *loc->loc_id_p = -1;
     }
 
+    ucs_array_for_each(alias, &ctx->loc_id_aliases) {
+        **alias = -1;
+    }
+    ucs_array_clear(&ctx->loc_id_aliases);
+
     pthread_mutex_unlock(&ctx->mutex);
 }
 
@@ -667,6 +693,7 @@ static void ucs_profile_reset_locations(ucs_profile_context_t *ctx)
     ctx->max_locations = 0;
     ucs_free(ctx->locations);
     ctx->locations = NULL;
+    ucs_array_cleanup_dynamic(&ctx->loc_id_aliases);
 
     pthread_mutex_unlock(&ctx->mutex);
 }
@@ -743,6 +770,7 @@ ucs_status_t ucs_profile_init(unsigned profile_mode, const char *file_name,
     ctx->num_locations    = 0;
     ctx->locations        = NULL;
     ctx->max_locations    = 0;
+    ucs_array_init_dynamic(&ctx->loc_id_aliases);
 
     if (profile_mode && !strlen(file_name)) {
         // TODO make sure profiling file is writeable
@@ -132,6 +132,13 @@ struct ucs_stats_node {
     ucs_stats_counter_t      counters[1];        /* instance counters */
 };
 
+/* Writer state kept between delta-encoded statistics frames */
+typedef struct ucs_stats_delta_state {
+    ucs_stats_counter_t       *counters;          /* Values sent in last frame */
+    size_t                    num_counters;       /* Length of counters array */
+    int                       need_keyframe;      /* Next frame must be full */
+} ucs_stats_delta_state_t;
+
 struct ucs_stats_filter_node {
     ucs_stats_filter_node_t   *parent;
     ucs_list_link_t           list;               /* nodes sharing same parent.*/
@@ -164,6 +171,34 @@ ucs_status_t ucs_stats_node_initv(ucs_stats_node_t *node, ucs_stats_class_t *cls
 ucs_status_t ucs_stats_serialize(FILE *stream, ucs_stats_node_t *root, int options);
 
 
+/**
+ * Serialize statistics in delta mode. The first frame, and any frame after the
+ * tree structure has changed, is a full binary snapshot (keyframe); other
+ * frames contain only the varint-encoded differences of the counters which
+ * changed since the previous frame.
+ *
+ * @param stream   Destination
+ * @param root     Statistics node root.
+ * @param options  Serialization options.
+ * @param state    Delta state, updated with the values of this frame.
+ */
+ucs_status_t ucs_stats_serialize_delta(FILE *stream, ucs_stats_node_t *root,
+                                       int options,
+                                       ucs_stats_delta_state_t *state);
+
+
+/**
+ * Initialize delta serialization state. The next frame will be a keyframe.
+ */
+void ucs_stats_delta_state_init(ucs_stats_delta_state_t *state);
+
+
+/**
+ * Release delta serialization state.
+ */
+void ucs_stats_delta_state_cleanup(ucs_stats_delta_state_t *state);
+
+
 /**
  * De-serialize statistics.
  *
@@ -175,6 +210,20 @@ ucs_status_t ucs_stats_serialize(FILE *stream, ucs_stats_node_t *root, int optio
 ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root);
 
 
+/**
+ * De-serialize one frame of statistics written by ucs_stats_serialize_delta().
+ * A keyframe replaces the tree in *p_root (releasing the previous one), and a
+ * delta frame updates the counters of *p_root in place.
+ *
+ * @param stream   Source data.
+ * @param p_root   Tree reconstructed from previous frames, or NULL before the
+ *                 first frame. Filled with the updated statistics tree.
+ *
+ * @return UCS_ERR_NO_ELEM if hit EOF.
+ */
+ucs_status_t ucs_stats_deserialize_delta(FILE *stream, ucs_stats_node_t **p_root);
+
+
 /**
  * Release stats returned by ucs_stats_deserialize().
  * @param root     Stats to release.
@@ -35,6 +35,11 @@
 #define UCS_STATS_COUNTER_U64        3
 
 
+/* Data format version */
+#define UCS_STATS_DATA_VERSION       1  /* Full snapshot of the tree */
+#define UCS_STATS_DATA_VERSION_DELTA 2  /* Counter changes since last frame */
+
+
 /* Compression mode */
 #define UCS_STATS_COMPRESSION_NONE   0
 #define UCS_STATS_COMPRESSION_BZIP2  1
@@ -226,19 +231,89 @@ static void ucs_stats_write_counters(ucs_stats_counter_t *counters,
     FWRITE(counter_data, pos - counter_data, stream);
 }
 
+static void ucs_stats_write_varint(uint64_t value, FILE *stream)
+{
+    uint8_t byte;
+
+    /* LEB128: 7 bits per byte, MSB set on all bytes but the last one */
+    do {
+        byte    = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            byte |= 0x80;
+        }
+        FWRITE_ONE(&byte, stream);
+    } while (value != 0);
+}
+
+static ucs_status_t ucs_stats_read_varint(FILE *stream, uint64_t *value_p)
+{
+    uint64_t value = 0;
+    unsigned shift = 0;
+    int c;
+
+    do {
+        c = fgetc(stream);
+        if (c == EOF) {
+            ucs_error("Error parsing statistics - premature end of stream");
+            return UCS_ERR_MESSAGE_TRUNCATED;
+        }
+
+        if (shift >= 64) {
+            ucs_error("Error parsing statistics - varint too long");
+            return UCS_ERR_OUT_OF_RANGE;
+        }
+
+        value |= (uint64_t)(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+
+    *value_p = value;
+    return UCS_OK;
+}
+
+/* Map signed deltas to unsigned so that small negative values stay short */
+static UCS_F_ALWAYS_INLINE uint64_t ucs_stats_zigzag_encode(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static UCS_F_ALWAYS_INLINE int64_t ucs_stats_zigzag_decode(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static unsigned
+ucs_stats_filter_counters(ucs_stats_node_t *node,
+                          ucs_stats_counter_t *filtered_counters)
+{
+    ucs_stats_filter_node_t *filter_node = node->filter_node;
+    uint32_t filtered_counter_index      = 0;
+    ucs_stats_node_t *temp_node;
+    uint32_t counter_index;
+
+    ucs_for_each_bit(counter_index, filter_node->counters_bitmask) {
+        filtered_counters[filtered_counter_index] = 0;
+        ucs_list_for_each(temp_node, &filter_node->type_list_head, type_list) {
+            filtered_counters[filtered_counter_index] +=
+                    temp_node->counters[counter_index];
+        }
+        filtered_counter_index++;
+    }
+
+    return filtered_counter_index;
+}
+
 static void
 ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
                                   ucs_stats_children_sel_t sel,
                                   ucs_stats_clsid_t **cls_hash)
 {
-    ucs_stats_counter_t filtered_counters[64] = {};
-    ucs_stats_filter_node_t *filter_node      = node->filter_node;
-    uint32_t filtered_counter_index           = 0;
+    ucs_stats_counter_t filtered_counters[64];
     ucs_stats_class_t *cls = node->cls;
     ucs_stats_clsid_t *elem, search;
-    ucs_stats_node_t *temp_node;
     ucs_stats_node_t *child;
-    uint32_t counter_index;
+    unsigned num_filtered;
     uint8_t sentinel;
 
     /* Search the class */
@@ -253,15 +328,10 @@ ucs_stats_serialize_binary_recurs(FILE *stream, ucs_stats_node_t *node,
     ucs_stats_write_str(node->name, stream);
 
     /* Filter output */
-    ucs_for_each_bit(counter_index, filter_node->counters_bitmask) {
-        ucs_list_for_each(temp_node, &filter_node->type_list_head, type_list) {
-            filtered_counters[filtered_counter_index] += temp_node->counters[counter_index];
-        }
-        filtered_counter_index++;
-    }
+    num_filtered = ucs_stats_filter_counters(node, filtered_counters);
 
     /* Write counters */
-    ucs_stats_write_counters(filtered_counters, filtered_counter_index, stream);
+    ucs_stats_write_counters(filtered_counters, num_filtered, stream);
 
     /* Children */
     ucs_list_for_each(child, &node->children[sel], list) {
@@ -287,7 +357,7 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
     sglib_hashed_ucs_stats_clsid_t_init(cls_hash);
 
     /* Write header */
-    hdr.version     = 1;
+    hdr.version     = UCS_STATS_DATA_VERSION;
     hdr.compression = UCS_STATS_COMPRESSION_NONE;
     hdr.reserved    = 0;
     hdr.num_classes = ucs_stats_get_all_classes_recurs(root, sel, cls_hash);
@@ -330,6 +400,128 @@ ucs_stats_serialize_binary(FILE *stream, ucs_stats_node_t *root,
     return UCS_OK;
 }
 
+/*
+ * Collect the filtered counters of all nodes in the same depth-first order
+ * used by ucs_stats_serialize_binary_recurs(). If counters is NULL, only count
+ * them.
+ */
+static size_t ucs_stats_collect_counters_recurs(ucs_stats_node_t *node,
+                                                ucs_stats_children_sel_t sel,
+                                                ucs_stats_counter_t *counters,
+                                                size_t offset)
+{
+    ucs_stats_counter_t filtered_counters[64];
+    ucs_stats_node_t *child;
+    unsigned num_filtered;
+
+    num_filtered = ucs_stats_filter_counters(node, filtered_counters);
+    if (counters != NULL) {
+        memcpy(counters + offset, filtered_counters,
+               num_filtered * sizeof(*counters));
+    }
+    offset += num_filtered;
+
+    ucs_list_for_each(child, &node->children[sel], list) {
+        offset = ucs_stats_collect_counters_recurs(child, sel, counters,
+                                                   offset);
+    }
+
+    return offset;
+}
+
+static void ucs_stats_serialize_delta_frame(FILE *stream,
+                                            const ucs_stats_counter_t *prev,
+                                            const ucs_stats_counter_t *curr,
+                                            size_t num_counters)
+{
+    ucs_stats_data_header_t hdr;
+    size_t i, num_changed, last;
+
+    hdr.version     = UCS_STATS_DATA_VERSION_DELTA;
+    hdr.compression = UCS_STATS_COMPRESSION_NONE;
+    hdr.reserved    = 0;
+    hdr.num_classes = 0;
+    FWRITE_ONE(&hdr, stream);
+
+    num_changed = 0;
+    for (i = 0; i < num_counters; ++i) {
+        num_changed += (curr[i] != prev[i]);
+    }
+
+    /*
+     * Number of changed counters, followed by a (gap, delta) pair for each of
+     * them: the gap is the number of unchanged counters since the previous
+     * changed one, and the delta is zigzag-encoded.
+     */
+    ucs_stats_write_varint(num_changed, stream);
+    last = 0;
+    for (i = 0; i < num_counters; ++i) {
+        if (curr[i] == prev[i]) {
+            continue;
+        }
+
+        ucs_stats_write_varint(i - last, stream);
+        ucs_stats_write_varint(ucs_stats_zigzag_encode(curr[i] - prev[i]),
+                               stream);
+        last = i + 1;
+    }
+}
+
+ucs_status_t ucs_stats_serialize_delta(FILE *stream, ucs_stats_node_t *root,
+                                       int options,
+                                       ucs_stats_delta_state_t *state)
+{
+    ucs_stats_children_sel_t sel =
+                    (options & UCS_STATS_SERIALIZE_INACTVIVE) ?
+                                    UCS_STATS_INACTIVE_CHILDREN :
+                                    UCS_STATS_ACTIVE_CHILDREN;
+    ucs_stats_counter_t *counters;
+    size_t num_counters;
+    ucs_status_t status;
+
+    num_counters = ucs_stats_collect_counters_recurs(root, sel, NULL, 0);
+    counters     = malloc(ucs_max(num_counters, 1) * sizeof(*counters));
+    if (counters == NULL) {
+        ucs_error("failed to allocate %zu statistics counters", num_counters);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_stats_collect_counters_recurs(root, sel, counters, 0);
+
+    if (state->need_keyframe || (state->counters == NULL) ||
+        (state->num_counters != num_counters) ||
+        (sel != UCS_STATS_ACTIVE_CHILDREN)) {
+        status = ucs_stats_serialize_binary(stream, root, sel);
+        if (status != UCS_OK) {
+            free(counters);
+            return status;
+        }
+
+        state->need_keyframe = 0;
+    } else {
+        ucs_stats_serialize_delta_frame(stream, state->counters, counters,
+                                        num_counters);
+    }
+
+    free(state->counters);
+    state->counters     = counters;
+    state->num_counters = num_counters;
+    return UCS_OK;
+}
+
+void ucs_stats_delta_state_init(ucs_stats_delta_state_t *state)
+{
+    state->counters      = NULL;
+    state->num_counters  = 0;
+    state->need_keyframe = 1;
+}
+
+void ucs_stats_delta_state_cleanup(ucs_stats_delta_state_t *state)
+{
+    free(state->counters);
+    ucs_stats_delta_state_init(state);
+}
+
 static ucs_status_t
 ucs_stats_serialize_text_recurs_filtered(FILE *stream,
                                          ucs_stats_filter_node_t *filter_node,
@@ -518,37 +710,24 @@ static void ucs_stats_free_classes(ucs_stats_class_t **classes, unsigned num_cla
     free(classes);
 }
 
-ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
+static ucs_status_t
+ucs_stats_deserialize_tree(FILE *stream, const ucs_stats_data_header_t *hdr,
+                           ucs_stats_node_t **p_root)
 {
-    ucs_stats_data_header_t hdr;
     ucs_stats_root_storage_t *s;
     ucs_stats_class_t **classes, *cls;
     unsigned i, j, num_counters;
     ucs_status_t status;
-    size_t nread;
     char *name;
 
-    nread = fread(&hdr, 1, sizeof(hdr), stream);
-    if (nread == 0) {
-        status = UCS_ERR_NO_ELEM;
-        goto err;
-    }
-
-    if (hdr.version != 1) {
-        ucs_error("invalid file version");
-        status = UCS_ERR_UNSUPPORTED;
-        goto err;
-    }
-
-    if (!(hdr.num_classes < UINT8_MAX)) {
+    if (!(hdr->num_classes < UINT8_MAX)) {
         ucs_error("invalid num classes");
-        status = UCS_ERR_OUT_OF_RANGE;
-        goto err;
+        return UCS_ERR_OUT_OF_RANGE;
     }
 
     /* Read classes */
-    classes = malloc(hdr.num_classes * sizeof(*classes));
-    for (i = 0; i < hdr.num_classes; ++i) {
+    classes = malloc(hdr->num_classes * sizeof(*classes));
+    for (i = 0; i < hdr->num_classes; ++i) {
         name = ucs_stats_read_str(stream);
         FREAD_ONE(&num_counters, stream);
 
@@ -566,7 +745,7 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
     }
 
     /* Read nodes */
-    status = ucs_stats_deserialize_recurs(stream, classes, hdr.num_classes,
+    status = ucs_stats_deserialize_recurs(stream, classes, hdr->num_classes,
                                          sizeof(ucs_stats_root_storage_t) - sizeof(ucs_stats_node_t),
                                          p_root);
     if (status != UCS_OK) {
@@ -577,16 +756,150 @@ ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
     }
 
     s = ucs_container_of(*p_root, ucs_stats_root_storage_t, node);
-    s->num_classes = hdr.num_classes;
+    s->num_classes = hdr->num_classes;
     s->classes     = classes;
     return UCS_OK;
 
 err_free:
-    ucs_stats_free_classes(classes, hdr.num_classes);
-err:
+    ucs_stats_free_classes(classes, hdr->num_classes);
     return status;
 }
 
+ucs_status_t ucs_stats_deserialize(FILE *stream, ucs_stats_node_t **p_root)
+{
+    ucs_stats_data_header_t hdr;
+    size_t nread;
+
+    nread = fread(&hdr, 1, sizeof(hdr), stream);
+    if (nread == 0) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    if (hdr.version != UCS_STATS_DATA_VERSION) {
+        ucs_error("invalid file version");
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    return ucs_stats_deserialize_tree(stream, &hdr, p_root);
+}
+
+/*
+ * Collect pointers to the counters of a de-serialized tree, in the same order
+ * as ucs_stats_collect_counters_recurs() on the writer side. If counters is
+ * NULL, only count them.
+ */
+static size_t ucs_stats_flatten_counters_recurs(ucs_stats_node_t *node,
+                                                ucs_stats_counter_t **counters,
+                                                size_t offset)
+{
+    ucs_stats_node_t *child;
+    unsigned i;
+
+    for (i = 0; i < node->cls->num_counters; ++i) {
+        if (counters != NULL) {
+            counters[offset] = &node->counters[i];
+        }
+        ++offset;
+    }
+
+    ucs_list_for_each(child, &node->children[UCS_STATS_ACTIVE_CHILDREN],
+                      list) {
+        offset = ucs_stats_flatten_counters_recurs(child, counters, offset);
+    }
+
+    return offset;
+}
+
+static ucs_status_t ucs_stats_apply_delta(FILE *stream, ucs_stats_node_t *root)
+{
+    uint64_t num_changed, gap, delta;
+    ucs_stats_counter_t **counters;
+    size_t num_counters, index;
+    ucs_status_t status;
+
+    num_counters = ucs_stats_flatten_counters_recurs(root, NULL, 0);
+    counters     = malloc(ucs_max(num_counters, 1) * sizeof(*counters));
+    if (counters == NULL) {
+        ucs_error("failed to allocate %zu statistics counter pointers",
+                  num_counters);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    ucs_stats_flatten_counters_recurs(root, counters, 0);
+
+    status = ucs_stats_read_varint(stream, &num_changed);
+    if (status != UCS_OK) {
+        goto out;
+    }
+
+    index = 0;
+    while (num_changed-- > 0) {
+        status = ucs_stats_read_varint(stream, &gap);
+        if (status != UCS_OK) {
+            goto out;
+        }
+
+        status = ucs_stats_read_varint(stream, &delta);
+        if (status != UCS_OK) {
+            goto out;
+        }
+
+        if (gap >= (num_counters - index)) {
+            ucs_error("Error parsing statistics - counter index out of range");
+            status = UCS_ERR_OUT_OF_RANGE;
+            goto out;
+        }
+
+        index           += gap;
+        *counters[index] += ucs_stats_zigzag_decode(delta);
+        ++index;
+    }
+
+    status = UCS_OK;
+
+out:
+    free(counters);
+    return status;
+}
+
+ucs_status_t ucs_stats_deserialize_delta(FILE *stream, ucs_stats_node_t **p_root)
+{
+    ucs_stats_data_header_t hdr;
+    ucs_stats_node_t *root;
+    ucs_status_t status;
+    size_t nread;
+
+    nread = fread(&hdr, 1, sizeof(hdr), stream);
+    if (nread == 0) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    if (hdr.version == UCS_STATS_DATA_VERSION) {
+        status = ucs_stats_deserialize_tree(stream, &hdr, &root);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        if (*p_root != NULL) {
+            ucs_stats_free(*p_root);
+        }
+
+        *p_root = root;
+        return UCS_OK;
+    } else if (hdr.version == UCS_STATS_DATA_VERSION_DELTA) {
+        if (*p_root == NULL) {
+            ucs_error("Error parsing statistics - delta frame without a "
+                      "preceding full frame");
+            return UCS_ERR_INVALID_PARAM;
+        }
+
+        return ucs_stats_apply_delta(stream, *p_root);
+    }
+
+    ucs_error("invalid file version");
+    return UCS_ERR_UNSUPPORTED;
+}
+
 static void ucs_stats_free_recurs(ucs_stats_node_t *node)
 {
     ucs_stats_node_t *child, *tmp;
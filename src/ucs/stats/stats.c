@@ -68,6 +68,9 @@ typedef struct {
 
     khash_t(ucs_stats_cls)           cls;
 
+    /* Last dumped counters, for delta-encoded stream output */
+    ucs_stats_delta_state_t          delta;
+
     pthread_mutex_t                  lock;
 #ifndef HAVE_LINUX_FUTEX_H
     pthread_cond_t                   cv;
@@ -211,6 +214,7 @@ static void ucs_stats_node_remove(ucs_stats_node_t *node, int make_inactive)
     pthread_mutex_lock(&ucs_stats_context.lock);
 
     ucs_list_del(&node->list);
+    ucs_stats_context.delta.need_keyframe = 1;
     if (make_inactive) {
         node->cls = ucs_stats_get_class(node->cls);
         if (node->cls) {
@@ -387,6 +391,7 @@ static ucs_status_t ucs_stats_node_add(ucs_stats_node_t *node,
     ucs_list_add_tail(&parent->children[UCS_STATS_ACTIVE_CHILDREN], &node->list);
     node->parent = parent;
     ucs_stats_add_to_filter(node, filter_node);
+    ucs_stats_context.delta.need_keyframe = 1;
 
     pthread_mutex_unlock(&ucs_stats_context.lock);
 
@@ -609,8 +614,16 @@ static void __ucs_stats_dump(int inactive)
             options |= UCS_STATS_SERIALIZE_INACTVIVE;
         }
 
-        status = ucs_stats_serialize(ucs_stats_context.stream,
-                                    &ucs_stats_context.root_node, options);
+        if (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_DELTA) {
+            status = ucs_stats_serialize_delta(ucs_stats_context.stream,
+                                               &ucs_stats_context.root_node,
+                                               options,
+                                               &ucs_stats_context.delta);
+        } else {
+            status = ucs_stats_serialize(ucs_stats_context.stream,
+                                         &ucs_stats_context.root_node,
+                                         options);
+        }
         fflush(ucs_stats_context.stream);
     }
 
@@ -719,6 +732,9 @@ static void ucs_stats_open_dest()
         /* Optional: Binary mode */
         if (!strcmp(next_token, ":bin")) {
             ucs_stats_context_flags |= UCS_STATS_FLAG_STREAM_BINARY;
+        } else if (!strcmp(next_token, ":delta")) {
+            ucs_stats_context_flags |= UCS_STATS_FLAG_STREAM_BINARY |
+                                       UCS_STATS_FLAG_STREAM_DELTA;
         }
     }
 
@@ -739,6 +755,7 @@ static void ucs_stats_close_dest()
         }
         ucs_stats_context_flags &= ~(UCS_STATS_FLAG_STREAM |
                                      UCS_STATS_FLAG_STREAM_BINARY |
+                                     UCS_STATS_FLAG_STREAM_DELTA |
                                      UCS_STATS_FLAG_STREAM_CLOSE);
     }
 }
@@ -847,6 +864,7 @@ void ucs_stats_init()
     }
 
     UCS_STATS_START_TIME(ucs_stats_context.start_time);
+    ucs_stats_delta_state_init(&ucs_stats_context.delta);
     ucs_stats_node_init_root("%s:%d", ucs_get_host_name(), getpid());
     ucs_stats_set_trigger();
     kh_init_inplace(ucs_stats_cls, &ucs_stats_context.cls);
@@ -857,13 +875,14 @@ void ucs_stats_init()
     /* Aggregate-sum class id to name database initialize */
     ucs_array_init_dynamic(&ucs_stats_context.aggrgt_counter_names);
 
-    ucs_debug("statistics enabled, flags: %c%c%c%c%c%c%c",
+    ucs_debug("statistics enabled, flags: %c%c%c%c%c%c%c%c",
               (ucs_stats_context_flags & UCS_STATS_FLAG_ON_TIMER)      ? 't' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_ON_EXIT)       ? 'e' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_ON_SIGNAL)     ? 's' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_SOCKET)        ? 'u' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM)        ? 'f' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_BINARY) ? 'b' : '-',
+              (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_DELTA)  ? 'd' : '-',
               (ucs_stats_context_flags & UCS_STATS_FLAG_STREAM_CLOSE)  ? 'c' : '-');
 }
 
@@ -878,6 +897,7 @@ void ucs_stats_cleanup()
     ucs_stats_unset_trigger();
     ucs_stats_clean_node_recurs(&ucs_stats_context.root_node);
     ucs_stats_close_dest();
+    ucs_stats_delta_state_cleanup(&ucs_stats_context.delta);
     ucs_assert(ucs_stats_context_flags == 0);
 
     kh_foreach_value(&ucs_stats_context.cls, cls, {
@@ -87,7 +87,8 @@ enum {
     UCS_STATS_FLAG_SOCKET        = UCS_BIT(8),
     UCS_STATS_FLAG_STREAM        = UCS_BIT(9),
     UCS_STATS_FLAG_STREAM_CLOSE  = UCS_BIT(10),
-    UCS_STATS_FLAG_STREAM_BINARY = UCS_BIT(11)
+    UCS_STATS_FLAG_STREAM_BINARY = UCS_BIT(11),
+    UCS_STATS_FLAG_STREAM_DELTA  = UCS_BIT(12)
 };
 
 /**
@@ -12,7 +12,8 @@
 #include <inttypes.h>
 
 /*
- * Dump binary statistics file to stdout.
+ * Dump binary statistics file to stdout. Files written in delta mode are
+ * reconstructed frame by frame, so every dump is printed as a full snapshot.
  * Usage: ucs_stats_parser [ file1 ] [ file2 ] ...
  */
 
@@ -38,7 +39,7 @@ dump_stats_recurs(FILE *stream, ucs_stats_node_t *node, unsigned indent)
 
 static ucs_status_t dump_file(const char *filename)
 {
-    ucs_stats_node_t *root;
+    ucs_stats_node_t *root = NULL;
     ucs_status_t status;
     FILE *stream;
 
@@ -49,18 +50,20 @@ static ucs_status_t dump_file(const char *filename)
     }
 
     while (!feof(stream)) {
-        status = ucs_stats_deserialize(stream, &root);
+        status = ucs_stats_deserialize_delta(stream, &root);
         if (status != UCS_OK) {
             goto out;
         }
 
         dump_stats_recurs(stdout, root, 0);
-        ucs_stats_free(root);
     }
 
     status = UCS_OK;
 
 out:
+    if (root != NULL) {
+        ucs_stats_free(root);
+    }
     fclose(stream);
     return status;
 }
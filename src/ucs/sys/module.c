@@ -387,41 +387,98 @@ static void ucs_module_check_expected_loaded(const char *framework,
     ucs_string_buffer_cleanup(&strb);
 }
 
+static int ucs_module_is_builtin(const char *module_name)
+{
+    ucs_string_buffer_t strb;
+    char *builtin_name;
+    int found;
+
+    found = 0;
+    ucs_string_buffer_init(&strb);
+    ucs_string_buffer_appendf(&strb, "%s", UCX_BUILTIN_MODULES);
+
+    ucs_string_buffer_for_each_token(builtin_name, &strb, ":") {
+        if (!strcmp(builtin_name, module_name)) {
+            found = 1;
+            break;
+        }
+    }
+
+    ucs_string_buffer_cleanup(&strb);
+    return found;
+}
+
+/*
+ * Check whether the modules allow-list leaves anything to search for. If every
+ * module in the allow-list is linked into the UCX libraries (for example, a
+ * transport built in by --with-builtin-modules), there is nothing to load and
+ * the directory scan is skipped. Any other name, including a third-party
+ * module, requires the scan.
+ */
+static int ucs_module_search_needed(const char *framework)
+{
+    const ucs_config_names_array_t *modules = &ucs_global_opts.modules.array;
+    unsigned i;
+
+    if ((ucs_global_opts.modules.mode != UCS_CONFIG_ALLOW_LIST_ALLOW) ||
+        (ucs_global_opts.plugin_path.count > 0)) {
+        return 1;
+    }
+
+    for (i = 0; i < modules->count; ++i) {
+        if (!ucs_module_is_builtin(modules->names[i])) {
+            return 1;
+        }
+    }
+
+    ucs_module_debug("all requested modules are built in, skipping module "
+                     "search for framework '%s'", framework);
+    return 0;
+}
+
+static void ucs_module_load_all(const char *framework,
+                                const char *expected_modules, unsigned flags)
+{
+    ucs_string_set_t loaded_set;
+    unsigned i;
+    int mode;
+
+    ucs_string_set_init(&loaded_set);
+    mode = ucs_module_flags_to_dlopen_mode(flags);
+
+    /* Load modules from directories */
+    for (i = 0; i < ucs_global_opts.plugin_path.count; ++i) {
+        ucs_module_load_from_dir(ucs_global_opts.plugin_path.names[i],
+                                 framework, mode, &loaded_set);
+    }
+
+    for (i = 0; i < ucs_array_length(&ucs_module_loader_state.srch_path);
+         ++i) {
+        ucs_module_load_from_dir(
+                ucs_array_elem(&ucs_module_loader_state.srch_path, i),
+                framework, mode, &loaded_set);
+    }
+
+    ucs_module_check_expected_loaded(framework, expected_modules,
+                                     &loaded_set);
+
+    ucs_string_set_cleanup(&loaded_set);
+}
+
 #endif /* UCX_SHARED_LIB */
 
 void ucs_load_modules(const char *framework, const char *expected_modules,
                       ucs_init_once_t *init_once, unsigned flags)
 {
 #ifdef UCX_SHARED_LIB
-    unsigned i;
-    int mode;
-    ucs_string_set_t loaded_set;
-
     ucs_module_loader_init_paths();
 
     UCS_INIT_ONCE(init_once) {
         ucs_assert(ucs_sys_is_dynamic_lib());
 
-        ucs_string_set_init(&loaded_set);
-        mode = ucs_module_flags_to_dlopen_mode(flags);
-
-        /* Load modules from directories */
-        for (i = 0; i < ucs_global_opts.plugin_path.count; ++i) {
-            ucs_module_load_from_dir(ucs_global_opts.plugin_path.names[i],
-                                     framework, mode, &loaded_set);
-        }
-
-        for (i = 0; i < ucs_array_length(&ucs_module_loader_state.srch_path);
-             ++i) {
-            ucs_module_load_from_dir(
-                    ucs_array_elem(&ucs_module_loader_state.srch_path, i),
-                    framework, mode, &loaded_set);
+        if (ucs_module_search_needed(framework)) {
+            ucs_module_load_all(framework, expected_modules, flags);
         }
-
-        ucs_module_check_expected_loaded(framework, expected_modules,
-                                         &loaded_set);
-
-        ucs_string_set_cleanup(&loaded_set);
     }
 #endif /* UCX_SHARED_LIB */
 }
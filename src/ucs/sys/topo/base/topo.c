@@ -11,6 +11,7 @@
 #include <ucs/memory/numa.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/topo/base/topo.h>
+#include <ucs/sys/topo/base/topo_cache.h>
 #include <ucs/sys/string.h>
 #include <ucs/sys/sys.h>
 
@@ -348,9 +349,19 @@ static int
 ucs_topo_read_device_numa_node(const ucs_sys_bus_id_t *bus_id)
 {
     int numa_node = UCS_NUMA_NODE_UNDEFINED;
+    char cache_key[64], cache_value[16];
     char *path;
     ucs_status_t status;
 
+    ucs_snprintf_safe(cache_key, sizeof(cache_key), "numa:");
+    ucs_topo_bus_id_str(bus_id, 0, cache_key + strlen(cache_key),
+                        sizeof(cache_key) - strlen(cache_key));
+    if ((ucs_topo_cache_get(cache_key, cache_value, sizeof(cache_value)) ==
+         UCS_OK) &&
+        (sscanf(cache_value, "%d", &numa_node) == 1)) {
+        return numa_node;
+    }
+
     status = ucs_string_alloc_path_buffer(&path, "sysfs_path");
     if (status != UCS_OK) {
         goto out;
@@ -362,6 +373,10 @@ ucs_topo_read_device_numa_node(const ucs_sys_bus_id_t *bus_id)
     }
 
     numa_node = ucs_numa_node_of_device(path);
+    if (numa_node != UCS_NUMA_NODE_UNDEFINED) {
+        ucs_snprintf_safe(cache_value, sizeof(cache_value), "%d", numa_node);
+        ucs_topo_cache_put(cache_key, cache_value);
+    }
 
 out_free_path:
     ucs_free(path);
@@ -1392,6 +1407,7 @@ void ucs_topo_init()
     ucs_spinlock_init(&ucs_topo_global_ctx.lock, 0);
     kh_init_inplace(bus_to_sys_dev, &ucs_topo_global_ctx.bus_to_sys_dev_hash);
     ucs_topo_global_ctx.num_devices = 0;
+    ucs_topo_cache_init();
     ucs_list_add_tail(&ucs_sys_topo_providers_list,
                       &ucs_sys_topo_provider_default.list);
     ucs_list_add_tail(&ucs_sys_topo_providers_list,
@@ -1411,6 +1427,7 @@ void ucs_topo_cleanup()
     kh_destroy_inplace(bus_to_sys_dev,
                        &ucs_topo_global_ctx.bus_to_sys_dev_hash);
     ucs_spinlock_destroy(&ucs_topo_global_ctx.lock);
+    ucs_topo_cache_cleanup();
 }
 
 typedef struct {
@@ -1495,11 +1512,26 @@ double ucs_topo_get_pci_bw(const char *dev_name, const char *sysfs_path)
     const ucs_topo_pci_info_t *p;
     char pci_width_str[16];
     char pci_speed_str[16];
+    char cache_value[32];
+    char *cache_key;
     ucs_status_t status;
     unsigned width;
     char gts[16];
     size_t i;
 
+    cache_key = NULL;
+    if ((sysfs_path != NULL) &&
+        (ucs_string_alloc_formatted_path(&cache_key, "pci_bw_cache_key",
+                                         "pci_bw:%s", sysfs_path) == UCS_OK) &&
+        (ucs_topo_cache_get(cache_key, cache_value, sizeof(cache_value)) ==
+         UCS_OK)) {
+        effective_bw = strtod(cache_value, NULL);
+        ucs_free(cache_key);
+        ucs_trace("%s: cached effective PCIe throughput %.3f MB/s", dev_name,
+                  effective_bw / UCS_MBYTE);
+        return effective_bw;
+    }
+
     status = ucs_sys_read_sysfs_file(dev_name, sysfs_path, pci_width_file_name,
                                      pci_width_str, sizeof(pci_width_str),
                                      UCS_LOG_LEVEL_DEBUG);
@@ -1544,10 +1576,18 @@ double ucs_topo_get_pci_bw(const char *dev_name, const char *sysfs_path)
         ucs_trace("%s: PCIe %s %ux, effective throughput %.3f MB/s %.3f Gb/s",
                   dev_name, p->name, width, effective_bw / UCS_MBYTE,
                   effective_bw * 8e-9);
+        if (cache_key != NULL) {
+            /* Hexadecimal floating point keeps the exact value */
+            ucs_snprintf_safe(cache_value, sizeof(cache_value), "%a",
+                              effective_bw);
+            ucs_topo_cache_put(cache_key, cache_value);
+            ucs_free(cache_key);
+        }
         return effective_bw;
     }
 
 out_max_bw:
+    ucs_free(cache_key);
     ucs_debug("%s: pci bandwidth undetected, using maximal value", dev_name);
     return UCS_INFINITY;
 }
@@ -1556,9 +1596,19 @@ const char *ucs_topo_resolve_sysfs_path(const char *dev_path, char *path_buffer)
 {
     const char *detected_type = NULL;
     char *device_file_path, *sysfs_realpath, *sysfs_path;
+    char *cache_key = NULL;
     struct stat st_buf;
     ucs_status_t status;
 
+    status = ucs_string_alloc_formatted_path(&cache_key, "sysfs_cache_key",
+                                             "sysfs_path:%s", dev_path);
+    if ((status == UCS_OK) &&
+        (ucs_topo_cache_get(cache_key, path_buffer, PATH_MAX) == UCS_OK)) {
+        ucs_debug("%s: cached sysfs path is '%s'", dev_path, path_buffer);
+        ucs_free(cache_key);
+        return path_buffer;
+    }
+
     /* realpath name is expected to be like below:
      * PF: /sys/devices/.../0000:03:00.0/<interface_type>/<dev_name>
      * SF: /sys/devices/.../0000:03:00.0/<UUID>/<interface_type>/<dev_name>
@@ -1595,11 +1645,16 @@ const char *ucs_topo_resolve_sysfs_path(const char *dev_path, char *path_buffer)
 
     ucs_free(device_file_path);
 out_undetected:
+    ucs_free(cache_key);
     ucs_debug("%s: sysfs path undetected", dev_path);
     return NULL;
 out_detected:
     ucs_debug("%s: %s sysfs path is '%s'\n", dev_path, detected_type,
               sysfs_path);
+    if (cache_key != NULL) {
+        ucs_topo_cache_put(cache_key, sysfs_path);
+        ucs_free(cache_key);
+    }
     ucs_free(device_file_path);
     return sysfs_path;
 }
@@ -0,0 +1,329 @@
+/**
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "topo_cache.h"
+
+#include <ucs/config/global_opts.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/string_buffer.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/string.h>
+#include <ucs/sys/sys.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+
+#define UCS_TOPO_CACHE_FORMAT_VERSION 1
+#define UCS_TOPO_CACHE_FILE_FMT       "%s/ucx_topo_cache.%s.%u"
+
+
+KHASH_MAP_INIT_STR(ucs_topo_cache, char*);
+
+
+static struct {
+    pthread_mutex_t          lock;
+    int                      loaded;
+    int                      fd;      /* Cache file opened for appending */
+    khash_t(ucs_topo_cache)  hash;
+} ucs_topo_cache = {
+    .lock   = PTHREAD_MUTEX_INITIALIZER,
+    .loaded = 0,
+    .fd     = -1
+};
+
+
+static void ucs_topo_cache_header(char *buf, size_t max)
+{
+    uint64_t high = 0, low = 0;
+
+    ucs_sys_get_boot_id(&high, &low);
+    ucs_snprintf_safe(buf, max, "ucx-topo-cache %d %s %016" PRIx64 "%016" PRIx64
+                      "\n", UCS_TOPO_CACHE_FORMAT_VERSION, PACKAGE_VERSION,
+                      high, low);
+}
+
+static void ucs_topo_cache_add_nolock(const char *key, const char *value)
+{
+    char *key_dup, *value_dup;
+    khiter_t iter;
+    int ret;
+
+    key_dup   = ucs_strdup(key, "topo_cache_key");
+    value_dup = ucs_strdup(value, "topo_cache_value");
+    if ((key_dup == NULL) || (value_dup == NULL)) {
+        goto err_free;
+    }
+
+    iter = kh_put(ucs_topo_cache, &ucs_topo_cache.hash, key_dup, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        goto err_free;
+    } else if (ret == UCS_KH_PUT_KEY_PRESENT) {
+        /* Keep the first value, the file may contain duplicate entries when
+         * several processes populate it concurrently */
+        goto err_free;
+    }
+
+    kh_val(&ucs_topo_cache.hash, iter) = value_dup;
+    return;
+
+err_free:
+    ucs_free(value_dup);
+    ucs_free(key_dup);
+}
+
+/* Open the cache file only if it is a regular file owned by the user, so
+ * another user can not make us read or append to a file of their choice */
+static int ucs_topo_cache_open(const char *path, int flags)
+{
+    struct stat st;
+    int fd;
+
+    fd = open(path, flags | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (fstat(fd, &st) != 0) {
+        ucs_debug("failed to stat topology cache '%s': %m", path);
+        goto err_close;
+    }
+
+    if (!S_ISREG(st.st_mode) || (st.st_uid != getuid())) {
+        ucs_debug("topology cache '%s' is not a regular file owned by uid %u",
+                  path, getuid());
+        goto err_close;
+    }
+
+    return fd;
+
+err_close:
+    close(fd);
+    return -1;
+}
+
+/* Read all entries, return 0 if the file does not exist or is stale */
+static int ucs_topo_cache_read(const char *path, const char *header)
+{
+    char *line       = NULL;
+    size_t line_size = 0;
+    char *value, *p;
+    FILE *stream;
+    int valid, fd;
+
+    fd = ucs_topo_cache_open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    stream = fdopen(fd, "r");
+    if (stream == NULL) {
+        close(fd);
+        return 0;
+    }
+
+    valid = (getline(&line, &line_size, stream) > 0) && !strcmp(line, header);
+    if (!valid) {
+        ucs_debug("topology cache '%s' is stale", path);
+        goto out;
+    }
+
+    while (getline(&line, &line_size, stream) > 0) {
+        p = strchr(line, '\n');
+        if (p == NULL) {
+            /* Partially written by a concurrent process */
+            continue;
+        }
+
+        *p    = '\0';
+        value = strchr(line, '\t');
+        if (value == NULL) {
+            continue;
+        }
+
+        *(value++) = '\0';
+        ucs_topo_cache_add_nolock(line, value);
+    }
+
+    ucs_debug("loaded %u entries from topology cache '%s'",
+              kh_size(&ucs_topo_cache.hash), path);
+
+out:
+    /* Allocated by getline() */
+    free(line);
+    fclose(stream);
+    return valid;
+}
+
+/* Replace the file atomically, so readers never see a partial header */
+static ucs_status_t ucs_topo_cache_create(const char *path, const char *header)
+{
+    char *tmp_path;
+    ucs_status_t status;
+    ssize_t ret;
+    int fd;
+
+    status = ucs_string_alloc_formatted_path(&tmp_path, "topo_cache_tmp_path",
+                                             "%s.%d", path, getpid());
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* Remove a leftover of a previous process with the same pid */
+    unlink(tmp_path);
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+              0644);
+    if (fd < 0) {
+        ucs_debug("failed to create topology cache '%s': %m", tmp_path);
+        status = UCS_ERR_IO_ERROR;
+        goto out;
+    }
+
+    ret = write(fd, header, strlen(header));
+    close(fd);
+    if (ret != strlen(header)) {
+        ucs_debug("failed to write topology cache '%s': %m", tmp_path);
+        status = UCS_ERR_IO_ERROR;
+        goto err_unlink;
+    }
+
+    if (rename(tmp_path, path) != 0) {
+        ucs_debug("failed to rename '%s' to '%s': %m", tmp_path, path);
+        status = UCS_ERR_IO_ERROR;
+        goto err_unlink;
+    }
+
+    goto out;
+
+err_unlink:
+    unlink(tmp_path);
+out:
+    ucs_free(tmp_path);
+    return status;
+}
+
+static void ucs_topo_cache_load_nolock()
+{
+    const char *dir = ucs_global_opts.topo_cache_dir;
+    char header[128];
+    char *path;
+
+    if (ucs_topo_cache.loaded) {
+        return;
+    }
+
+    ucs_topo_cache.loaded = 1;
+    if ((dir == NULL) || (strlen(dir) == 0)) {
+        return;
+    }
+
+    /* File name includes the host name in case the directory is shared between
+     * nodes, and the user id since other users may not write to it */
+    if (ucs_string_alloc_formatted_path(&path, "topo_cache_path",
+                                        UCS_TOPO_CACHE_FILE_FMT, dir,
+                                        ucs_get_host_name(),
+                                        getuid()) != UCS_OK) {
+        return;
+    }
+
+    ucs_topo_cache_header(header, sizeof(header));
+    if (!ucs_topo_cache_read(path, header) &&
+        (ucs_topo_cache_create(path, header) != UCS_OK)) {
+        goto out;
+    }
+
+    ucs_topo_cache.fd = ucs_topo_cache_open(path, O_WRONLY | O_APPEND);
+    if (ucs_topo_cache.fd < 0) {
+        ucs_debug("failed to open topology cache '%s': %m", path);
+    }
+
+out:
+    ucs_free(path);
+}
+
+ucs_status_t ucs_topo_cache_get(const char *key, char *value, size_t max)
+{
+    ucs_status_t status = UCS_ERR_NO_ELEM;
+    khiter_t iter;
+
+    pthread_mutex_lock(&ucs_topo_cache.lock);
+    ucs_topo_cache_load_nolock();
+    iter = kh_get(ucs_topo_cache, &ucs_topo_cache.hash, key);
+    if (iter != kh_end(&ucs_topo_cache.hash)) {
+        ucs_strncpy_safe(value, kh_val(&ucs_topo_cache.hash, iter), max);
+        status = UCS_OK;
+    }
+    pthread_mutex_unlock(&ucs_topo_cache.lock);
+
+    return status;
+}
+
+void ucs_topo_cache_put(const char *key, const char *value)
+{
+    ucs_string_buffer_t line = UCS_STRING_BUFFER_INITIALIZER;
+    khiter_t iter;
+    size_t length;
+
+    if ((strpbrk(key, " \t\n") != NULL) || (strchr(value, '\n') != NULL)) {
+        return;
+    }
+
+    pthread_mutex_lock(&ucs_topo_cache.lock);
+    ucs_topo_cache_load_nolock();
+    if (ucs_topo_cache.fd < 0) {
+        goto out;
+    }
+
+    iter = kh_get(ucs_topo_cache, &ucs_topo_cache.hash, key);
+    if (iter != kh_end(&ucs_topo_cache.hash)) {
+        goto out;
+    }
+
+    ucs_topo_cache_add_nolock(key, value);
+
+    /* Single write of a whole line, which is atomic with O_APPEND */
+    ucs_string_buffer_appendf(&line, "%s\t%s\n", key, value);
+    length = ucs_string_buffer_length(&line);
+    if (write(ucs_topo_cache.fd, ucs_string_buffer_cstr(&line), length) !=
+        length) {
+        ucs_debug("failed to add '%s' to topology cache: %m", key);
+    }
+
+    ucs_string_buffer_cleanup(&line);
+out:
+    pthread_mutex_unlock(&ucs_topo_cache.lock);
+}
+
+void ucs_topo_cache_init()
+{
+    kh_init_inplace(ucs_topo_cache, &ucs_topo_cache.hash);
+    ucs_topo_cache.loaded = 0;
+    ucs_topo_cache.fd     = -1;
+}
+
+void ucs_topo_cache_cleanup()
+{
+    const char *key;
+    char *value;
+
+    kh_foreach(&ucs_topo_cache.hash, key, value, {
+        ucs_free((char*)key);
+        ucs_free(value);
+    });
+    kh_destroy_inplace(ucs_topo_cache, &ucs_topo_cache.hash);
+
+    if (ucs_topo_cache.fd >= 0) {
+        close(ucs_topo_cache.fd);
+    }
+}
@@ -0,0 +1,55 @@
+/**
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifndef UCS_TOPO_CACHE_H
+#define UCS_TOPO_CACHE_H
+
+#include <ucs/type/status.h>
+#include <ucs/sys/compiler_def.h>
+#include <stddef.h>
+
+BEGIN_C_DECLS
+
+/**
+ * Node-local cache of topology information derived from sysfs.
+ *
+ * The cache is stored in a text file under UCX_TOPO_CACHE_DIR, which is shared
+ * by all processes on the node. The file is tagged with the kernel boot id and
+ * the UCX version, so it is discarded after a reboot or an upgrade. Only
+ * values which do not change while the system is running should be stored.
+ */
+
+
+/**
+ * Look up a cached value.
+ *
+ * @param [in]  key    Key to look up, must not contain whitespace.
+ * @param [out] value  Filled with the cached value.
+ * @param [in]  max    Size of the value buffer.
+ *
+ * @return UCS_OK if found, UCS_ERR_NO_ELEM if the key is not cached or the
+ *         cache is disabled.
+ */
+ucs_status_t ucs_topo_cache_get(const char *key, char *value, size_t max);
+
+
+/**
+ * Add a value to the cache, both in memory and in the cache file.
+ *
+ * @param [in]  key    Key to add, must not contain whitespace.
+ * @param [in]  value  Value to add, must not contain newlines.
+ */
+void ucs_topo_cache_put(const char *key, const char *value);
+
+
+void ucs_topo_cache_init();
+
+
+void ucs_topo_cache_cleanup();
+
+END_C_DECLS
+
+#endif
@@ -8,6 +8,7 @@
 #define UCT_IOV_INL_
 
 #include <uct/api/uct.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/sys/math.h>
 #include <ucs/debug/assert.h>
 
@@ -130,9 +131,10 @@ size_t uct_iov_to_buffer(const uct_iov_t *iov, size_t iovcnt,
             to_copy       = copy_limit - copied;
             limit_reached = 1;
         }
-        memcpy(UCS_PTR_BYTE_OFFSET(buf, copied),
-               UCS_PTR_BYTE_OFFSET(iov[iov_iter->iov_index].buffer, offset),
-               to_copy);
+        ucs_memcpy_relaxed(UCS_PTR_BYTE_OFFSET(buf, copied),
+                           UCS_PTR_BYTE_OFFSET(iov[iov_iter->iov_index].buffer,
+                                               offset),
+                           to_copy, UCS_ARCH_MEMCPY_NT_NONE, to_copy);
         copied += to_copy;
 
         if (limit_reached) {
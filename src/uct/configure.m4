@@ -5,6 +5,8 @@
 #
 
 uct_modules=""
+# Transports which are always part of libuct
+uct_builtin_modules=":self:posix:sysv:tcp"
 m4_include([src/uct/cuda/configure.m4])
 m4_include([src/uct/ib/configure.m4])
 m4_include([src/uct/rocm/configure.m4])
@@ -14,6 +16,8 @@ m4_include([src/uct/ze/configure.m4])
 m4_include([src/uct/gaudi/configure.m4])
 
 AC_DEFINE_UNQUOTED([uct_MODULES], ["${uct_modules}"], [UCT loadable modules])
+AC_DEFINE_UNQUOTED([UCX_BUILTIN_MODULES], ["${uct_builtin_modules}"],
+                   [Modules which are linked into the UCX libraries])
 
 AC_CONFIG_FILES([src/uct/Makefile
                  src/uct/ucx-uct.pc])
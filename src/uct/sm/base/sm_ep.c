@@ -9,20 +9,66 @@
 
 #include "sm_ep.h"
 
+#include <uct/base/uct_iov.inl>
 #include <ucs/arch/atomic.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/time/time.h>
 
 
+/* Number of cache lines of the remote buffer to prefetch before get_bcopy */
+#define UCT_SM_EP_GET_PREFETCH_LINES 8
+
+
 #define uct_sm_ep_trace_data(_remote_addr, _rkey, _fmt, ...) \
      ucs_trace_data(_fmt " to 0x%"PRIx64"(%+ld)", ## __VA_ARGS__, (_remote_addr), \
                     (_rkey))
 
+
+/*
+ * Copy between local iov and a remote mapped buffer. The remote side is
+ * accessed with non-temporal hints, so large transfers do not evict the local
+ * working set from the cache.
+ */
+static UCS_F_ALWAYS_INLINE size_t
+uct_sm_ep_iov_copy(const uct_iov_t *iov, size_t iovcnt, void *remote_ptr,
+                   int is_put)
+{
+    size_t total_length = uct_iov_total_length(iov, iovcnt);
+    size_t offset       = 0;
+    size_t iov_it, length;
+    void *local_ptr;
+
+    for (iov_it = 0; iov_it < iovcnt; ++iov_it) {
+        length    = uct_iov_get_length(&iov[iov_it]);
+        local_ptr = iov[iov_it].buffer;
+        if (length == 0) {
+            continue;
+        }
+
+        if (is_put) {
+            ucs_memcpy_relaxed(UCS_PTR_BYTE_OFFSET(remote_ptr, offset),
+                               local_ptr, length, UCS_ARCH_MEMCPY_NT_DEST,
+                               total_length);
+        } else {
+            ucs_memcpy_relaxed(local_ptr,
+                               UCS_PTR_BYTE_OFFSET(remote_ptr, offset),
+                               length, UCS_ARCH_MEMCPY_NT_SOURCE,
+                               total_length);
+        }
+
+        offset += length;
+    }
+
+    return total_length;
+}
+
 ucs_status_t uct_sm_ep_put_short(uct_ep_h tl_ep, const void *buffer,
                                  unsigned length, uint64_t remote_addr,
                                  uct_rkey_t rkey)
 {
     if (ucs_likely(length != 0)) {
-        memcpy((void *)(rkey + remote_addr), buffer, length);
+        ucs_memcpy_relaxed((void *)(rkey + remote_addr), buffer, length,
+                           UCS_ARCH_MEMCPY_NT_DEST, length);
         uct_sm_ep_trace_data(remote_addr, rkey, "PUT_SHORT [buffer %p size %u]",
                              buffer, length);
     } else {
@@ -44,13 +90,35 @@ ssize_t uct_sm_ep_put_bcopy(uct_ep_h tl_ep, uct_pack_callback_t pack_cb,
     return length;
 }
 
+ucs_status_t uct_sm_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                 size_t iovcnt, uint64_t remote_addr,
+                                 uct_rkey_t rkey, uct_completion_t *comp)
+{
+    size_t length;
+
+    length = uct_sm_ep_iov_copy(iov, iovcnt, (void*)(rkey + remote_addr), 1);
+    uct_sm_ep_trace_data(remote_addr, rkey, "PUT_ZCOPY [iovcnt %zu size %zu]",
+                         iovcnt, length);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), PUT, ZCOPY, length);
+    return UCS_OK;
+}
+
 ucs_status_t uct_sm_ep_get_bcopy(uct_ep_h tl_ep, uct_unpack_callback_t unpack_cb,
                                  void *arg, size_t length,
                                  uint64_t remote_addr, uct_rkey_t rkey,
                                  uct_completion_t *comp)
 {
+    void *remote_ptr = (void*)(rkey + remote_addr);
+    size_t offset;
+
     if (ucs_likely(0 != length)) {
-        unpack_cb(arg, (void *)(rkey + remote_addr), length);
+        for (offset = 0;
+             offset < ucs_min(length, UCT_SM_EP_GET_PREFETCH_LINES *
+                                      UCS_SYS_CACHE_LINE_SIZE);
+             offset += UCS_SYS_CACHE_LINE_SIZE) {
+            ucs_read_prefetch(UCS_PTR_BYTE_OFFSET(remote_ptr, offset));
+        }
+        unpack_cb(arg, remote_ptr, length);
         uct_sm_ep_trace_data(remote_addr, rkey, "GET_BCOPY [length %zu]", length);
     } else {
         ucs_trace_data("GET_BCOPY [zero-length]");
@@ -59,6 +127,19 @@ ucs_status_t uct_sm_ep_get_bcopy(uct_ep_h tl_ep, uct_unpack_callback_t unpack_cb
     return UCS_OK;
 }
 
+ucs_status_t uct_sm_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                 size_t iovcnt, uint64_t remote_addr,
+                                 uct_rkey_t rkey, uct_completion_t *comp)
+{
+    size_t length;
+
+    length = uct_sm_ep_iov_copy(iov, iovcnt, (void*)(rkey + remote_addr), 0);
+    uct_sm_ep_trace_data(remote_addr, rkey, "GET_ZCOPY [iovcnt %zu size %zu]",
+                         iovcnt, length);
+    UCT_TL_EP_STAT_OP(ucs_derived_of(tl_ep, uct_base_ep_t), GET, ZCOPY, length);
+    return UCS_OK;
+}
+
 ucs_status_t uct_sm_ep_atomic32_post(uct_ep_h ep, unsigned opcode, uint32_t value,
                                      uint64_t remote_addr, uct_rkey_t rkey)
 {
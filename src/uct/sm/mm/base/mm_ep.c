@@ -21,7 +21,8 @@
 typedef enum {
     UCT_MM_SEND_AM_BCOPY,
     UCT_MM_SEND_AM_SHORT,
-    UCT_MM_SEND_AM_SHORT_IOV
+    UCT_MM_SEND_AM_SHORT_IOV,
+    UCT_MM_SEND_AM_ZCOPY
 } uct_mm_send_op_t;
 
 static UCS_F_NOINLINE ucs_status_t
@@ -157,6 +158,8 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
 
     kh_init_inplace(uct_mm_remote_seg, &self->remote_segs);
     ucs_arbiter_group_init(&self->arb_group);
+    ucs_queue_head_init(&self->send_descs);
+    ucs_list_add_tail(&iface->ep_list, &self->list);
 
     /* save remote md address */
     if (md->iface_addr_len > 0) {
@@ -200,11 +203,29 @@ err_free_segs:
 err_free_md_addr:
     ucs_free(self->remote_iface_addr);
 err:
+    ucs_list_del(&self->list);
     return status;
 }
 
 static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(self->super.super.iface,
+                                           uct_mm_iface_t);
+    uct_mm_flush_comp_t *flush_comp;
+    ucs_queue_iter_t iter;
+
+    ucs_queue_for_each_safe(flush_comp, iter, &iface->flush_comps, queue) {
+        if (flush_comp->ep == self) {
+            ucs_queue_del_iter(&iface->flush_comps, iter);
+            ucs_free(flush_comp);
+        }
+    }
+
+    /* The remote side may still read the descriptors of an endpoint which was
+     * not flushed, so they are not reused until the iface is destroyed */
+    ucs_queue_splice(&iface->ep_send_descs, &self->send_descs);
+    ucs_list_del(&self->list);
+
     uct_mm_ep_pending_purge(&self->super.super, NULL, NULL);
     uct_mm_ep_cleanup_remote_segs(self);
     ucs_free(self->remote_iface_addr);
@@ -243,6 +264,27 @@ static inline void uct_mm_ep_update_cached_tail(uct_mm_ep_t *ep)
     ep->cached_tail = ep->fifo_ctl->tail;
 }
 
+/* Release am_zcopy send descriptors which were consumed by the remote side */
+static void uct_mm_ep_release_send_descs(uct_mm_ep_t *ep)
+{
+    uct_mm_send_desc_t *desc;
+
+    if (ucs_queue_is_empty(&ep->send_descs)) {
+        return;
+    }
+
+    desc = ucs_queue_head_elem_non_empty(&ep->send_descs, uct_mm_send_desc_t,
+                                         queue);
+    if (desc->sn >= ep->cached_tail) {
+        uct_mm_ep_update_cached_tail(ep);
+    }
+
+    ucs_queue_for_each_extract(desc, &ep->send_descs, queue,
+                               desc->sn < ep->cached_tail) {
+        ucs_mpool_put(desc);
+    }
+}
+
 static UCS_F_ALWAYS_INLINE void uct_mm_ep_peer_check(uct_mm_ep_t *ep,
                                                      unsigned flags)
 {
@@ -276,6 +318,8 @@ static UCS_F_ALWAYS_INLINE ssize_t uct_mm_ep_am_common_send(
     uint64_t head;
     ucs_iov_iter_t iov_iter;
     void *desc_data;
+    uct_mm_send_desc_t *send_desc;
+    uct_mm_fifo_zcopy_t *zcopy;
 
     UCT_CHECK_AM_ID(am_id);
 
@@ -351,6 +395,25 @@ retry:
                               head & ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED);
         UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, elem->length);
         break;
+    case UCT_MM_SEND_AM_ZCOPY:
+        /* the data is already in the send descriptor passed as 'arg', the
+         * remote side reads it in-place */
+        send_desc                     = arg;
+        send_desc->sn                 = head &
+                                        ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED;
+        zcopy                         = (uct_mm_fifo_zcopy_t*)(elem + 1);
+        zcopy->desc                   = send_desc->info;
+        zcopy->length                 = length;
+        zcopy->seg_uuid               = send_desc->seg_uuid;
+        zcopy->pid                    = getpid();
+        elem_flags                    = UCT_MM_FIFO_ELEM_FLAG_ZCOPY;
+        elem->length                  = sizeof(*zcopy);
+        ucs_queue_push(&ep->send_descs, &send_desc->queue);
+
+        uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_SEND, elem_flags, am_id,
+                              send_desc + 1, length, send_desc->sn);
+        UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, length);
+        break;
     }
 
     elem->am_id = am_id;
@@ -375,6 +438,7 @@ retry:
     switch (send_op) {
     case UCT_MM_SEND_AM_SHORT:
     case UCT_MM_SEND_AM_SHORT_IOV:
+    case UCT_MM_SEND_AM_ZCOPY:
         return UCS_OK;
     case UCT_MM_SEND_AM_BCOPY:
         return length;
@@ -425,6 +489,50 @@ ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_
                                     NULL, pack_cb, arg, NULL, 0, flags);
 }
 
+ucs_status_t uct_mm_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                unsigned header_length, const uct_iov_t *iov,
+                                size_t iovcnt, unsigned flags,
+                                uct_completion_t *comp)
+{
+    uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_send_desc_t *desc;
+    ucs_iov_iter_t iov_iter;
+    ucs_status_t status;
+    size_t length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_SM_MAX_IOV, "uct_mm_ep_am_zcopy");
+    UCT_CHECK_LENGTH(header_length, 0, UCT_MM_IFACE_AM_ZCOPY_MAX_HDR,
+                     "am_zcopy header");
+    UCT_CHECK_LENGTH(uct_iov_total_length(iov, iovcnt), 0,
+                     iface->config.zcopy_seg_size, "am_zcopy");
+
+    uct_mm_ep_release_send_descs(ep);
+
+    desc = ucs_mpool_get_inline(&iface->send_desc_mp);
+    if (ucs_unlikely(desc == NULL)) {
+        return uct_mm_ep_no_resources_handle(ep, flags);
+    }
+
+    /* Copy the message to the shared send descriptor before taking a FIFO
+     * element, so the receiver would copy it only once to the final buffer */
+    ucs_iov_iter_init(&iov_iter);
+    memcpy(desc + 1, header, header_length);
+    length = header_length +
+             uct_iov_to_buffer(iov, iovcnt, &iov_iter,
+                               UCS_PTR_BYTE_OFFSET(desc + 1, header_length),
+                               SIZE_MAX);
+
+    status = (ucs_status_t)uct_mm_ep_am_common_send(UCT_MM_SEND_AM_ZCOPY, ep,
+                                                    iface, id, length, 0, NULL,
+                                                    NULL, desc, NULL, 0, flags);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_mpool_put_inline(desc);
+    }
+
+    return status;
+}
+
 static inline int uct_mm_ep_has_tx_resources(uct_mm_ep_t *ep)
 {
     uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface, uct_mm_iface_t);
@@ -537,7 +645,11 @@ void uct_mm_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp)
 {
-    uct_mm_ep_t *ep = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_iface_t *iface = ucs_derived_of(tl_ep->iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(tl_ep, uct_mm_ep_t);
+    uct_mm_flush_comp_t *flush_comp;
+
+    uct_mm_ep_release_send_descs(ep);
 
     if (!uct_mm_ep_has_tx_resources(ep)) {
         if (!ucs_arbiter_group_is_empty(&ep->arb_group)) {
@@ -550,11 +662,82 @@ ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
         }
     }
 
+    /* The remote side reads am_zcopy data from the send descriptors, so they
+     * must not be reused by another endpoint until it consumed them */
+    if (!ucs_queue_is_empty(&ep->send_descs) &&
+        !(flags & UCT_FLUSH_FLAG_CANCEL)) {
+        if (comp != NULL) {
+            flush_comp = ucs_malloc(sizeof(*flush_comp), "mm_flush_comp");
+            if (flush_comp == NULL) {
+                return UCS_ERR_NO_MEMORY;
+            }
+
+            flush_comp->ep   = ep;
+            flush_comp->comp = comp;
+            ucs_queue_push(&iface->flush_comps, &flush_comp->queue);
+        }
+
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_INPROGRESS;
+    }
+
     ucs_memory_cpu_store_fence();
     UCT_TL_EP_STAT_FLUSH(&ep->super);
     return UCS_OK;
 }
 
+int uct_mm_ep_zcopy_is_flushed(uct_mm_ep_t *ep)
+{
+    uct_mm_ep_release_send_descs(ep);
+    return ucs_queue_is_empty(&ep->send_descs);
+}
+
+unsigned uct_mm_ep_progress_flush(uct_mm_iface_t *iface)
+{
+    uct_mm_flush_comp_t *flush_comp;
+    ucs_queue_head_t completed;
+    ucs_queue_iter_t iter;
+    unsigned count = 0;
+
+    ucs_queue_head_init(&completed);
+    ucs_queue_for_each_safe(flush_comp, iter, &iface->flush_comps, queue) {
+        if (uct_mm_ep_zcopy_is_flushed(flush_comp->ep)) {
+            ucs_queue_del_iter(&iface->flush_comps, iter);
+            ucs_queue_push(&completed, &flush_comp->queue);
+        }
+    }
+
+    /* Completion callbacks may destroy endpoints, which removes their flush
+     * operations from the iface queue */
+    ucs_queue_for_each_extract(flush_comp, &completed, queue, 1) {
+        uct_invoke_completion(flush_comp->comp, UCS_OK);
+        ucs_free(flush_comp);
+        ++count;
+    }
+
+    return count;
+}
+
+void uct_mm_ep_peer_failed(uct_mm_iface_t *iface, pid_t pid,
+                           ucs_status_t status)
+{
+    uct_mm_ep_t *ep, *tmp_ep;
+    int found = 0;
+
+    ucs_list_for_each_safe(ep, tmp_ep, &iface->ep_list, list) {
+        if (ep->fifo_ctl->pid == pid) {
+            uct_iface_handle_ep_err(&iface->super.super.super, &ep->super.super,
+                                    status);
+            found = 1;
+        }
+    }
+
+    if (!found) {
+        ucs_diag("mm_iface %p: no endpoint to report the failure of process "
+                 "%d: %s", iface, pid, ucs_status_string(status));
+    }
+}
+
 ucs_status_t
 uct_mm_ep_check(uct_ep_h tl_ep, unsigned flags, uct_completion_t *comp)
 {
@@ -11,13 +11,9 @@
 
 #include "mm_iface.h"
 
-#include <ucs/datastruct/khash.h>
 #include <uct/sm/base/sm_ep.h>
 
 
-KHASH_INIT(uct_mm_remote_seg, uintptr_t, uct_mm_remote_seg_t, 1,
-           kh_int64_hash_func, kh_int64_hash_equal)
-
 /*
  * Check if the remote receive FIFO has room.
  * Returns 1 if can send, 0 otherwise.
@@ -38,6 +34,17 @@ KHASH_INIT(uct_mm_remote_seg, uintptr_t, uct_mm_remote_seg_t, 1,
                 (_tail))) < (int64_t)(_fifo_size))
 
 
+/**
+ * Flush operation which waits until the remote side has consumed all am_zcopy
+ * send descriptors of the endpoint
+ */
+typedef struct uct_mm_flush_comp {
+    ucs_queue_elem_t           queue;   /* element in the iface queue */
+    struct uct_mm_ep           *ep;     /* endpoint being flushed */
+    uct_completion_t           *comp;   /* user completion */
+} uct_mm_flush_comp_t;
+
+
 /**
  * MM transport endpoint
  */
@@ -69,6 +76,13 @@ typedef struct uct_mm_ep {
     ucs_arbiter_elem_t         arb_elem;
 
     uct_keepalive_info_t       keepalive; /* keepalive info */
+
+    /* am_zcopy send descriptors which the remote side may still be reading,
+     * ordered by their FIFO index */
+    ucs_queue_head_t           send_descs;
+
+    /* element in the iface endpoint list */
+    ucs_list_link_t            list;
 } uct_mm_ep_t;
 
 
@@ -84,6 +98,11 @@ ucs_status_t uct_mm_ep_am_short_iov(uct_ep_h tl_ep, uint8_t id,
 ssize_t uct_mm_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id, uct_pack_callback_t pack_cb,
                            void *arg, unsigned flags);
 
+ucs_status_t uct_mm_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                unsigned header_length, const uct_iov_t *iov,
+                                size_t iovcnt, unsigned flags,
+                                uct_completion_t *comp);
+
 ucs_status_t uct_mm_ep_flush(uct_ep_h tl_ep, unsigned flags,
                              uct_completion_t *comp);
 
@@ -104,4 +123,11 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
 int uct_mm_ep_is_connected(const uct_ep_h tl_ep,
                            const uct_ep_is_connected_params_t *params);
 
+int uct_mm_ep_zcopy_is_flushed(uct_mm_ep_t *ep);
+
+unsigned uct_mm_ep_progress_flush(uct_mm_iface_t *iface);
+
+void uct_mm_ep_peer_failed(uct_mm_iface_t *iface, pid_t pid,
+                           ucs_status_t status);
+
 #endif
@@ -19,6 +19,7 @@
 #include <ucs/async/async.h>
 #include <ucs/sys/string.h>
 #include <sys/poll.h>
+#include <sys/mman.h>
 
 
 /* Maximal number of events to clear from the signaling pipe in single call */
@@ -27,6 +28,11 @@
 #define UCT_MM_IFACE_OVERHEAD 10e-9
 #define UCT_MM_IFACE_LATENCY  ucs_linear_func_make(80e-9, 0)
 
+/* am_zcopy also gets a send descriptor and releases it after the receiver has
+ * consumed the FIFO element */
+#define UCT_MM_IFACE_SEND_OVERHEAD_VALUE \
+    "am_zcopy:50ns," UCS_PP_MAKE_STRING(UCT_MM_IFACE_OVERHEAD)
+
 ucs_config_field_t uct_mm_iface_config_table[] = {
     {"SM_", "ALLOC=md,mmap,heap;BW=15360MBs", NULL,
      ucs_offsetof(uct_mm_iface_config_t, super),
@@ -40,6 +46,13 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
      "Size of send/receive buffers for copy-out sends.",
      ucs_offsetof(uct_mm_iface_config_t, seg_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+    {"ZCOPY_SEG_SIZE", "64k",
+     "Maximal size of zero-copy active messages. The sender writes them to its\n"
+     "own shared memory buffers, and the receiver reads them in-place instead\n"
+     "of splitting them to SEG_SIZE fragments. 0 disables am_zcopy.",
+     ucs_offsetof(uct_mm_iface_config_t, zcopy_seg_size),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
     {"FIFO_RELEASE_FACTOR", "0.5",
      "Frequency of resource releasing on the receiver's side in the MM UCT.\n"
      "This value refers to the percentage of the FIFO size. (must be >= 0 and < 1).",
@@ -49,13 +62,44 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
                                   ucs_offsetof(uct_mm_iface_config_t, mp), ""),
 
     {"FIFO_HUGETLB", "no",
-     "Enable using huge pages for internal shared memory buffers."
+     "Enable using transparent huge pages for the receive FIFO and receive\n"
+     "descriptors, to reduce TLB misses.\n"
      "Possible values are:\n"
-     " y   - Allocate memory using huge pages only.\n"
-     " n   - Allocate memory using regular pages only.\n"
-     " try - Try to allocate memory using huge pages and if it fails, allocate regular pages.",
+     " y   - Use huge pages, fail if they are not supported.\n"
+     " n   - Use regular pages only.\n"
+     " try - Try to use huge pages and if it fails, use regular pages.",
      ucs_offsetof(uct_mm_iface_config_t, hugetlb_mode), UCS_CONFIG_TYPE_TERNARY},
 
+    {"NUMA_BIND", "y",
+     "Place the receive FIFO and receive descriptors on the NUMA node of the\n"
+     "process, if the process is bound to CPUs of a single NUMA node. If the\n"
+     "node runs out of memory, other nodes are used.",
+     ucs_offsetof(uct_mm_iface_config_t, numa_bind), UCS_CONFIG_TYPE_BOOL},
+
+    {"RX_POOL", "n",
+     "Allocate receive descriptors from a shared memory pool of the node, which\n"
+     "is used by all processes of the user which enable it, instead of private\n"
+     "segments of every process. This bounds the receive memory of the node\n"
+     "when running many processes per node. If the pool is exhausted, or the\n"
+     "process reached its quota, private memory is used.",
+     ucs_offsetof(uct_mm_iface_config_t, rx_pool.enable), UCS_CONFIG_TYPE_BOOL},
+
+    {"RX_POOL_SIZE", "256m",
+     "Total size of the node receive pool. It must be the same for all processes\n"
+     "which use the pool, and cannot exceed 4g.",
+     ucs_offsetof(uct_mm_iface_config_t, rx_pool.size),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"RX_POOL_SLAB_SIZE", "1m",
+     "Size of the chunks which are allocated from the node receive pool.",
+     ucs_offsetof(uct_mm_iface_config_t, rx_pool.slab_size),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"RX_POOL_QUOTA", "16m",
+     "Maximal amount of memory a process may allocate from the node receive pool.",
+     ucs_offsetof(uct_mm_iface_config_t, rx_pool.quota),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
     {"FIFO_ELEM_SIZE", "128",
      "Size of the FIFO element size (data + header) in the MM UCTs.",
      ucs_offsetof(uct_mm_iface_config_t, fifo_elem_size), UCS_CONFIG_TYPE_UINT},
@@ -67,7 +111,7 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
     {"ERROR_HANDLING", "n", "Expose error handling support capability",
      ucs_offsetof(uct_mm_iface_config_t, error_handling), UCS_CONFIG_TYPE_BOOL},
 
-    {"SEND_OVERHEAD", UCS_PP_MAKE_STRING(UCT_MM_IFACE_OVERHEAD),
+    {"SEND_OVERHEAD", UCT_MM_IFACE_SEND_OVERHEAD_VALUE,
      "Time spent after the message request has been passed to the hardware or\n"
      "system software layers and before operation has been finalized", 0,
      UCS_CONFIG_TYPE_KEY_VALUE(UCS_CONFIG_TYPE_TIME,
@@ -75,6 +119,8 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
          ucs_offsetof(uct_mm_iface_config_t, overhead.send.am_short)},
         {"am_bcopy", "send overhead for buffered Active Message operation type",
          ucs_offsetof(uct_mm_iface_config_t, overhead.send.am_bcopy)},
+        {"am_zcopy", "send overhead for zero-copy Active Message operation type",
+         ucs_offsetof(uct_mm_iface_config_t, overhead.send.am_zcopy)},
         {NULL})},
 
     {"RECV_OVERHEAD", UCS_PP_MAKE_STRING(UCT_MM_IFACE_OVERHEAD),
@@ -85,6 +131,9 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
         {"am_bcopy", "receive overhead for buffered Active Message operation "
                      "type",
          ucs_offsetof(uct_mm_iface_config_t, overhead.recv.am_bcopy)},
+        {"am_zcopy", "receive overhead for zero-copy Active Message operation "
+                     "type",
+         ucs_offsetof(uct_mm_iface_config_t, overhead.recv.am_zcopy)},
         {NULL})},
 
     {NULL}
@@ -160,10 +209,20 @@ void uct_mm_iface_release_desc(uct_recv_desc_t *self, void *desc)
 ucs_status_t uct_mm_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                 uct_completion_t *comp)
 {
+    uct_mm_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_iface_t);
+    uct_mm_ep_t *ep;
+
     if (comp != NULL) {
         return UCS_ERR_UNSUPPORTED;
     }
 
+    ucs_list_for_each(ep, &iface->ep_list, list) {
+        if (!uct_mm_ep_zcopy_is_flushed(ep)) {
+            UCT_TL_IFACE_STAT_FLUSH_WAIT(&iface->super.super);
+            return UCS_INPROGRESS;
+        }
+    }
+
     ucs_memory_cpu_store_fence();
     UCT_TL_IFACE_STAT_FLUSH(ucs_derived_of(tl_iface, uct_base_iface_t));
     return UCS_OK;
@@ -186,23 +245,25 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->cap.put.max_zcopy       = SIZE_MAX;
     iface_attr->cap.put.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.put.align_mtu       = iface_attr->cap.put.opt_zcopy_align;
-    iface_attr->cap.put.max_iov         = 1;
+    iface_attr->cap.put.max_iov         = UCT_SM_MAX_IOV;
 
     iface_attr->cap.get.max_bcopy       = SIZE_MAX;
     iface_attr->cap.get.min_zcopy       = 0;
     iface_attr->cap.get.max_zcopy       = SIZE_MAX;
     iface_attr->cap.get.opt_zcopy_align = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.get.align_mtu       = iface_attr->cap.get.opt_zcopy_align;
-    iface_attr->cap.get.max_iov         = 1;
+    iface_attr->cap.get.max_iov         = UCT_SM_MAX_IOV;
 
     iface_attr->cap.am.max_short        = iface->config.fifo_elem_size -
                                           sizeof(uct_mm_fifo_element_t);
     iface_attr->cap.am.max_bcopy        = iface->config.seg_size;
     iface_attr->cap.am.min_zcopy        = 0;
-    iface_attr->cap.am.max_zcopy        = 0;
+    iface_attr->cap.am.max_zcopy        = iface->config.zcopy_seg_size;
     iface_attr->cap.am.opt_zcopy_align  = UCS_SYS_CACHE_LINE_SIZE;
     iface_attr->cap.am.align_mtu        = iface_attr->cap.am.opt_zcopy_align;
     iface_attr->cap.am.max_iov          = SIZE_MAX;
+    iface_attr->cap.am.max_hdr          = (iface->config.zcopy_seg_size > 0) ?
+                                          UCT_MM_IFACE_AM_ZCOPY_MAX_HDR : 0;
 
     iface_attr->iface_addr_len          = sizeof(uct_mm_iface_addr_t) +
                                           md->iface_addr_len;
@@ -211,8 +272,10 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     iface_attr->max_conn_priv           = 0;
     iface_attr->cap.flags               = UCT_IFACE_FLAG_PUT_SHORT           |
                                           UCT_IFACE_FLAG_PUT_BCOPY           |
+                                          UCT_IFACE_FLAG_PUT_ZCOPY           |
                                           UCT_IFACE_FLAG_ATOMIC_CPU          |
                                           UCT_IFACE_FLAG_GET_BCOPY           |
+                                          UCT_IFACE_FLAG_GET_ZCOPY           |
                                           UCT_IFACE_FLAG_AM_SHORT            |
                                           UCT_IFACE_FLAG_AM_BCOPY            |
                                           UCT_IFACE_FLAG_PENDING             |
@@ -220,6 +283,11 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
                                           UCT_IFACE_FLAG_CONNECT_TO_IFACE    |
                                           iface->config.extra_cap_flags;
 
+    if (iface->config.zcopy_seg_size > 0) {
+        iface_attr->cap.flags          |= UCT_IFACE_FLAG_AM_ZCOPY;
+        iface_attr->cap.am.max_iov      = UCT_SM_MAX_IOV;
+    }
+
     status = uct_mm_md_mapper_ops(md)->query(&attach_shm_file);
     ucs_assert_always(status == UCS_OK);
 
@@ -295,6 +363,106 @@ uct_mm_assign_desc_to_fifo_elem(uct_mm_iface_t *iface,
     return UCS_OK;
 }
 
+static UCS_F_NOINLINE ucs_status_t
+uct_mm_iface_attach_sender_seg(uct_mm_iface_t *iface,
+                               const uct_mm_fifo_zcopy_t *zcopy,
+                               void **address_p)
+{
+    const uct_mm_desc_info_t *info = &zcopy->desc;
+    uct_mm_sender_seg_t *sender_seg;
+    ucs_status_t status;
+    khiter_t khiter;
+    int khret;
+
+    khiter = kh_put(uct_mm_sender_seg, &iface->sender_segs, info->seg_id,
+                    &khret);
+    if (khret == UCS_KH_PUT_FAILED) {
+        ucs_error("failed to add sender segment to mm iface hash");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    sender_seg = &kh_val(&iface->sender_segs, khiter);
+    if (khret == UCS_KH_PUT_KEY_PRESENT) {
+        /* the sender released the segment we attached, and created a new one
+         * with the same id */
+        ucs_debug("mm_iface %p: sender segment id 0x%"PRIx64" was re-created",
+                  iface, info->seg_id);
+        uct_mm_iface_mapper_call(iface, mem_detach, &sender_seg->rseg);
+    }
+
+    /* the segment is released only if the sender is gone, check it before
+     * attaching to avoid an error from the mapper */
+    if (!uct_mm_iface_mapper_call(iface, is_reachable, info->seg_id,
+                                  iface->md_addr)) {
+        kh_del(uct_mm_sender_seg, &iface->sender_segs, khiter);
+        return UCS_ERR_UNREACHABLE;
+    }
+
+    status = uct_mm_iface_mapper_call(iface, mem_attach, info->seg_id,
+                                      info->seg_size, iface->md_addr,
+                                      &sender_seg->rseg);
+    if (status != UCS_OK) {
+        kh_del(uct_mm_sender_seg, &iface->sender_segs, khiter);
+        return status;
+    }
+
+    sender_seg->uuid = zcopy->seg_uuid;
+    *address_p       = sender_seg->rseg.address;
+    ucs_debug("mm_iface %p: attached sender segment id 0x%"PRIx64" at %p",
+              iface, info->seg_id, sender_seg->rseg.address);
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE void
+uct_mm_iface_process_recv_zcopy(uct_mm_iface_t *iface,
+                                uct_mm_fifo_element_t *elem)
+{
+    uct_mm_fifo_zcopy_t *zcopy = (uct_mm_fifo_zcopy_t*)(elem + 1);
+    uct_mm_sender_seg_t *sender_seg;
+    ucs_status_t status;
+    khiter_t khiter;
+    void *address;
+    void *data;
+
+    khiter = kh_get(uct_mm_sender_seg, &iface->sender_segs, zcopy->desc.seg_id);
+    if (ucs_likely(khiter != kh_end(&iface->sender_segs))) {
+        sender_seg = &kh_val(&iface->sender_segs, khiter);
+    } else {
+        sender_seg = NULL;
+    }
+
+    if (ucs_likely((sender_seg != NULL) &&
+                   (sender_seg->uuid == zcopy->seg_uuid))) {
+        address = sender_seg->rseg.address;
+    } else {
+        status = uct_mm_iface_attach_sender_seg(iface, zcopy, &address);
+        if (ucs_unlikely(status != UCS_OK)) {
+            /* the sender keeps the segment until the message is consumed, so
+             * it is released only if the sender iface or process is gone */
+            ucs_debug("mm_iface %p: failed to attach sender segment id "
+                      "0x%"PRIx64" of process %d: %s", iface,
+                      zcopy->desc.seg_id, zcopy->pid,
+                      ucs_status_string(status));
+            uct_mm_ep_peer_failed(iface, zcopy->pid,
+                                  UCS_ERR_CONNECTION_RESET);
+            return;
+        }
+    }
+
+    /* the data stays in the sender memory, so the receiver must consume it
+     * during the callback */
+    data = UCS_PTR_BYTE_OFFSET(address, zcopy->desc.offset);
+    uct_mm_iface_trace_am(iface, UCT_AM_TRACE_TYPE_RECV, elem->flags,
+                          elem->am_id, data, zcopy->length, iface->read_index);
+    uct_iface_invoke_am(&iface->super.super, elem->am_id, data, zcopy->length,
+                        0);
+
+    /* the sender reuses the descriptor, and completes its flush, only after
+     * the tail has passed the element, so don't wait for a batch to release */
+    ucs_memory_cpu_store_fence();
+    iface->recv_fifo_ctl->tail = iface->read_index + 1;
+}
+
 static UCS_F_ALWAYS_INLINE void uct_mm_iface_process_recv(uct_mm_iface_t *iface)
 {
     uct_mm_fifo_element_t *elem = iface->read_index_elem;
@@ -310,6 +478,11 @@ static UCS_F_ALWAYS_INLINE void uct_mm_iface_process_recv(uct_mm_iface_t *iface)
         return;
     }
 
+    if (elem->flags & UCT_MM_FIFO_ELEM_FLAG_ZCOPY) {
+        uct_mm_iface_process_recv_zcopy(iface, elem);
+        return;
+    }
+
     /* check the memory pool to make sure that there is a new descriptor available */
     if (ucs_unlikely(iface->last_recv_desc == NULL)) {
         UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
@@ -419,6 +592,10 @@ static unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending,
                          &total_count);
 
+    if (ucs_unlikely(!ucs_queue_is_empty(&iface->flush_comps))) {
+        total_count += uct_mm_ep_progress_flush(iface);
+    }
+
     return total_count;
 }
 
@@ -438,7 +615,8 @@ uct_mm_iface_event_fd_arm(uct_iface_h tl_iface, unsigned events)
     int ret;
 
     if ((events & UCT_EVENT_SEND_COMP) &&
-        !ucs_arbiter_is_empty(&iface->arbiter)) {
+        (!ucs_arbiter_is_empty(&iface->arbiter) ||
+         !ucs_queue_is_empty(&iface->flush_comps))) {
         /* if we have outstanding send operations, can't go to sleep */
         return UCS_ERR_BUSY;
     }
@@ -504,10 +682,13 @@ static UCS_CLASS_DECLARE_DELETE_FUNC(uct_mm_iface_t, uct_iface_t);
 static uct_iface_ops_t uct_mm_iface_ops = {
     .ep_put_short             = uct_sm_ep_put_short,
     .ep_put_bcopy             = uct_sm_ep_put_bcopy,
+    .ep_put_zcopy             = uct_sm_ep_put_zcopy,
     .ep_get_bcopy             = uct_sm_ep_get_bcopy,
+    .ep_get_zcopy             = uct_sm_ep_get_zcopy,
     .ep_am_short              = uct_mm_ep_am_short,
     .ep_am_short_iov          = uct_mm_ep_am_short_iov,
     .ep_am_bcopy              = uct_mm_ep_am_bcopy,
+    .ep_am_zcopy              = uct_mm_ep_am_zcopy,
     .ep_atomic_cswap64        = uct_sm_ep_atomic_cswap64,
     .ep_atomic64_post         = uct_sm_ep_atomic64_post,
     .ep_atomic64_fetch        = uct_sm_ep_atomic64_fetch,
@@ -544,6 +725,12 @@ uct_mm_estimate_perf(uct_iface_h tl_iface, uct_perf_attr_t *perf_attr)
     uct_ppn_bandwidth_t bandwidth = {iface->super.config.bandwidth, 0};
     uct_mm_iface_op_overhead_t *overhead;
 
+    if (op == UCT_EP_OP_AM_ZCOPY) {
+        /* am_zcopy copies the payload to a send descriptor before the receiver
+         * reads it, so the memory is traversed twice */
+        bandwidth.dedicated /= 2;
+    }
+
     if (perf_attr->field_mask & UCT_PERF_ATTR_FIELD_BANDWIDTH) {
         perf_attr->bandwidth = bandwidth;
     }
@@ -561,6 +748,9 @@ uct_mm_estimate_perf(uct_iface_h tl_iface, uct_perf_attr_t *perf_attr)
         case UCT_EP_OP_AM_BCOPY:
             perf_attr->send_pre_overhead = overhead->am_bcopy;
             break;
+        case UCT_EP_OP_AM_ZCOPY:
+            perf_attr->send_pre_overhead = overhead->am_zcopy;
+            break;
         default:
             perf_attr->send_pre_overhead = UCT_MM_IFACE_OVERHEAD;
             break;
@@ -576,6 +766,9 @@ uct_mm_estimate_perf(uct_iface_h tl_iface, uct_perf_attr_t *perf_attr)
         case UCT_EP_OP_AM_BCOPY:
             perf_attr->recv_overhead = overhead->am_bcopy;
             break;
+        case UCT_EP_OP_AM_ZCOPY:
+            perf_attr->recv_overhead = overhead->am_zcopy;
+            break;
         default:
             perf_attr->recv_overhead = UCT_MM_IFACE_OVERHEAD;
             break;
@@ -613,6 +806,51 @@ static uct_iface_internal_ops_t uct_mm_iface_internal_ops = {
     .ep_get_device_ep       = (uct_ep_get_device_ep_func_t)ucs_empty_function_return_unsupported
 };
 
+/*
+ * Place receive memory on the NUMA node of the process, and back it with
+ * transparent huge pages, according to the configuration.
+ */
+static ucs_status_t
+uct_mm_iface_mem_place(uct_mm_iface_t *iface, void *address, size_t length)
+{
+    ucs_status_t status;
+    int ret;
+
+    if (iface->numa_node != UCS_NUMA_NODE_UNDEFINED) {
+        status = ucs_numa_mem_bind_preferred(address, length,
+                                             iface->numa_node);
+        if (status != UCS_OK) {
+            ucs_debug("mm_iface %p: failed to bind %p..%p to numa node %d",
+                      iface, address, UCS_PTR_BYTE_OFFSET(address, length),
+                      iface->numa_node);
+        }
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (iface->config.hugetlb_mode != UCS_NO) {
+        ret = madvise(address, length, MADV_HUGEPAGE);
+        if (ret != 0) {
+            if (iface->config.hugetlb_mode == UCS_YES) {
+                ucs_error("mm_iface %p: madvise(%p, %zu, MADV_HUGEPAGE) "
+                          "failed: %m", iface, address, length);
+                return UCS_ERR_UNSUPPORTED;
+            }
+
+            ucs_debug("mm_iface %p: madvise(%p, %zu, MADV_HUGEPAGE) failed: %m",
+                      iface, address, length);
+        }
+    }
+#else
+    if (iface->config.hugetlb_mode == UCS_YES) {
+        ucs_error("mm_iface %p: transparent huge pages are not supported",
+                  iface);
+        return UCS_ERR_UNSUPPORTED;
+    }
+#endif
+
+    return UCS_OK;
+}
+
 static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
                                         uct_mem_h memh)
 {
@@ -637,6 +875,148 @@ static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
     desc->info.offset   = offset;
 }
 
+/*
+ * Receive descriptors chunks are taken from the node receive pool if it is
+ * used, or allocated from private shared memory otherwise. The chunk header
+ * holds the chunk memory, whose memh is the pool segment for pool chunks.
+ */
+static ucs_status_t
+uct_mm_iface_recv_chunk_alloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
+{
+    uct_mm_iface_t *iface = ucs_container_of(mp, uct_mm_iface_t, recv_desc_mp);
+    uct_allocated_memory_t *hdr, mem;
+    ucs_status_t status;
+
+    mem.address = NULL;
+    if (iface->rx_pool.seg != NULL) {
+        mem.address = uct_mm_rx_pool_slab_get(&iface->rx_pool);
+    }
+
+    if (mem.address != NULL) {
+        mem.length = iface->rx_pool.slab_size;
+        mem.method = UCT_ALLOC_METHOD_MD;
+        mem.md     = iface->super.super.md;
+        mem.memh   = iface->rx_pool.seg;
+    } else {
+        status = uct_iface_mem_alloc(&iface->super.super.super,
+                                     sizeof(*hdr) + *size_p,
+                                     UCT_MD_MEM_ACCESS_LOCAL_READ |
+                                     UCT_MD_MEM_ACCESS_LOCAL_WRITE |
+                                     UCT_MD_MEM_FLAG_LOCK,
+                                     ucs_mpool_name(mp), &mem);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    status = uct_mm_iface_mem_place(iface, mem.address, mem.length);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    hdr      = mem.address;
+    *hdr     = mem;
+    *size_p  = mem.length - sizeof(*hdr);
+    *chunk_p = hdr + 1;
+    return UCS_OK;
+
+err_free:
+    if (mem.memh == iface->rx_pool.seg) {
+        uct_mm_rx_pool_slab_put(&iface->rx_pool, mem.address);
+    } else {
+        uct_iface_mem_free(&mem);
+    }
+    return status;
+}
+
+static void uct_mm_iface_recv_chunk_release(ucs_mpool_t *mp, void *chunk)
+{
+    uct_mm_iface_t *iface = ucs_container_of(mp, uct_mm_iface_t, recv_desc_mp);
+    uct_allocated_memory_t *hdr = UCS_PTR_BYTE_OFFSET(chunk, -sizeof(*hdr));
+    uct_allocated_memory_t mem  = *hdr;
+
+    if (mem.memh == iface->rx_pool.seg) {
+        uct_mm_rx_pool_slab_put(&iface->rx_pool, mem.address);
+    } else {
+        uct_iface_mem_free(&mem);
+    }
+}
+
+static void uct_mm_iface_recv_obj_init(ucs_mpool_t *mp, void *obj, void *chunk)
+{
+    uct_mm_iface_t *iface = ucs_container_of(mp, uct_mm_iface_t, recv_desc_mp);
+    uct_allocated_memory_t *hdr = UCS_PTR_BYTE_OFFSET(chunk, -sizeof(*hdr));
+
+    uct_mm_iface_recv_desc_init(&iface->super.super.super, obj, hdr->memh);
+}
+
+static ucs_mpool_ops_t uct_mm_iface_recv_mpool_ops = {
+    .chunk_alloc   = uct_mm_iface_recv_chunk_alloc,
+    .chunk_release = uct_mm_iface_recv_chunk_release,
+    .obj_init      = uct_mm_iface_recv_obj_init,
+    .obj_cleanup   = NULL,
+    .obj_str       = NULL
+};
+
+static void
+uct_mm_iface_rx_pool_open(uct_mm_iface_t *iface,
+                          const uct_mm_iface_config_t *mm_config,
+                          size_t desc_size)
+{
+    uct_mm_md_t *md = ucs_derived_of(iface->super.super.md, uct_mm_md_t);
+    ucs_status_t status;
+
+    iface->rx_pool.seg = NULL;
+    if (!mm_config->rx_pool.enable) {
+        return;
+    }
+
+    /* descriptor offsets and segment size are passed as 32-bit values */
+    if (mm_config->rx_pool.size > UINT_MAX) {
+        ucs_warn("mm_iface %p: receive pool size %zu exceeds the maximum %u, "
+                 "not using it", iface, mm_config->rx_pool.size, UINT_MAX);
+        return;
+    }
+
+    /* make sure a slab holds a useful number of descriptors */
+    if (mm_config->rx_pool.slab_size < (4 * desc_size)) {
+        ucs_warn("mm_iface %p: receive pool slab size %zu is too small for "
+                 "descriptors of %zu bytes, not using it", iface,
+                 mm_config->rx_pool.slab_size, desc_size);
+        return;
+    }
+
+    status = uct_mm_rx_pool_open(md, mm_config->rx_pool.size,
+                                 mm_config->rx_pool.slab_size,
+                                 mm_config->rx_pool.quota, &iface->rx_pool);
+    if (status != UCS_OK) {
+        ucs_debug("mm_iface %p: failed to open receive pool: %s", iface,
+                  ucs_status_string(status));
+        iface->rx_pool.seg = NULL;
+    }
+}
+
+static void uct_mm_iface_send_desc_init(uct_iface_h tl_iface, void *obj,
+                                        uct_mem_h memh)
+{
+    uct_mm_send_desc_t *desc = obj;
+    uct_mm_seg_t *seg        = memh;
+
+    if (seg->length > UINT_MAX) {
+        ucs_error("mm: shared memory segment length cannot exceed %u", UINT_MAX);
+        desc->info.seg_id   = UINT64_MAX;
+        desc->info.seg_size = 0;
+        desc->info.offset   = 0;
+        desc->seg_uuid      = 0;
+        return;
+    }
+
+    desc->info.seg_id   = seg->seg_id;
+    desc->info.seg_size = seg->length;
+    desc->info.offset   = UCS_PTR_BYTE_DIFF(seg->address, desc + 1);
+    desc->seg_uuid      = seg->uuid;
+}
+
 static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, unsigned num_elems)
 {
     uct_mm_fifo_element_t *elem;
@@ -747,7 +1127,9 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                     ucs_derived_of(tl_config, uct_mm_iface_config_t);
     uct_mm_fifo_element_t* fifo_elem_p;
     size_t alignment, align_offset, payload_offset;
+    ucs_mpool_params_t mp_params;
     ucs_status_t status;
+    uct_mm_md_t *mm_md;
     unsigned i;
 
     UCS_CLASS_CALL_SUPER_INIT(uct_sm_iface_t, &uct_mm_iface_ops,
@@ -783,9 +1165,16 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
     }
 
     self->config.overhead          = mm_config->overhead;
+    self->config.hugetlb_mode      = mm_config->hugetlb_mode;
+    self->numa_node                = mm_config->numa_bind ?
+                                     ucs_numa_node_of_process() :
+                                     UCS_NUMA_NODE_UNDEFINED;
     self->config.fifo_size         = mm_config->fifo_size;
     self->config.fifo_elem_size    = mm_config->fifo_elem_size;
     self->config.seg_size          = mm_config->seg_size;
+    self->config.zcopy_seg_size    = ucs_min(mm_config->zcopy_seg_size,
+                                             UINT_MAX -
+                                             UCT_MM_IFACE_AM_ZCOPY_MAX_HDR);
     self->config.fifo_max_poll     = ((mm_config->fifo_max_poll == UCS_ULUNITS_AUTO) ?
                                       UCT_MM_IFACE_FIFO_MAX_POLL :
                                       /* trim by the maximum unsigned integer value */
@@ -807,6 +1196,12 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                      params->rx_headroom : 0;
     self->release_desc.cb          = uct_mm_iface_release_desc;
 
+    /* am_zcopy needs the element to hold the send descriptor parameters */
+    if (self->config.fifo_elem_size < (sizeof(uct_mm_fifo_element_t) +
+                                       sizeof(uct_mm_fifo_zcopy_t))) {
+        self->config.zcopy_seg_size = 0;
+    }
+
     /* Allocate the receive FIFO */
     status = uct_iface_mem_alloc(&self->super.super.super,
                                  UCT_MM_GET_FIFO_SIZE(self),
@@ -817,6 +1212,12 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         return status;
     }
 
+    status = uct_mm_iface_mem_place(self, self->recv_fifo_mem.address,
+                                    self->recv_fifo_mem.length);
+    if (status != UCS_OK) {
+        goto err_free_fifo;
+    }
+
     uct_mm_iface_set_fifo_ptrs(self->recv_fifo_mem.address,
                                &self->recv_fifo_ctl, &self->recv_fifo_elems);
     self->recv_fifo_ctl->head = 0;
@@ -841,15 +1242,22 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_close_signal_fd;
     }
 
+    uct_mm_iface_rx_pool_open(self, mm_config,
+                              payload_offset + self->config.seg_size);
+
     /* create a memory pool for receive descriptors */
-    status = uct_iface_mpool_init(&self->super.super, &self->recv_desc_mp,
-                                  payload_offset + self->config.seg_size,
-                                  align_offset, alignment, &mm_config->mp,
-                                  mm_config->mp.bufs_grow,
-                                  uct_mm_iface_recv_desc_init, "mm_recv_desc");
+    ucs_mpool_params_reset(&mp_params);
+    uct_iface_mpool_config_copy(&mp_params, &mm_config->mp);
+    mp_params.elems_per_chunk = mm_config->mp.bufs_grow;
+    mp_params.elem_size       = payload_offset + self->config.seg_size;
+    mp_params.align_offset    = align_offset;
+    mp_params.alignment       = alignment;
+    mp_params.ops             = &uct_mm_iface_recv_mpool_ops;
+    mp_params.name            = "mm_recv_desc";
+    status = ucs_mpool_init(&mp_params, &self->recv_desc_mp);
     if (status != UCS_OK) {
         ucs_error("failed to create a receive descriptor memory pool for the MM transport");
-        goto err_close_signal_fd;
+        goto err_close_rx_pool;
     }
 
     /* set the first receive descriptor */
@@ -874,16 +1282,60 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         }
     }
 
+    /* create a memory pool for am_zcopy send descriptors, it is allocated from
+     * shared memory so the receiver could attach to it */
+    status = uct_iface_mpool_init(&self->super.super, &self->send_desc_mp,
+                                  sizeof(uct_mm_send_desc_t) +
+                                  UCT_MM_IFACE_AM_ZCOPY_MAX_HDR +
+                                  self->config.zcopy_seg_size,
+                                  sizeof(uct_mm_send_desc_t),
+                                  UCS_SYS_CACHE_LINE_SIZE, &mm_config->mp,
+                                  mm_config->mp.bufs_grow,
+                                  uct_mm_iface_send_desc_init, "mm_send_desc");
+    if (status != UCS_OK) {
+        ucs_error("failed to create a send descriptor memory pool for the MM "
+                  "transport");
+        goto destroy_descs;
+    }
+
+    mm_md         = ucs_derived_of(md, uct_mm_md_t);
+    self->md_addr = NULL;
+    if (mm_md->iface_addr_len > 0) {
+        self->md_addr = ucs_malloc(mm_md->iface_addr_len, "mm_md_addr");
+        if (self->md_addr == NULL) {
+            status = UCS_ERR_NO_MEMORY;
+            goto destroy_send_mpool;
+        }
+
+        status = uct_mm_md_mapper_ops(mm_md)->iface_addr_pack(mm_md,
+                                                              self->md_addr);
+        if (status != UCS_OK) {
+            goto free_md_addr;
+        }
+    }
+
+    kh_init_inplace(uct_mm_sender_seg, &self->sender_segs);
+    ucs_list_head_init(&self->ep_list);
+    ucs_queue_head_init(&self->flush_comps);
+    ucs_queue_head_init(&self->ep_send_descs);
     ucs_arbiter_init(&self->arbiter);
     uct_mm_iface_log_created(self);
 
     return UCS_OK;
 
+free_md_addr:
+    ucs_free(self->md_addr);
+destroy_send_mpool:
+    ucs_mpool_cleanup(&self->send_desc_mp, 1);
 destroy_descs:
     uct_mm_iface_free_rx_descs(self, i);
     ucs_mpool_put(self->last_recv_desc);
 destroy_recv_mpool:
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+err_close_rx_pool:
+    if (self->rx_pool.seg != NULL) {
+        uct_mm_rx_pool_close(&self->rx_pool);
+    }
 err_close_signal_fd:
     close(self->signal_fd);
 err_free_fifo:
@@ -894,15 +1346,33 @@ err:
 
 static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
 {
+    uct_mm_sender_seg_t sender_seg;
+    uct_mm_send_desc_t *desc;
+
     uct_base_iface_progress_disable(&self->super.super.super,
                                     UCT_PROGRESS_SEND | UCT_PROGRESS_RECV);
 
+    ucs_assert(ucs_queue_is_empty(&self->flush_comps));
+    ucs_queue_for_each_extract(desc, &self->ep_send_descs, queue, 1) {
+        ucs_mpool_put(desc);
+    }
+
+    kh_foreach_value(&self->sender_segs, sender_seg, {
+        uct_mm_iface_mapper_call(self, mem_detach, &sender_seg.rseg);
+    })
+    kh_destroy_inplace(uct_mm_sender_seg, &self->sender_segs);
+    ucs_free(self->md_addr);
+    ucs_mpool_cleanup(&self->send_desc_mp, 1);
+
     /* return all the descriptors that are now 'assigned' to the FIFO,
      * to their mpool */
     uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
 
     ucs_mpool_put(self->last_recv_desc);
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+    if (self->rx_pool.seg != NULL) {
+        uct_mm_rx_pool_close(&self->rx_pool);
+    }
     close(self->signal_fd);
     uct_iface_mem_free(&self->recv_fifo_mem);
     ucs_arbiter_cleanup(&self->arbiter);
@@ -9,12 +9,17 @@
 #define UCT_MM_IFACE_H
 
 #include "mm_md.h"
+#include "mm_rx_pool.h"
 
 #include <uct/base/uct_iface.h>
 #include <uct/sm/base/sm_iface.h>
 #include <ucs/arch/cpu.h>
 #include <ucs/debug/memtrack_int.h>
 #include <ucs/datastruct/arbiter.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/queue.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/ptr_arith.h>
 #include <ucs/sys/sys.h>
@@ -29,9 +34,17 @@ enum {
 
     /* Whether the element data is inline or in receive descriptor */
     UCT_MM_FIFO_ELEM_FLAG_INLINE = UCS_BIT(1),
+
+    /* The element data is in a send descriptor of the sender, which is
+       described by uct_mm_fifo_zcopy_t in the element inline data */
+    UCT_MM_FIFO_ELEM_FLAG_ZCOPY  = UCS_BIT(2),
 };
 
 
+KHASH_INIT(uct_mm_remote_seg, uintptr_t, uct_mm_remote_seg_t, 1,
+           kh_int64_hash_func, kh_int64_hash_equal)
+
+
 #define UCT_MM_FIFO_CTL_SIZE \
     ucs_align_up(sizeof(uct_mm_fifo_ctl_t), UCS_SYS_CACHE_LINE_SIZE)
 
@@ -63,7 +76,8 @@ enum {
                                                              '?', \
                        (_elem_sn), \
                        ((_flags) & UCT_MM_FIFO_ELEM_FLAG_OWNER) ? 'o' : '-', \
-                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_INLINE) ? 'i' : '-')
+                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_INLINE) ? 'i' : \
+                       ((_flags) & UCT_MM_FIFO_ELEM_FLAG_ZCOPY)  ? 'z' : '-')
 
 
 /* AIMD (additive increase/multiplicative decrease) algorithm adopted for FIFO
@@ -84,6 +98,10 @@ enum {
 #define UCT_MM_IFACE_FIFO_AI_VALUE              1 /* FIFO window += AI value */
 #define UCT_MM_IFACE_FIFO_MD_FACTOR             2 /* FIFO window /= MD factor */
 
+/* Maximal header length of am_zcopy, it is stored in the send descriptor
+ * together with the payload */
+#define UCT_MM_IFACE_AM_ZCOPY_MAX_HDR           128
+
 /* If this bit is set in fifo_ctl.head, trigger async event on the receiver  */
 #define UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED      UCS_BIT(63)
 
@@ -91,6 +109,7 @@ enum {
 typedef struct uct_mm_iface_op_overhead {
     double am_short;
     double am_bcopy;
+    double am_zcopy;
 } uct_mm_iface_op_overhead_t;
 
 
@@ -107,12 +126,23 @@ typedef struct uct_mm_iface_config {
     uct_sm_iface_config_t    super;
     size_t                   seg_size;            /* Size of the receive
                                                    * descriptor (for payload) */
+    size_t                   zcopy_seg_size;      /* Size of the send
+                                                   * descriptor for am_zcopy */
     unsigned                 fifo_size;           /* Size of the receive FIFO */
     size_t                   fifo_max_poll;       /* Maximal RX completions to pick
                                                    * during RX poll */
     double                   release_fifo_factor; /* Tail index update frequency */
     ucs_ternary_auto_value_t hugetlb_mode;        /* Enable using huge pages for
                                                    * shared memory buffers */
+    int                      numa_bind;           /* Bind receive memory to the
+                                                   * local NUMA node */
+    struct {
+        int                  enable;              /* Use the node receive pool */
+        size_t               size;                /* Total pool size */
+        size_t               slab_size;           /* Pool allocation unit */
+        size_t               quota;               /* Maximal pool memory per
+                                                   * process */
+    } rx_pool;
     unsigned                 fifo_elem_size;      /* Size of the FIFO element size */
     int                      error_handling; /* Exposing of error handling cap */
     uct_iface_mpool_config_t mp;
@@ -158,6 +188,51 @@ typedef struct uct_mm_desc_info {
 } UCS_S_PACKED uct_mm_desc_info_t;
 
 
+/**
+ * MM send descriptor for am_zcopy, allocated from shared memory of the sender
+ * and read in-place by the receiver.
+ */
+typedef struct uct_mm_send_desc {
+    uct_mm_desc_info_t        info;           /* descriptor information for the
+                                                 remote side which reads it */
+    ucs_queue_elem_t          queue;          /* element in the endpoint queue
+                                                 of descriptors in flight */
+    uint64_t                  sn;             /* FIFO head index of the element
+                                                 which refers to the descriptor */
+    uint64_t                  seg_uuid;       /* unique id of the segment */
+    /* the data follows here */
+} uct_mm_send_desc_t;
+
+
+/**
+ * Inline data of a FIFO element with UCT_MM_FIFO_ELEM_FLAG_ZCOPY
+ */
+typedef struct uct_mm_fifo_zcopy {
+    uct_mm_desc_info_t        desc;           /* sender descriptor parameters */
+    uint32_t                  length;         /* length of the data in the
+                                                 sender descriptor */
+    uint64_t                  seg_uuid;       /* unique id of the sender
+                                                 segment */
+    pid_t                     pid;            /* process id of the sender */
+} UCS_S_PACKED uct_mm_fifo_zcopy_t;
+
+
+/**
+ * Sender segment which the receiver attached to read am_zcopy data
+ */
+typedef struct uct_mm_sender_seg {
+    uct_mm_remote_seg_t       rseg;           /* attached segment */
+    uint64_t                  uuid;           /* unique id of the segment, a
+                                                 segment id may be reused by a
+                                                 new segment after the sender
+                                                 released the old one */
+} uct_mm_sender_seg_t;
+
+
+KHASH_INIT(uct_mm_sender_seg, uintptr_t, uct_mm_sender_seg_t, 1,
+           kh_int64_hash_func, kh_int64_hash_equal)
+
+
 /**
  * MM FIFO element
  */
@@ -222,6 +297,30 @@ typedef struct uct_mm_iface {
     ucs_mpool_t             recv_desc_mp;
     uct_mm_recv_desc_t      *last_recv_desc;  /* next receive descriptor to use */
 
+    ucs_mpool_t             send_desc_mp;     /* send descriptors for am_zcopy */
+
+    /* NUMA node to place receive memory on, or UCS_NUMA_NODE_UNDEFINED */
+    ucs_numa_node_t         numa_node;
+
+    /* node-level receive pool, seg is NULL if not used */
+    uct_mm_rx_pool_t        rx_pool;
+
+    /* send descriptor segments of remote senders, attached on receive */
+    khash_t(uct_mm_sender_seg) sender_segs;
+
+    /* endpoints of the iface, to report a sender whose segment can not be
+     * attached */
+    ucs_list_link_t         ep_list;
+
+    /* flush operations waiting for am_zcopy send descriptors to be consumed */
+    ucs_queue_head_t        flush_comps;
+
+    /* am_zcopy send descriptors of destroyed endpoints, which the remote side
+     * may still read, returned to the pool when the iface is destroyed */
+    ucs_queue_head_t        ep_send_descs;
+    void                    *md_addr;         /* local md-specific address, used
+                                                 to attach sender segments */
+
     int                     signal_fd;        /* Unix socket for receiving remote signal */
 
     size_t                  rx_headroom;
@@ -233,9 +332,12 @@ typedef struct uct_mm_iface {
         unsigned                fifo_elem_size;
         /* size of the receive descriptor (for payload) */
         unsigned                seg_size;
+        /* maximal am_zcopy payload, 0 if am_zcopy is disabled */
+        unsigned                zcopy_seg_size;
         unsigned                fifo_max_poll;
         uint64_t                extra_cap_flags;
         uct_mm_iface_overhead_t overhead;
+        ucs_ternary_auto_value_t hugetlb_mode;
     } config;
 } uct_mm_iface_t;
 
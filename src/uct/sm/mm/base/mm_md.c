@@ -12,6 +12,7 @@
 #include "mm_md.h"
 
 #include <ucs/debug/log.h>
+#include <ucs/sys/sys.h>
 #include <inttypes.h>
 #include <limits.h>
 
@@ -63,6 +64,7 @@ ucs_status_t uct_mm_seg_new(void *address, size_t length, uct_mm_seg_t **seg_p)
     seg->address = address;
     seg->length  = length;
     seg->seg_id  = 0;
+    seg->uuid    = ucs_generate_uuid((uintptr_t)seg);
     *seg_p       = seg;
     return UCS_OK;
 }
@@ -114,10 +116,19 @@ ucs_status_t uct_mm_md_open(uct_component_t *component, const char *md_name,
     md->super.component = &mmc->super;
     md->iface_addr_len  = mmc->md_ops->iface_addr_length(md);
 
+    if (mmc->md_ops->md_init != NULL) {
+        status = mmc->md_ops->md_init(md);
+        if (status != UCS_OK) {
+            goto err_release_opts;
+        }
+    }
+
     /* cppcheck-suppress autoVariables */
     *md_p = &md->super;
     return UCS_OK;
 
+err_release_opts:
+    ucs_config_parser_release_opts(md->config, mmc->super.md_config.table);
 err_free_mm_md_config:
     ucs_free(md->config);
 err_free_mm_md:
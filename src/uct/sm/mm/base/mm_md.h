@@ -29,6 +29,9 @@ typedef struct uct_mm_seg {
     uct_mm_seg_id_t       seg_id;     /* Shared memory ID */
     void                  *address;   /* Virtual address */
     size_t                length;     /* Size of the memory */
+    uint64_t              uuid;       /* Unique identifier, to detect a
+                                         segment which was re-created with the
+                                         same ID */
 } uct_mm_seg_t;
 
 
@@ -112,6 +115,27 @@ typedef void
                                    const uct_mm_remote_seg_t *rseg);
 
 
+/* Open a shared memory segment identified by 'key', which other processes
+ * on the node can open by the same key, or create it with zero size if it does
+ * not exist. Returns the seg_id which may be attached by mem_attach(), and a
+ * file descriptor of the segment, which the caller sizes, maps and closes.
+ */
+typedef ucs_status_t
+(*uct_mm_mapper_shared_seg_open_func_t)(uct_mm_md_t *md, uint32_t key,
+                                        uct_mm_seg_id_t *seg_id_p, int *fd_p);
+
+
+/* Remove a segment opened by shared_seg_open() from the system. Processes
+ * which already opened it may keep using it. */
+typedef void
+(*uct_mm_mapper_shared_seg_unlink_func_t)(uct_mm_md_t *md,
+                                          uct_mm_seg_id_t seg_id);
+
+
+/* Initialize mapper-specific state when a memory domain is opened */
+typedef ucs_status_t (*uct_mm_mapper_md_init_func_t)(uct_mm_md_t *md);
+
+
 /*
  * Memory mapper operations - used to implement MD and TL functionality
  */
@@ -123,6 +147,11 @@ typedef struct uct_mm_mapper_ops {
     uct_mm_mapper_mem_attach_func_t        mem_attach;
     uct_mm_mapper_mem_detach_func_t        mem_detach;
     uct_mm_mapper_is_reachable_func_t      is_reachable;
+    /* optional, NULL if the mapper does not support named segments */
+    uct_mm_mapper_shared_seg_open_func_t   shared_seg_open;
+    uct_mm_mapper_shared_seg_unlink_func_t shared_seg_unlink;
+    /* optional, NULL if the mapper has no state to initialize */
+    uct_mm_mapper_md_init_func_t           md_init;
 } uct_mm_md_mapper_ops_t;
 
 
@@ -0,0 +1,502 @@
+/**
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "mm_rx_pool.h"
+
+#include <ucs/algorithm/crc.h>
+#include <ucs/arch/atomic.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/ptr_arith.h>
+#include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+#define UCT_MM_RX_POOL_MAGIC         0x3150527852786375ul /* "ucxRxRP1" */
+#define UCT_MM_RX_POOL_SLAB_NULL     UINT32_MAX /* end of the free list */
+#define UCT_MM_RX_POOL_MAX_USERS     1024
+#define UCT_MM_RX_POOL_OPEN_RETRIES  16
+#define UCT_MM_RX_POOL_LOCK_TIMEOUT  1.0        /* seconds */
+
+/*
+ * Bytes of the pool file locked by open file description locks, which the
+ * kernel releases when the holder exits or crashes, regardless of pid reuse
+ * and pid namespaces:
+ * - INIT is held exclusively while a process opens or closes the pool.
+ * - USER + i is held exclusively by the user of slot i while the pool is
+ *   open by it.
+ */
+#define UCT_MM_RX_POOL_LOCK_INIT     0
+#define UCT_MM_RX_POOL_LOCK_USER     1
+
+/* Slab owner is the user slot + 1 in the lower 16 bits, and the slot
+ * generation in the upper 16 bits, 0 if the slab is free */
+#define UCT_MM_RX_POOL_OWNER(_slot, _gen) \
+    ((((uint32_t)(_gen) & UCS_MASK(16)) << 16) | ((_slot) + 1))
+#define UCT_MM_RX_POOL_OWNER_SLOT(_owner) \
+    (((_owner) & UCS_MASK(16)) - 1)
+#define UCT_MM_RX_POOL_OWNER_GEN(_owner) \
+    ((_owner) >> 16)
+
+
+/* Slab entry in the shared control area */
+typedef struct {
+    volatile uint32_t next;       /* Next free slab, valid if the slab is free */
+    volatile uint32_t owner;      /* Owner, see UCT_MM_RX_POOL_OWNER */
+} uct_mm_rx_pool_slab_t;
+
+
+/* Processes share a pool only if all these are the same */
+typedef struct {
+    uint64_t              boot_id[2]; /* System boot id */
+    uint64_t              size;       /* Total pool size */
+    uint64_t              slab_size;  /* Size of a single slab */
+    uint32_t              uid;        /* User id */
+    ucs_sys_ns_t          pid_ns;     /* PID namespace */
+} uct_mm_rx_pool_id_t;
+
+
+struct uct_mm_rx_pool_ctl {
+    volatile uint64_t     magic;      /* Set after init */
+    uct_mm_rx_pool_id_t   id;         /* Identity of the pool */
+    uint32_t              num_slabs;  /* Number of slabs */
+    volatile uint64_t     free_head;  /* Index of the first free slab in the
+                                         lower 32 bits, and a counter in the
+                                         upper 32 bits to prevent ABA */
+    /* Generation of every user slot, incremented when a new user takes it */
+    volatile uint32_t     user_gen[UCT_MM_RX_POOL_MAX_USERS];
+    uct_mm_rx_pool_slab_t slab[0];
+};
+
+
+/* Number of pool slabs held by this process, for all pool handles */
+static volatile uint32_t uct_mm_rx_pool_proc_slabs = 0;
+
+
+static void uct_mm_rx_pool_push(uct_mm_rx_pool_ctl_t *ctl, uint32_t index)
+{
+    uint64_t head, new_head;
+
+    do {
+        head                  = ctl->free_head;
+        ctl->slab[index].next = (uint32_t)head;
+        new_head              = (((head >> 32) + 1) << 32) | index;
+        ucs_memory_cpu_store_fence();
+    } while (!ucs_atomic_bool_cswap64(&ctl->free_head, head, new_head));
+}
+
+static uint32_t uct_mm_rx_pool_pop(uct_mm_rx_pool_ctl_t *ctl)
+{
+    uint64_t head, new_head;
+    uint32_t index;
+
+    do {
+        head  = ctl->free_head;
+        index = (uint32_t)head;
+        if (index == UCT_MM_RX_POOL_SLAB_NULL) {
+            return UCT_MM_RX_POOL_SLAB_NULL;
+        }
+
+        new_head = (((head >> 32) + 1) << 32) | ctl->slab[index].next;
+    } while (!ucs_atomic_bool_cswap64(&ctl->free_head, head, new_head));
+
+    return index;
+}
+
+#ifdef F_OFD_SETLK
+static size_t uct_mm_rx_pool_ctl_size(unsigned num_slabs)
+{
+    return ucs_align_up(sizeof(uct_mm_rx_pool_ctl_t) +
+                        (num_slabs * sizeof(uct_mm_rx_pool_slab_t)),
+                        ucs_get_page_size());
+}
+
+static int uct_mm_rx_pool_fcntl_lock(int fd, int cmd, struct flock *fl,
+                                     short type, off_t start, off_t len)
+{
+    memset(fl, 0, sizeof(*fl));
+    fl->l_type   = type;
+    fl->l_whence = SEEK_SET;
+    fl->l_start  = start;
+    fl->l_len    = len;
+    return fcntl(fd, cmd, fl);
+}
+
+static ucs_status_t uct_mm_rx_pool_init_lock(uct_mm_rx_pool_t *pool)
+{
+    ucs_time_t deadline = ucs_get_time() +
+                          ucs_time_from_sec(UCT_MM_RX_POOL_LOCK_TIMEOUT);
+    struct flock fl;
+
+    /* do not block forever on a stopped process */
+    while (uct_mm_rx_pool_fcntl_lock(pool->fd, F_OFD_SETLK, &fl, F_WRLCK,
+                                     UCT_MM_RX_POOL_LOCK_INIT, 1) != 0) {
+        if ((errno != EAGAIN) && (errno != EACCES)) {
+            ucs_debug("mm_rx_pool %p: failed to lock: %m", pool);
+            return UCS_ERR_IO_ERROR;
+        }
+
+        if (ucs_get_time() > deadline) {
+            ucs_debug("mm_rx_pool %p: timed out waiting for the pool lock",
+                      pool);
+            return UCS_ERR_TIMED_OUT;
+        }
+
+        sched_yield();
+    }
+
+    return UCS_OK;
+}
+
+static void uct_mm_rx_pool_init_unlock(uct_mm_rx_pool_t *pool)
+{
+    struct flock fl;
+
+    uct_mm_rx_pool_fcntl_lock(pool->fd, F_OFD_SETLK, &fl, F_UNLCK,
+                              UCT_MM_RX_POOL_LOCK_INIT, 1);
+}
+
+/* Check if another handle holds a lock on the given range. Locks of this
+ * handle are not reported. */
+static int uct_mm_rx_pool_is_locked(uct_mm_rx_pool_t *pool, off_t start,
+                                    off_t len)
+{
+    struct flock fl;
+
+    if (uct_mm_rx_pool_fcntl_lock(pool->fd, F_OFD_GETLK, &fl, F_WRLCK, start,
+                                  len) != 0) {
+        /* assume it is in use */
+        return 1;
+    }
+
+    return fl.l_type != F_UNLCK;
+}
+
+/* Return the slabs of users which closed the pool without releasing them,
+ * because they exited or crashed */
+static unsigned uct_mm_rx_pool_reclaim(uct_mm_rx_pool_t *pool)
+{
+    uct_mm_rx_pool_ctl_t *ctl = pool->ctl;
+    unsigned count            = 0;
+    uint32_t index, owner, slot;
+
+    for (index = 0; index < pool->num_slabs; ++index) {
+        owner = ctl->slab[index].owner;
+        if ((owner == 0) || (owner == pool->owner)) {
+            continue;
+        }
+
+        /* The owner is alive if it still holds its slot, and the slot was not
+         * taken over by a new user. If a new user takes the slot after the
+         * check, it changes the generation, so the swap below fails for its
+         * slabs. */
+        slot = UCT_MM_RX_POOL_OWNER_SLOT(owner);
+        if ((slot < UCT_MM_RX_POOL_MAX_USERS) && (slot != pool->slot) &&
+            (UCT_MM_RX_POOL_OWNER_GEN(owner) ==
+             (ctl->user_gen[slot] & UCS_MASK(16))) &&
+            uct_mm_rx_pool_is_locked(pool, UCT_MM_RX_POOL_LOCK_USER + slot,
+                                     1)) {
+            continue;
+        }
+
+        if (ucs_atomic_bool_cswap32(&ctl->slab[index].owner, owner, 0)) {
+            ucs_debug("mm_rx_pool %p: reclaimed slab %u of closed user %u",
+                      pool, index, slot);
+            uct_mm_rx_pool_push(ctl, index);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/* Take a free user slot, must be called with the init lock held */
+static ucs_status_t uct_mm_rx_pool_user_add(uct_mm_rx_pool_t *pool)
+{
+    uct_mm_rx_pool_ctl_t *ctl = pool->ctl;
+    struct flock fl;
+    uint32_t gen;
+    unsigned slot;
+
+    for (slot = 0; slot < UCT_MM_RX_POOL_MAX_USERS; ++slot) {
+        if (uct_mm_rx_pool_fcntl_lock(pool->fd, F_OFD_SETLK, &fl, F_WRLCK,
+                                      UCT_MM_RX_POOL_LOCK_USER + slot,
+                                      1) == 0) {
+            gen         = ucs_atomic_fadd32(&ctl->user_gen[slot], 1) + 1;
+            pool->slot  = slot;
+            pool->owner = UCT_MM_RX_POOL_OWNER(slot, gen);
+            return UCS_OK;
+        }
+    }
+
+    ucs_debug("mm_rx_pool %p: all %d user slots are taken", pool,
+              UCT_MM_RX_POOL_MAX_USERS);
+    return UCS_ERR_EXCEEDS_LIMIT;
+}
+
+static void uct_mm_rx_pool_ctl_init(uct_mm_rx_pool_t *pool,
+                                    const uct_mm_rx_pool_id_t *id)
+{
+    uct_mm_rx_pool_ctl_t *ctl = pool->ctl;
+    uint32_t index;
+
+    ctl->id        = *id;
+    ctl->num_slabs = pool->num_slabs;
+    ctl->free_head = UCT_MM_RX_POOL_SLAB_NULL;
+    memset((void*)ctl->user_gen, 0, sizeof(ctl->user_gen));
+
+    for (index = pool->num_slabs; index > 0; --index) {
+        ctl->slab[index - 1].owner = 0;
+        uct_mm_rx_pool_push(ctl, index - 1);
+    }
+
+    ucs_memory_cpu_store_fence();
+    ctl->magic = UCT_MM_RX_POOL_MAGIC;
+}
+
+/*
+ * Map the pool and register as its user. The pool is initialized if it is
+ * new, or if the process which created it exited before completing the
+ * initialization. The init lock makes sure no other process initializes or
+ * removes the pool meanwhile.
+ */
+static ucs_status_t
+uct_mm_rx_pool_attach(uct_mm_rx_pool_t *pool, const uct_mm_rx_pool_id_t *id,
+                      uct_mm_seg_id_t seg_id)
+{
+    size_t size = id->size;
+    ucs_status_t status;
+    struct stat st;
+    void *address;
+    int init;
+
+    status = uct_mm_rx_pool_init_lock(pool);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (fstat(pool->fd, &st) != 0) {
+        ucs_debug("mm_rx_pool %p: fstat(fd=%d) failed: %m", pool, pool->fd);
+        status = UCS_ERR_IO_ERROR;
+        goto out_unlock;
+    }
+
+    if (st.st_nlink == 0) {
+        /* the last user removed the pool after we opened it */
+        status = UCS_ERR_BUSY;
+        goto out_unlock;
+    }
+
+    if (st.st_size == 0) {
+        if (ftruncate(pool->fd, size) != 0) {
+            ucs_debug("mm_rx_pool %p: ftruncate(fd=%d, length=%zu) failed: %m",
+                      pool, pool->fd, size);
+            status = UCS_ERR_SHMEM_SEGMENT;
+            goto out_unlock;
+        }
+    } else if (st.st_size != size) {
+        ucs_debug("mm_rx_pool %p: existing pool size is %zu, expected %zu",
+                  pool, (size_t)st.st_size, size);
+        status = UCS_ERR_INVALID_PARAM;
+        goto out_unlock;
+    }
+
+    address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, pool->fd,
+                   0);
+    if (address == MAP_FAILED) {
+        ucs_debug("mm_rx_pool %p: mmap(size=%zu) failed: %m", pool, size);
+        status = UCS_ERR_SHMEM_SEGMENT;
+        goto out_unlock;
+    }
+
+    pool->ctl   = address;
+    pool->slabs = UCS_PTR_BYTE_OFFSET(address,
+                                      uct_mm_rx_pool_ctl_size(pool->num_slabs));
+
+    init = (pool->ctl->magic != UCT_MM_RX_POOL_MAGIC);
+    if (init) {
+        uct_mm_rx_pool_ctl_init(pool, id);
+    } else if (memcmp(&pool->ctl->id, id, sizeof(*id)) ||
+               (pool->ctl->num_slabs != pool->num_slabs)) {
+        ucs_debug("mm_rx_pool %p: existing pool belongs to other processes",
+                  pool);
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_unmap;
+    }
+
+    status = uct_mm_rx_pool_user_add(pool);
+    if (status != UCS_OK) {
+        goto err_unmap;
+    }
+
+    status = uct_mm_seg_new(address, size, &pool->seg);
+    if (status != UCS_OK) {
+        /* the user lock is released when the file is closed */
+        goto err_unmap;
+    }
+
+    pool->seg->seg_id = seg_id;
+    ucs_debug("mm_rx_pool %p: %s pool at %p with %u slabs of %zu bytes, "
+              "user slot %u", pool, init ? "initialized" : "joined", address,
+              pool->num_slabs, pool->slab_size, pool->slot);
+    goto out_unlock;
+
+err_unmap:
+    munmap(address, size);
+out_unlock:
+    uct_mm_rx_pool_init_unlock(pool);
+    return status;
+}
+
+static void uct_mm_rx_pool_id_init(uct_mm_rx_pool_id_t *id, size_t size,
+                                   size_t slab_size)
+{
+    memset(id, 0, sizeof(*id));
+    if (ucs_sys_get_boot_id(&id->boot_id[0], &id->boot_id[1]) != UCS_OK) {
+        ucs_debug("failed to read boot id, sharing receive pool across boots");
+    }
+
+    id->size      = size;
+    id->slab_size = slab_size;
+    id->uid       = getuid();
+    id->pid_ns    = ucs_sys_get_ns(UCS_SYS_NS_TYPE_PID);
+}
+#endif
+
+
+ucs_status_t uct_mm_rx_pool_open(uct_mm_md_t *md, size_t size,
+                                 size_t slab_size, size_t quota,
+                                 uct_mm_rx_pool_t *pool)
+{
+#ifdef F_OFD_SETLK
+    uct_mm_md_mapper_ops_t *ops = uct_mm_md_mapper_ops(md);
+    uct_mm_rx_pool_id_t id;
+    uct_mm_seg_id_t seg_id;
+    ucs_status_t status;
+    size_t ctl_size;
+    unsigned retry;
+
+    if (ops->shared_seg_open == NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    pool->md        = md;
+    pool->slab_size = ucs_align_up_pow2(slab_size, ucs_get_page_size());
+    pool->max_slabs = quota / pool->slab_size;
+    ctl_size        = uct_mm_rx_pool_ctl_size(size / pool->slab_size);
+    if ((size < (ctl_size + pool->slab_size)) || (pool->max_slabs == 0)) {
+        ucs_debug("mm_rx_pool: size %zu or quota %zu is too small for slabs "
+                  "of %zu bytes", size, quota, pool->slab_size);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    pool->num_slabs = (size - ctl_size) / pool->slab_size;
+
+    /* the pool is shared by the processes of the user in the same PID
+     * namespace, with the same pool configuration */
+    uct_mm_rx_pool_id_init(&id, size, pool->slab_size);
+
+    for (retry = 0; retry < UCT_MM_RX_POOL_OPEN_RETRIES; ++retry) {
+        status = ops->shared_seg_open(md, ucs_crc32(0, &id, sizeof(id)),
+                                      &seg_id, &pool->fd);
+        if (status != UCS_OK) {
+            return status;
+        }
+
+        status = uct_mm_rx_pool_attach(pool, &id, seg_id);
+        if (status == UCS_OK) {
+            return UCS_OK;
+        }
+
+        close(pool->fd);
+        if (status != UCS_ERR_BUSY) {
+            return status;
+        }
+
+        /* the last user removed the pool, create a new one */
+    }
+
+    return UCS_ERR_BUSY;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
+void uct_mm_rx_pool_close(uct_mm_rx_pool_t *pool)
+{
+#ifdef F_OFD_SETLK
+    uct_mm_md_mapper_ops_t *ops = uct_mm_md_mapper_ops(pool->md);
+    ucs_status_t status;
+
+    /* remove the pool if there are no other users; hold the init lock so no
+     * process would join it meanwhile */
+    status = uct_mm_rx_pool_init_lock(pool);
+    if ((status == UCS_OK) &&
+        !uct_mm_rx_pool_is_locked(pool, UCT_MM_RX_POOL_LOCK_USER,
+                                  UCT_MM_RX_POOL_MAX_USERS)) {
+        ucs_debug("mm_rx_pool %p: removing the pool", pool);
+        ops->shared_seg_unlink(pool->md, pool->seg->seg_id);
+    }
+
+    munmap(pool->ctl, pool->seg->length);
+    ucs_free(pool->seg);
+
+    /* releases the locks */
+    close(pool->fd);
+#endif
+}
+
+void *uct_mm_rx_pool_slab_get(uct_mm_rx_pool_t *pool)
+{
+    uint32_t index;
+
+    if (ucs_atomic_fadd32(&uct_mm_rx_pool_proc_slabs, 1) >= pool->max_slabs) {
+        goto err;
+    }
+
+    index = uct_mm_rx_pool_pop(pool->ctl);
+#ifdef F_OFD_SETLK
+    if ((index == UCT_MM_RX_POOL_SLAB_NULL) &&
+        (uct_mm_rx_pool_reclaim(pool) > 0)) {
+        index = uct_mm_rx_pool_pop(pool->ctl);
+    }
+#endif
+
+    if (index == UCT_MM_RX_POOL_SLAB_NULL) {
+        goto err;
+    }
+
+    ucs_assert(pool->ctl->slab[index].owner == 0);
+    pool->ctl->slab[index].owner = pool->owner;
+    return UCS_PTR_BYTE_OFFSET(pool->slabs, index * pool->slab_size);
+
+err:
+    ucs_atomic_sub32(&uct_mm_rx_pool_proc_slabs, 1);
+    return NULL;
+}
+
+void uct_mm_rx_pool_slab_put(uct_mm_rx_pool_t *pool, void *slab)
+{
+    uint32_t index = UCS_PTR_BYTE_DIFF(pool->slabs, slab) / pool->slab_size;
+
+    ucs_assert(index < pool->num_slabs);
+    ucs_assert(pool->ctl->slab[index].owner == pool->owner);
+
+    pool->ctl->slab[index].owner = 0;
+    uct_mm_rx_pool_push(pool->ctl, index);
+    ucs_atomic_sub32(&uct_mm_rx_pool_proc_slabs, 1);
+}
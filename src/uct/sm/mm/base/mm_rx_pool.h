@@ -0,0 +1,87 @@
+/**
+* Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+*
+* See file LICENSE for terms.
+*/
+
+#ifndef UCT_MM_RX_POOL_H
+#define UCT_MM_RX_POOL_H
+
+#include "mm_md.h"
+
+
+/* Control area at the beginning of the shared receive pool */
+typedef struct uct_mm_rx_pool_ctl uct_mm_rx_pool_ctl_t;
+
+
+/**
+ * Node-level receive memory pool, shared by the processes on the node.
+ *
+ * The pool is a single shared memory segment, created by the first process
+ * which opens it and attached by the others. It is divided to fixed-size
+ * slabs which are handed out to processes by a lock-free free list, and each
+ * process may hold a limited number of slabs at a time. Since all slabs are
+ * in the same segment, a sender attaches it only once for all receivers on
+ * the node which use the pool.
+ *
+ * Every open handle holds a file lock on its user slot, so the slabs and the
+ * pool itself are released even if the process is killed.
+ */
+typedef struct uct_mm_rx_pool {
+    uct_mm_md_t          *md;         /* Memory domain of the pool segment */
+    uct_mm_seg_t         *seg;        /* Pool shared memory segment */
+    uct_mm_rx_pool_ctl_t *ctl;        /* Shared control area */
+    void                 *slabs;      /* Address of the first slab */
+    size_t               slab_size;   /* Size of a single slab */
+    unsigned             num_slabs;   /* Total number of slabs in the pool */
+    unsigned             max_slabs;   /* Maximal number of slabs this process
+                                         may hold */
+    int                  fd;          /* Pool file, holds the user slot lock */
+    unsigned             slot;        /* User slot of this handle */
+    uint32_t             owner;       /* Owner value of slabs held by this
+                                         handle */
+} uct_mm_rx_pool_t;
+
+
+/**
+ * Open the receive pool of the node, and create it if it does not exist.
+ * The pool is shared by processes of the same user, in the same PID namespace
+ * and boot, with the same pool size and slab size.
+ *
+ * @param [in]  md         Memory domain to allocate the pool segment with.
+ *                         It must support shared_seg_open.
+ * @param [in]  size       Total pool size.
+ * @param [in]  slab_size  Size of a single slab.
+ * @param [in]  quota      Maximal amount of pool memory the process may hold.
+ * @param [out] pool       Filled with the pool handle.
+ *
+ * @return UCS_OK, or an error if the pool cannot be used, in which case the
+ *         caller should fall back to private memory.
+ */
+ucs_status_t uct_mm_rx_pool_open(uct_mm_md_t *md, size_t size,
+                                 size_t slab_size, size_t quota,
+                                 uct_mm_rx_pool_t *pool);
+
+
+/**
+ * Close a pool handle opened by @ref uct_mm_rx_pool_open. All slabs must be
+ * returned before. The last user to close the pool removes it.
+ */
+void uct_mm_rx_pool_close(uct_mm_rx_pool_t *pool);
+
+
+/**
+ * Take a slab from the pool.
+ *
+ * @return Slab address, or NULL if the pool is exhausted or the process
+ *         quota is reached.
+ */
+void *uct_mm_rx_pool_slab_get(uct_mm_rx_pool_t *pool);
+
+
+/**
+ * Return a slab obtained by @ref uct_mm_rx_pool_slab_get to the pool.
+ */
+void uct_mm_rx_pool_slab_put(uct_mm_rx_pool_t *pool, void *slab);
+
+#endif
@@ -11,14 +11,19 @@
 
 #include <uct/sm/mm/base/mm_md.h>
 #include <uct/sm/mm/base/mm_iface.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/lru.h>
 #include <ucs/debug/memtrack_int.h>
 #include <ucs/debug/log.h>
 #include <ucs/sys/ptr_arith.h>
 #include <ucs/sys/string.h>
 #include <ucs/profile/profile.h>
 #include <ucs/sys/sys.h>
+#include <ucs/time/time.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <sched.h>
 #include <uct/api/v2/uct_v2.h>
 
 
@@ -41,6 +46,9 @@
                                          UCT_POSIX_SEG_FLAG_HUGETLB)
 #define UCT_POSIX_SEG_MMID_MASK         (~UCT_POSIX_SEG_FLAGS_MASK)
 
+/* mmid of segments opened by a well-known key, random mmids are 32-bit */
+#define UCT_POSIX_SHARED_MMID_FLAG      UCS_BIT(40)
+
 /* Packing mmid for procfs mode */
 #define UCT_POSIX_PROCFS_MMID_FD_BITS   30  /* how many bits for file descriptor */
 #define UCT_POSIX_PROCFS_MMID_PID_BITS  30  /* how many bits for pid */
@@ -56,6 +64,7 @@ typedef struct uct_posix_md_config {
     char               *dir;
     int                use_proc_link;
     size_t             shm_min_size;
+    unsigned           attach_cache_size;
 } uct_posix_md_config_t;
 
 typedef struct uct_posix_packed_rkey {
@@ -65,6 +74,44 @@ typedef struct uct_posix_packed_rkey {
 } UCS_S_PACKED uct_posix_packed_rkey_t;
 
 
+/* Mapping of a remote segment, shared by all endpoints, interfaces and remote
+ * keys of the process which attach to the same segment */
+typedef struct uct_posix_attach {
+    uct_mm_seg_id_t           seg_id;
+    void                      *address;
+    size_t                    length;
+    dev_t                     st_dev;     /* Identify the backing file, to */
+    ino_t                     st_ino;     /* detect a re-created segment */
+    unsigned                  refcount;
+    int                       hashed;     /* Whether found by lookup */
+} uct_posix_attach_t;
+
+
+KHASH_MAP_INIT_INT64(uct_posix_attach, uct_posix_attach_t*);
+
+
+/*
+ * Process-wide cache of remote segment mappings. Mappings which are no longer
+ * used are kept in an LRU list, up to a limit taken as the minimum across all
+ * open memory domains. The idle mappings are released when the last memory
+ * domain is closed.
+ */
+static struct {
+    pthread_mutex_t           lock;
+    khash_t(uct_posix_attach) hash;
+    ucs_lru_h                 idle;       /* Unused mappings */
+    unsigned                  num_idle;
+    unsigned                  max_idle;
+    unsigned                  num_mds;
+} uct_posix_attach_cache = {
+    .lock     = PTHREAD_MUTEX_INITIALIZER,
+    .idle     = NULL,
+    .num_idle = 0,
+    .max_idle = 0,
+    .num_mds  = 0
+};
+
+
 static ucs_config_field_t uct_posix_md_config_table[] = {
     {"MM_", "", NULL, ucs_offsetof(uct_posix_md_config_t, super),
      UCS_CONFIG_TYPE_TABLE(uct_mm_md_config_table)},
@@ -88,6 +135,16 @@ static ucs_config_field_t uct_posix_md_config_table[] = {
      " n   - Use original file path to share posix file.\n",
      ucs_offsetof(uct_posix_md_config_t, use_proc_link), UCS_CONFIG_TYPE_BOOL},
 
+    {"ATTACH_CACHE_SIZE", "0",
+     "Maximal number of idle remote segment mappings to keep in the process,\n"
+     "to be reused by later attachments to the same segment. The limit applies\n"
+     "only to idle mappings: mappings in use are not counted and never evicted,\n"
+     "and are shared by all interfaces, endpoints and remote keys of the\n"
+     "process. A cached idle mapping keeps the remote segment memory allocated\n"
+     "until it is evicted.",
+     ucs_offsetof(uct_posix_md_config_t, attach_cache_size),
+     UCS_CONFIG_TYPE_UINT},
+
     {NULL}
 };
 
@@ -429,29 +486,166 @@ uct_posix_mem_open(uct_mm_seg_id_t seg_id, const char *dir, int *fd_p,
     return status;
 }
 
+static void uct_posix_attach_unhash_nolock(uct_posix_attach_t *attach)
+{
+    khiter_t iter;
+
+    if (!attach->hashed) {
+        return;
+    }
+
+    iter = kh_get(uct_posix_attach, &uct_posix_attach_cache.hash,
+                  attach->seg_id);
+    ucs_assert(iter != kh_end(&uct_posix_attach_cache.hash));
+    kh_del(uct_posix_attach, &uct_posix_attach_cache.hash, iter);
+    attach->hashed = 0;
+}
+
+static ucs_status_t uct_posix_attach_destroy_nolock(uct_posix_attach_t *attach)
+{
+    ucs_status_t status;
+
+    ucs_assert(attach->refcount == 0);
+    uct_posix_attach_unhash_nolock(attach);
+    status = uct_posix_munmap(attach->address, attach->length);
+    ucs_free(attach);
+    return status;
+}
+
+static void uct_posix_attach_idle_remove_nolock(uct_posix_attach_t *attach)
+{
+    if ((uct_posix_attach_cache.idle != NULL) &&
+        ucs_lru_remove(uct_posix_attach_cache.idle, attach)) {
+        --uct_posix_attach_cache.num_idle;
+    }
+}
+
+static void uct_posix_attach_evict_nolock(unsigned max_idle)
+{
+    ucs_lru_element_t *elem;
+
+    while (uct_posix_attach_cache.num_idle > max_idle) {
+        elem = ucs_lru_pop(uct_posix_attach_cache.idle);
+        uct_posix_attach_destroy_nolock(elem->key);
+        ucs_free(elem);
+        --uct_posix_attach_cache.num_idle;
+    }
+}
+
+/* Returns 0 if the segment should be unmapped */
+static int uct_posix_attach_keep_idle_nolock(uct_posix_attach_t *attach)
+{
+    ucs_status_t status;
+
+    if (!attach->hashed || (uct_posix_attach_cache.num_mds == 0) ||
+        (uct_posix_attach_cache.max_idle == 0)) {
+        return 0;
+    }
+
+    if (uct_posix_attach_cache.idle == NULL) {
+        status = ucs_lru_create(uct_posix_attach_cache.max_idle,
+                                &uct_posix_attach_cache.idle);
+        if (status != UCS_OK) {
+            return 0;
+        }
+    }
+
+    uct_posix_attach_evict_nolock(uct_posix_attach_cache.max_idle - 1);
+    ucs_lru_push(uct_posix_attach_cache.idle, attach);
+    ++uct_posix_attach_cache.num_idle;
+    return 1;
+}
+
 static ucs_status_t
 uct_posix_mem_attach_common(uct_mm_seg_id_t seg_id, size_t length,
                             const char *dir, uct_mm_remote_seg_t *rseg)
 {
+    uct_posix_attach_t *attach;
+    struct stat file_stat;
     ucs_status_t status;
     int mmap_flags, fd;
+    khiter_t iter;
+    int ret;
 
     ucs_assert(length > 0);
-    rseg->cookie = (void*)length;
 
     status = uct_posix_mem_open(seg_id, dir, &fd, UCS_LOG_LEVEL_ERROR);
     if (status != UCS_OK) {
         return status;
     }
 
+    if (fstat(fd, &file_stat) != 0) {
+        ucs_error("fstat(fd=%d) failed: %m", fd);
+        status = UCS_ERR_SHMEM_SEGMENT;
+        goto out_close;
+    }
+
+    pthread_mutex_lock(&uct_posix_attach_cache.lock);
+
+    iter = kh_get(uct_posix_attach, &uct_posix_attach_cache.hash, seg_id);
+    if (iter != kh_end(&uct_posix_attach_cache.hash)) {
+        attach = kh_val(&uct_posix_attach_cache.hash, iter);
+        if ((attach->st_dev == file_stat.st_dev) &&
+            (attach->st_ino == file_stat.st_ino) &&
+            (attach->length == length)) {
+            if (attach->refcount++ == 0) {
+                uct_posix_attach_idle_remove_nolock(attach);
+            }
+            goto out_attached;
+        }
+
+        /* The segment was destroyed and re-created with the same id; current
+         * users of the old mapping keep it until they detach */
+        uct_posix_attach_unhash_nolock(attach);
+        if (attach->refcount == 0) {
+            uct_posix_attach_idle_remove_nolock(attach);
+            uct_posix_attach_destroy_nolock(attach);
+        }
+    }
+
+    attach = ucs_malloc(sizeof(*attach), "posix_attach");
+    if (attach == NULL) {
+        ucs_error("failed to allocate posix attach descriptor");
+        status = UCS_ERR_NO_MEMORY;
+        goto out_unlock;
+    }
+
 #ifdef MAP_HUGETLB
     mmap_flags = (seg_id & UCT_POSIX_SEG_FLAG_HUGETLB) ? MAP_HUGETLB : 0;
 #else
     mmap_flags = 0;
 #endif
-    rseg->address = NULL;
-    status = uct_posix_mmap(&rseg->address, &length, mmap_flags, fd,
+    attach->address = NULL;
+    attach->length  = length;
+    status = uct_posix_mmap(&attach->address, &attach->length, mmap_flags, fd,
                             "posix_attach", UCS_LOG_LEVEL_ERROR);
+    if (status != UCS_OK) {
+        ucs_free(attach);
+        goto out_unlock;
+    }
+
+    attach->seg_id   = seg_id;
+    attach->length   = length;
+    attach->st_dev   = file_stat.st_dev;
+    attach->st_ino   = file_stat.st_ino;
+    attach->refcount = 1;
+
+    iter = kh_put(uct_posix_attach, &uct_posix_attach_cache.hash, seg_id,
+                  &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        /* Still usable, just not shared */
+        attach->hashed = 0;
+    } else {
+        kh_val(&uct_posix_attach_cache.hash, iter) = attach;
+        attach->hashed = 1;
+    }
+
+out_attached:
+    rseg->address = attach->address;
+    rseg->cookie  = attach;
+out_unlock:
+    pthread_mutex_unlock(&uct_posix_attach_cache.lock);
+out_close:
     close(fd);
     return status;
 }
@@ -484,7 +678,18 @@ uct_posix_is_reachable(uct_mm_md_t *md, uct_mm_seg_id_t seg_id,
 
 static ucs_status_t uct_posix_mem_detach_common(const uct_mm_remote_seg_t *rseg)
 {
-    return uct_posix_munmap(rseg->address, (size_t)rseg->cookie);
+    uct_posix_attach_t *attach = rseg->cookie;
+    ucs_status_t status        = UCS_OK;
+
+    pthread_mutex_lock(&uct_posix_attach_cache.lock);
+    ucs_assert(attach->refcount > 0);
+    if ((--attach->refcount == 0) &&
+        !uct_posix_attach_keep_idle_nolock(attach)) {
+        status = uct_posix_attach_destroy_nolock(attach);
+    }
+    pthread_mutex_unlock(&uct_posix_attach_cache.lock);
+
+    return status;
 }
 
 static ucs_status_t
@@ -724,6 +929,60 @@ static void uct_posix_mem_detach(uct_mm_md_t *md, const uct_mm_remote_seg_t *rse
     uct_posix_mem_detach_common(rseg);
 }
 
+static ucs_status_t uct_posix_md_init(uct_mm_md_t *md)
+{
+    const uct_posix_md_config_t *posix_config =
+                    ucs_derived_of(md->config, uct_posix_md_config_t);
+
+    pthread_mutex_lock(&uct_posix_attach_cache.lock);
+    if (uct_posix_attach_cache.num_mds++ == 0) {
+        uct_posix_attach_cache.max_idle = posix_config->attach_cache_size;
+    } else {
+        uct_posix_attach_cache.max_idle = ucs_min(
+                uct_posix_attach_cache.max_idle,
+                posix_config->attach_cache_size);
+    }
+
+    uct_posix_attach_evict_nolock(uct_posix_attach_cache.max_idle);
+    pthread_mutex_unlock(&uct_posix_attach_cache.lock);
+    return UCS_OK;
+}
+
+static void uct_posix_md_close(uct_md_h md)
+{
+    pthread_mutex_lock(&uct_posix_attach_cache.lock);
+    ucs_assert(uct_posix_attach_cache.num_mds > 0);
+    if (--uct_posix_attach_cache.num_mds == 0) {
+        uct_posix_attach_evict_nolock(0);
+    }
+    pthread_mutex_unlock(&uct_posix_attach_cache.lock);
+
+    uct_mm_md_close(md);
+}
+
+static ucs_status_t
+uct_posix_shared_seg_open(uct_mm_md_t *md, uint32_t key,
+                          uct_mm_seg_id_t *seg_id_p, int *fd_p)
+{
+    uint64_t mmid = UCT_POSIX_SHARED_MMID_FLAG | key;
+    ucs_status_t status;
+
+    status = uct_posix_shm_open(mmid, O_CREAT, fd_p, UCS_LOG_LEVEL_DEBUG);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucs_debug("opened posix shared segment 0x%"PRIx64" fd %d", mmid, *fd_p);
+    *seg_id_p = mmid | UCT_POSIX_SEG_FLAG_SHM_OPEN;
+    return UCS_OK;
+}
+
+static void
+uct_posix_shared_seg_unlink(uct_mm_md_t *md, uct_mm_seg_id_t seg_id)
+{
+    uct_posix_unlink(md, seg_id, UCS_LOG_LEVEL_DEBUG);
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, uct_posix_rkey_unpack,
                  (component, rkey_buffer, params, rkey_p, handle_p),
                  uct_component_t *component, const void *rkey_buffer,
@@ -770,7 +1029,7 @@ UCS_PROFILE_FUNC(ucs_status_t, uct_posix_rkey_release,(component, rkey, handle),
 
 static uct_mm_md_mapper_ops_t uct_posix_md_ops = {
     .super = {
-        .close              = uct_mm_md_close,
+        .close              = uct_posix_md_close,
         .query              = uct_posix_md_query,
         .mem_alloc          = uct_posix_mem_alloc,
         .mem_free           = uct_posix_mem_free,
@@ -787,7 +1046,10 @@ static uct_mm_md_mapper_ops_t uct_posix_md_ops = {
     .iface_addr_pack   = uct_posix_iface_addr_pack,
     .mem_attach        = uct_posix_mem_attach,
     .mem_detach        = uct_posix_mem_detach,
-    .is_reachable      = uct_posix_is_reachable
+    .is_reachable      = uct_posix_is_reachable,
+    .shared_seg_open   = uct_posix_shared_seg_open,
+    .shared_seg_unlink = uct_posix_shared_seg_unlink,
+    .md_init           = uct_posix_md_init
 };
 
 UCT_MM_TL_DEFINE(posix, &uct_posix_md_ops, uct_posix_rkey_unpack,
@@ -795,3 +1057,11 @@ UCT_MM_TL_DEFINE(posix, &uct_posix_md_ops, uct_posix_rkey_unpack,
                  uct_posix_iface_config_table);
 
 UCT_SINGLE_TL_INIT(&uct_posix_component.super, posix,,,)
+
+UCS_STATIC_CLEANUP {
+    uct_posix_attach_evict_nolock(0);
+    if (uct_posix_attach_cache.idle != NULL) {
+        ucs_lru_destroy(uct_posix_attach_cache.idle);
+    }
+    kh_destroy_inplace(uct_posix_attach, &uct_posix_attach_cache.hash);
+}
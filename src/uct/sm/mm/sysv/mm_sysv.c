@@ -68,6 +68,16 @@ static ucs_status_t uct_sysv_mem_attach_common(int shmid, void **address_p)
     return UCS_OK;
 }
 
+static int
+uct_sysv_is_reachable(uct_mm_md_t *md, uct_mm_seg_id_t seg_id,
+                      const void *iface_addr)
+{
+    struct shmid_ds shm_ds;
+
+    /* a removed segment cannot be attached anymore once its owner detached */
+    return shmctl(seg_id, IPC_STAT, &shm_ds) == 0;
+}
+
 static ucs_status_t
 uct_sysv_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
                    ucs_memory_type_t mem_type, ucs_sys_device_t sys_dev,
@@ -215,7 +225,7 @@ static uct_mm_md_mapper_ops_t uct_sysv_md_ops = {
     .iface_addr_pack   = (uct_mm_mapper_iface_addr_pack_func_t)ucs_empty_function_return_success,
     .mem_attach        = uct_sysv_mem_attach,
     .mem_detach        = uct_sysv_mem_detach,
-    .is_reachable      = (uct_mm_mapper_is_reachable_func_t)ucs_empty_function_return_one_int
+    .is_reachable      = uct_sysv_is_reachable
 };
 
 UCT_MM_TL_DEFINE(sysv, &uct_sysv_md_ops, uct_sysv_rkey_unpack,
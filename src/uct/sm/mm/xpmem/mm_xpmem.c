@@ -72,7 +72,10 @@ static ucs_config_field_t uct_xpmem_md_config_table[] = {
 };
 
 static ucs_config_field_t uct_xpmem_iface_config_table[] = {
-  {"MM_", "", NULL, 0, UCS_CONFIG_TYPE_TABLE(uct_mm_iface_config_table)},
+  /* Senders are attached using the xpmem segment of the peer, which is not
+   * known to the receiver, so am_zcopy is not supported */
+  {"MM_", "ZCOPY_SEG_SIZE=0", NULL, 0,
+   UCS_CONFIG_TYPE_TABLE(uct_mm_iface_config_table)},
 
   {NULL}
 };
@@ -15,12 +15,22 @@ AS_IF([test "x$enable_cma" != xno],
             [AC_CHECK_FUNC([process_vm_readv],
                            [cma_happy="yes"],
                            [cma_happy="no"])
-             AS_IF([test "x$cma_happy" = "xyes"],
-                   [uct_modules="${uct_modules}:cma"])
             ])
       ]
 )
 
+#
+# Link CMA into libuct when requested by --with-builtin-modules, so it is
+# registered by its constructor and not searched for as a loadable module
+#
+cma_builtin="no"
+AS_IF([test "x$cma_happy" = "xyes"],
+      [AS_CASE([",${with_builtin_modules},"],
+               [*,cma,*], [cma_builtin="yes"
+                           uct_builtin_modules="${uct_builtin_modules}:cma"],
+               [uct_modules="${uct_modules}:cma"])])
+
 AM_CONDITIONAL([HAVE_CMA], [test "x$cma_happy" != xno])
+AM_CONDITIONAL([HAVE_CMA_BUILTIN], [test "x$cma_builtin" = xyes])
 AC_CONFIG_FILES([src/uct/sm/scopy/cma/Makefile
                  src/uct/sm/scopy/cma/ucx-cma.pc])
@@ -31,6 +31,9 @@
 /* Maximum number of events to wait on event set */
 #define UCT_TCP_MAX_EVENTS                    16
 
+/* Initial time to skip polling of an idle iface, when poll backoff is enabled */
+#define UCT_TCP_POLL_BACKOFF_MIN              ucs_time_from_usec(1)
+
 /* How long should be string to keep [%s:%s] string
  * where %s value can be -/Tx/Rx */
 #define UCT_TCP_EP_CTX_CAPS_STR_MAX           8
@@ -114,7 +117,13 @@ enum {
     /* EP is on EP PTR map. */
     UCT_TCP_EP_FLAG_ON_PTR_MAP         = UCS_BIT(9),
     /* EP has some operations done without flush */
-    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10)
+    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10),
+    /* EP is counted in the number of non-blocking connections which are
+     * in progress on the iface. */
+    UCT_TCP_EP_FLAG_CONN_INFLIGHT      = UCS_BIT(11),
+    /* EP waits on the iface connection queue to start its non-blocking
+     * connection establishment. */
+    UCT_TCP_EP_FLAG_CONN_QUEUED        = UCS_BIT(12)
 };
 
 
@@ -354,6 +363,8 @@ struct uct_tcp_ep {
         ucs_conn_match_elem_t     elem;         /* Connection matching element, used by EPs
                                                  * created with CONNECT_TO_IFACE method */
     };
+    ucs_list_link_t               conn_list;    /* List element to insert into
+                                                 * iface connection queue */
     char                          peer_addr[0]; /* Remote iface addr */
 };
 
@@ -382,8 +393,19 @@ typedef struct uct_tcp_iface {
                                                       * are in progress + how many EPs are
                                                       * waiting for PUT Zcopy operation ACKs
                                                       * (0/1 for each EP) */
+    unsigned                      conn_inflight;     /* How many non-blocking
+                                                      * connections are in progress */
+    ucs_list_link_t               conn_queue;        /* EPs which wait for other
+                                                      * connections to complete */
     ucs_range_spec_t              port_range;        /** Range of ports to use for bind() */
 
+    struct {
+        ucs_time_t                next_poll;         /* Do not poll the sockets
+                                                      * before this time */
+        ucs_time_t                interval;          /* Time to skip polling after
+                                                      * the next idle poll */
+    } poll_backoff;
+
     struct {
         size_t                    tx_seg_size;       /* TX AM buffer size */
         size_t                    rx_seg_size;       /* RX AM buffer size */
@@ -404,7 +426,12 @@ typedef struct uct_tcp_iface {
         int                       prefer_default;    /* Prefer default gateway */
         int                       put_enable;        /* Enable PUT Zcopy operation support */
         int                       conn_nb;           /* Use non-blocking connect() */
+        unsigned                  max_conn_inflight; /* Maximal number of non-blocking
+                                                      * connections in progress */
+        int                       fast_open;         /* Use TCP Fast Open */
         unsigned                  max_poll;          /* Number of events to poll per socket*/
+        ucs_time_t                poll_backoff_max;  /* Maximal time to skip polling
+                                                      * while idle, 0 - disabled */
         uint8_t                   max_conn_retries;  /* How many connection establishment attempts
                                                       * should be done if dropped connection was
                                                       * detected due to lack of system resources */
@@ -413,6 +440,8 @@ typedef struct uct_tcp_iface {
                                                       * It cannot exceed 255. */
         ucs_time_t                user_timeout;      /* TCP_USER_TIMEOUT */
         double                    max_bw;            /* Upper bound to TCP iface bandwidth */
+        unsigned                  num_paths;         /* Number of connections between
+                                                      * a pair of endpoints */
         struct {
             ucs_time_t            idle;              /* The time the connection needs to remain
                                                       * idle before TCP starts sending keepalive
@@ -429,6 +458,7 @@ typedef struct uct_tcp_iface {
         int                       nodelay;           /* TCP_NODELAY */
         size_t                    sndbuf;            /* SO_SNDBUF */
         size_t                    rcvbuf;            /* SO_RCVBUF */
+        ucs_time_t                busy_poll;         /* SO_BUSY_POLL */
     } sockopt;
 } uct_tcp_iface_t;
 
@@ -445,16 +475,21 @@ typedef struct uct_tcp_iface_config {
     int                            prefer_default;
     int                            put_enable;
     int                            conn_nb;
+    unsigned                       max_conn_inflight;
+    int                            fast_open;
     unsigned                       max_poll;
+    ucs_time_t                     poll_backoff_max;
     unsigned                       max_conn_retries;
     int                            sockopt_nodelay;
     uct_tcp_send_recv_buf_config_t sockopt;
+    ucs_time_t                     sockopt_busy_poll;
     unsigned                       syn_cnt;
     ucs_time_t                     user_timeout;
     uct_iface_mpool_config_t       tx_mpool;
     uct_iface_mpool_config_t       rx_mpool;
     ucs_range_spec_t               port_range;
     double                         max_bw;
+    unsigned                       num_paths;
     struct {
         ucs_time_t                 idle;
         unsigned long              cnt;
@@ -680,6 +715,14 @@ static inline void uct_tcp_iface_outstanding_dec(uct_tcp_iface_t *iface)
     iface->outstanding--;
 }
 
+/* Poll the sockets on the next progress call, e.g. when a reply is expected */
+static UCS_F_ALWAYS_INLINE void
+uct_tcp_iface_poll_backoff_reset(uct_tcp_iface_t *iface)
+{
+    iface->poll_backoff.next_poll = 0;
+    iface->poll_backoff.interval  = 0;
+}
+
 /**
  * Query for active network devices under /sys/class/net, as determined by
  * ucs_netif_is_active().
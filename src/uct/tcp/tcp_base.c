@@ -58,3 +58,68 @@ ucs_status_t ucs_tcp_base_set_user_timeout(int fd, ucs_time_t user_timeout)
     return UCS_ERR_UNSUPPORTED;
 #endif
 }
+
+ucs_status_t ucs_tcp_base_set_busy_poll(int fd, ucs_time_t busy_poll)
+{
+#ifdef SO_BUSY_POLL
+    int busy_poll_us;
+    double busy_poll_us_d;
+#  ifdef SO_PREFER_BUSY_POLL
+    int prefer_busy_poll;
+    ucs_status_t status;
+#  endif
+#endif
+
+    if (busy_poll == UCS_TIME_AUTO) {
+        return UCS_OK;
+    }
+
+#ifdef SO_BUSY_POLL
+    busy_poll_us_d = ucs_time_to_usec(busy_poll);
+    if ((busy_poll == UCS_TIME_INFINITY) || (busy_poll_us_d > INT_MAX)) {
+        busy_poll_us = INT_MAX;
+    } else {
+        /* Round, since conversion from ucs_time_t is not exact */
+        busy_poll_us = busy_poll_us_d + 0.5;
+    }
+
+#  ifdef SO_PREFER_BUSY_POLL
+    prefer_busy_poll = (busy_poll_us > 0);
+    status           = ucs_socket_setopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL,
+                                         (const void*)&prefer_busy_poll,
+                                         sizeof(prefer_busy_poll));
+    if (status != UCS_OK) {
+        return status;
+    }
+#  endif
+
+    return ucs_socket_setopt(fd, SOL_SOCKET, SO_BUSY_POLL,
+                             (const void*)&busy_poll_us, sizeof(busy_poll_us));
+#else
+    ucs_error("SO_BUSY_POLL is not supported");
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
+ucs_status_t ucs_tcp_base_set_fast_open(int fd, int is_listener)
+{
+    int value;
+
+    if (is_listener) {
+#ifdef TCP_FASTOPEN
+        /* Length of the queue of connections which were not accepted yet */
+        value = ucs_socket_max_conn();
+        return ucs_socket_setopt(fd, IPPROTO_TCP, TCP_FASTOPEN,
+                                 (const void*)&value, sizeof(value));
+#endif
+    } else {
+#ifdef TCP_FASTOPEN_CONNECT
+        value = 1;
+        return ucs_socket_setopt(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT,
+                                 (const void*)&value, sizeof(value));
+#endif
+    }
+
+    ucs_error("TCP Fast Open is not supported");
+    return UCS_ERR_UNSUPPORTED;
+}
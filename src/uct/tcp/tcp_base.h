@@ -53,5 +53,7 @@ typedef struct uct_tcp_send_recv_buf_config {
 
 ucs_status_t ucs_tcp_base_set_syn_cnt(int fd, int tcp_syn_cnt);
 ucs_status_t ucs_tcp_base_set_user_timeout(int fd, ucs_time_t user_timeout);
+ucs_status_t ucs_tcp_base_set_busy_poll(int fd, ucs_time_t busy_poll);
+ucs_status_t ucs_tcp_base_set_fast_open(int fd, int is_listener);
 
 #endif /* UCT_TCP_BASE_H */
@@ -13,10 +13,31 @@
 #include <ucs/async/async.h>
 
 
+static ucs_status_t uct_tcp_cm_conn_connect(uct_tcp_ep_t *ep);
+
+static void uct_tcp_cm_conn_queue_progress(uct_tcp_iface_t *iface)
+{
+    ucs_status_t status;
+    uct_tcp_ep_t *ep;
+
+    while (!ucs_list_is_empty(&iface->conn_queue) &&
+           (iface->conn_inflight < iface->config.max_conn_inflight)) {
+        ep         = ucs_list_extract_head(&iface->conn_queue, uct_tcp_ep_t,
+                                           conn_list);
+        ep->flags &= ~UCT_TCP_EP_FLAG_CONN_QUEUED;
+
+        status = uct_tcp_cm_conn_connect(ep);
+        if (status != UCS_OK) {
+            uct_tcp_ep_set_failed(ep, status);
+        }
+    }
+}
+
 void uct_tcp_cm_change_conn_state(uct_tcp_ep_t *ep,
                                   uct_tcp_ep_conn_state_t new_conn_state)
 {
     int full_log           = 1;
+    int conn_done          = 0;
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
     char str_local_addr[UCS_SOCKADDR_STRING_LEN];
@@ -27,6 +48,21 @@ void uct_tcp_cm_change_conn_state(uct_tcp_ep_t *ep,
     old_conn_state = (uct_tcp_ep_conn_state_t)ep->conn_state;
     ep->conn_state = new_conn_state;
 
+    if (ep->flags & UCT_TCP_EP_FLAG_CONN_INFLIGHT) {
+        /* Non-blocking connect() was completed, failed or restarted */
+        ucs_assert(old_conn_state == UCT_TCP_EP_CONN_STATE_CONNECTING);
+        ucs_assert(iface->conn_inflight > 0);
+        ep->flags &= ~UCT_TCP_EP_FLAG_CONN_INFLIGHT;
+        --iface->conn_inflight;
+        conn_done  = 1;
+    } else if (ep->flags & UCT_TCP_EP_FLAG_CONN_QUEUED) {
+        /* The EP is closed, or connected by an accepted socket, before its
+         * connect() was started */
+        ucs_assert(old_conn_state == UCT_TCP_EP_CONN_STATE_CONNECTING);
+        ucs_list_del(&ep->conn_list);
+        ep->flags &= ~UCT_TCP_EP_FLAG_CONN_QUEUED;
+    }
+
     switch(ep->conn_state) {
     case UCT_TCP_EP_CONN_STATE_CONNECTING:
     case UCT_TCP_EP_CONN_STATE_WAITING_ACK:
@@ -107,6 +143,11 @@ void uct_tcp_cm_change_conn_state(uct_tcp_ep_t *ep,
                   ep, uct_tcp_ep_cm_state[old_conn_state].name,
                   uct_tcp_ep_cm_state[ep->conn_state].name);
     }
+
+    if (conn_done) {
+        /* Start the connections which were queued by the inflight limit */
+        uct_tcp_cm_conn_queue_progress(iface);
+    }
 }
 
 /* `fmt_str` parameter has to contain "%s" to write event type */
@@ -144,6 +185,38 @@ static void uct_tcp_cm_trace_conn_pkt(const uct_tcp_ep_t *ep,
             uct_tcp_ep_get_cm_id(ep));
 }
 
+static ucs_status_t
+uct_tcp_cm_send(uct_tcp_ep_t *ep, const void *data, size_t length)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    ssize_t ret;
+
+    if (iface->config.fast_open &&
+        (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTING)) {
+        /* The first send() on a TCP Fast Open socket starts the connection
+         * establishment, and fails with EINPROGRESS if the data could not be
+         * sent with the SYN packet. Then the data is sent when the connection
+         * is established, and other errors are reported by the send below. */
+        do {
+            ret = send(ep->fd, data, length, MSG_NOSIGNAL);
+        } while ((ret < 0) && (errno == EINTR));
+
+        if (ret > 0) {
+            data    = UCS_PTR_BYTE_OFFSET(data, ret);
+            length -= ret;
+        } else if ((ret < 0) && (errno == EINPROGRESS)) {
+            ucs_trace("tcp_ep %p: fast open connection is in progress", ep);
+        }
+    }
+
+    if (length == 0) {
+        return UCS_OK;
+    }
+
+    return ucs_socket_send(ep->fd, data, length);
+}
+
 ucs_status_t uct_tcp_cm_send_event_pending_cb(uct_pending_req_t *self)
 {
     uct_tcp_ep_pending_req_t *req =
@@ -242,7 +315,7 @@ ucs_status_t uct_tcp_cm_send_event(uct_tcp_ep_t *ep,
         *pkt_event           = event;
     }
 
-    status = ucs_socket_send(ep->fd, pkt_buf, pkt_length);
+    status = uct_tcp_cm_send(ep, pkt_buf, pkt_length);
     if (status == UCS_OK) {
         uct_tcp_cm_trace_conn_pkt(ep, UCS_LOG_LEVEL_TRACE,
                                   "%s sent to", event);
@@ -768,26 +841,19 @@ err:
     return 0;
 }
 
-ucs_status_t uct_tcp_cm_conn_start(uct_tcp_ep_t *ep)
+static ucs_status_t uct_tcp_cm_conn_connect(uct_tcp_ep_t *ep)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
     ucs_status_t status;
 
-    ep->conn_retries++;
-    if (ep->conn_retries > iface->config.max_conn_retries) {
-        ucs_error("tcp_ep %p: reached maximum number of connection retries "
-                  "(%u)", ep, iface->config.max_conn_retries);
-        return UCS_ERR_TIMED_OUT;
-    }
-
-    uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CONNECTING);
-
     status = ucs_socket_connect(ep->fd, (const struct sockaddr*)&ep->peer_addr);
     if (UCS_STATUS_IS_ERR(status)) {
         return status;
     } else if (status == UCS_INPROGRESS) {
         ucs_assert(iface->config.conn_nb);
+        ep->flags |= UCT_TCP_EP_FLAG_CONN_INFLIGHT;
+        ++iface->conn_inflight;
         uct_tcp_ep_mod_events(ep, UCS_EVENT_SET_EVWRITE, 0);
         return UCS_OK;
     }
@@ -805,6 +871,34 @@ ucs_status_t uct_tcp_cm_conn_start(uct_tcp_ep_t *ep)
     return UCS_OK;
 }
 
+ucs_status_t uct_tcp_cm_conn_start(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    ep->conn_retries++;
+    if (ep->conn_retries > iface->config.max_conn_retries) {
+        ucs_error("tcp_ep %p: reached maximum number of connection retries "
+                  "(%u)", ep, iface->config.max_conn_retries);
+        return UCS_ERR_TIMED_OUT;
+    }
+
+    uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CONNECTING);
+
+    if (iface->config.conn_nb &&
+        (iface->conn_inflight >= iface->config.max_conn_inflight)) {
+        /* Limit the number of non-blocking connections in progress, the EP
+         * is connected when one of them is completed */
+        ucs_trace("tcp_ep %p: queue connection, %u are in progress", ep,
+                  iface->conn_inflight);
+        ucs_list_add_tail(&iface->conn_queue, &ep->conn_list);
+        ep->flags |= UCT_TCP_EP_FLAG_CONN_QUEUED;
+        return UCS_OK;
+    }
+
+    return uct_tcp_cm_conn_connect(ep);
+}
+
 /* This function is called from async thread */
 ucs_status_t uct_tcp_cm_handle_incoming_conn(uct_tcp_iface_t *iface,
                                              const struct sockaddr *peer_addr,
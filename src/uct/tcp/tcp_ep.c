@@ -329,6 +329,7 @@ uct_tcp_ep_tx_started(uct_tcp_ep_t *ep, const uct_tcp_am_hdr_t *hdr)
 
     ep->tx.length      += sizeof(*hdr) + hdr->length;
     iface->outstanding += ep->tx.length;
+    uct_tcp_iface_poll_backoff_reset(iface);
 }
 
 static UCS_F_ALWAYS_INLINE void
@@ -699,6 +700,13 @@ static ucs_status_t uct_tcp_ep_create_socket_and_connect(uct_tcp_ep_t *ep)
         goto err;
     }
 
+    if (iface->config.fast_open) {
+        status = ucs_tcp_base_set_fast_open(ep->fd, 0);
+        if (status != UCS_OK) {
+            goto err;
+        }
+    }
+
     status = uct_tcp_cm_conn_start(ep);
     if (status != UCS_OK) {
         goto err;
@@ -1007,6 +1015,8 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, ucs_event_set_types_t add,
             ucs_fatal("unable to modify event set for tcp_ep %p (fd=%d)", ep,
                       ep->fd);
         }
+
+        uct_tcp_iface_poll_backoff_reset(iface);
     }
 }
 
@@ -1439,13 +1449,17 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
     uct_tcp_am_hdr_t *hdr;
     size_t recv_length;
     size_t recvd_length;
+    size_t prev_length;
     size_t remaining;
+    int recv_full;
 
     ucs_trace_func("ep=%p", ep);
 
     if (!uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
-        if (ucs_unlikely(uct_tcp_ep_ctx_buf_alloc(
-                                ep, &ep->rx, &iface->rx_mpool) != UCS_OK)) {
+        /* The buffer may be kept from the previous receive operation */
+        if ((ep->rx.buf == NULL) &&
+            ucs_unlikely(uct_tcp_ep_ctx_buf_alloc(
+                                 ep, &ep->rx, &iface->rx_mpool) != UCS_OK)) {
             return 0;
         }
 
@@ -1467,11 +1481,16 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
         recv_length  = ucs_max(0, (ssize_t)(hdr->length - recvd_length));
     }
 
+    prev_length = ep->rx.length;
     if (!uct_tcp_ep_recv(ep, recv_length)) {
         goto out;
     }
 
-    /* Parse received active messages */
+    /* The socket is likely to have more data if the whole posted length was
+     * received */
+    recv_full = (ep->rx.length - prev_length) == recv_length;
+
+    /* Parse all active messages received by a single recv() call */
     while (uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
         remaining = ep->rx.length - ep->rx.offset;
         if (remaining < sizeof(*hdr)) {
@@ -1541,7 +1560,13 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
         ucs_assert(ep != NULL);
     }
 
-    uct_tcp_ep_ctx_reset(&ep->rx);
+    if (recv_full) {
+        /* Keep the buffer for the next receive operation from a busy peer, it
+         * is released when the socket is drained */
+        uct_tcp_ep_ctx_rewind(&ep->rx);
+    } else {
+        uct_tcp_ep_ctx_reset(&ep->rx);
+    }
 
 out:
     return handled;
@@ -60,10 +60,35 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "time, but can lead to connection resets due to high load on TCP/IP stack",
    ucs_offsetof(uct_tcp_iface_config_t, conn_nb), UCS_CONFIG_TYPE_BOOL},
 
+  {"MAX_CONN_INFLIGHT", "128",
+   "Maximal number of non-blocking connection establishments which may be in\n"
+   "progress on the interface at the same time, when CONN_NB is enabled. Further\n"
+   "connections are queued, and started when the connections in progress are\n"
+   "completed, to avoid overloading the TCP/IP stack of the peers during the\n"
+   "startup of a large job.",
+   ucs_offsetof(uct_tcp_iface_config_t, max_conn_inflight),
+   UCS_CONFIG_TYPE_UINT},
+
+  {"FAST_OPEN", "n",
+   "Use TCP Fast Open (TCP_FASTOPEN_CONNECT and TCP_FASTOPEN socket options) to\n"
+   "send the connection request in the SYN packet, which saves a round trip\n"
+   "when connecting to a peer which was already connected before. It also has\n"
+   "to be enabled for the server side by the net.ipv4.tcp_fastopen sysctl.",
+   ucs_offsetof(uct_tcp_iface_config_t, fast_open), UCS_CONFIG_TYPE_BOOL},
+
   {"MAX_POLL", UCS_PP_MAKE_STRING(UCT_TCP_MAX_EVENTS),
    "Number of times to poll on a ready socket. 0 - no polling, -1 - until drained",
    ucs_offsetof(uct_tcp_iface_config_t, max_poll), UCS_CONFIG_TYPE_UINT},
 
+  {"POLL_BACKOFF_MAX", "0",
+   "Maximal time to skip polling the sockets of an idle interface, to avoid a\n"
+   "system call on every progress. Every poll which finds no events doubles the\n"
+   "time during which progress calls skip polling, up to this value. Polling\n"
+   "resumes on every progress call when data is sent or the interface is armed\n"
+   "for wakeup. 0 - poll on every progress call.",
+   ucs_offsetof(uct_tcp_iface_config_t, poll_backoff_max),
+   UCS_CONFIG_TYPE_TIME_UNITS},
+
   {UCT_TCP_CONFIG_MAX_CONN_RETRIES, "25",
    "How many connection establishment attempts should be done if dropped "
    "connection was detected due to lack of system resources",
@@ -76,6 +101,16 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
 
   UCT_TCP_SEND_RECV_BUF_FIELDS(ucs_offsetof(uct_tcp_iface_config_t, sockopt)),
 
+  {"BUSY_POLL", "auto",
+   "Time to busy poll the network device queue when there is no data on a\n"
+   "socket (SO_BUSY_POLL socket option), which reduces receive latency at the\n"
+   "expense of CPU usage. Busy polling is also preferred over interrupts when\n"
+   "the SO_PREFER_BUSY_POLL socket option is supported. Increasing it above the\n"
+   "system default requires the CAP_NET_ADMIN capability. auto means to use\n"
+   "the system default.",
+   ucs_offsetof(uct_tcp_iface_config_t, sockopt_busy_poll),
+   UCS_CONFIG_TYPE_TIME_UNITS},
+
   UCT_TCP_SYN_CNT(ucs_offsetof(uct_tcp_iface_config_t, syn_cnt)),
 
   UCT_TCP_USER_TIMEOUT(ucs_offsetof(uct_tcp_iface_config_t, user_timeout)),
@@ -92,9 +127,19 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    ucs_offsetof(uct_tcp_iface_config_t, port_range), UCS_CONFIG_TYPE_RANGE_SPEC},
 
    {"MAX_BW", "2200MBs",
-    "Upper bound to TCP iface bandwidth. 'auto' means BW is unlimited.",
+    "Upper bound to the bandwidth of a single TCP connection, which is a single\n"
+    "lane of a UCP endpoint. The iface bandwidth is bounded by MAX_BW multiplied\n"
+    "by NUM_PATHS. 'auto' means BW is unlimited.",
     ucs_offsetof(uct_tcp_iface_config_t, max_bw), UCS_CONFIG_TYPE_BW},
 
+  {"NUM_PATHS", "1",
+   "Number of connections that should be created between a pair of communicating\n"
+   "endpoints. Every connection is a separate socket, and large messages are\n"
+   "split among them to exceed the bandwidth of a single TCP flow, which is\n"
+   "bounded by MAX_BW. The number of connections which are used for large\n"
+   "messages is also limited by " UCS_DEFAULT_ENV_PREFIX "MAX_RNDV_LANES.",
+   ucs_offsetof(uct_tcp_iface_config_t, num_paths), UCS_CONFIG_TYPE_UINT},
+
 #ifdef UCT_TCP_EP_KEEPALIVE
   {"KEEPIDLE", UCS_PP_MAKE_STRING(UCT_TCP_EP_DEFAULT_KEEPALIVE_IDLE) "s",
    "The time the connection needs to remain idle before TCP starts sending "
@@ -342,8 +387,12 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface,
     pci_bw                 = ucs_topo_get_pci_bw(iface->if_name, sysfs_path);
     calculated_bw          = ucs_min(pci_bw, network_bw);
 
-    /* Bandwidth is bounded by TCP stack computation time */
-    attr->bandwidth.shared = ucs_min(calculated_bw, iface->config.max_bw);
+    /* Bandwidth of every connection is bounded by TCP stack computation
+     * time */
+    attr->bandwidth.shared = ucs_min(calculated_bw,
+                                     iface->config.max_bw *
+                                     iface->config.num_paths);
+    attr->dev_num_paths    = iface->config.num_paths;
 
     attr->ep_addr_len      = sizeof(uct_tcp_ep_addr_t);
     attr->iface_addr_len   = sizeof(uct_tcp_iface_addr_t);
@@ -442,6 +491,11 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     unsigned read_events;
     ucs_status_t status;
 
+    if ((iface->poll_backoff.next_poll != 0) && (iface->outstanding == 0) &&
+        (ucs_get_time() < iface->poll_backoff.next_poll)) {
+        return 0;
+    }
+
     do {
         read_events = ucs_min(ucs_sys_event_set_max_wait_events, max_events);
         status = ucs_event_set_wait(iface->event_set, &read_events,
@@ -455,9 +509,37 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     } while ((max_events > 0) && (read_events == UCT_TCP_MAX_EVENTS) &&
              ((status == UCS_OK) || (status == UCS_INPROGRESS)));
 
+    if (iface->config.poll_backoff_max == 0) {
+        /* Poll backoff is disabled, so next_poll always remains 0 */
+        return count;
+    }
+
+    if ((max_events == iface->config.max_poll) && (iface->outstanding == 0)) {
+        /* No events - poll less frequently until there is some activity */
+        iface->poll_backoff.interval  = ucs_min(
+                ucs_max(iface->poll_backoff.interval * 2,
+                        UCT_TCP_POLL_BACKOFF_MIN),
+                iface->config.poll_backoff_max);
+        iface->poll_backoff.next_poll = ucs_get_time() +
+                                        iface->poll_backoff.interval;
+    } else {
+        uct_tcp_iface_poll_backoff_reset(iface);
+    }
+
     return count;
 }
 
+static ucs_status_t uct_tcp_iface_event_arm(uct_iface_h tl_iface,
+                                            unsigned events)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+
+    /* The caller is going to wait for an event on the iface event fd, so check
+     * the sockets on the first progress call after the wakeup */
+    uct_tcp_iface_poll_backoff_reset(iface);
+    return UCS_OK;
+}
+
 static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                         uct_completion_t *comp)
 {
@@ -535,6 +617,11 @@ ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
         return status;
     }
 
+    status = ucs_tcp_base_set_busy_poll(fd, iface->sockopt.busy_poll);
+    if (status != UCS_OK) {
+        return status;
+    }
+
     status = ucs_tcp_base_set_syn_cnt(fd, iface->config.syn_cnt);
     if (status != UCS_OK) {
         return status;
@@ -564,7 +651,7 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_progress_disable   = uct_base_iface_progress_disable,
     .iface_progress           = uct_tcp_iface_progress,
     .iface_event_fd_get       = uct_tcp_iface_event_fd_get,
-    .iface_event_arm          = (uct_iface_event_arm_func_t)ucs_empty_function_return_success,
+    .iface_event_arm          = uct_tcp_iface_event_arm,
     .iface_close              = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_iface_t),
     .iface_query              = uct_tcp_iface_query,
     .iface_get_address        = uct_tcp_iface_get_address,
@@ -627,6 +714,13 @@ static ucs_status_t uct_tcp_iface_listener_init(uct_tcp_iface_t *iface)
         goto err;
     }
 
+    if (iface->config.fast_open) {
+        status = ucs_tcp_base_set_fast_open(iface->listen_fd, 1);
+        if (status != UCS_OK) {
+            goto err_close_sock;
+        }
+    }
+
     /* Get the port which was selected for the socket */
     ret = getsockname(iface->listen_fd, (struct sockaddr*)&bind_addr, &socklen);
     if (ret < 0) {
@@ -678,9 +772,30 @@ static ucs_mpool_ops_t uct_tcp_mpool_ops = {
     .obj_str       = NULL
 };
 
+static ucs_status_t
+uct_tcp_iface_estimate_perf(uct_iface_h tl_iface, uct_perf_attr_t *perf_attr)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+    ucs_status_t status;
+
+    status = uct_base_iface_estimate_perf(tl_iface, perf_attr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* A single connection does not exceed the bandwidth of one TCP flow */
+    if (perf_attr->field_mask & UCT_PERF_ATTR_FIELD_PATH_BANDWIDTH) {
+        perf_attr->path_bandwidth.shared =
+                ucs_min(perf_attr->path_bandwidth.shared,
+                        iface->config.max_bw);
+    }
+
+    return UCS_OK;
+}
+
 static uct_iface_internal_ops_t uct_tcp_iface_internal_ops = {
     .iface_query_v2         = uct_iface_base_query_v2,
-    .iface_estimate_perf    = uct_base_iface_estimate_perf,
+    .iface_estimate_perf    = uct_tcp_iface_estimate_perf,
     .iface_vfs_refresh      = (uct_iface_vfs_refresh_func_t)ucs_empty_function,
     .ep_query               = (uct_ep_query_func_t)ucs_empty_function_return_unsupported,
     .ep_invalidate          = (uct_ep_invalidate_func_t)ucs_empty_function_return_unsupported,
@@ -724,6 +839,8 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     ucs_strncpy_zero(self->if_name, params->mode.device.dev_name,
                      sizeof(self->if_name));
     self->outstanding        = 0;
+    self->conn_inflight      = 0;
+    uct_tcp_iface_poll_backoff_reset(self);
     self->config.tx_seg_size = config->tx_seg_size +
                                sizeof(uct_tcp_am_hdr_t);
     self->config.rx_seg_size = config->rx_seg_size +
@@ -766,13 +883,17 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     self->config.prefer_default    = config->prefer_default;
     self->config.put_enable        = config->put_enable;
     self->config.conn_nb           = config->conn_nb;
+    self->config.max_conn_inflight = config->max_conn_inflight;
+    self->config.fast_open         = config->fast_open;
     self->config.max_poll          = config->max_poll;
+    self->config.poll_backoff_max  = config->poll_backoff_max;
     self->config.max_conn_retries  = config->max_conn_retries;
     self->config.syn_cnt           = config->syn_cnt;
     self->config.user_timeout      = config->user_timeout;
     self->sockopt.nodelay          = config->sockopt_nodelay;
     self->sockopt.sndbuf           = config->sockopt.sndbuf;
     self->sockopt.rcvbuf           = config->sockopt.rcvbuf;
+    self->sockopt.busy_poll        = config->sockopt_busy_poll;
     self->config.keepalive.cnt     = config->keepalive.cnt;
     self->config.keepalive.intvl   = config->keepalive.intvl;
     self->config.ep_bind_src_addr  = config->ep_bind_src_addr;
@@ -795,6 +916,15 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
                                   DBL_MAX :
                                   config->max_bw;
 
+    if ((config->num_paths == 0) || (config->num_paths > UINT8_MAX)) {
+        ucs_error("number of paths (%u) must be between 1 and %u",
+                  config->num_paths, UINT8_MAX);
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
+    self->config.num_paths = config->num_paths;
+
     if (self->config.tx_seg_size > self->config.rx_seg_size) {
         ucs_error("RX segment size (%zu) must be >= TX segment size (%zu)",
                   self->config.rx_seg_size, self->config.tx_seg_size);
@@ -847,6 +977,7 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     }
 
     ucs_list_head_init(&self->ep_list);
+    ucs_list_head_init(&self->conn_queue);
     ucs_conn_match_init(&self->conn_match_ctx, self->config.sockaddr_len,
                         UCT_TCP_CM_CONN_SN_MAX, &uct_tcp_cm_conn_match_ops);
     status = UCS_PTR_MAP_INIT(tcp_ep, &self->ep_ptr_map);
@@ -933,6 +1064,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
     }
 
     uct_tcp_iface_ep_list_cleanup(self);
+    ucs_assert(ucs_list_is_empty(&self->conn_queue));
     ucs_conn_match_cleanup(&self->conn_match_ctx);
     UCS_PTR_MAP_DESTROY(tcp_ep, &self->ep_ptr_map);
 
@@ -1038,9 +1038,12 @@ UCS_TEST_P(test_ucp_am_nbx, resend_evicts_orphan_partial_msg)
     ucs_interval_tree_init(rdesc_frag_tree(forged_rdesc),
                            &r_worker->am.frag_tree_mpool);
 
+    ucp_ep_am_frags_t *r_frags = ucp_am_ep_frags_get(r_ep_ext);
+    ASSERT_TRUE(r_frags != NULL);
+
     auto orphan_is_linked = [&]() -> bool {
         ucp_recv_desc_t *rdesc;
-        ucs_list_for_each(rdesc, &r_ep_ext->am.started_ams,
+        ucs_list_for_each(rdesc, &r_frags->started_ams,
                           am_first.list) {
             if (rdesc == forged_rdesc) {
                 return true;
@@ -1051,7 +1054,7 @@ UCS_TEST_P(test_ucp_am_nbx, resend_evicts_orphan_partial_msg)
 
     {
         UCS_ASYNC_BLOCK(&r_worker->async);
-        ucs_list_add_tail(&r_ep_ext->am.started_ams,
+        ucs_list_add_tail(&r_frags->started_ams,
                           &forged_rdesc->am_first.list);
         UCS_ASYNC_UNBLOCK(&r_worker->async);
     }
@@ -1100,6 +1103,84 @@ UCS_TEST_P(test_ucp_am_nbx, resend_evicts_orphan_partial_msg)
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx)
 
 
+class test_ucp_am_nbx_coalesce : public test_ucp_am_nbx {
+public:
+    test_ucp_am_nbx_coalesce()
+    {
+        stats_activate();
+    }
+
+    ~test_ucp_am_nbx_coalesce()
+    {
+        stats_restore();
+    }
+
+protected:
+    void check_coalesced(unsigned num_sends)
+    {
+#ifdef ENABLE_STATS
+        ucs_stats_node_t *stats = sender().worker()->stats;
+        uint64_t num_msgs       = UCS_STATS_GET_COUNTER(
+                stats, UCP_WORKER_STAT_COALESCE_TX_MSG);
+        uint64_t num_frames     = UCS_STATS_GET_COUNTER(
+                stats, UCP_WORKER_STAT_COALESCE_TX_FRAME);
+
+        UCS_TEST_MESSAGE << num_msgs << " of " << num_sends
+                         << " messages coalesced to " << num_frames
+                         << " frames";
+        if (has_transport("self") || has_transport("tcp")) {
+            /* Self transport never runs out of send resources, and tcp gets
+             * them back as soon as the socket accepts more data, so messages
+             * are not accumulated */
+            return;
+        }
+
+        EXPECT_GT(num_msgs, 0u);
+        EXPECT_LT(num_frames, num_msgs);
+#endif
+    }
+};
+
+/* Small socket buffers make tcp run out of send resources */
+UCS_TEST_SKIP_COND_P(test_ucp_am_nbx_coalesce, send_small,
+                     !is_proto_enabled(), "COALESCE_THRESH=64",
+                     "TCP_SNDBUF?=4k", "TCP_RCVBUF?=4k")
+{
+    const unsigned num_sends = 10000 / ucs::test_time_multiplier();
+    const size_t size        = 8;
+    std::vector<uint8_t> sbuf(size);
+    std::vector<void*> sptrs;
+
+    mem_buffer::pattern_fill(sbuf.data(), size, SEED);
+    m_hdr.resize(8);
+    ucs::fill_random(m_hdr);
+    set_am_data_handler(receiver(), TEST_AM_NBX_ID, am_data_cb, this);
+
+    /* Messages are coalesced only after the lanes are connected, so
+     * complete the wireup first */
+    ucp::data_type_desc_t sdt_desc(m_dt, sbuf.data(), size);
+    ASSERT_UCS_OK(request_wait(send_am(sdt_desc, get_send_flag(),
+                                       m_hdr.data(), m_hdr.size())));
+    wait_receives();
+
+    /* Send without progress to run out of send resources, so the following
+     * messages are coalesced. Mix fast completion sends to use both short and
+     * bcopy protocols. */
+    for (unsigned i = 0; i < num_sends; ++i) {
+        sptrs.push_back(send_am(sdt_desc, get_send_flag(), m_hdr.data(),
+                                m_hdr.size(), NULL,
+                                (i % 2) ? UCP_OP_ATTR_FLAG_FAST_CMPL : 0));
+    }
+
+    wait_receives();
+    ASSERT_UCS_OK(requests_wait(sptrs));
+    EXPECT_EQ(m_recv_counter, m_send_counter);
+    check_coalesced(num_sends);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_coalesce)
+
+
 class test_ucp_am_nbx_reply_always : public test_ucp_am_nbx {
 protected:
     virtual unsigned get_send_flag() const
@@ -2062,6 +2143,37 @@ UCS_TEST_P(test_ucp_am_nbx_rndv, rndv_am_bcopy, "RNDV_SCHEME=am")
     test_am_send_recv(RNDV_THRESH);
 }
 
+UCS_TEST_SKIP_COND_P(test_ucp_am_nbx_rndv, rndv_am_compress,
+                     !is_proto_enabled(), "RNDV_SCHEME=am", "COMPRESS=y",
+                     "COMPRESS_RATIO=100", "COMPRESS_BW=100GBs")
+{
+    /* Pattern data does not compress, so fragments are sent as is */
+    test_am_send_recv(256 * UCS_KBYTE);
+
+    if (has_transport("tcp")) {
+        EXPECT_GT(sender().worker()->compress.tx_size, 0u);
+    }
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_am_nbx_rndv, rndv_tcp_num_paths,
+                     !has_transport("tcp"), "NET_DEVICES=lo",
+                     "TCP_NUM_PATHS?=2", "MAX_RNDV_LANES=2")
+{
+    const ucp_ep_config_key_t *key = &ucp_ep_config(sender().ep())->key;
+    unsigned num_tcp_paths         = 0;
+
+    for (ucp_lane_index_t lane = 0; lane < key->num_lanes; ++lane) {
+        if (!strcmp(ucp_ep_get_tl_rsc(sender().ep(), lane)->tl_name, "tcp")) {
+            num_tcp_paths = ucs_max(num_tcp_paths,
+                                    key->lanes[lane].path_index + 1u);
+        }
+    }
+
+    /* Large messages are sent over two connections to the same device */
+    EXPECT_EQ(2u, num_tcp_paths);
+    test_am_send_recv(UCS_MBYTE);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am_nbx_rndv);
 
 class test_ucp_am_nbx_rndv_memtype : public test_ucp_am_nbx_rndv {
@@ -7,12 +7,14 @@
 #include "ucp_test.h"
 
 #include <cstddef>
+#include <map>
 #include <set>
 
 extern "C" {
 #include <ucp/core/ucp_context.h>
 #include <ucp/core/ucp_mm.h>
 #include <ucs/sys/sys.h>
+#include <uct/base/uct_component.h>
 }
 
 class test_ucp_lib_query : public ucs::test {
@@ -74,6 +76,107 @@ UCS_TEST_P(test_ucp_context, max_hca_per_gpu_config)
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_context, all, "all")
 
+class test_ucp_context_md_open : public test_ucp_context {
+protected:
+    /* Slow device initialization */
+    static const unsigned MD_OPEN_DELAY_MS = 50;
+
+    virtual void cleanup()
+    {
+        m_mock.cleanup();
+        test_ucp_context::cleanup();
+    }
+
+    void mock_slow_md_open(ucp_context_h context)
+    {
+        for (ucp_rsc_index_t i = 0; i < context->num_cmpts; ++i) {
+            m_mock.setup(&context->tl_cmpts[i].cmpt->md_open, md_open_mock);
+        }
+    }
+
+    ucp_context_h create_context(ucs_time_t *elapsed_p)
+    {
+        ucs_time_t start_time = ucs_get_time();
+        ucp_context_h context = create_entity()->ucph();
+
+        *elapsed_p = ucs_get_time() - start_time;
+        return context;
+    }
+
+    static ucs_status_t
+    md_open_mock(uct_component_h component, const char *md_name,
+                 const uct_md_config_t *config, uct_md_h *md_p)
+    {
+        if (m_count_md_opens) {
+            ++m_md_opens[component];
+        }
+
+        usleep(MD_OPEN_DELAY_MS * UCS_MSEC_PER_SEC);
+        return m_mock.orig_func(&component->md_open, component, md_name,
+                                config, md_p);
+    }
+
+    static ucs::mock                           m_mock;
+    static bool                                m_count_md_opens;
+    static std::map<uct_component_h, unsigned> m_md_opens;
+};
+
+ucs::mock test_ucp_context_md_open::m_mock;
+bool test_ucp_context_md_open::m_count_md_opens = false;
+std::map<uct_component_h, unsigned> test_ucp_context_md_open::m_md_opens;
+
+UCS_TEST_P(test_ucp_context_md_open, parallel_md_open)
+{
+    ucs_time_t serial_time, parallel_time;
+
+    mock_slow_md_open(create_entity()->ucph());
+    m_md_opens.clear();
+
+    m_count_md_opens     = true;
+    ucp_context_h serial = create_context(&serial_time);
+    m_count_md_opens     = false;
+
+    modify_config("PARALLEL_MD_OPEN", "y");
+    ucp_context_h parallel = create_context(&parallel_time);
+
+    /* Opening memory domains concurrently must not change the resources */
+    ASSERT_EQ(serial->num_mds, parallel->num_mds);
+    for (ucp_md_index_t i = 0; i < serial->num_mds; ++i) {
+        EXPECT_STREQ(serial->tl_mds[i].rsc.md_name,
+                     parallel->tl_mds[i].rsc.md_name);
+        EXPECT_EQ(serial->tl_mds[i].cmpt_index, parallel->tl_mds[i].cmpt_index);
+    }
+
+    ASSERT_EQ(serial->num_tls, parallel->num_tls);
+    for (ucp_rsc_index_t i = 0; i < serial->num_tls; ++i) {
+        EXPECT_STREQ(serial->tl_rscs[i].tl_rsc.tl_name,
+                     parallel->tl_rscs[i].tl_rsc.tl_name);
+        EXPECT_STREQ(serial->tl_rscs[i].tl_rsc.dev_name,
+                     parallel->tl_rscs[i].tl_rsc.dev_name);
+        EXPECT_EQ(serial->tl_rscs[i].md_index, parallel->tl_rscs[i].md_index);
+    }
+
+    UCS_TEST_MESSAGE << m_md_opens.size() << " components, serial open: "
+                     << ucs_time_to_msec(serial_time) << " ms, parallel open: "
+                     << ucs_time_to_msec(parallel_time) << " ms";
+    if (m_md_opens.size() < 2) {
+        UCS_TEST_SKIP_R("less than two components have memory domains");
+    }
+
+    /* The delays of all components but the slowest one are overlapped */
+    unsigned serial_opens = 0, max_cmpt_opens = 0;
+    for (const auto &md_opens : m_md_opens) {
+        serial_opens  += md_opens.second;
+        max_cmpt_opens = std::max(max_cmpt_opens, md_opens.second);
+    }
+
+    EXPECT_LT(ucs_time_to_msec(parallel_time),
+              ucs_time_to_msec(serial_time) -
+              ((serial_opens - max_cmpt_opens) * MD_OPEN_DELAY_MS / 2));
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_context_md_open, all, "all")
+
 class test_ucp_aliases : public test_ucp_context {
 };
 
@@ -6,6 +6,7 @@
 
 #include "ucp_test.h"
 #include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_ep.h>
 
 class test_ucp_ep : public ucp_test {
 public:
@@ -93,3 +94,124 @@ UCS_TEST_P(test_ucp_ep, ucp_query_transport)
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_ep);
+
+
+class test_ucp_ep_memory : public ucp_test {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant> &variants)
+    {
+        add_variant(variants, UCP_FEATURE_AM | UCP_FEATURE_RMA);
+    }
+
+protected:
+    static const uint16_t AM_ID = 1;
+
+    static ucs_status_t
+    am_cb(void *arg, const void *header, size_t header_length, void *data,
+          size_t length, const ucp_am_recv_param_t *param)
+    {
+        ++(*static_cast<size_t*>(arg));
+        return UCS_OK;
+    }
+
+    void close_eps(const std::vector<ucp_ep_h> &eps)
+    {
+        std::vector<void*> reqs;
+
+        for (std::vector<ucp_ep_h>::const_iterator it = eps.begin();
+             it != eps.end(); ++it) {
+            reqs.push_back(ep_close_nbx(*it, 0));
+        }
+
+        requests_wait(reqs);
+    }
+};
+
+UCS_TEST_P(test_ucp_ep_memory, ep_size)
+{
+    /* Endpoint and its extension are allocated together, and transport
+     * endpoints of the self transport are not counted */
+    size_t ep_size = sizeof(ucp_ep_t) + sizeof(ucp_ep_ext_t);
+    /* Layout of the AM state when the reassembly state was kept inline */
+    struct inline_am_state {
+        ucp_ep_am_frags_t frags;
+        uint64_t          psn;
+    };
+    size_t inline_ext_size = sizeof(ucp_ep_ext_t) - sizeof(ucp_ep_ext_t::am) +
+                             sizeof(inline_am_state);
+
+    UCS_TEST_MESSAGE << "endpoint size " << ep_size << " bytes, extension "
+                     << sizeof(ucp_ep_ext_t) << " bytes (" << inline_ext_size
+                     << " with inline AM reassembly state)";
+
+    /* Moving the reassembly state out must not be absorbed by padding */
+    UCS_STATIC_ASSERT(sizeof(ucp_ep_ext_t) + sizeof(ucp_ep_am_frags_t) -
+                      sizeof(ucp_ep_am_frags_t*) <=
+                      sizeof(ucp_ep_ext_t) - sizeof(ucp_ep_ext_t::am) +
+                      sizeof(inline_am_state));
+    EXPECT_LT(sizeof(ucp_ep_ext_t), inline_ext_size);
+}
+
+UCS_TEST_P(test_ucp_ep_memory, am_frags_on_first_use)
+{
+    const size_t num_eps = 1000 / ucs::test_time_multiplier();
+    const size_t size    = 64 * UCS_KBYTE;
+    std::vector<char> sbuf(size, 'a');
+    std::vector<ucp_ep_h> eps;
+    ucp_am_handler_param_t am_param;
+    ucp_request_param_t param;
+    ucp_ep_params_t ep_params;
+    ucp_address_t *address;
+    size_t address_length;
+    size_t num_recvs;
+    ucs_status_t status;
+    ucp_ep_h ep;
+
+    status = ucp_worker_get_address(receiver().worker(), &address,
+                                    &address_length);
+    ASSERT_UCS_OK(status);
+
+    ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address    = address;
+
+    /* Endpoints which did not receive fragmented messages do not have the
+     * reassembly state */
+    for (size_t i = 0; i < num_eps; ++i) {
+        status = ucp_ep_create(sender().worker(), &ep_params, &ep);
+        if (status != UCS_OK) {
+            break;
+        }
+
+        eps.push_back(ep);
+        EXPECT_TRUE(ep->ext->am.frags == NULL);
+    }
+
+    ucp_worker_release_address(receiver().worker(), address);
+    EXPECT_UCS_OK(status);
+    close_eps(eps);
+
+    sender().connect(&receiver(), get_ep_params());
+    EXPECT_TRUE(receiver().ep()->ext->am.frags == NULL);
+
+    num_recvs           = 0;
+    am_param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                          UCP_AM_HANDLER_PARAM_FIELD_CB |
+                          UCP_AM_HANDLER_PARAM_FIELD_ARG;
+    am_param.id         = AM_ID;
+    am_param.cb         = am_cb;
+    am_param.arg        = &num_recvs;
+    ASSERT_UCS_OK(ucp_worker_set_am_recv_handler(receiver().worker(),
+                                                 &am_param));
+
+    /* Multi-fragment eager message allocates the reassembly state */
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags        = UCP_AM_SEND_FLAG_EAGER;
+    void *sreq = ucp_am_send_nbx(sender().ep(), AM_ID, NULL, 0, sbuf.data(),
+                                 sbuf.size(), &param);
+    ASSERT_UCS_OK(request_wait(sreq));
+    wait_for_value(&num_recvs, (size_t)1);
+    EXPECT_EQ(1u, num_recvs);
+    EXPECT_TRUE(receiver().ep()->ext->am.frags != NULL);
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_ep_memory, self, "self")
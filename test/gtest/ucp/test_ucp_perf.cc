@@ -122,6 +122,13 @@ const test_perf::test_spec test_ucp_perf::tests[] =
     ucs_offsetof(ucx_perf_result_t, latency.total_average), 1e6, 0.001, 60.0,
     0 },
 
+  { "tag_lat_hybrid", "usec",
+    UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_PINGPONG,
+    UCX_PERF_WAIT_MODE_HYBRID,
+    UCP_PERF_DATATYPE_CONTIG, 0, 1, { 8 }, 1, 100000lu,
+    ucs_offsetof(ucx_perf_result_t, latency.total_average), 1e6, 0.001, 60.0,
+    0 },
+
   { "tag_lat_iov", "usec",
     UCX_PERF_API_UCP, UCX_PERF_CMD_TAG, UCX_PERF_TEST_TYPE_PINGPONG,
     UCX_PERF_WAIT_MODE_POLL,
@@ -333,7 +340,9 @@ UCS_TEST_SKIP_COND_P(test_ucp_perf, envelope, has_transport("self"))
     size_t max_iter = std::numeric_limits<size_t>::max();
     test_spec test  = tests[get_variant_value(VARIANT_TEST_TYPE)];
 
-    if (ucs::is_aws() && (test.wait_mode == UCX_PERF_WAIT_MODE_SLEEP) &&
+    if (ucs::is_aws() &&
+        ((test.wait_mode == UCX_PERF_WAIT_MODE_SLEEP) ||
+         (test.wait_mode == UCX_PERF_WAIT_MODE_HYBRID)) &&
         (has_transport("ud_v") || has_transport("srd"))) {
         // TODO support wakeup in UD transport without requiring IBV_SEND_SOLICITED
         UCS_TEST_SKIP_R("wait mode sleep on EFA not available");
@@ -382,7 +391,9 @@ UCS_TEST_P(test_ucp_loopback, envelope)
 {
     test_spec test = tests[get_variant_value(VARIANT_TEST_TYPE)];
 
-    if (ucs::is_aws() && (test.wait_mode == UCX_PERF_WAIT_MODE_SLEEP)) {
+    if (ucs::is_aws() &&
+        ((test.wait_mode == UCX_PERF_WAIT_MODE_SLEEP) ||
+         (test.wait_mode == UCX_PERF_WAIT_MODE_HYBRID))) {
         UCS_TEST_SKIP_R("wait mode sleep on EFA not available");
     }
 
@@ -453,3 +464,69 @@ UCS_TEST_P(test_ucp_wait_mem, envelope) {
 }
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_wait_mem, shm, "shm")
+
+
+class test_ucp_idle_progress : public test_ucp_perf {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant> &variants)
+    {
+        add_variant(variants, 0);
+    }
+
+protected:
+    double run_lat_test(const std::string &title, const std::string &tls,
+                        const std::string &backoff_max)
+    {
+        ucs::scoped_setenv tls_env("UCX_TLS", tls.c_str());
+        ucs::scoped_setenv warn_invalid("UCX_WARN_INVALID_CONFIG", "no");
+        ucs::scoped_setenv all_to_all_env("UCX_CONNECT_ALL_TO_ALL", "y");
+        ucs::scoped_setenv backoff_env("UCX_TCP_POLL_BACKOFF_MAX",
+                                       backoff_max.c_str());
+        const test_spec test = { title.c_str(), "usec",
+                                 UCX_PERF_API_UCP, UCX_PERF_CMD_TAG,
+                                 UCX_PERF_TEST_TYPE_PINGPONG,
+                                 UCX_PERF_WAIT_MODE_POLL,
+                                 UCP_PERF_DATATYPE_CONTIG,
+                                 0, 1, { 8 }, 1, 100000lu,
+                                 ucs_offsetof(ucx_perf_result_t,
+                                              latency.total_average),
+                                 1e6, 0.001, 60.0, 0,
+                                 UCS_MEMORY_TYPE_HOST,
+                                 UCS_MEMORY_TYPE_HOST };
+
+        return run_test(test, 0, false, "", "");
+    }
+};
+
+UCS_TEST_SKIP_COND_P(test_ucp_idle_progress, envelope,
+                     RUNNING_ON_VALGRIND || !ucs::perf_retry_count) {
+    double ref_lat = 0, tcp_lat = 0, backoff_lat = 0;
+
+    /* Latency depends on the machine load, so retry before failing */
+    for (int retry = 0; retry < ucs::perf_retry_count; ++retry) {
+        /* Reference shared memory latency, without any TCP interfaces */
+        ref_lat = run_lat_test("tag latency reference", "shm", "0");
+
+        /* Same test with idle TCP endpoints, polling the sockets on every
+         * progress call */
+        tcp_lat = run_lat_test("tag latency with idle tcp", "shm,tcp", "0");
+
+        /* With poll backoff, the idle TCP interfaces should not add a system
+         * call to every progress */
+        backoff_lat = run_lat_test("tag latency with idle tcp and backoff",
+                                   "shm,tcp", "100us");
+
+        UCS_TEST_MESSAGE << "idle tcp latency overhead: "
+                         << (tcp_lat - ref_lat) << " usec without backoff, "
+                         << (backoff_lat - ref_lat) << " usec with backoff";
+
+        /* Backoff should remove most of the overhead of the idle sockets */
+        if ((backoff_lat - ref_lat) < ((tcp_lat - ref_lat) / 2)) {
+            break;
+        }
+    }
+
+    EXPECT_LT(backoff_lat - ref_lat, (tcp_lat - ref_lat) / 2);
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_idle_progress, shm, "shm")
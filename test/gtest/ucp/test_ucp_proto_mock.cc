@@ -1165,8 +1165,9 @@ UCS_TEST_P(test_ucp_proto_mock_cma, am_send_1_lane)
 
     check_ep_config(sender(), {
         {0,      92, "short",                                 "posix/memory"},
-        {93,   5028, "copy-in",                               "posix/memory"},
-        {5029, INF,  "rendezvous zero-copy read from remote", "cma/mock"},
+        {93,    405, "copy-in",                               "posix/memory"},
+        {406,  6979, "zero-copy",                             "posix/memory"},
+        {6980, INF,  "rendezvous zero-copy read from remote", "cma/mock"},
     }, key);
 }
 
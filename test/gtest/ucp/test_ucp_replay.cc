@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2026. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#include "ucp_test.h"
+
+extern "C" {
+#include <ucp/core/ucp_api_record.h>
+#include <ucs/profile/profile.h>
+}
+
+#include <fstream>
+#include <iterator>
+#include <sys/wait.h>
+
+
+class test_ucp_replay : public ucp_test {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant> &variants)
+    {
+        add_variant(variants, UCP_FEATURE_TAG | UCP_FEATURE_AM |
+                              UCP_FEATURE_RMA);
+    }
+
+    virtual void init()
+    {
+#ifndef HAVE_PROFILING
+        UCS_TEST_SKIP_R("profiling is disabled");
+#endif
+        ucp_test::init();
+
+        m_receiver = &receiver();
+        sender().connect(m_receiver, get_ep_params());
+
+        /* Second peer of the sender, to check endpoints are recorded. It
+         * becomes the last entity, so the first receiver is kept aside. */
+        m_peer2 = create_entity();
+        sender().connect(m_peer2, get_ep_params(), 1);
+
+        m_file_name = "test_ucp_replay." + ucs::to_string(getpid()) + ".prof";
+    }
+
+    virtual void cleanup()
+    {
+        unlink(m_file_name.c_str());
+        ucp_test::cleanup();
+    }
+
+protected:
+    struct record {
+        std::string op;
+        uint32_t    length;
+        uint64_t    peer;
+        uint64_t    dt_class;
+    };
+
+    static const uint16_t AM_ID      = 1;
+    static const size_t   RNDV_SIZE  = 256 * UCS_KBYTE;
+    static const size_t   RECV_SIZE  = 4 * UCS_KBYTE;
+
+    void start_profile()
+    {
+        ucs_profile_reset_locations_id(ucs_profile_default_ctx);
+        ucs_profile_cleanup(ucs_profile_default_ctx);
+        push_config();
+        modify_config("PROFILE_MODE", "log");
+        modify_config("PROFILE_FILE", m_file_name.c_str());
+        ucs_profile_init(ucs_global_opts.profile_mode,
+                         ucs_global_opts.profile_file,
+                         ucs_global_opts.profile_log_size,
+                         &ucs_profile_default_ctx);
+    }
+
+    std::vector<record> stop_profile()
+    {
+        ucs_profile_dump(ucs_profile_default_ctx);
+        /* Read before cleanup, which rewrites the file without the records
+         * of the threads which were already dumped */
+        std::vector<record> records = read_records();
+
+        ucs_profile_reset_locations_id(ucs_profile_default_ctx);
+        ucs_profile_cleanup(ucs_profile_default_ctx);
+        pop_config();
+        ucs_profile_init(ucs_global_opts.profile_mode,
+                         ucs_global_opts.profile_file,
+                         ucs_global_opts.profile_log_size,
+                         &ucs_profile_default_ctx);
+        return records;
+    }
+
+    std::vector<record> read_records() const
+    {
+        std::ifstream f(m_file_name.c_str());
+        std::string data((std::istreambuf_iterator<char>(f)),
+                         std::istreambuf_iterator<char>());
+        std::vector<record> records;
+
+        EXPECT_GE(data.size(), sizeof(ucs_profile_header_t));
+        if (data.size() < sizeof(ucs_profile_header_t)) {
+            return records;
+        }
+
+        auto header    = reinterpret_cast<const ucs_profile_header_t*>(
+                                 data.data());
+        auto locations = reinterpret_cast<const ucs_profile_location_t*>(
+                                 data.data() + header->locations.offset);
+        size_t num_locations = header->locations.size /
+                               sizeof(ucs_profile_location_t);
+        const char *ptr      = data.data() + header->threads.offset;
+        const char *end      = ptr + header->threads.size;
+
+        while (ptr < end) {
+            auto thread = reinterpret_cast<const ucs_profile_thread_header_t*>(
+                                  ptr);
+            ptr += sizeof(*thread) + (num_locations *
+                                      sizeof(ucs_profile_thread_location_t));
+
+            auto rec = reinterpret_cast<const ucs_profile_record_t*>(ptr);
+            for (uint64_t i = 0; i < thread->num_records; ++i, ++rec) {
+                const ucs_profile_location_t *loc = &locations[rec->location];
+                std::string name(loc->name, strnlen(loc->name,
+                                                    sizeof(loc->name)));
+                if (name.find(UCP_API_RECORD_PREFIX) != 0) {
+                    continue;
+                }
+
+                records.push_back({name.substr(strlen(UCP_API_RECORD_PREFIX)),
+                                   rec->param32,
+                                   UCP_API_RECORD_PEER(rec->param64),
+                                   UCP_API_RECORD_DT_CLASS(rec->param64)});
+            }
+            ptr = reinterpret_cast<const char*>(rec);
+        }
+
+        return records;
+    }
+
+    static ucs_status_t
+    am_cb(void *arg, const void *header, size_t header_length, void *data,
+          size_t length, const ucp_am_recv_param_t *param)
+    {
+        test_ucp_replay *self = static_cast<test_ucp_replay*>(arg);
+
+        if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+            self->m_am_rndv_data = data;
+            return UCS_INPROGRESS;
+        }
+
+        return UCS_OK;
+    }
+
+    void set_am_handler(entity &e)
+    {
+        ucp_am_handler_param_t param;
+
+        param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID |
+                           UCP_AM_HANDLER_PARAM_FIELD_CB |
+                           UCP_AM_HANDLER_PARAM_FIELD_ARG;
+        param.id         = AM_ID;
+        param.cb         = am_cb;
+        param.arg        = this;
+        ASSERT_UCS_OK(ucp_worker_set_am_recv_handler(e.worker(), &param));
+    }
+
+    void tag_send_recv(entity &receiver_e, ucp_ep_h ep, ucp_tag_t tag,
+                       const ucp_dt_iov_t *iov, size_t iovcnt, size_t length)
+    {
+        std::vector<char> recv_buf(RECV_SIZE);
+        std::vector<char> send_buf(length, 's');
+        ucp_request_param_t param;
+
+        param.op_attr_mask = 0;
+        void *rreq = ucp_tag_recv_nbx(receiver_e.worker(), recv_buf.data(),
+                                      recv_buf.size(), tag, (ucp_tag_t)-1,
+                                      &param);
+
+        if (iov != NULL) {
+            param.op_attr_mask = UCP_OP_ATTR_FIELD_DATATYPE;
+            param.datatype     = ucp_dt_make_iov();
+            void *sreq = ucp_tag_send_nbx(ep, iov, iovcnt, tag, &param);
+            ASSERT_UCS_OK(request_wait(sreq));
+        } else {
+            void *sreq = ucp_tag_send_nbx(ep, send_buf.data(), length, tag,
+                                          &param);
+            ASSERT_UCS_OK(request_wait(sreq));
+        }
+
+        ASSERT_UCS_OK(request_wait(rreq));
+    }
+
+    void am_send_rndv()
+    {
+        std::vector<char> send_buf(RNDV_SIZE, 'a');
+        ucp_request_param_t param;
+
+        set_am_handler(*m_receiver);
+
+        m_am_rndv_data     = NULL;
+        param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+        param.flags        = UCP_AM_SEND_FLAG_RNDV;
+        void *sreq = ucp_am_send_nbx(sender().ep(), AM_ID, NULL, 0,
+                                     send_buf.data(), send_buf.size(),
+                                     &param);
+
+        wait_for_flag(&m_am_rndv_data);
+        ASSERT_NE((void*)NULL, m_am_rndv_data);
+        ucp_am_data_release(m_receiver->worker(), m_am_rndv_data);
+        ASSERT_UCS_OK(request_wait(sreq));
+    }
+
+    void put()
+    {
+        mapped_buffer local(sizeof(uint64_t), sender());
+        mapped_buffer remote(sizeof(uint64_t), *m_receiver);
+        ucp_request_param_t param;
+
+        ucs::handle<ucp_rkey_h> rkey = remote.rkey(sender());
+        param.op_attr_mask = 0;
+        void *sreq = ucp_put_nbx(sender().ep(), local.ptr(), local.size(),
+                                 (uint64_t)remote.ptr(), rkey, &param);
+        ASSERT_UCS_OK(request_wait(sreq));
+        flush_ep(sender());
+    }
+
+    static size_t count(const std::vector<record> &records,
+                        const std::string &op)
+    {
+        return std::count_if(records.begin(), records.end(),
+                             [&op](const record &r) { return r.op == op; });
+    }
+
+    void replay(const std::string &args) const
+    {
+#ifdef GTEST_UCX_REPLAY
+        if (access(GTEST_UCX_REPLAY, X_OK) != 0) {
+            UCS_TEST_SKIP_R("ucx_replay was not built");
+        }
+
+        std::string cmd = std::string("timeout 120 ") + GTEST_UCX_REPLAY +
+                          " " + args + " " + m_file_name + " >/dev/null";
+        int ret         = system(cmd.c_str());
+        ASSERT_TRUE(WIFEXITED(ret)) << cmd;
+        EXPECT_EQ(0, WEXITSTATUS(ret)) << cmd;
+#else
+        UCS_TEST_SKIP_R("ucx_replay path is not defined");
+#endif
+    }
+
+    entity            *m_receiver;
+    entity            *m_peer2;
+    std::string       m_file_name;
+    void * volatile   m_am_rndv_data;
+};
+
+UCS_TEST_P(test_ucp_replay, record_and_replay)
+{
+    static const size_t CONTIG_SIZE = 100;
+    std::vector<char> iov_buf(300, 'i');
+    ucp_dt_iov_t iov[3];
+
+    for (size_t i = 0; i < ucs_static_array_size(iov); ++i) {
+        iov[i].buffer = &iov_buf[i * 100];
+        iov[i].length = 100;
+    }
+
+    start_profile();
+    tag_send_recv(*m_receiver, sender().ep(), 1, NULL, 0, CONTIG_SIZE);
+    tag_send_recv(*m_peer2, sender().ep(0, 1), 2, iov,
+                  ucs_static_array_size(iov), iov_buf.size());
+    am_send_rndv();
+    put();
+    std::vector<record> records = stop_profile();
+
+    /* Sends to both peers are recorded, with their datatype */
+    std::set<uint64_t> peers;
+    for (const record &r : records) {
+        if (r.op == UCP_API_RECORD_OP_TAG_SEND) {
+            peers.insert(r.peer);
+            if (r.peer == UCP_API_RECORD_PEER((uintptr_t)sender().ep())) {
+                EXPECT_EQ(CONTIG_SIZE, r.length);
+                EXPECT_EQ((uint64_t)UCP_DATATYPE_CONTIG, r.dt_class);
+            } else {
+                EXPECT_EQ(iov_buf.size(), r.length);
+                EXPECT_EQ((uint64_t)UCP_DATATYPE_IOV, r.dt_class);
+            }
+        }
+    }
+    EXPECT_EQ(2u, peers.size());
+
+    /* Receives are recorded with the received length, not the buffer size */
+    std::set<uint32_t> recv_lengths;
+    for (const record &r : records) {
+        if (r.op == UCP_API_RECORD_OP_TAG_RECV) {
+            recv_lengths.insert(r.length);
+        }
+    }
+    EXPECT_EQ((std::set<uint32_t>{CONTIG_SIZE, (uint32_t)iov_buf.size()}),
+              recv_lengths);
+
+    EXPECT_EQ(1u, count(records, UCP_API_RECORD_OP_AM_SEND));
+    EXPECT_EQ(1u, count(records, UCP_API_RECORD_OP_PUT));
+
+    /* Overlapped replay, and serial replay with recorded pacing */
+    replay("");
+    replay("-w 1 -p");
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_replay, shm, "shm")
@@ -84,6 +84,7 @@ protected:
     }
 
     void send_recv_unexp(bool immediate);
+    void send_recv_compress(size_t size);
     static ucs_status_t m_req_status;
 };
 
@@ -119,6 +120,37 @@ void test_ucp_tag_match::send_recv_unexp(bool immediate)
     EXPECT_EQ(send_data, recv_data);
 }
 
+void test_ucp_tag_match::send_recv_compress(size_t size)
+{
+    std::vector<uint8_t> sendbuf(size, 0);
+    std::vector<uint8_t> recvbuf(size, 0);
+    ucp_tag_recv_info_t info;
+    request *my_send_req;
+    ucs_status_t status;
+
+    /* Sparse buffer which is easy to compress */
+    for (size_t i = 0; i < size; i += 512) {
+        sendbuf[i] = ucs::rand() | 1;
+    }
+
+    my_send_req = send_nb(sendbuf.data(), size, DATATYPE, 0x111337);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(my_send_req));
+
+    status = recv_b(recvbuf.data(), size, DATATYPE, 0x1337, 0xffff, &info);
+    ASSERT_UCS_OK(status);
+    wait_and_validate(my_send_req);
+
+    EXPECT_EQ(size, info.length);
+    EXPECT_EQ(sendbuf, recvbuf);
+
+    if (has_transport("tcp")) {
+        /* Compression pays off on a slow transport, so staging buffers were
+         * used to compress and decompress the data */
+        EXPECT_GT(sender().worker()->compress.tx_size, 0u);
+        EXPECT_GT(receiver().worker()->compress.rx_size, 0u);
+    }
+}
+
 UCS_TEST_P(test_ucp_tag_match, send_recv_unexp)
 {
     send_recv_unexp(false);
@@ -534,6 +566,20 @@ UCS_TEST_P(test_ucp_tag_match, send_nb_multiple_recv_unexp) {
     }
 }
 
+UCS_TEST_SKIP_COND_P(test_ucp_tag_match, send_recv_eager_compress,
+                     use_proto_v1(), "RNDV_THRESH=inf", "COMPRESS=y",
+                     "COMPRESS_RATIO=100", "COMPRESS_BW=100GBs")
+{
+    send_recv_compress(256 * UCS_KBYTE);
+}
+
+UCS_TEST_SKIP_COND_P(test_ucp_tag_match, send_recv_rndv_compress,
+                     use_proto_v1(), "RNDV_THRESH=0", "RNDV_SCHEME=am",
+                     "COMPRESS=y", "COMPRESS_RATIO=100", "COMPRESS_BW=100GBs")
+{
+    send_recv_compress(UCS_MBYTE);
+}
+
 UCS_TEST_P(test_ucp_tag_match, sync_send_unexp) {
     ucp_tag_recv_info_t info;
     ucs_status_t        status;
@@ -566,6 +612,95 @@ UCS_TEST_P(test_ucp_tag_match, sync_send_unexp) {
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match)
 
+class test_ucp_tag_match_coalesce : public test_ucp_tag {
+public:
+    test_ucp_tag_match_coalesce()
+    {
+        stats_activate();
+    }
+
+    ~test_ucp_tag_match_coalesce()
+    {
+        stats_restore();
+    }
+
+protected:
+    void check_coalesced(unsigned num_sends)
+    {
+#ifdef ENABLE_STATS
+        ucs_stats_node_t *stats = sender().worker()->stats;
+        uint64_t num_msgs       = UCS_STATS_GET_COUNTER(
+                stats, UCP_WORKER_STAT_COALESCE_TX_MSG);
+        uint64_t num_frames     = UCS_STATS_GET_COUNTER(
+                stats, UCP_WORKER_STAT_COALESCE_TX_FRAME);
+
+        UCS_TEST_MESSAGE << num_msgs << " of " << num_sends
+                         << " messages coalesced to " << num_frames
+                         << " frames";
+        if (has_transport("self") || has_transport("tcp")) {
+            /* Self transport never runs out of send resources, and tcp gets
+             * them back as soon as the socket accepts more data, so messages
+             * are not accumulated */
+            return;
+        }
+
+        EXPECT_GT(num_msgs, 0u);
+        EXPECT_LT(num_frames, num_msgs);
+#endif
+    }
+};
+
+/* Small socket buffers make tcp run out of send resources */
+UCS_TEST_P(test_ucp_tag_match_coalesce, send_nb_multiple_recv,
+           "COALESCE_THRESH=64", "TCP_SNDBUF?=4k", "TCP_RCVBUF?=4k")
+{
+    const unsigned num_requests = 10000 / ucs::test_time_multiplier();
+    std::vector<request*> send_reqs;
+    std::vector<uint64_t> send_data(num_requests);
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+    uint64_t recv_data = 0;
+
+    skip_loopback();
+
+    /* Messages are coalesced only after the lanes are connected, so
+     * complete the wireup first */
+    send_b(&recv_data, sizeof(recv_data), DATATYPE, 0x111336);
+    status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, 0, 0, &info);
+    ASSERT_UCS_OK(status);
+
+    /* Send without progress to run out of send resources, so the following
+     * messages are coalesced */
+    for (unsigned i = 0; i < num_requests; ++i) {
+        send_data[i] = i;
+        request *req = send_nb(&send_data[i], sizeof(send_data[i]), DATATYPE,
+                               0x111337 + i);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(req));
+        if (req != NULL) {
+            send_reqs.push_back(req);
+        }
+    }
+
+    for (unsigned i = 0; i < num_requests; ++i) {
+        status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, 0, 0, &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(sizeof(recv_data), info.length);
+        EXPECT_EQ((ucp_tag_t)(0x111337 + i), info.sender_tag);
+        EXPECT_EQ(i, recv_data);
+    }
+
+    for (std::vector<request*>::iterator it = send_reqs.begin();
+         it != send_reqs.end(); ++it) {
+        wait_for_flag(&(*it)->completed);
+        EXPECT_EQ(UCS_OK, (*it)->status);
+        request_free(*it);
+    }
+
+    check_coalesced(num_requests);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match_coalesce)
+
 class test_ucp_tag_match_rndv : public test_ucp_tag_match {
 public:
     enum {
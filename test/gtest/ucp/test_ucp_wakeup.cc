@@ -42,6 +42,33 @@ protected:
         ASSERT_EQ(UCS_OK, status);
     }
 
+    typedef struct {
+        ucp_ep_h     ep;
+        ucp_worker_h worker;
+        uint64_t     *data;
+        uint64_t     tag;
+        unsigned     delay_us;
+    } delayed_send_t;
+
+    /* Send from another thread, while the receiver waits for the data */
+    static void *delayed_send(void *arg) {
+        delayed_send_t *send = reinterpret_cast<delayed_send_t*>(arg);
+        void *req;
+
+        usleep(send->delay_us);
+        req = ucp_tag_send_nb(send->ep, send->data, sizeof(*send->data),
+                              ucp_dt_make_contig(1), send->tag,
+                              send_completion);
+        if (UCS_PTR_IS_PTR(req)) {
+            while (!ucp_request_is_completed(req)) {
+                ucp_worker_progress(send->worker);
+            }
+            ucp_request_release(req);
+        }
+
+        return NULL;
+    }
+
     static size_t comp_cntr;
 };
 
@@ -148,6 +175,80 @@ UCS_TEST_SKIP_COND_P(test_ucp_wakeup, tx_wait, has_transport("tcp"),
     EXPECT_EQ(send_data, recv_data);
 }
 
+/* An idle TCP interface skips polling its sockets, but it must still deliver
+ * the data, and ucp_worker_wait() must wake up for it. When the interface is
+ * armed, it polls the sockets on the next progress call, so the receive
+ * completes after a few wakeups instead of spinning until the poll backoff
+ * expires. */
+UCS_TEST_SKIP_COND_P(test_ucp_wakeup, tcp_poll_backoff, !has_transport("tcp"),
+                     "TCP_POLL_BACKOFF_MAX?=1s")
+{
+    const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
+    const uint64_t TAG            = 0xdeadbeef;
+    const unsigned MAX_WAKEUPS    = 100;
+    ucp_worker_h recv_worker      = receiver().worker();
+    uint64_t send_data, recv_data;
+    delayed_send_t send;
+    pthread_t thread;
+    unsigned num_wakeups;
+    void *req;
+
+    sender().connect(&receiver(), get_ep_params());
+
+    /* Establish the connection, which needs progress on both sides */
+    send_data = 1;
+    req       = ucp_tag_send_nb(sender().ep(), &send_data, sizeof(send_data),
+                                DATATYPE, TAG, send_completion);
+    if (UCS_PTR_IS_PTR(req)) {
+        wait(req);
+    } else {
+        ASSERT_UCS_OK(UCS_PTR_STATUS(req));
+    }
+
+    req = ucp_tag_recv_nb(recv_worker, &recv_data, sizeof(recv_data),
+                          DATATYPE, TAG, (ucp_tag_t)-1, recv_completion);
+    wait(req);
+    EXPECT_EQ(send_data, recv_data);
+    flush_worker(sender());
+
+    send.ep       = sender().ep();
+    send.worker   = sender().worker();
+    send.data     = &send_data;
+    send.tag      = TAG;
+    send.delay_us = 50000;
+
+    for (send_data = 2; send_data < 5; ++send_data) {
+        recv_data = 0;
+        req       = ucp_tag_recv_nb(recv_worker, &recv_data,
+                                    sizeof(recv_data), DATATYPE, TAG,
+                                    (ucp_tag_t)-1, recv_completion);
+
+        /* Let the receiver back off from polling the idle sockets */
+        ucs_time_t deadline = ucs_get_time() + ucs_time_from_msec(200);
+        while (ucs_get_time() < deadline) {
+            ucp_worker_progress(recv_worker);
+        }
+
+        pthread_create(&thread, NULL, delayed_send, &send);
+
+        num_wakeups = 0;
+        while (!ucp_request_is_completed(req) &&
+               (num_wakeups < MAX_WAKEUPS)) {
+            if (ucp_worker_progress(recv_worker)) {
+                continue;
+            }
+
+            EXPECT_UCS_OK(ucp_worker_wait(recv_worker));
+            ++num_wakeups;
+        }
+
+        pthread_join(thread, NULL);
+        EXPECT_LT(num_wakeups, MAX_WAKEUPS);
+        wait(req);
+        EXPECT_EQ(send_data, recv_data);
+    }
+}
+
 UCS_TEST_P(test_ucp_wakeup, signal)
 {
     int efd;
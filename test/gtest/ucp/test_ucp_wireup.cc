@@ -22,6 +22,7 @@ extern "C" {
 #include <ucp/wireup/wireup_ep.h>
 #include <ucp/core/ucp_ep.inl>
 #include <ucs/sys/math.h>
+#include <uct/base/uct_iface.h>
 }
 
 class test_ucp_wireup : public ucp_test {
@@ -37,7 +38,8 @@ protected:
         UNIFIED_MODE   = UCS_BIT(3),
         TEST_AMO       = UCS_BIT(4),
         NO_EP_MATCH    = UCS_BIT(5),
-        WORKER_ADDR_V2 = UCS_BIT(6)
+        WORKER_ADDR_V2 = UCS_BIT(6),
+        WORKER_ADDR_V3 = UCS_BIT(7)
     };
 
     typedef uint64_t               elem_type;
@@ -88,20 +90,33 @@ protected:
     bool ep_iface_has_caps(const entity& e, const std::string& tl,
                            uint64_t caps);
 
+    void mock_remote_node(const entity &e);
+
 protected:
     vec_type                               m_send_data;
     vec_type                               m_recv_data;
     ucs::handle<ucp_mem_h, ucp_context_h>  m_memh_sender;
     ucs::handle<ucp_mem_h, ucp_context_h>  m_memh_receiver;
     std::vector< ucs::handle<ucp_rkey_h> > m_rkeys;
+    ucs::mock                              m_mock;
 
 private:
     static void stream_recv_completion(void *request, ucs_status_t status,
                                        size_t length);
 
     static void unmap_memh(ucp_mem_h memh, ucp_context_h context);
+
+    static int
+    is_reachable_mock(const uct_iface_h tl_iface,
+                      const uct_iface_is_reachable_params_t *params);
+
+    static std::map<uct_iface_is_reachable_v2_func_t*,
+                    uct_iface_is_reachable_v2_func_t> m_orig_is_reachable;
 };
 
+std::map<uct_iface_is_reachable_v2_func_t*, uct_iface_is_reachable_v2_func_t>
+        test_ucp_wireup::m_orig_is_reachable;
+
 void test_ucp_wireup::get_test_variants(std::vector<ucp_test_variant>& variants,
                                         uint64_t features, bool test_all)
 {
@@ -132,6 +147,11 @@ void test_ucp_wireup::get_test_variants(std::vector<ucp_test_variant>& variants,
         add_variant_with_value(variants, UCP_FEATURE_TAG,
                                TEST_TAG | WORKER_ADDR_V2 | UNIFIED_MODE,
                                "tag,unified,addr_v2");
+        add_variant_with_value(variants, UCP_FEATURE_TAG,
+                               TEST_TAG | WORKER_ADDR_V3, "tag,addr_v3");
+        add_variant_with_value(variants, UCP_FEATURE_TAG,
+                               TEST_TAG | WORKER_ADDR_V3 | UNIFIED_MODE,
+                               "tag,unified,addr_v3");
     }
 
     if (features & UCP_FEATURE_STREAM) {
@@ -171,6 +191,8 @@ void test_ucp_wireup::init()
 
     if (get_variant_value() & WORKER_ADDR_V2) {
         modify_config("ADDRESS_VERSION", "v2");
+    } else if (get_variant_value() & WORKER_ADDR_V3) {
+        modify_config("ADDRESS_VERSION", "v3");
     }
 
     ucp_test::init();
@@ -239,6 +261,7 @@ void test_ucp_wireup::memhs_cleanup() {
 }
 
 void test_ucp_wireup::cleanup() {
+    m_mock.cleanup();
     rkeys_cleanup();
     memhs_cleanup();
     ucp_test::cleanup();
@@ -431,6 +454,38 @@ bool test_ucp_wireup::ep_iface_has_caps(const entity& e, const std::string& tl,
     return false;
 }
 
+/* Make all peers look as if they are on another node, by hiding the
+ * device-scope reachability of the local interfaces */
+void test_ucp_wireup::mock_remote_node(const entity &e)
+{
+    for (unsigned i = 0; i < e.worker()->num_ifaces; ++i) {
+        uct_base_iface_t *iface = ucs_derived_of(e.worker()->ifaces[i]->iface,
+                                                 uct_base_iface_t);
+        auto *func_p            = &iface->internal_ops->iface_is_reachable_v2;
+
+        if (m_orig_is_reachable.find(func_p) == m_orig_is_reachable.end()) {
+            m_orig_is_reachable[func_p] = *func_p;
+        }
+
+        m_mock.setup(func_p, is_reachable_mock);
+    }
+}
+
+int test_ucp_wireup::is_reachable_mock(
+        const uct_iface_h tl_iface,
+        const uct_iface_is_reachable_params_t *params)
+{
+    uct_base_iface_t *iface = ucs_derived_of(tl_iface, uct_base_iface_t);
+
+    if ((params->field_mask & UCT_IFACE_IS_REACHABLE_FIELD_SCOPE) &&
+        (params->scope == UCT_IFACE_REACHABILITY_SCOPE_DEVICE)) {
+        return 0;
+    }
+
+    return m_orig_is_reachable.at(&iface->internal_ops->iface_is_reachable_v2)(
+            tl_iface, params);
+}
+
 class test_ucp_wireup_1sided : public test_ucp_wireup {
 public:
     static void get_test_variants(std::vector<ucp_test_variant>& variants)
@@ -446,8 +501,65 @@ public:
     }
 
     ucp_object_version_t address_version() const {
-        return (get_variant_value() & WORKER_ADDR_V2) ?
-               UCP_OBJECT_VERSION_V2 : UCP_OBJECT_VERSION_V1;
+        if (get_variant_value() & WORKER_ADDR_V2) {
+            return UCP_OBJECT_VERSION_V2;
+        } else if (get_variant_value() & WORKER_ADDR_V3) {
+            return UCP_OBJECT_VERSION_V3;
+        }
+
+        return UCP_OBJECT_VERSION_V1;
+    }
+
+    void pack_address(ucp_ep_h ep, ucp_object_version_t addr_v, size_t *size_p,
+                      void **buffer_p)
+    {
+        ucs_status_t status = ucp_address_pack(sender().worker(), ep,
+                                               &ucp_tl_bitmap_max,
+                                               UCP_ADDRESS_PACK_FLAGS_ALL,
+                                               addr_v, m_lanes2remote,
+                                               UINT_MAX, size_p, buffer_p);
+        ASSERT_UCS_OK(status);
+    }
+
+    static void
+    expect_equal_addresses(const ucp_unpacked_address_t *addr1,
+                           const ucp_unpacked_address_t *addr2)
+    {
+        ASSERT_EQ(addr1->address_count, addr2->address_count);
+        EXPECT_EQ(addr1->uuid, addr2->uuid);
+
+        for (unsigned i = 0; i < addr1->address_count; ++i) {
+            const ucp_address_entry_t *ae1 = &addr1->address_list[i];
+            const ucp_address_entry_t *ae2 = &addr2->address_list[i];
+
+            EXPECT_EQ(ae1->tl_name_csum, ae2->tl_name_csum);
+            EXPECT_EQ(ae1->md_index, ae2->md_index);
+            EXPECT_EQ(ae1->sys_dev, ae2->sys_dev);
+            EXPECT_EQ(ae1->dev_index, ae2->dev_index);
+            EXPECT_EQ(ae1->dev_num_paths, ae2->dev_num_paths);
+            ASSERT_EQ(ae1->dev_addr_len, ae2->dev_addr_len);
+            EXPECT_EQ(0, memcmp(ae1->dev_addr, ae2->dev_addr,
+                                ae1->dev_addr_len));
+            ASSERT_EQ(ae1->iface_addr_len, ae2->iface_addr_len);
+            EXPECT_EQ(0, memcmp(ae1->iface_addr, ae2->iface_addr,
+                                ae1->iface_addr_len));
+            EXPECT_EQ(ae1->iface_attr.flags, ae2->iface_attr.flags);
+            EXPECT_EQ(ae1->iface_attr.priority, ae2->iface_attr.priority);
+            EXPECT_EQ(ae1->iface_attr.seg_size, ae2->iface_attr.seg_size);
+            EXPECT_DOUBLE_EQ(ae1->iface_attr.overhead,
+                             ae2->iface_attr.overhead);
+            EXPECT_DOUBLE_EQ(ae1->iface_attr.bandwidth,
+                             ae2->iface_attr.bandwidth);
+            EXPECT_DOUBLE_EQ(ae1->iface_attr.lat_ovh, ae2->iface_attr.lat_ovh);
+            ASSERT_EQ(ae1->num_ep_addrs, ae2->num_ep_addrs);
+            for (unsigned j = 0; j < ae1->num_ep_addrs; ++j) {
+                EXPECT_EQ(ae1->ep_addrs[j].lane, ae2->ep_addrs[j].lane);
+                ASSERT_EQ(ae1->ep_addrs[j].len, ae2->ep_addrs[j].len);
+                EXPECT_EQ(0, memcmp(ae1->ep_addrs[j].addr,
+                                    ae2->ep_addrs[j].addr,
+                                    ae1->ep_addrs[j].len));
+            }
+        }
     }
 
     ucp_lane_index_t m_lanes2remote[UCP_MAX_LANES];
@@ -537,6 +649,61 @@ UCS_TEST_P(test_ucp_wireup_1sided, ep_address, "IB_NUM_PATHS?=2") {
     ucs_free(buffer);
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, compact_address, "IB_NUM_PATHS?=2") {
+    const unsigned count = 10000 / ucs::test_time_multiplier();
+    ucp_unpacked_address unpacked_v2, unpacked_v3;
+    size_t size_v2, size_v3;
+    void *buffer_v2, *buffer_v3;
+    ucs_status_t status;
+
+    sender().connect(&receiver(), get_ep_params());
+
+    pack_address(sender().ep(), UCP_OBJECT_VERSION_V2, &size_v2, &buffer_v2);
+    pack_address(sender().ep(), UCP_OBJECT_VERSION_V3, &size_v3, &buffer_v3);
+
+    status = ucp_address_unpack(sender().worker(), buffer_v2,
+                                UCP_ADDRESS_PACK_FLAGS_ALL, &unpacked_v2);
+    ASSERT_UCS_OK(status);
+    status = ucp_address_unpack(sender().worker(), buffer_v3,
+                                UCP_ADDRESS_PACK_FLAGS_ALL, &unpacked_v3);
+    ASSERT_UCS_OK(status);
+
+    EXPECT_EQ(UCP_OBJECT_VERSION_V3, unpacked_v3.addr_version);
+    expect_equal_addresses(&unpacked_v2, &unpacked_v3);
+    if (!(get_variant_value() & UNIFIED_MODE)) {
+        /* In unified mode iface attributes are not packed, so the transport
+         * names dictionary may exceed the savings of a small address */
+        EXPECT_LE(size_v3, size_v2);
+    }
+
+    ucs_time_t start_time = ucs_get_time();
+    for (unsigned i = 0; i < count; ++i) {
+        ucs_free(buffer_v3);
+        pack_address(sender().ep(), UCP_OBJECT_VERSION_V3, &size_v3,
+                     &buffer_v3);
+    }
+    ucs_time_t pack_time = ucs_get_time() - start_time;
+
+    start_time = ucs_get_time();
+    for (unsigned i = 0; i < count; ++i) {
+        ucs_free(unpacked_v3.address_list);
+        status = ucp_address_unpack(sender().worker(), buffer_v3,
+                                    UCP_ADDRESS_PACK_FLAGS_ALL, &unpacked_v3);
+        ASSERT_UCS_OK(status);
+    }
+    ucs_time_t unpack_time = ucs_get_time() - start_time;
+
+    UCS_TEST_MESSAGE << "address size v2: " << size_v2 << " v3: " << size_v3
+                     << ", v3 pack: " << (ucs_time_to_nsec(pack_time) / count)
+                     << " ns, unpack: "
+                     << (ucs_time_to_nsec(unpack_time) / count) << " ns";
+
+    ucs_free(unpacked_v2.address_list);
+    ucs_free(unpacked_v3.address_list);
+    ucs_free(buffer_v2);
+    ucs_free(buffer_v3);
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, empty_address) {
     ucs_status_t status;
     size_t size;
@@ -940,6 +1107,226 @@ UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_2sided)
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_wireup_2sided,
                               tcp_aux, "tcp,rc_verbs")
 
+class test_ucp_wireup_lazy : public test_ucp_wireup {
+public:
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        test_ucp_wireup::get_test_variants(variants,
+                                           UCP_FEATURE_RMA | UCP_FEATURE_TAG);
+    }
+
+protected:
+    virtual void init()
+    {
+        modify_config("WIREUP_LAZY", "y");
+        test_ucp_wireup::init();
+    }
+
+    bool is_lazy(ucp_ep_h ep) const
+    {
+        return ep->flags & UCP_EP_FLAG_LAZY_CONNECT;
+    }
+};
+
+UCS_TEST_P(test_ucp_wireup_lazy, connect_on_first_use) {
+    skip_loopback();
+
+    sender().connect(&receiver(), get_ep_params());
+    EXPECT_TRUE(is_lazy(sender().ep()));
+
+    /* The endpoint is not connected by progress or flush */
+    short_progress_loop();
+    flush_worker(sender());
+    EXPECT_TRUE(is_lazy(sender().ep()));
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 1, 1);
+    EXPECT_FALSE(is_lazy(sender().ep()));
+    flush_worker(sender());
+}
+
+UCS_TEST_P(test_ucp_wireup_lazy, two_sided) {
+    skip_loopback();
+
+    sender().connect(&receiver(), get_ep_params());
+    receiver().connect(&sender(), get_ep_params());
+
+    send_recv(sender().ep(), receiver().worker(), receiver().ep(), 8, 1);
+    send_recv(receiver().ep(), sender().worker(), sender().ep(), 8, 1);
+    flush_worker(sender());
+    flush_worker(receiver());
+}
+
+UCS_TEST_P(test_ucp_wireup_lazy, close_unused) {
+    const unsigned count = 10;
+
+    skip_loopback();
+
+    for (unsigned i = 0; i < count; ++i) {
+        sender().connect(&receiver(), get_ep_params(), i);
+    }
+
+    for (unsigned i = 0; i < count; ++i) {
+        EXPECT_TRUE(is_lazy(sender().ep(0, i)));
+        disconnect(sender().revoke_ep(0, i));
+    }
+
+    /* The peer did not get any wireup message */
+    short_progress_loop();
+    EXPECT_EQ(0u, receiver().worker()->num_all_eps);
+}
+
+UCS_TEST_P(test_ucp_wireup_lazy, select_cache) {
+    const unsigned count = 4;
+
+    skip_loopback();
+
+    for (unsigned i = 0; i < count; ++i) {
+        sender().connect(&receiver(), get_ep_params(), i);
+        send_recv(sender().ep(0, i), receiver().worker(), NULL, 1, 1);
+    }
+
+    /* All endpoints to the same peer share the selection result */
+    EXPECT_EQ(1u, kh_size(&sender().worker()->select_cache));
+    for (unsigned i = 1; i < count; ++i) {
+        EXPECT_EQ(sender().ep(0, 0)->cfg_index, sender().ep(0, i)->cfg_index);
+    }
+}
+
+UCS_TEST_P(test_ucp_wireup_lazy, select_cache_peers) {
+    skip_loopback();
+
+    if (!(get_variant_value() & TEST_TAG)) {
+        UCS_TEST_SKIP_R("RMA test buffers are mapped only on the receiver");
+    }
+
+    /* The new entity becomes the last one, so keep the original receiver */
+    entity *local_peer    = &receiver();
+    entity *remote_peer   = create_entity();
+    ucp_context_h context = sender().ucph();
+
+    sender().connect(local_peer, get_ep_params(), 0);
+    sender().connect(remote_peer, get_ep_params(), 1);
+    sender().connect(remote_peer, get_ep_params(), 2);
+
+    /* Each endpoint is connected to its own peer, with the same selection as
+     * a non-lazy endpoint to a peer on another node */
+    send_recv(sender().ep(0, 0), local_peer->worker(), NULL, 1, 1);
+    mock_remote_node(sender());
+    send_recv(sender().ep(0, 1), remote_peer->worker(), NULL, 1, 1);
+
+    int select_cache_orig = context->config.ext.wireup_select_cache;
+    context->config.ext.wireup_select_cache = 0;
+    send_recv(sender().ep(0, 2), remote_peer->worker(), NULL, 1, 1);
+    context->config.ext.wireup_select_cache = select_cache_orig;
+    m_mock.cleanup();
+
+    EXPECT_EQ(sender().ep(0, 2)->cfg_index, sender().ep(0, 1)->cfg_index);
+    if (sender().ep(0, 0)->cfg_index != sender().ep(0, 1)->cfg_index) {
+        EXPECT_EQ(2u, kh_size(&sender().worker()->select_cache));
+    }
+
+    flush_worker(sender());
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_lazy)
+
+class test_ucp_wireup_select_cache : public test_ucp_wireup {
+public:
+    static void get_test_variants_features(
+            std::vector<ucp_test_variant>& variants)
+    {
+        test_ucp_wireup::get_test_variants(variants, UCP_FEATURE_TAG);
+    }
+
+    static void get_test_variants(std::vector<ucp_test_variant>& variants)
+    {
+        add_variant_values(variants, get_test_variants_features, 0);
+        add_variant_values(variants, get_test_variants_features, 1,
+                           "no_select_cache");
+    }
+
+protected:
+    virtual void init()
+    {
+        if (!select_cache()) {
+            modify_config("WIREUP_SELECT_CACHE", "n");
+        }
+
+        test_ucp_wireup::init();
+    }
+
+    bool select_cache() const
+    {
+        return get_variant_value(1) == 0;
+    }
+};
+
+UCS_TEST_P(test_ucp_wireup_select_cache, ep_create_rate) {
+    const unsigned count = 100 / ucs::test_time_multiplier();
+
+    skip_loopback();
+
+    ucs_time_t start_time = ucs_get_time();
+    for (unsigned i = 0; i < count; ++i) {
+        sender().connect(&receiver(), get_ep_params(), i);
+    }
+    ucs_time_t elapsed = ucs_get_time() - start_time;
+
+    UCS_TEST_MESSAGE << "lane selection cache "
+                     << (select_cache() ? "enabled" : "disabled") << ": "
+                     << (count / ucs_time_to_sec(elapsed)) << " ep/sec";
+
+    EXPECT_EQ(select_cache() ? 1u : 0u,
+              kh_size(&sender().worker()->select_cache));
+    for (unsigned i = 1; i < count; ++i) {
+        EXPECT_EQ(sender().ep(0, 0)->cfg_index, sender().ep(0, i)->cfg_index);
+    }
+
+    send_recv(sender().ep(0, count - 1), receiver().worker(), NULL, 1, 1);
+    flush_worker(sender());
+}
+
+UCS_TEST_P(test_ucp_wireup_select_cache, peer_locality) {
+    skip_loopback();
+
+    /* The new entity becomes the last one, so keep the original receiver */
+    entity *local_peer    = &receiver();
+    entity *remote_peer   = create_entity();
+    ucp_context_h context = sender().ucph();
+
+    /* Populate the cache with a peer on the same node */
+    sender().connect(local_peer, get_ep_params(), 0);
+
+    /* Peer with the same capabilities on another node must not reuse the
+     * intra-node selection, and must get the same configuration as without
+     * the cache */
+    mock_remote_node(sender());
+    sender().connect(remote_peer, get_ep_params(), 1);
+
+    int select_cache_orig = context->config.ext.wireup_select_cache;
+    context->config.ext.wireup_select_cache = 0;
+    sender().connect(remote_peer, get_ep_params(), 2);
+    context->config.ext.wireup_select_cache = select_cache_orig;
+    m_mock.cleanup();
+
+    ucp_ep_h local_ep  = sender().ep(0, 0);
+    ucp_ep_h cached_ep = sender().ep(0, 1);
+    ucp_ep_h fresh_ep  = sender().ep(0, 2);
+    EXPECT_EQ(fresh_ep->cfg_index, cached_ep->cfg_index);
+
+    /* The peers differ only by locality, unless it is determined by a shared
+     * memory lane */
+    bool same_locality = !((ucp_ep_config(local_ep)->key.flags ^
+                            ucp_ep_config(fresh_ep)->key.flags) &
+                           UCP_EP_CONFIG_KEY_FLAG_INTRA_NODE);
+    EXPECT_EQ(same_locality, local_ep->cfg_index == fresh_ep->cfg_index);
+
+    send_recv(sender().ep(0, 1), remote_peer->worker(), NULL, 1, 1);
+    flush_worker(sender());
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_wireup_select_cache)
+
 class test_ucp_wireup_errh_peer : public test_ucp_wireup_1sided
 {
 public:
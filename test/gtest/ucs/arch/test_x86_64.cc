@@ -14,6 +14,8 @@ extern "C" {
 #include <ucs/time/time.h>
 }
 
+#include <cpuid.h>
+#include <fstream>
 #include <sys/mman.h>
 
 class test_arch : public ucs::test {
@@ -198,4 +200,49 @@ UCS_TEST_F(test_arch, nt_buffer_transfer_nt_src_dst) {
     ucs_global_opts.arch.nt_dest_threshold = 0;
     nt_buffer_transfer_test(UCS_ARCH_MEMCPY_NT_SOURCE);
 }
+
+UCS_TEST_F(test_arch, memcpy_calibrate_cache) {
+#ifndef __AVX__
+    UCS_TEST_SKIP_R("Built without AVX support");
+#else
+    const size_t bt_min      = 64 * UCS_KBYTE;
+    const size_t dest_thresh = 128 * UCS_KBYTE;
+    size_t llc_size          = ucs_cpu_get_cache_size(UCS_CPU_CACHE_L3);
+    char dir[]               = "/tmp/ucx_test_memcpy_XXXXXX";
+    unsigned eax, ebx, ecx, edx;
+    char file_name[64];
+
+    if (llc_size == 0) {
+        UCS_TEST_SKIP_R("last level cache size is unknown");
+    }
+
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    modify_config("MEMCPY_CALIBRATE", "y");
+    modify_config("MEMCPY_CALIBRATE_CACHE", dir);
+
+    /* The result is saved per vendor, processor signature and cache size */
+    modify_config("NT_BUFFER_TRANSFER_MIN", "auto");
+    ucs_cpu_init();
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    snprintf(file_name, sizeof(file_name), "ucx_memcpy_%d_%08x_%zu",
+             ucs_arch_get_cpu_vendor(), eax, llc_size);
+    std::string path = std::string(dir) + "/" + file_name;
+    EXPECT_EQ(0, access(path.c_str(), R_OK)) << path;
+
+    /* A saved result is used instead of measuring again */
+    {
+        std::ofstream file(path.c_str());
+        file << bt_min << " " << dest_thresh << std::endl;
+    }
+
+    modify_config("NT_BUFFER_TRANSFER_MIN", "auto");
+    ucs_cpu_init();
+    EXPECT_EQ(bt_min, ucs_global_opts.arch.nt_buffer_transfer_min);
+    EXPECT_EQ(dest_thresh, ucs_global_opts.arch.nt_dest_threshold);
+
+    unlink(path.c_str());
+    rmdir(dir);
+#endif
+}
 #endif
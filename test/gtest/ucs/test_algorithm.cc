@@ -9,7 +9,9 @@ extern "C" {
 #include <ucs/algorithm/crc.h>
 #include <ucs/algorithm/qsort_r.h>
 #include <ucs/algorithm/string_distance.h>
+#include <ucs/algorithm/zrle.h>
 }
+#include <algorithm>
 #include <vector>
 
 class test_algorithm : public ucs::test {
@@ -155,3 +157,69 @@ UCS_TEST_F(test_algorithm, string_distance) {
     EXPECT_EQ(4u, ucs_string_distance("aabbccddeeff", "ababccdgedeff"));
     EXPECT_EQ(6u, ucs_string_distance("aabbccddeeff", "aagbbhddefefii"));
 }
+
+UCS_TEST_F(test_algorithm, zrle) {
+    for (int i = 0; i < 1000 / ucs::test_time_multiplier(); ++i) {
+        size_t length = ucs::rand() % 200000;
+        std::vector<uint8_t> src(length, 0), dst(length + 64), out(length);
+        size_t compressed_length, decompressed_length;
+        ucs_status_t status;
+
+        /* Random runs of zero and non-zero bytes */
+        for (size_t offset = 0; offset < length;) {
+            size_t run = std::min<size_t>(ucs::rand() % 100000, length - offset);
+            if (ucs::rand() % 2) {
+                for (size_t j = offset; j < offset + run; ++j) {
+                    src[j] = ucs::rand() % 4;
+                }
+            }
+            offset += run;
+        }
+
+        status = ucs_zrle_compress(src.data(), length, dst.data(), dst.size(),
+                                   &compressed_length);
+        if (status == UCS_ERR_EXCEEDS_LIMIT) {
+            continue;
+        }
+
+        ASSERT_UCS_OK(status);
+        status = ucs_zrle_decompress(dst.data(), compressed_length, out.data(),
+                                     out.size(), &decompressed_length);
+        ASSERT_UCS_OK(status);
+        ASSERT_EQ(length, decompressed_length);
+        ASSERT_TRUE(src == out);
+
+        /* Output buffer is too small */
+        if (compressed_length > 0) {
+            EXPECT_EQ(UCS_ERR_EXCEEDS_LIMIT,
+                      ucs_zrle_compress(src.data(), length, dst.data(),
+                                        compressed_length - 1,
+                                        &compressed_length));
+        }
+    }
+}
+
+UCS_TEST_F(test_algorithm, zrle_sparse) {
+    std::vector<uint8_t> src(1000000, 0), dst(src.size()), out(src.size());
+    size_t compressed_length, decompressed_length;
+
+    for (size_t offset = 0; offset < src.size(); offset += 4096) {
+        src[offset] = 1;
+    }
+
+    ASSERT_UCS_OK(ucs_zrle_compress(src.data(), src.size(), dst.data(),
+                                    dst.size(), &compressed_length));
+    EXPECT_LT(compressed_length, src.size() / 100);
+
+    /* Truncated data */
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucs_zrle_decompress(dst.data(), compressed_length - 1,
+                                  out.data(), out.size(),
+                                  &decompressed_length));
+
+    ASSERT_UCS_OK(ucs_zrle_decompress(dst.data(), compressed_length,
+                                      out.data(), out.size(),
+                                      &decompressed_length));
+    EXPECT_EQ(src.size(), decompressed_length);
+    EXPECT_TRUE(src == out);
+}
@@ -476,3 +476,43 @@ UCS_TEST_F(test_callbackq, oneshot_ordering) {
     dispatch(100);
     EXPECT_EQ(remaining_user_ids.size(), m_total_count);
 }
+
+UCS_TEST_F(test_callbackq, prof, "PROFILE_PROGRESS=y") {
+    static const unsigned count = UCS_CALLBACKQ_FAST_COUNT + 3;
+    callback_ctx ctx[count], oneshot_ctx;
+    ucs_string_buffer_t strb;
+
+    ASSERT_TRUE(ucs_callbackq_prof_is_enabled(&m_cbq));
+
+    /* Fill the fast-path array, and spill the rest */
+    for (unsigned i = 0; i < count; ++i) {
+        init_ctx(&ctx[i]);
+        add(&ctx[i]);
+    }
+
+    init_ctx(&oneshot_ctx);
+    add_oneshot(&oneshot_ctx);
+
+    EXPECT_EQ(count + 1, dispatch(1));
+    dispatch(9);
+    remove(&ctx[0]);
+
+    for (unsigned i = 0; i < count; ++i) {
+        EXPECT_EQ(10u, ctx[i].count);
+    }
+    EXPECT_EQ(1u, oneshot_ctx.count);
+
+    ucs_string_buffer_init(&strb);
+    ucs_callbackq_prof_dump(&m_cbq, &strb);
+    std::string dump = ucs_string_buffer_cstr(&strb);
+    ucs_string_buffer_cleanup(&strb);
+    UCS_TEST_MESSAGE << dump;
+
+    EXPECT_NE(std::string::npos, dump.find("calls 10 work 10"));
+    EXPECT_NE(std::string::npos, dump.find("(one-shot): calls 1 work 1"));
+    EXPECT_NE(std::string::npos, dump.find("(removed)"));
+
+    for (unsigned i = 1; i < count; ++i) {
+        remove(&ctx[i]);
+    }
+}
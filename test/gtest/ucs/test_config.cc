@@ -794,6 +794,31 @@ UCS_TEST_F(test_config, performance) {
     }
 }
 
+UCS_TEST_F(test_config, performance_fill_opts) {
+    const unsigned num_iters = 10000 / ucs::test_time_multiplier();
+
+    /* Many unrelated variables and a few of ours, like a typical MPI job */
+    ucs::ptr_vector<ucs::scoped_setenv> env;
+    for (unsigned i = 0; i < 300; ++i) {
+        env.push_back(new ucs::scoped_setenv(
+                        (std::string("MTEST") + ucs::to_string(i)).c_str(),
+                        ""));
+    }
+    env.push_back(new ucs::scoped_setenv("UCX_COLOR", "white"));
+    env.push_back(new ucs::scoped_setenv("UCX_PRICE", "100"));
+
+    ucs_time_t start_time = ucs_get_time();
+    for (unsigned i = 0; i < num_iters; ++i) {
+        car_opts opts(UCS_DEFAULT_ENV_PREFIX, NULL);
+        EXPECT_EQ(COLOR_WHITE, opts->color);
+    }
+
+    UCS_TEST_MESSAGE << "fill_opts: "
+                     << ucs_time_to_usec(ucs_get_time() - start_time) /
+                                num_iters
+                     << " usec";
+}
+
 UCS_TEST_F(test_config, unused) {
     ucs::ucx_env_cleanup env_cleanup;
 
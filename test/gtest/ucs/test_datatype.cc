@@ -1437,6 +1437,68 @@ UCS_TEST_F(test_datatype_ptr_map, unsafe_put) {
     UCS_PTR_MAP_DESTROY(unsafe_put, &ptr_map);
 }
 
+UCS_TEST_F(test_datatype_ptr_map, stale_key) {
+    UCS_PTR_MAP_T(unsafe_put) ptr_map;
+    ucs_ptr_map_key_t key, stale_key, live_keys[2];
+    int value1, value2;
+    void *ptr;
+
+    ASSERT_UCS_OK(UCS_PTR_MAP_INIT(unsafe_put, &ptr_map));
+
+    ASSERT_UCS_OK(UCS_PTR_MAP_PUT(unsafe_put, &ptr_map, &value1, 1,
+                                  &stale_key));
+    ASSERT_UCS_OK(UCS_PTR_MAP_DEL(unsafe_put, &ptr_map, stale_key));
+    EXPECT_EQ(UCS_ERR_NO_ELEM, UCS_PTR_MAP_DEL(unsafe_put, &ptr_map,
+                                               stale_key));
+
+    /* The released slot is reused only after all other free slots */
+    ASSERT_UCS_OK(UCS_PTR_MAP_PUT(unsafe_put, &ptr_map, &value2, 1, &key));
+    EXPECT_NE(stale_key >> UCS_PTR_MAP_KEY_INDEX_SHIFT,
+              key >> UCS_PTR_MAP_KEY_INDEX_SHIFT);
+
+    EXPECT_EQ(UCS_ERR_NO_ELEM, UCS_PTR_MAP_GET(unsafe_put, &ptr_map, stale_key,
+                                               0, &ptr));
+    EXPECT_EQ(UCS_ERR_NO_ELEM, UCS_PTR_MAP_DEL(unsafe_put, &ptr_map,
+                                               stale_key));
+    ASSERT_UCS_OK(UCS_PTR_MAP_GET(unsafe_put, &ptr_map, key, 0, &ptr));
+    EXPECT_EQ(&value2, ptr);
+
+    /* Keys beyond the table are not found */
+    EXPECT_EQ(UCS_ERR_NO_ELEM,
+              UCS_PTR_MAP_GET(unsafe_put, &ptr_map,
+                              key + (UCS_BIT(20) <<
+                                     UCS_PTR_MAP_KEY_INDEX_SHIFT),
+                              0, &ptr));
+
+    ASSERT_UCS_OK(UCS_PTR_MAP_GET(unsafe_put, &ptr_map, key, 1, &ptr));
+    EXPECT_EQ(&value2, ptr);
+
+    /* The stale key is still rejected after more put/del cycles than a 16-bit
+     * generation can count, while other keys are alive */
+    for (unsigned i = 0; i < ucs_static_array_size(live_keys); ++i) {
+        ASSERT_UCS_OK(UCS_PTR_MAP_PUT(unsafe_put, &ptr_map, &value1, 1,
+                                      &live_keys[i]));
+    }
+
+    for (unsigned i = 0; i < (2 * UCS_BIT(16)) + 1; ++i) {
+        ASSERT_UCS_OK(UCS_PTR_MAP_PUT(unsafe_put, &ptr_map, &value2, 1,
+                                      &key));
+        ASSERT_TRUE(ucs_ptr_map_key_indirect(key));
+        ASSERT_NE(stale_key, key);
+        ASSERT_UCS_OK(UCS_PTR_MAP_DEL(unsafe_put, &ptr_map, key));
+    }
+
+    EXPECT_EQ(UCS_ERR_NO_ELEM, UCS_PTR_MAP_GET(unsafe_put, &ptr_map, stale_key,
+                                               0, &ptr));
+    for (unsigned i = 0; i < ucs_static_array_size(live_keys); ++i) {
+        ASSERT_UCS_OK(UCS_PTR_MAP_GET(unsafe_put, &ptr_map, live_keys[i], 1,
+                                      &ptr));
+        EXPECT_EQ(&value1, ptr);
+    }
+
+    UCS_PTR_MAP_DESTROY(unsafe_put, &ptr_map);
+}
+
 class test_datatype_ptr_map_safe : public test_datatype_ptr_map {
 public:
     test_datatype_ptr_map_safe()
@@ -107,3 +107,26 @@ UCS_TEST_F(test_lru, pop_oldest) {
     expected.insert(expected.end(), elements2.begin(), elements2.end());
     run(elements2, expected);
 }
+
+UCS_TEST_F(test_lru, remove) {
+    std::vector<uint64_t> elements;
+    init_vector(elements, m_capacity, 0);
+    run(elements, elements);
+
+    EXPECT_TRUE(ucs_lru_remove(m_lru, (void*)elements[3]));
+    EXPECT_FALSE(ucs_lru_remove(m_lru, (void*)elements[3]));
+    EXPECT_FALSE(ucs_lru_is_present(m_lru, (void*)elements[3]));
+
+    /* Remaining elements keep their order, and the freed slot is reused */
+    std::vector<uint64_t> expected(elements);
+    expected.erase(expected.begin() + 3);
+    expected.push_back(uint64_t(m_capacity));
+    ucs_lru_push(m_lru, (void*)m_capacity);
+
+    std::vector<uint64_t> actual;
+    void **item;
+    ucs_lru_for_each(item, m_lru) {
+        actual.insert(actual.begin(), (uint64_t)*item);
+    }
+    EXPECT_EQ(expected, actual);
+}
@@ -212,6 +212,13 @@ protected:
     int m_pipefds[2];
 };
 
+class stats_delta_file_test : public stats_file_test {
+public:
+    virtual std::string stats_dest_config() {
+        return "file:/dev/fd/" + ucs::to_string(m_pipefds[1]) + ":delta";
+    }
+};
+
 class stats_on_demand_test : public stats_udp_test {
 public:
     virtual std::string stats_trigger_config() {
@@ -332,6 +339,53 @@ UCS_TEST_F(stats_file_test, report) {
     ucs_stats_free(root);
 }
 
+UCS_TEST_F(stats_delta_file_test, report) {
+    ucs_stats_node_t       *cat_node;
+    ucs_stats_node_t       *data_nodes[NUM_DATA_NODES] = {NULL};
+    ucs_stats_node_t       *data_node;
+
+    prepare_nodes(&cat_node, data_nodes);
+    ucs_stats_dump();
+    std::string keyframe = get_data();
+
+    /* Nothing changed, so only the delta frame header is written */
+    ucs_stats_dump();
+    std::string unchanged = get_data();
+    EXPECT_LT(unchanged.size(), keyframe.size() / 10);
+
+    UCS_STATS_UPDATE_COUNTER(data_nodes[1], 2, 5);
+    UCS_STATS_SET_COUNTER(data_nodes[3], 0, 1);
+    ucs_stats_dump();
+    std::string delta = get_data();
+    free_nodes(cat_node, data_nodes);
+
+    std::string data = keyframe + unchanged + delta;
+    FILE *f          = fmemopen(&data[0], data.size(), "rb");
+    ucs_stats_node_t *root = NULL;
+
+    ASSERT_UCS_OK(ucs_stats_deserialize_delta(f, &root));
+    check_tree(root, data_nodes);
+    ASSERT_UCS_OK(ucs_stats_deserialize_delta(f, &root));
+    check_tree(root, data_nodes);
+    ASSERT_UCS_OK(ucs_stats_deserialize_delta(f, &root));
+    fclose(f);
+
+    cat_node = ucs_list_head(&root->children[UCS_STATS_ACTIVE_CHILDREN],
+                             ucs_stats_node_t, list);
+    unsigned i = 0;
+    ucs_list_for_each(data_node, &cat_node->children[UCS_STATS_ACTIVE_CHILDREN],
+                      list) {
+        EXPECT_EQ((i == 3) ? 1u : 10u, data_node->counters[0]) << i;
+        EXPECT_EQ(20u, data_node->counters[1]) << i;
+        EXPECT_EQ((i == 1) ? 35u : 30u, data_node->counters[2]) << i;
+        EXPECT_EQ(40u, data_node->counters[3]) << i;
+        ++i;
+    }
+    EXPECT_EQ(unsigned(NUM_DATA_NODES), i);
+
+    ucs_stats_free(root);
+}
+
 UCS_TEST_F(stats_on_demand_test, report) {
     ucs_stats_node_t       *cat_node;
     ucs_stats_node_t       *data_nodes[NUM_DATA_NODES] = {NULL};
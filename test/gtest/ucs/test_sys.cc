@@ -36,6 +36,16 @@ protected:
         EXPECT_EQ(std::string(expected), buf);
     }
 
+    bool module_search_skipped() const {
+        for (const std::string &warning : m_warnings) {
+            if (warning.find("skipping module search") != std::string::npos) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     static void check_cache_type(ucs_cpu_cache_type_t type, const char *name)
     {
         size_t cache;
@@ -145,6 +155,36 @@ UCS_TEST_F(test_sys, module) {
     EXPECT_EQ(1, test_module_loaded);
 }
 
+UCS_TEST_F(test_sys, module_search_skip) {
+    UCS_MODULE_FRAMEWORK_DECLARE(test);
+
+    /* Only built-in transports are requested, so nothing can be loaded */
+    modify_config("MODULES", "self,tcp");
+    modify_config("MODULE_LOG_LEVEL", "warn");
+
+    {
+        scoped_log_handler wrap_warn(wrap_warns_logger);
+        UCS_MODULE_FRAMEWORK_LOAD(test, 0);
+    }
+
+    EXPECT_TRUE(module_search_skipped());
+}
+
+UCS_TEST_F(test_sys, module_search_third_party) {
+    UCS_MODULE_FRAMEWORK_DECLARE(test);
+
+    /* A module which is not built in could be installed separately */
+    modify_config("MODULES", "tcp,nonexistent");
+    modify_config("MODULE_LOG_LEVEL", "warn");
+
+    {
+        scoped_log_handler wrap_warn(wrap_warns_logger);
+        UCS_MODULE_FRAMEWORK_LOAD(test, 0);
+    }
+
+    EXPECT_FALSE(module_search_skipped());
+}
+
 UCS_TEST_F(test_sys, module_file_suffix) {
 #ifndef UCX_MODULE_FILE_SUFFIX
     UCS_TEST_SKIP_R("module file suffix is not configured");
@@ -8,13 +8,20 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
 #include <limits>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 
 extern "C" {
 #include <ucs/memory/numa.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/topo/base/topo.h>
+#include <ucs/sys/topo/base/topo_cache.h>
 }
 
 static std::string get_sysfs_device_path(const std::string &bdf)
@@ -71,6 +78,23 @@ protected:
 
     void read_pcie_devices();
 
+    /* Constants of get_mempolicy(2), numaif.h may be missing */
+    enum {
+        MEMPOLICY_DEFAULT   = 0,
+        MEMPOLICY_PREFERRED = 1,
+        MEMPOLICY_F_ADDR    = UCS_BIT(1)
+    };
+
+    /* Memory policy of the page which contains the address */
+    static int mem_policy(void *address)
+    {
+        int mode = -1;
+
+        EXPECT_EQ(0, syscall(SYS_get_mempolicy, &mode, NULL, 0, address,
+                             MEMPOLICY_F_ADDR)) << strerror(errno);
+        return mode;
+    }
+
     // Find a sibling DMA engine for a GPU
     void get_siblings(const std::string &hca_bdf, std::string &gpu_bdf,
                       std::string &dma_bdf)
@@ -506,6 +530,50 @@ UCS_TEST_F(test_topo, numa_distance) {
     }
 }
 
+UCS_TEST_F(test_topo, numa_mem_bind_preferred) {
+    size_t page_size = ucs_get_page_size();
+    size_t length    = 4 * page_size;
+    ucs_numa_node_t node;
+    ucs_status_t status;
+    char *ptr;
+
+    node = ucs_numa_node_of_process();
+    if (node == UCS_NUMA_NODE_UNDEFINED) {
+        node = UCS_NUMA_NODE_DEFAULT;
+    }
+
+    ptr = (char*)mmap(NULL, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, ptr);
+
+    /* Only the second and third pages are entirely in the range */
+    status = ucs_numa_mem_bind_preferred(ptr + (page_size / 2),
+                                         (2 * page_size) + page_size / 2,
+                                         node);
+    if (status == UCS_ERR_UNSUPPORTED) {
+        munmap(ptr, length);
+        UCS_TEST_SKIP_R("mbind is not supported");
+    }
+
+    ASSERT_UCS_OK(status);
+    memset(ptr, 0, length);
+    EXPECT_EQ(MEMPOLICY_DEFAULT, mem_policy(ptr));
+    EXPECT_EQ(MEMPOLICY_PREFERRED, mem_policy(ptr + page_size));
+    EXPECT_EQ(MEMPOLICY_PREFERRED, mem_policy(ptr + (2 * page_size)));
+    EXPECT_EQ(MEMPOLICY_DEFAULT, mem_policy(ptr + (3 * page_size)));
+
+    /* No page is entirely in the range */
+    EXPECT_UCS_OK(ucs_numa_mem_bind_preferred(ptr + (3 * page_size) + 1,
+                                              page_size - 1, node));
+    EXPECT_EQ(MEMPOLICY_DEFAULT, mem_policy(ptr + (3 * page_size)));
+
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucs_numa_mem_bind_preferred(ptr, length,
+                                          ucs_numa_num_configured_nodes()));
+
+    munmap(ptr, length);
+}
+
 // Scan and classify PCI devices
 void test_topo::read_pcie_devices()
 {
@@ -675,3 +743,146 @@ UCS_TEST_F(test_topo, sibling_multiple_memory_devices) {
     expect_sibling(gpu_dev1);
     expect_sibling(gpu_dev2);
 }
+
+class test_topo_cache : public ucs::test {
+protected:
+    virtual void init()
+    {
+        char dir_template[] = "/tmp/ucx_topo_cache_XXXXXX";
+
+        ucs::test::init();
+        ASSERT_NE(nullptr, mkdtemp(dir_template));
+        m_dir = dir_template;
+
+        push_config();
+        modify_config("TOPO_CACHE_DIR", m_dir.c_str());
+        reload();
+    }
+
+    virtual void cleanup()
+    {
+        pop_config();
+        reload();
+
+        for (const auto &file : files()) {
+            unlink(file.c_str());
+        }
+        rmdir(m_dir.c_str());
+        ucs::test::cleanup();
+    }
+
+    /* Drop the in-memory cache, so the next access reads the file */
+    static void reload()
+    {
+        ucs_topo_cache_cleanup();
+        ucs_topo_cache_init();
+    }
+
+    std::vector<std::string> files() const
+    {
+        std::vector<std::string> result;
+        struct dirent *entry;
+        DIR *dir;
+
+        dir = opendir(m_dir.c_str());
+        if (dir == NULL) {
+            return result;
+        }
+
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] != '.') {
+                result.push_back(m_dir + "/" + entry->d_name);
+            }
+        }
+
+        closedir(dir);
+        return result;
+    }
+
+    static std::string get(const char *key)
+    {
+        char value[64];
+
+        if (ucs_topo_cache_get(key, value, sizeof(value)) != UCS_OK) {
+            return "<none>";
+        }
+
+        return value;
+    }
+
+    std::string m_dir;
+};
+
+UCS_TEST_F(test_topo_cache, persist) {
+    EXPECT_EQ("<none>", get("key1"));
+
+    ucs_topo_cache_put("key1", "value 1");
+    ucs_topo_cache_put("key2", "value2");
+    /* Keys with whitespace are not cached */
+    ucs_topo_cache_put("key 3", "value3");
+    /* Existing entries are not overwritten */
+    ucs_topo_cache_put("key1", "other");
+
+    EXPECT_EQ("value 1", get("key1"));
+    EXPECT_EQ("value2", get("key2"));
+    EXPECT_EQ("<none>", get("key 3"));
+
+    reload();
+    ASSERT_EQ(1u, files().size());
+    EXPECT_EQ("value 1", get("key1"));
+    EXPECT_EQ("value2", get("key2"));
+}
+
+UCS_TEST_F(test_topo_cache, stale) {
+    ucs_topo_cache_put("key1", "value1");
+    reload();
+
+    ASSERT_EQ(1u, files().size());
+    std::string path = files().front();
+
+    /* Cache created by a different boot or UCX version must be ignored */
+    std::ifstream in(path);
+    std::string header, entries;
+    std::getline(in, header);
+    std::getline(in, entries, '\0');
+    in.close();
+
+    std::ofstream out(path, std::ios::trunc);
+    out << "ucx-topo-cache 0 stale\n" << entries;
+    out.close();
+
+    EXPECT_EQ("<none>", get("key1"));
+
+    ucs_topo_cache_put("key1", "value2");
+    reload();
+    EXPECT_EQ("value2", get("key1"));
+}
+
+
+UCS_TEST_F(test_topo_cache, symlink) {
+    struct stat st;
+
+    ucs_topo_cache_put("key1", "value1");
+    reload();
+
+    ASSERT_EQ(1u, files().size());
+    std::string path   = files().front();
+    std::string target = m_dir + "/target";
+
+    /* A cache file which is replaced by a link is neither read nor written,
+     * and is re-created instead */
+    ASSERT_EQ(0, rename(path.c_str(), target.c_str()));
+    ASSERT_EQ(0, symlink(target.c_str(), path.c_str()));
+
+    EXPECT_EQ("<none>", get("key1"));
+    ucs_topo_cache_put("key2", "value2");
+
+    ASSERT_EQ(0, lstat(path.c_str(), &st));
+    EXPECT_TRUE(S_ISREG(st.st_mode));
+
+    std::ifstream in(target);
+    std::string contents((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    EXPECT_NE(std::string::npos, contents.find("key1"));
+    EXPECT_EQ(std::string::npos, contents.find("key2"));
+}
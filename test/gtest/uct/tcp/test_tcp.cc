@@ -9,6 +9,7 @@
 extern "C" {
 #include <uct/api/uct.h>
 #include <uct/tcp/tcp.h>
+#include <uct/tcp/tcp_base.h>
 }
 
 class test_uct_tcp : public uct_test {
@@ -156,6 +157,51 @@ public:
         }
     }
 
+    void test_conn_rate() {
+        const size_t num_eps =
+            ucs_min(static_cast<size_t>(max_connections()), 256lu) /
+            ucs::test_time_multiplier();
+        entity *sender       = uct_test::create_entity(0);
+        size_t num_connected = 0;
+        uct_tcp_iface_t *iface;
+
+        m_entities.push_back(sender);
+        iface = ucs_derived_of(sender->iface(), uct_tcp_iface_t);
+
+        ucs_time_t start_time = ucs_get_time();
+        for (size_t i = 0; i < num_eps; ++i) {
+            sender->connect_to_iface(i, *m_ent);
+        }
+
+        /* Connections above the limit wait in the queue */
+        if (iface->config.conn_nb) {
+            EXPECT_LE(iface->conn_inflight, iface->config.max_conn_inflight);
+            EXPECT_EQ(ucs_list_is_empty(&iface->conn_queue),
+                      iface->conn_inflight < iface->config.max_conn_inflight);
+        }
+
+        ucs_time_t deadline = ucs::get_deadline();
+        while ((num_connected < num_eps) && (ucs_get_time() < deadline)) {
+            progress();
+            for (num_connected = 0; num_connected < num_eps; ++num_connected) {
+                uct_tcp_ep_t *ep = ucs_derived_of(sender->ep(num_connected),
+                                                  uct_tcp_ep_t);
+                if (ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED) {
+                    break;
+                }
+            }
+        }
+
+        double elapsed = ucs_time_to_sec(ucs_get_time() - start_time);
+        ASSERT_EQ(num_eps, num_connected);
+        EXPECT_EQ(0u, iface->conn_inflight);
+        EXPECT_TRUE(ucs_list_is_empty(&iface->conn_queue));
+        UCS_TEST_MESSAGE << num_eps << " endpoints established in "
+                         << (elapsed * UCS_MSEC_PER_SEC) << " ms, "
+                         << static_cast<size_t>(num_eps / elapsed)
+                         << " endpoints/sec";
+    }
+
 private:
     void init_data(void *buf, size_t msg_size) {
         uct_tcp_am_hdr_t *tcp_am_hdr;
@@ -231,6 +277,113 @@ private:
     }
 
 protected:
+    typedef struct {
+        uint64_t count;
+        bool     in_order;
+    } am_burst_ctx;
+
+    static ucs_status_t
+    am_burst_handler(void *arg, void *data, size_t length, unsigned flags)
+    {
+        am_burst_ctx *ctx = static_cast<am_burst_ctx*>(arg);
+
+        EXPECT_EQ(sizeof(uint64_t), length);
+        ctx->in_order = ctx->in_order &&
+                        (*static_cast<uint64_t*>(data) == ctx->count);
+        ++ctx->count;
+        return UCS_OK;
+    }
+
+    /* Returns the number of progress calls after which the receiver kept an
+     * empty RX buffer */
+    size_t test_am_short_burst(entity *sender)
+    {
+        static const uint8_t AM_ID = 1;
+        const uint64_t num_sends   = 10000 / ucs::test_time_multiplier();
+        am_burst_ctx ctx           = {0, true};
+        size_t num_kept            = 0;
+        ucs_time_t deadline;
+        ucs_status_t status;
+
+        sender->connect(0, *m_ent, 0);
+
+        status = uct_iface_set_am_handler(m_ent->iface(), AM_ID,
+                                          am_burst_handler, &ctx, 0);
+        ASSERT_UCS_OK(status);
+
+        /* Send without progressing the receiver as long as possible, so it
+         * gets many messages in a single read */
+        for (uint64_t sn = 0; sn < num_sends; ++sn) {
+            while ((status = uct_ep_am_short(sender->ep(0), AM_ID, sn, NULL,
+                                             0)) == UCS_ERR_NO_RESOURCE) {
+                progress();
+                num_kept += (get_kept_rx_buf_num() > 0);
+            }
+            ASSERT_UCS_OK(status);
+        }
+
+        deadline = ucs_get_time() + ucs_time_from_sec(DEFAULT_TIMEOUT_SEC) *
+                                    ucs::test_time_multiplier();
+        while ((ctx.count < num_sends) && (ucs_get_time() < deadline)) {
+            progress();
+            num_kept += (get_kept_rx_buf_num() > 0);
+        }
+
+        EXPECT_EQ(num_sends, ctx.count);
+        EXPECT_TRUE(ctx.in_order);
+
+        status = uct_iface_set_am_handler(m_ent->iface(), AM_ID, NULL, NULL, 0);
+        EXPECT_UCS_OK(status);
+        return num_kept;
+    }
+
+    /* Number of endpoints which keep an empty RX buffer between reads */
+    size_t get_kept_rx_buf_num()
+    {
+        size_t num = 0;
+        uct_tcp_ep_t *ep;
+
+        UCS_ASYNC_BLOCK(m_tcp_iface->super.worker->async);
+        ucs_list_for_each(ep, &m_tcp_iface->ep_list, list) {
+            num += (ep->rx.buf != NULL) && (ep->rx.length == 0);
+        }
+        UCS_ASYNC_UNBLOCK(m_tcp_iface->super.worker->async);
+
+        return num;
+    }
+
+    static bool is_busy_poll_permitted(int busy_poll_usec)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        ucs_status_t status;
+
+        if (fd < 0) {
+            return false;
+        }
+
+        {
+            /* Raising it above the system default requires CAP_NET_ADMIN */
+            scoped_log_handler slh(hide_errors_logger);
+            status = ucs_tcp_base_set_busy_poll(
+                    fd, ucs_time_from_usec(busy_poll_usec));
+        }
+
+        close(fd);
+        return status == UCS_OK;
+    }
+
+    static int get_busy_poll(int fd)
+    {
+        int busy_poll    = -1;
+        socklen_t optlen = sizeof(busy_poll);
+
+#ifdef SO_BUSY_POLL
+        EXPECT_EQ(0, getsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll,
+                                &optlen));
+#endif
+        return busy_poll;
+    }
+
     uct_tcp_iface *m_tcp_iface;
     entity        *m_ent;
 };
@@ -286,5 +439,119 @@ UCS_TEST_P(test_uct_tcp, check_addr_len)
     EXPECT_EQ(sizeof(uct_tcp_ep_addr_t), iface_attr.ep_addr_len);
 }
 
+UCS_TEST_P(test_uct_tcp, num_paths, "TCP_NUM_PATHS=4")
+{
+    uct_iface_attr_t iface_attr;
+    uct_perf_attr_t perf_attr;
+
+    ucs_status_t status = uct_iface_query(m_ent->iface(), &iface_attr);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(4, iface_attr.dev_num_paths);
+
+    perf_attr.field_mask = UCT_PERF_ATTR_FIELD_OPERATION |
+                           UCT_PERF_ATTR_FIELD_BANDWIDTH |
+                           UCT_PERF_ATTR_FIELD_PATH_BANDWIDTH;
+    perf_attr.operation  = UCT_EP_OP_PUT_ZCOPY;
+    status               = uct_iface_estimate_perf(m_ent->iface(),
+                                                   &perf_attr);
+    ASSERT_UCS_OK(status);
+
+    /* Every connection is bounded by the bandwidth of a single flow */
+    EXPECT_LE(perf_attr.path_bandwidth.shared, m_tcp_iface->config.max_bw);
+    EXPECT_LE(perf_attr.path_bandwidth.shared, perf_attr.bandwidth.shared);
+    EXPECT_LE(perf_attr.bandwidth.shared, 4 * m_tcp_iface->config.max_bw);
+}
+
+UCS_TEST_P(test_uct_tcp, am_short_burst)
+{
+    entity *sender = uct_test::create_entity(0);
+
+    m_entities.push_back(sender);
+    test_am_short_burst(sender);
+}
+
+/* The RX buffer holds exactly 80 messages of 13 bytes, which are the TCP AM
+ * header and the 8-byte AM header, so a read which fills it ends on a message
+ * boundary */
+UCS_TEST_SKIP_COND_P(test_uct_tcp, am_short_burst_busy_poll,
+                     !is_busy_poll_permitted(50), "TCP_BUSY_POLL=50us",
+                     "TCP_TX_SEG_SIZE=1035", "TCP_RX_SEG_SIZE=1035")
+{
+    entity *sender = uct_test::create_entity(0);
+    size_t num_kept;
+    uct_tcp_ep_t *ep;
+
+    ASSERT_EQ(80 * 13, m_tcp_iface->config.rx_seg_size);
+    m_entities.push_back(sender);
+    num_kept = test_am_short_burst(sender);
+
+    /* A read which fills the whole RX buffer keeps it for the next one */
+    UCS_TEST_MESSAGE << "RX buffer was kept after " << num_kept
+                     << " progress calls";
+    EXPECT_GT(num_kept, 0u);
+    EXPECT_EQ(50, get_busy_poll(ucs_derived_of(sender->ep(0),
+                                               uct_tcp_ep_t)->fd));
+
+    /* Accepted endpoints use the option as well */
+    UCS_ASYNC_BLOCK(m_tcp_iface->super.worker->async);
+    ucs_list_for_each(ep, &m_tcp_iface->ep_list, list) {
+        EXPECT_EQ(50, get_busy_poll(ep->fd));
+    }
+    UCS_ASYNC_UNBLOCK(m_tcp_iface->super.worker->async);
+}
+
+UCS_TEST_P(test_uct_tcp, set_busy_poll)
+{
+    static const int BUSY_POLL_USEC = 50;
+    int fd                          = socket(AF_INET, SOCK_STREAM, 0);
+    ucs_status_t status;
+    int orig_busy_poll;
+
+    ASSERT_GE(fd, 0);
+    orig_busy_poll = get_busy_poll(fd);
+
+    /* auto keeps the system default */
+    ASSERT_UCS_OK(ucs_tcp_base_set_busy_poll(fd, UCS_TIME_AUTO));
+    EXPECT_EQ(orig_busy_poll, get_busy_poll(fd));
+
+    {
+        /* Raising it above the system default requires CAP_NET_ADMIN */
+        scoped_log_handler slh(hide_errors_logger);
+        status = ucs_tcp_base_set_busy_poll(
+                fd, ucs_time_from_usec(BUSY_POLL_USEC));
+    }
+
+    if (status == UCS_OK) {
+        EXPECT_EQ(BUSY_POLL_USEC, get_busy_poll(fd));
+    } else {
+        UCS_TEST_MESSAGE << "failed to set busy poll: "
+                         << ucs_status_string(status);
+    }
+
+    close(fd);
+}
+
+UCS_TEST_P(test_uct_tcp, conn_rate)
+{
+    test_conn_rate();
+}
+
+UCS_TEST_P(test_uct_tcp, conn_rate_nb, "TCP_CONN_NB=y")
+{
+    test_conn_rate();
+}
+
+UCS_TEST_P(test_uct_tcp, conn_rate_nb_limited, "TCP_CONN_NB=y",
+           "TCP_MAX_CONN_INFLIGHT=4")
+{
+    test_conn_rate();
+}
+
+#ifdef TCP_FASTOPEN_CONNECT
+UCS_TEST_P(test_uct_tcp, conn_rate_fast_open, "TCP_FAST_OPEN=y")
+{
+    test_conn_rate();
+}
+#endif
 
 _UCT_INSTANTIATE_TEST_CASE(test_uct_tcp, tcp)
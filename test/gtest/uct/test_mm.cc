@@ -7,12 +7,15 @@
 extern "C" {
 #include <uct/api/uct.h>
 #include <uct/sm/mm/base/mm_md.h>
+#include <uct/sm/mm/base/mm_iface.h>
 #include <ucs/time/time.h>
 }
 #include "uct_p2p_test.h"
 #include <common/test.h>
 #include "uct_test.h"
 
+#include <sys/wait.h>
+
 
 class test_uct_mm : public uct_test {
 public:
@@ -182,6 +185,128 @@ public:
         uct_rkey_release(GetParam()->component, &rkey_ob);
     }
 
+    static size_t rx_pool_pack_cb(void *dest, void *arg) {
+        const uint64_t sn = *(const uint64_t*)arg;
+
+        std::fill_n((uint64_t*)dest, RX_POOL_MSG_SIZE / sizeof(uint64_t), sn);
+        return RX_POOL_MSG_SIZE;
+    }
+
+    struct rx_pool_recv {
+        unsigned           count;
+        unsigned           in_pool; /* Messages received in the pool */
+        const uct_mm_seg_t *seg;    /* Pool segment of the receiver */
+    };
+
+    static ucs_status_t rx_pool_am_handler(void *arg, void *data,
+                                           size_t length, unsigned flags) {
+        rx_pool_recv *recv      = (rx_pool_recv*)arg;
+        const uint64_t *payload = (const uint64_t*)data;
+
+        EXPECT_EQ(size_t(RX_POOL_MSG_SIZE), length);
+        for (size_t i = 0; i < length / sizeof(uint64_t); ++i) {
+            if (payload[i] != recv->count) {
+                ADD_FAILURE() << "payload[" << i << "]=" << payload[i]
+                              << " expected " << recv->count;
+                break;
+            }
+        }
+
+        if ((recv->seg != NULL) && (data >= recv->seg->address) &&
+            (UCS_PTR_BYTE_OFFSET(data, length) <=
+             UCS_PTR_BYTE_OFFSET(recv->seg->address, recv->seg->length))) {
+            ++recv->in_pool;
+        }
+
+        ++recv->count;
+        return UCS_OK;
+    }
+
+    /* Path of the file which backs a file descriptor */
+    static std::string fd_path(int fd) {
+        std::string link = "/proc/self/fd/" + ucs::to_string(fd);
+        char path[PATH_MAX];
+        ssize_t ret;
+
+        ret = readlink(link.c_str(), path, sizeof(path) - 1);
+        EXPECT_GT(ret, 0) << link << ": " << strerror(errno);
+        return std::string(path, std::max(ret, ssize_t(0)));
+    }
+
+    struct zcopy_recv {
+        unsigned count;
+        uint64_t value;
+    };
+
+    static ucs_status_t zcopy_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        zcopy_recv *recv = (zcopy_recv*)arg;
+
+        EXPECT_EQ(size_t(ZCOPY_MSG_SIZE), length);
+        recv->value = *(const uint64_t*)data;
+        ++recv->count;
+        return UCS_OK;
+    }
+
+    static ucs_status_t zcopy_values_handler(void *arg, void *data,
+                                             size_t length, unsigned flags) {
+        std::vector<uint64_t> *values = (std::vector<uint64_t>*)arg;
+
+        values->push_back(*(const uint64_t*)data);
+        return UCS_OK;
+    }
+
+    static ucs_status_t zcopy_err_handler(void *arg, uct_ep_h ep,
+                                          ucs_status_t status) {
+        EXPECT_EQ(UCS_ERR_CONNECTION_RESET, status);
+        m_err_ep = ep;
+        ++m_err_count;
+        return UCS_OK;
+    }
+
+    static ucs_status_t
+    mem_attach_fail(uct_mm_md_t *md, uct_mm_seg_id_t seg_id, size_t length,
+                    const void *iface_addr, uct_mm_remote_seg_t *rseg) {
+        return UCS_ERR_SHMEM_SEGMENT;
+    }
+
+    void wait_for_values(std::vector<uint64_t> *values, size_t size) {
+        ucs_time_t deadline = ucs_get_time() +
+                              ucs_time_from_sec(DEFAULT_TIMEOUT_SEC);
+
+        while ((values->size() < size) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+    }
+
+    void send_zcopy(entity *sender, uint64_t value, unsigned ep_index = 0) {
+        std::vector<uint64_t> buffer(ZCOPY_MSG_SIZE / sizeof(uint64_t), value);
+        ucs_status_t status;
+        uct_iov_t iov;
+
+        iov.buffer = &buffer[0];
+        iov.length = ZCOPY_MSG_SIZE;
+        iov.memh   = UCT_MEM_HANDLE_NULL;
+        iov.stride = 0;
+        iov.count  = 1;
+
+        do {
+            status = uct_ep_am_zcopy(sender->ep(ep_index), 0, NULL, 0, &iov,
+                                     1, 0, NULL);
+            if (status == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (status == UCS_ERR_NO_RESOURCE);
+        ASSERT_UCS_OK(status);
+    }
+
+    uct_mm_iface_t *mm_iface(entity *e) {
+        return ucs_derived_of(e->iface(), uct_mm_iface_t);
+    }
+
+    static const size_t RX_POOL_MSG_SIZE = 4 * UCS_KBYTE;
+    static const size_t ZCOPY_MSG_SIZE   = 4 * UCS_KBYTE;
+
     void test_memh(void *ptr, uct_mem_h memh, size_t size) {
         test_attach(ptr, memh, size);
         test_attach(ptr, memh, size);
@@ -190,8 +315,15 @@ public:
 
 protected:
     entity *m_e1, *m_e2;
+    ucs::mock m_mock;
+
+    static unsigned m_err_count;
+    static uct_ep_h m_err_ep;
 };
 
+unsigned test_uct_mm::m_err_count = 0;
+uct_ep_h test_uct_mm::m_err_ep    = NULL;
+
 UCS_TEST_SKIP_COND_P(test_uct_mm, open_for_posix,
                      check_caps(UCT_IFACE_FLAG_AM_SHORT | UCT_IFACE_FLAG_CB_SYNC))
 {
@@ -219,6 +351,229 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, open_for_posix,
     free(recv_buffer);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_mm, rx_pool,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC),
+                     "MM_RX_POOL=y", "MM_RX_POOL_SIZE=16m",
+                     "MM_RX_POOL_SLAB_SIZE=256k", "MM_RX_POOL_QUOTA=16m")
+{
+    const unsigned num_msgs = 1000 / ucs::test_time_multiplier();
+    rx_pool_recv recv       = {0, 0, mm_iface(m_e2)->rx_pool.seg};
+    ucs_status_t status;
+    ssize_t packed_len;
+
+    if (GetParam()->tl_name != "posix") {
+        /* only posix supports the node receive pool */
+        EXPECT_EQ(NULL, mm_iface(m_e1)->rx_pool.seg);
+    } else {
+        ASSERT_NE((void*)NULL, mm_iface(m_e1)->rx_pool.seg);
+        ASSERT_NE((void*)NULL, mm_iface(m_e2)->rx_pool.seg);
+        EXPECT_EQ(mm_iface(m_e1)->rx_pool.seg->seg_id,
+                  mm_iface(m_e2)->rx_pool.seg->seg_id);
+    }
+
+    status = uct_iface_set_am_handler(m_e2->iface(), 0, rx_pool_am_handler,
+                                      &recv, 0);
+    ASSERT_UCS_OK(status);
+
+    for (uint64_t sn = 0; sn < num_msgs; ++sn) {
+        do {
+            packed_len = uct_ep_am_bcopy(m_e1->ep(0), 0, rx_pool_pack_cb, &sn,
+                                         0);
+            if (packed_len == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (packed_len == UCS_ERR_NO_RESOURCE);
+        ASSERT_EQ((ssize_t)RX_POOL_MSG_SIZE, packed_len);
+    }
+
+    wait_for_value(&recv.count, num_msgs, true);
+    EXPECT_EQ(num_msgs, recv.count);
+
+    /* The quota covers all receive descriptors, so none is private */
+    if (recv.seg != NULL) {
+        EXPECT_EQ(num_msgs, recv.in_pool);
+    }
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, rx_pool_recovery,
+                     GetParam()->tl_name != "posix")
+{
+    static const size_t size      = 2 * UCS_MBYTE;
+    static const size_t slab_size = 256 * UCS_KBYTE;
+    uct_mm_md_t *md = ucs_derived_of(m_e1->md(), uct_mm_md_t);
+    std::vector<void*> slabs;
+    uct_mm_rx_pool_t pool;
+    unsigned num_slabs;
+    std::string path;
+    int fd, status;
+    pid_t pid;
+
+    ASSERT_UCS_OK(uct_mm_rx_pool_open(md, size, slab_size, size, &pool));
+    path      = fd_path(pool.fd);
+    num_slabs = pool.num_slabs;
+    uct_mm_rx_pool_close(&pool);
+
+    /* A creator which crashed after sizing the pool left it uninitialized */
+    fd = open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    ASSERT_GE(fd, 0) << path << ": " << strerror(errno);
+    EXPECT_EQ(0, ftruncate(fd, size));
+    close(fd);
+
+    ASSERT_UCS_OK(uct_mm_rx_pool_open(md, size, slab_size, size, &pool));
+    EXPECT_EQ(num_slabs, pool.num_slabs);
+
+    /* A process which crashed while holding a slab */
+    pid = fork();
+    if (pid == 0) {
+        uct_mm_rx_pool_t child_pool;
+
+        if ((uct_mm_rx_pool_open(md, size, slab_size, size, &child_pool) !=
+             UCS_OK) ||
+            (uct_mm_rx_pool_slab_get(&child_pool) == NULL)) {
+            _exit(1);
+        }
+
+        _exit(0);
+    }
+
+    ASSERT_GE(pid, 0) << strerror(errno);
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    for (unsigned i = 0; i < num_slabs; ++i) {
+        slabs.push_back(uct_mm_rx_pool_slab_get(&pool));
+        EXPECT_NE((void*)NULL, slabs.back()) << "slab " << i;
+    }
+
+    for (void *slab : slabs) {
+        if (slab != NULL) {
+            uct_mm_rx_pool_slab_put(&pool, slab);
+        }
+    }
+
+    uct_mm_rx_pool_close(&pool);
+
+    /* The last user removed the pool */
+    EXPECT_NE(0, access(path.c_str(), F_OK));
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, zcopy_sender_recreate,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    zcopy_recv recv = {0, 0};
+    ucs_status_t status;
+
+    status = uct_iface_set_am_handler(m_e2->iface(), 0, zcopy_am_handler,
+                                      &recv, 0);
+    ASSERT_UCS_OK(status);
+
+    send_zcopy(m_e1, 1);
+    wait_for_value(&recv.count, 1u, true);
+    EXPECT_EQ(1u, recv.value);
+
+    /* A new sender may reuse the id of the released send segment, which the
+     * receiver must not read through its old mapping */
+    m_e2->destroy_ep(0);
+    m_entities.remove(m_e1);
+    m_e1 = uct_test::create_entity(0);
+    m_entities.push_back(m_e1);
+    m_e1->connect(0, *m_e2, 0);
+
+    send_zcopy(m_e1, 2);
+    wait_for_value(&recv.count, 2u, true);
+    EXPECT_EQ(2u, recv.value);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, zcopy_flush,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    zcopy_recv recv = {0, 0};
+    uct_completion_t comp;
+    ucs_status_t status;
+
+    status = uct_iface_set_am_handler(m_e2->iface(), 0, zcopy_am_handler,
+                                      &recv, 0);
+    ASSERT_UCS_OK(status);
+
+    send_zcopy(m_e1, 1);
+
+    /* The receiver did not read the send descriptor yet */
+    comp.func   = (uct_completion_callback_t)ucs_empty_function;
+    comp.count  = 1;
+    comp.status = UCS_OK;
+    ASSERT_EQ(UCS_INPROGRESS, uct_ep_flush(m_e1->ep(0), 0, &comp));
+    EXPECT_EQ(UCS_INPROGRESS, uct_iface_flush(m_e1->iface(), 0, NULL));
+    for (int i = 0; i < 10; ++i) {
+        m_e1->progress();
+    }
+    EXPECT_EQ(1, comp.count);
+
+    wait_for_value(&comp.count, 0, true);
+    EXPECT_EQ(1u, recv.count);
+    EXPECT_UCS_OK(uct_ep_flush(m_e1->ep(0), 0, NULL));
+    EXPECT_UCS_OK(uct_iface_flush(m_e1->iface(), 0, NULL));
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, zcopy_destroy_unflushed,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    std::vector<uint64_t> values;
+    ucs_status_t status;
+
+    status = uct_iface_set_am_handler(m_e2->iface(), 0, zcopy_values_handler,
+                                      &values, 0);
+    ASSERT_UCS_OK(status);
+
+    /* The descriptor of a destroyed endpoint is not reused by a new endpoint
+     * while the receiver did not read it */
+    send_zcopy(m_e1, 1);
+    m_e1->destroy_ep(0);
+    EXPECT_FALSE(ucs_queue_is_empty(&mm_iface(m_e1)->ep_send_descs));
+
+    m_e1->connect(0, *m_e2, 0);
+    send_zcopy(m_e1, 2);
+
+    wait_for_values(&values, 2);
+    ASSERT_EQ(2u, values.size());
+    EXPECT_EQ(1u, values[0]);
+    EXPECT_EQ(2u, values[1]);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, zcopy_attach_failure,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    uct_mm_md_t *md = ucs_derived_of(m_e2->md(), uct_mm_md_t);
+    zcopy_recv recv = {0, 0};
+    ucs_status_t status;
+    entity *receiver;
+
+    /* The receiver reports the sender as failed instead of losing the
+     * message */
+    m_err_count = 0;
+    receiver    = uct_test::create_entity(0, zcopy_err_handler);
+    m_entities.push_back(receiver);
+    m_e1->connect(1, *receiver, 0);
+    receiver->connect(0, *m_e1, 1);
+
+    status = uct_iface_set_am_handler(receiver->iface(), 0, zcopy_am_handler,
+                                      &recv, 0);
+    ASSERT_UCS_OK(status);
+
+    m_mock.setup(&uct_mm_md_mapper_ops(md)->mem_attach, mem_attach_fail);
+    send_zcopy(m_e1, 1, 1);
+    wait_for_value(&m_err_count, 1u, true);
+    m_mock.cleanup();
+
+    EXPECT_EQ(0u, recv.count);
+    EXPECT_EQ(receiver->ep(0), m_err_ep);
+}
+
 UCS_TEST_SKIP_COND_P(test_uct_mm, alloc,
                      !check_md_caps(UCT_MD_FLAG_ALLOC)) {
 
@@ -270,4 +625,62 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, reg,
     ASSERT_UCS_OK(status);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_mm, attach_cache,
+                     (GetParam()->tl_name != "posix") ||
+                     !check_md_caps(UCT_MD_FLAG_ALLOC),
+                     "ATTACH_CACHE_SIZE?=2")
+{
+    size_t size               = ucs_min(100000u, m_e1->md_attr().max_alloc);
+    uct_md_h md_ref           = m_e1->md();
+    uct_alloc_method_t method = UCT_ALLOC_METHOD_MD;
+    uct_mm_remote_seg_t rseg1, rseg2, rseg3;
+    uct_mem_alloc_params_t params;
+    uct_allocated_memory_t mem;
+    ucs_status_t status;
+
+    params.field_mask = UCT_MEM_ALLOC_PARAM_FIELD_FLAGS    |
+                        UCT_MEM_ALLOC_PARAM_FIELD_MEM_TYPE |
+                        UCT_MEM_ALLOC_PARAM_FIELD_MDS      |
+                        UCT_MEM_ALLOC_PARAM_FIELD_NAME;
+    params.flags      = UCT_MD_MEM_ACCESS_ALL;
+    params.name       = "test_mm";
+    params.mem_type   = UCS_MEMORY_TYPE_HOST;
+    params.mds.mds    = &md_ref;
+    params.mds.count  = 1;
+
+    status = uct_mem_alloc(size, &method, 1, &params, &mem);
+    ASSERT_UCS_OK(status);
+
+    uct_mm_seg_t *seg     = (uct_mm_seg_t*)mem.memh;
+    size_t iface_addr_len = uct_mm_md_mapper_call(md(m_e1), iface_addr_length);
+    std::vector<uint8_t> iface_addr(iface_addr_len);
+
+    status = uct_mm_md_mapper_call(md(m_e1), iface_addr_pack, &iface_addr[0]);
+    ASSERT_UCS_OK(status);
+
+    /* Attachments in use share the same mapping */
+    status = uct_mm_md_mapper_call(md(m_e2), mem_attach, seg->seg_id,
+                                   mem.length, &iface_addr[0], &rseg1);
+    ASSERT_UCS_OK(status);
+    status = uct_mm_md_mapper_call(md(m_e2), mem_attach, seg->seg_id,
+                                   mem.length, &iface_addr[0], &rseg2);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(rseg1.address, rseg2.address);
+
+    uct_mm_md_mapper_call(md(m_e2), mem_detach, &rseg1);
+    test_attach_ptr(mem.address, rseg2.address, 0xdeadbeef33333);
+    uct_mm_md_mapper_call(md(m_e2), mem_detach, &rseg2);
+
+    /* Unused mapping is kept, and reused by any memory domain */
+    status = uct_mm_md_mapper_call(md(m_e1), mem_attach, seg->seg_id,
+                                   mem.length, &iface_addr[0], &rseg3);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(rseg2.address, rseg3.address);
+    test_attach_ptr(mem.address, rseg3.address, 0xdeadbeef44444);
+    uct_mm_md_mapper_call(md(m_e1), mem_detach, &rseg3);
+
+    status = uct_mem_free(&mem);
+    ASSERT_UCS_OK(status);
+}
+
 UCT_INSTANTIATE_MM_TEST_CASE(test_uct_mm)
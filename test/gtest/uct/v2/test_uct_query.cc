@@ -24,6 +24,8 @@ extern "C" {
 #define MM_SEND_OVERHEAD_AM_BCOPY  7
 #define MM_RECV_OVERHEAD_AM_SHORT  8
 #define MM_RECV_OVERHEAD_AM_BCOPY  9
+#define MM_SEND_OVERHEAD_AM_ZCOPY  10
+#define MM_RECV_OVERHEAD_AM_ZCOPY  11
 
 
 class test_uct_query : public uct_test {
@@ -175,10 +177,12 @@ class test_uct_query_mm : public test_uct_query {
 UCS_TEST_P(test_uct_query_mm, send_recv_overhead,
            "MM_SEND_OVERHEAD=am_short:"
            UCS_PP_MAKE_STRING(MM_SEND_OVERHEAD_AM_SHORT) ",am_bcopy:"
-           UCS_PP_MAKE_STRING(MM_SEND_OVERHEAD_AM_BCOPY),
+           UCS_PP_MAKE_STRING(MM_SEND_OVERHEAD_AM_BCOPY) ",am_zcopy:"
+           UCS_PP_MAKE_STRING(MM_SEND_OVERHEAD_AM_ZCOPY),
            "MM_RECV_OVERHEAD=am_short:"
            UCS_PP_MAKE_STRING(MM_RECV_OVERHEAD_AM_SHORT) ",am_bcopy:"
-           UCS_PP_MAKE_STRING(MM_RECV_OVERHEAD_AM_BCOPY))
+           UCS_PP_MAKE_STRING(MM_RECV_OVERHEAD_AM_BCOPY) ",am_zcopy:"
+           UCS_PP_MAKE_STRING(MM_RECV_OVERHEAD_AM_ZCOPY))
 {
     auto perf_attr        = init_perf_attr();
     perf_attr.field_mask |= UCT_PERF_ATTR_FIELD_SEND_PRE_OVERHEAD |
@@ -192,6 +196,15 @@ UCS_TEST_P(test_uct_query_mm, send_recv_overhead,
     EXPECT_EQ(iface_estimate_perf(&perf_attr), UCS_OK);
     EXPECT_FLOAT_EQ(perf_attr.send_pre_overhead, MM_SEND_OVERHEAD_AM_BCOPY);
     EXPECT_FLOAT_EQ(perf_attr.recv_overhead, MM_RECV_OVERHEAD_AM_BCOPY);
+
+    if (!check_caps(UCT_IFACE_FLAG_AM_ZCOPY)) {
+        return;
+    }
+
+    perf_attr.operation = UCT_EP_OP_AM_ZCOPY;
+    EXPECT_EQ(iface_estimate_perf(&perf_attr), UCS_OK);
+    EXPECT_FLOAT_EQ(perf_attr.send_pre_overhead, MM_SEND_OVERHEAD_AM_ZCOPY);
+    EXPECT_FLOAT_EQ(perf_attr.recv_overhead, MM_RECV_OVERHEAD_AM_ZCOPY);
 }
 
 UCT_INSTANTIATE_MM_TEST_CASE(test_uct_query_mm)